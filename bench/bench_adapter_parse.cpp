@@ -0,0 +1,82 @@
+/**
+ * SPDX-FileComment: Micro benchmark for adapter response parsing.
+ * SPDX-FileType: SOURCE
+ * SPDX-FileContributor: ZHENG Robert
+ * SPDX-FileCopyrightText: 2026 ZHENG Robert
+ * SPDX-License-Identifier: MIT
+ *
+ * @file bench_adapter_parse.cpp
+ * @brief Compares a full DOM parse with the adapters' on-demand scan.
+ * @version 0.1.0
+ * @date 2026-10-19
+ *
+ * @author ZHENG Robert
+ * @license MIT License
+ */
+
+#include "bench_common.hpp"
+
+#include "regeocode/adapter_bing.hpp"
+#include "regeocode/adapter_country_info.hpp"
+#include "regeocode/adapter_geonames_timezone.hpp"
+#include "regeocode/adapter_geonames_wikipedia.hpp"
+#include "regeocode/adapter_google.hpp"
+#include "regeocode/adapter_marea_tides.hpp"
+#include "regeocode/adapter_nominatim.hpp"
+#include "regeocode/adapter_opencage.hpp"
+#include "regeocode/adapter_openweather.hpp"
+#include "regeocode/adapter_pollution.hpp"
+#include "regeocode/adapter_seaweather.hpp"
+#include "regeocode/adapter_tides.hpp"
+
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <utility>
+#include <vector>
+
+int main(int argc, char **argv) {
+  using namespace regeocode;
+
+  const std::string fixture_dir = argc > 1 ? argv[1] : "tests/fixtures";
+  constexpr std::size_t kIterations = 20'000;
+
+  std::vector<std::pair<std::string, ApiAdapterPtr>> adapters;
+  adapters.emplace_back("nominatim", std::make_unique<NominatimAdapter>());
+  adapters.emplace_back("google", std::make_unique<GoogleAdapter>());
+  adapters.emplace_back("opencage", std::make_unique<OpenCageAdapter>());
+  adapters.emplace_back("bing", std::make_unique<BingAdapter>());
+  adapters.emplace_back("country_info", std::make_unique<CountryInfoAdapter>());
+  adapters.emplace_back("timezone", std::make_unique<GeoNamesTimezoneAdapter>());
+  adapters.emplace_back("wikipedia",
+                        std::make_unique<GeoNamesWikipediaAdapter>());
+  adapters.emplace_back("openweather", std::make_unique<OpenWeatherAdapter>());
+  adapters.emplace_back("pollution", std::make_unique<PollutionAdapter>());
+  adapters.emplace_back("marea_tides", std::make_unique<MareaTidesAdapter>());
+  adapters.emplace_back("tides", std::make_unique<TidesAdapter>());
+  adapters.emplace_back("seaweather", std::make_unique<SeaWeatherAdapter>());
+
+  for (const auto &[name, adapter] : adapters) {
+    std::ifstream f(fixture_dir + "/" + name + ".json");
+    if (!f.is_open()) {
+      std::cerr << "Missing fixture for " << name << std::endl;
+      return 1;
+    }
+    std::stringstream ss;
+    ss << f.rdbuf();
+    const std::string body = ss.str();
+
+    // Lower bound of the previous implementation: the DOM build alone
+    bench::report(bench::run(name + "/dom_parse", kIterations, [&] {
+      auto j = nlohmann::json::parse(body);
+      bench::do_not_optimize(j);
+    }));
+
+    bench::report(bench::run(name + "/parse_response", kIterations, [&] {
+      auto r = adapter->parse_response(body);
+      bench::do_not_optimize(r);
+    }));
+  }
+
+  return 0;
+}
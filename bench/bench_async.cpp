@@ -0,0 +1,97 @@
+/**
+ * SPDX-FileComment: Benchmark for the awaitable batch lookup.
+ * SPDX-FileType: SOURCE
+ * SPDX-FileContributor: ZHENG Robert
+ * SPDX-FileCopyrightText: 2026 ZHENG Robert
+ * SPDX-License-Identifier: MIT
+ *
+ * @file bench_async.cpp
+ * @brief Batches through batch_reverse_geocode() (one thread per
+ *        coordinate) against batch_reverse_geocode_async() (one coroutine
+ *        frame per coordinate on the engine), over a loopback h2c provider.
+ * @version 0.1.0
+ * @date 2026-10-19
+ *
+ * @author ZHENG Robert
+ * @license MIT License
+ */
+
+#include "bench_common.hpp"
+#include "stand_in_server.hpp"
+
+#include "regeocode/adapter_nominatim.hpp"
+#include "regeocode/re_geocode_core.hpp"
+
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+int main(int argc, char **argv) {
+  using namespace regeocode;
+  using namespace std::chrono_literals;
+
+  const std::string fixture_dir = argc > 1 ? argv[1] : "tests/fixtures";
+  // Simulated provider processing time
+  constexpr auto kLatency = 20ms;
+
+  std::ifstream f(fixture_dir + "/nominatim.json");
+  if (!f.is_open()) {
+    std::cerr << "Missing fixture for nominatim" << std::endl;
+    return 1;
+  }
+  std::stringstream ss;
+  ss << f.rdbuf();
+  const bench::StandInServer server(ss.str(), kLatency);
+  const std::string quota =
+      (std::filesystem::temp_directory_path() / "bench_async_quota.json")
+          .string();
+
+  ApiConfig cfg;
+  cfg.name = "nominatim";
+  cfg.adapter = "nominatim";
+  cfg.type = "geocoding";
+  cfg.uri_template = server.url() + "?lat={{ latitude }}&lon={{ longitude }}";
+  cfg.accept_encoding = "identity";
+  cfg.http_version = HttpVersion::Http2PriorKnowledge;
+  std::vector<ApiAdapterPtr> adapters;
+  adapters.push_back(std::make_unique<NominatimAdapter>());
+  HttpClientOptions client_options;
+  client_options.multiplex = true;
+  client_options.max_concurrent_streams = 1000;
+  const ReverseGeocoder geocoder({{cfg.name, cfg}}, std::move(adapters),
+                                 std::make_unique<HttpClient>(client_options),
+                                 quota);
+
+  for (const std::size_t batch : {16, 256, 1024}) {
+    std::vector<Coordinates> coords;
+    for (std::size_t i = 0; i < batch; ++i)
+      coords.push_back({48.0 + 1e-4 * static_cast<double>(i), 11.5, ""});
+    auto per_lookup = [batch](bench::Result r) {
+      r.ns_per_op /= static_cast<double>(batch);
+      r.allocs_per_op /= static_cast<double>(batch);
+      r.bytes_per_op /= static_cast<double>(batch);
+      return r;
+    };
+    // Dual-language lookups: two requests per coordinate
+    const bench::Result threads =
+        per_lookup(bench::run("threads/" + std::to_string(batch), 3, [&] {
+          bench::do_not_optimize(
+              geocoder.batch_reverse_geocode(coords, {"nominatim"}));
+        }));
+    const bench::Result awaited =
+        per_lookup(bench::run("coroutines/" + std::to_string(batch), 3, [&] {
+          bench::do_not_optimize(sync_wait(
+              geocoder.batch_reverse_geocode_async(coords, {"nominatim"})));
+        }));
+    for (const bench::Result &r : {threads, awaited}) {
+      bench::report(r);
+      std::printf("%-40s %10.0f lookups/s\n", "", 1e9 / r.ns_per_op);
+    }
+  }
+  std::filesystem::remove(quota);
+  return 0;
+}
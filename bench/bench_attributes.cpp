@@ -0,0 +1,128 @@
+/**
+ * SPDX-FileComment: Micro benchmark for AddressResult attribute storage.
+ * SPDX-FileType: SOURCE
+ * SPDX-FileContributor: ZHENG Robert
+ * SPDX-FileCopyrightText: 2026 ZHENG Robert
+ * SPDX-License-Identifier: MIT
+ *
+ * @file bench_attributes.cpp
+ * @brief Compares std::map with AttributeMap on real adapter attribute sets.
+ * @version 0.1.0
+ * @date 2026-10-19
+ *
+ * @author ZHENG Robert
+ * @license MIT License
+ */
+
+#include "bench_common.hpp"
+
+#include "regeocode/adapter_google.hpp"
+#include "regeocode/adapter_marea_tides.hpp"
+#include "regeocode/adapter_seaweather.hpp"
+#include "regeocode/attribute_map.hpp"
+
+#include <fstream>
+#include <map>
+#include <memory>
+#include <nlohmann/json.hpp>
+#include <sstream>
+#include <utility>
+#include <vector>
+
+int main(int argc, char **argv) {
+  using namespace regeocode;
+
+  const std::string fixture_dir = argc > 1 ? argv[1] : "tests/fixtures";
+  constexpr std::size_t kIterations = 20'000;
+
+  std::vector<std::pair<std::string, ApiAdapterPtr>> adapters;
+  adapters.emplace_back("google", std::make_unique<GoogleAdapter>());
+  adapters.emplace_back("marea_tides", std::make_unique<MareaTidesAdapter>());
+  adapters.emplace_back("seaweather", std::make_unique<SeaWeatherAdapter>());
+
+  for (const auto &[name, adapter] : adapters) {
+    std::ifstream f(fixture_dir + "/" + name + ".json");
+    if (!f.is_open()) {
+      std::cerr << "Missing fixture for " << name << std::endl;
+      return 1;
+    }
+    std::stringstream ss;
+    ss << f.rdbuf();
+    const std::string body = ss.str();
+
+    // The attribute set this adapter produces, replayed into both containers
+    std::vector<std::pair<std::string, std::string>> attrs;
+    for (const auto &[key, value] : adapter->parse_response(body).attributes)
+      attrs.emplace_back(key, value);
+    std::printf("%s: %zu attributes\n", name.c_str(), attrs.size());
+
+    // Fill alone, then fill + JSON conversion as in parse_response +
+    // reverse_geocode_json. Values are built as temporaries first, like
+    // adapters do.
+    bench::report(bench::run(name + "/std::map/fill", kIterations, [&] {
+      std::map<std::string, std::string> m;
+      for (const auto &[key, value] : attrs) {
+        std::string v(value);
+        m[key.c_str()] = std::move(v);
+      }
+      bench::do_not_optimize(m);
+    }));
+    bench::report(bench::run(name + "/AttributeMap/fill", kIterations, [&] {
+      AttributeMap m;
+      for (const auto &[key, value] : attrs) {
+        std::string v(value);
+        m[key] = v;
+      }
+      bench::do_not_optimize(m);
+    }));
+    bench::report(bench::run(name + "/std::map/fill+to_json", kIterations, [&] {
+      std::map<std::string, std::string> m;
+      for (const auto &[key, value] : attrs) {
+        std::string v(value);
+        m[key.c_str()] = std::move(v);
+      }
+      nlohmann::json j = m;
+      bench::do_not_optimize(j);
+    }));
+    bench::report(
+        bench::run(name + "/AttributeMap/fill+to_json", kIterations, [&] {
+          AttributeMap m;
+          for (const auto &[key, value] : attrs) {
+            std::string v(value);
+            m[key] = v;
+          }
+          nlohmann::json j = m;
+          bench::do_not_optimize(j);
+        }));
+
+    // Lookups with literal-style keys
+    std::map<std::string, std::string> map_attrs(attrs.begin(), attrs.end());
+    AttributeMap flat_attrs;
+    for (const auto &[key, value] : attrs)
+      flat_attrs[key] = value;
+
+    bench::report(bench::run(name + "/std::map/lookup_all", kIterations, [&] {
+      std::size_t hits = 0;
+      for (const auto &kv : attrs)
+        hits += map_attrs.count(kv.first.c_str());
+      bench::do_not_optimize(hits);
+    }));
+    bench::report(
+        bench::run(name + "/AttributeMap/lookup_all", kIterations, [&] {
+          std::size_t hits = 0;
+          for (const auto &kv : attrs)
+            hits += flat_attrs.count(kv.first.c_str());
+          bench::do_not_optimize(hits);
+        }));
+
+    // End to end with the current AddressResult
+    bench::report(
+        bench::run(name + "/parse_response+to_json", kIterations, [&] {
+          auto r = adapter->parse_response(body);
+          nlohmann::json j = r.attributes;
+          bench::do_not_optimize(j);
+        }));
+  }
+
+  return 0;
+}
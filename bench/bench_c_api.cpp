@@ -0,0 +1,169 @@
+/**
+ * SPDX-FileComment: Micro benchmark for C API lookups.
+ * SPDX-FileType: SOURCE
+ * SPDX-FileContributor: ZHENG Robert
+ * SPDX-FileCopyrightText: 2026 ZHENG Robert
+ * SPDX-License-Identifier: MIT
+ *
+ * @file bench_c_api.cpp
+ * @brief Lookups per second through the C API: the JSON-based
+ *        geocoder_lookup() (as callers use it, with parsing json_full) against
+ *        the typed geocoder_lookup_record(), and batches as separate records
+ *        against one result set, on a mocked HTTP client.
+ * @version 0.1.0
+ * @date 2026-10-19
+ *
+ * @author ZHENG Robert
+ * @license MIT License
+ */
+
+#include "bench_common.hpp"
+
+#include "regeocode/adapter_nominatim.hpp"
+#include "regeocode/adapter_openweather.hpp"
+#include "regeocode/re_geocode_c_api.h"
+#include "regeocode/re_geocode_core.hpp"
+
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+namespace {
+/**
+ * @brief Answers every request with a recorded response.
+ */
+class FixtureHttpClient : public regeocode::HttpClient {
+public:
+  explicit FixtureHttpClient(std::string body) : body_(std::move(body)) {}
+
+  regeocode::HttpResponse
+  get(const std::string & /*url*/, long /*timeout*/,
+      const regeocode::HttpRequestOptions & /*options*/) const override {
+    regeocode::HttpResponse response;
+    response.status_code = 200;
+    response.body = body_;
+    return response;
+  }
+
+private:
+  std::string body_;
+};
+
+std::string read_fixture(const std::string &name) {
+  std::ifstream f("tests/fixtures/" + name + ".json");
+  std::stringstream ss;
+  ss << f.rdbuf();
+  return ss.str();
+}
+
+geocoder_t *make_geocoder(const std::string &api, const std::string &type,
+                          regeocode::ApiAdapterPtr adapter,
+                          const std::string &quota_file) {
+  using namespace regeocode;
+  ApiConfig cfg;
+  cfg.name = api;
+  cfg.adapter = adapter->name();
+  cfg.type = type;
+  cfg.uri_template = "http://fixture/" + api + "?lat={{ latitude }}";
+  std::unordered_map<std::string, ApiConfig> configs{{api, cfg}};
+  std::vector<ApiAdapterPtr> adapters;
+  adapters.push_back(std::move(adapter));
+  return geocoder_wrap(std::make_unique<ReverseGeocoder>(
+      std::move(configs), std::move(adapters),
+      std::make_unique<FixtureHttpClient>(read_fixture(api)), quota_file));
+}
+
+void report_rate(const regeocode::bench::Result &r) {
+  std::printf("%-40s %10.0f lookups/s %8.1f allocs/op %10.1f B/op\n",
+              r.name.c_str(), 1e9 / r.ns_per_op, r.allocs_per_op,
+              r.bytes_per_op);
+}
+} // namespace
+
+int main() {
+  using namespace regeocode;
+  namespace bench = regeocode::bench;
+
+  const std::string quota =
+      (std::filesystem::temp_directory_path() / "bench_c_api_quota.json")
+          .string();
+  struct Case {
+    const char *api;
+    const char *type;
+    ApiAdapterPtr adapter;
+  };
+  Case cases[] = {
+      {"nominatim", "geocoding", std::make_unique<NominatimAdapter>()},
+      {"openweather", "info", std::make_unique<OpenWeatherAdapter>()}};
+
+  for (Case &c : cases) {
+    geocoder_t *geocoder =
+        make_geocoder(c.api, c.type, std::move(c.adapter), quota);
+    const std::string prefix = std::string(c.api) + "/";
+
+    // Before: a JSON document per lookup, dumped, copied and re-parsed
+    report_rate(bench::run(prefix + "lookup+parse_json", 5'000, [&] {
+      geocode_result_t r =
+          geocoder_lookup(geocoder, 48.137, 11.576, c.api, "de");
+      auto doc = nlohmann::json::parse(r.json_full);
+      bench::do_not_optimize(doc);
+      geocoder_result_free(&r);
+    }));
+    report_rate(bench::run(prefix + "lookup", 5'000, [&] {
+      geocode_result_t r =
+          geocoder_lookup(geocoder, 48.137, 11.576, c.api, "de");
+      bench::do_not_optimize(r);
+      geocoder_result_free(&r);
+    }));
+
+    // After: fields and attributes read straight from the record
+    report_rate(bench::run(prefix + "lookup_record", 5'000, [&] {
+      geocode_record_t r =
+          geocoder_lookup_record(geocoder, 48.137, 11.576, c.api, "de");
+      std::size_t n = 0;
+      for (std::size_t i = 0; i < r.attribute_count; ++i)
+        n += r.attributes[i].value[0] != '\0';
+      bench::do_not_optimize(n);
+      geocoder_record_free(&r);
+    }));
+    report_rate(bench::run(prefix + "lookup_record+json", 5'000, [&] {
+      geocode_record_t r =
+          geocoder_lookup_record(geocoder, 48.137, 11.576, c.api, "de");
+      bench::do_not_optimize(geocoder_record_json(&r));
+      geocoder_record_free(&r);
+    }));
+
+    // Batches: one block per record against one block per set
+    constexpr std::size_t kBatch = 64;
+    std::vector<double> lats(kBatch, 48.137), lons(kBatch, 11.576);
+    std::vector<geocode_record_t> records(kBatch);
+    auto per_lookup = [](bench::Result r) {
+      r.ns_per_op /= kBatch;
+      r.allocs_per_op /= kBatch;
+      r.bytes_per_op /= kBatch;
+      return r;
+    };
+    report_rate(per_lookup(bench::run(prefix + "lookup_batch", 100, [&] {
+      geocoder_lookup_batch(geocoder, lats.data(), lons.data(), kBatch, c.api,
+                            "de", records.data());
+      for (auto &r : records)
+        geocoder_record_free(&r);
+    })));
+    report_rate(per_lookup(bench::run(prefix + "lookup_set", 100, [&] {
+      geocode_result_set_t *set = geocoder_lookup_set(
+          geocoder, lats.data(), lons.data(), kBatch, c.api, "de");
+      bench::do_not_optimize(geocoder_result_set_records(set));
+      geocoder_result_set_free(set);
+    })));
+
+    geocoder_free(geocoder);
+  }
+  std::filesystem::remove(quota);
+  return 0;
+}
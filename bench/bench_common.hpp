@@ -0,0 +1,140 @@
+/**
+ * SPDX-FileComment: Shared helpers for the micro benchmarks.
+ * SPDX-FileType: SOURCE
+ * SPDX-FileContributor: ZHENG Robert
+ * SPDX-FileCopyrightText: 2026 ZHENG Robert
+ * SPDX-License-Identifier: MIT
+ *
+ * @file bench_common.hpp
+ * @brief Timing loop and heap allocation counter for the benchmarks.
+ * @version 0.1.0
+ * @date 2026-10-19
+ *
+ * Include this header from exactly one translation unit per benchmark
+ * executable: it replaces the global operator new/delete to count heap
+ * allocations.
+ *
+ * @author ZHENG Robert
+ * @license MIT License
+ */
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <string>
+#include <string_view>
+
+namespace regeocode::bench {
+
+inline std::atomic<std::size_t> g_allocations{0};
+inline std::atomic<std::size_t> g_allocated_bytes{0};
+
+/**
+ * @brief Result of a single benchmark case.
+ */
+struct Result {
+  std::string name;            ///< Case name.
+  std::size_t iterations{};    ///< Number of iterations run.
+  double ns_per_op{};          ///< Mean wall time per iteration.
+  double allocs_per_op{};      ///< Heap allocations per iteration.
+  double bytes_per_op{};       ///< Heap bytes requested per iteration.
+};
+
+/**
+ * @brief Prevents the compiler from optimising away a computed value.
+ */
+template <typename T> inline void do_not_optimize(const T &value) {
+  asm volatile("" : : "r,m"(value) : "memory");
+}
+
+/**
+ * @brief Runs @p fn @p iterations times and measures time and allocations.
+ */
+template <typename Fn>
+Result run(std::string_view name, std::size_t iterations, Fn &&fn) {
+  // Warm-up pass, so lazily initialised statics are not counted.
+  for (std::size_t i = 0; i < iterations / 10 + 1; ++i)
+    fn();
+
+  const std::size_t allocs_before = g_allocations.load();
+  const std::size_t bytes_before = g_allocated_bytes.load();
+  const auto start = std::chrono::steady_clock::now();
+  for (std::size_t i = 0; i < iterations; ++i)
+    fn();
+  const auto stop = std::chrono::steady_clock::now();
+
+  Result r;
+  r.name = std::string(name);
+  r.iterations = iterations;
+  r.ns_per_op =
+      std::chrono::duration<double, std::nano>(stop - start).count() /
+      static_cast<double>(iterations);
+  r.allocs_per_op =
+      static_cast<double>(g_allocations.load() - allocs_before) /
+      static_cast<double>(iterations);
+  r.bytes_per_op =
+      static_cast<double>(g_allocated_bytes.load() - bytes_before) /
+      static_cast<double>(iterations);
+  return r;
+}
+
+/**
+ * @brief Prints a result as one human-readable line.
+ */
+inline void report(const Result &r) {
+  char line[256];
+  std::snprintf(line, sizeof(line),
+                "%-40s %12.1f ns/op %10.2f allocs/op %12.1f B/op",
+                r.name.c_str(), r.ns_per_op, r.allocs_per_op, r.bytes_per_op);
+  std::cout << line << '\n';
+}
+
+} // namespace regeocode::bench
+
+// --- Global allocation counting ---
+
+// GCC pairs the inlined free() with the replaced operator new and warns,
+// although both sides are replaced together here.
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+
+void *operator new(std::size_t size) {
+  regeocode::bench::g_allocations.fetch_add(1, std::memory_order_relaxed);
+  regeocode::bench::g_allocated_bytes.fetch_add(size,
+                                                std::memory_order_relaxed);
+  if (void *p = std::malloc(size == 0 ? 1 : size))
+    return p;
+  throw std::bad_alloc();
+}
+
+void operator delete(void *p) noexcept { std::free(p); }
+void operator delete(void *p, std::size_t) noexcept { std::free(p); }
+
+// std::pmr::new_delete_resource() allocates through the aligned overloads
+void *operator new(std::size_t size, std::align_val_t align) {
+  regeocode::bench::g_allocations.fetch_add(1, std::memory_order_relaxed);
+  regeocode::bench::g_allocated_bytes.fetch_add(size,
+                                                std::memory_order_relaxed);
+  const auto alignment = static_cast<std::size_t>(align);
+  if (void *p = std::aligned_alloc(
+          alignment, (size + alignment - 1) / alignment * alignment))
+    return p;
+  throw std::bad_alloc();
+}
+
+void operator delete(void *p, std::align_val_t) noexcept { std::free(p); }
+void operator delete(void *p, std::size_t, std::align_val_t) noexcept {
+  std::free(p);
+}
+
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
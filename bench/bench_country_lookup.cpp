@@ -0,0 +1,153 @@
+/**
+ * SPDX-FileComment: Micro benchmark for the country code lookups.
+ * SPDX-FileType: SOURCE
+ * SPDX-FileContributor: ZHENG Robert
+ * SPDX-FileCopyrightText: 2026 ZHENG Robert
+ * SPDX-License-Identifier: MIT
+ *
+ * @file bench_country_lookup.cpp
+ * @brief Compares the hash-map country lookups with the direct-table index.
+ * @version 0.1.0
+ * @date 2026-10-19
+ *
+ * @author ZHENG Robert
+ * @license MIT License
+ */
+
+#include "bench_common.hpp"
+
+#include "regeocode/adapter_country.hpp"
+#include "regeocode/country_code_index.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <fstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+
+using namespace regeocode;
+
+// --- Previous implementations, kept here as the baseline ---
+
+class LegacyCountryIndex {
+public:
+  explicit LegacyCountryIndex(const std::string &json_path) {
+    std::ifstream f(json_path);
+    nlohmann::json data;
+    f >> data;
+    for (const auto &item : data) {
+      std::string code = item["cca2"].get<std::string>();
+      nlohmann::json entry;
+      entry["name.common"] = item["name"].value("common", "");
+      entry["name.official"] = item["name"].value("official", "");
+      entry["capital"] = item.contains("capital") && !item["capital"].empty()
+                             ? item["capital"][0]
+                             : nlohmann::json("");
+      entry["region"] = item.value("region", "");
+      entry["flag"] = item.value("flag", "");
+      entry["flag_url"] =
+          "https://github.com/lipis/flag-icons/blob/main/flags/4x3/" + code +
+          ".svg";
+      indexed_data_[code] = std::move(entry);
+    }
+  }
+
+  nlohmann::json get_country(std::string_view country_code) const {
+    std::string target_code{country_code};
+    std::ranges::transform(target_code, target_code.begin(),
+                           [](unsigned char c) {
+                             return static_cast<char>(std::toupper(c));
+                           });
+    if (auto it = indexed_data_.find(target_code); it != indexed_data_.end())
+      return it->second;
+    return nlohmann::json::object();
+  }
+
+private:
+  std::unordered_map<std::string, nlohmann::json> indexed_data_;
+};
+
+std::string legacy_language_from_country(const std::string &cc_raw) {
+  std::string cc = cc_raw;
+  for (auto &c : cc)
+    c = static_cast<char>(::tolower(c));
+
+  static const std::unordered_map<std::string, std::string> map = {
+      {"de", "de"}, {"at", "de"}, {"ch", "de"},    {"ae", "ar"},
+      {"sa", "ar"}, {"eg", "ar"}, {"cn", "zh-CN"}, {"tw", "zh-TW"},
+      {"jp", "ja"}, {"kr", "ko"}, {"fr", "fr"},    {"es", "es"},
+      {"it", "it"}, {"ru", "ru"}, {"pt", "pt"},    {"nl", "nl"}};
+
+  auto it = map.find(cc);
+  if (it != map.end())
+    return it->second;
+  return "en";
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  const std::string json_path = argc > 1 ? argv[1] : "data/countries.json";
+  constexpr std::size_t kIterations = 1'000'000;
+
+  // Mixed-case probe set with a few misses.
+  const std::vector<std::string> probes = {"de", "CN", "us", "Fr", "jp",
+                                           "br", "XX", "at", "za", "nz"};
+
+  try {
+    LegacyCountryIndex legacy(json_path);
+    CountryAdapter adapter(json_path);
+
+    std::size_t i = 0;
+    bench::report(bench::run("get_country/legacy_unordered_map", kIterations,
+                             [&] {
+                               auto j = legacy.get_country(
+                                   probes[i++ % probes.size()]);
+                               bench::do_not_optimize(j);
+                             }));
+
+    i = 0;
+    bench::report(bench::run("get_country/json_copy", kIterations, [&] {
+      auto j = adapter.get_country(probes[i++ % probes.size()]);
+      bench::do_not_optimize(j);
+    }));
+
+    i = 0;
+    bench::report(bench::run("find/alpha2_table", kIterations, [&] {
+      const auto *r = adapter.find(probes[i++ % probes.size()]);
+      bench::do_not_optimize(r);
+    }));
+
+    const std::vector<std::string> probes3 = {"DEU", "chn", "USA", "FRA",
+                                              "276", "156", "840", "XXX"};
+    i = 0;
+    bench::report(bench::run("country_index/alpha3_numeric", kIterations, [&] {
+      auto o = country_index::find(probes3[i++ % probes3.size()]);
+      bench::do_not_optimize(o);
+    }));
+
+    i = 0;
+    bench::report(bench::run("language_from_country/legacy", kIterations, [&] {
+      auto lang = legacy_language_from_country(probes[i++ % probes.size()]);
+      bench::do_not_optimize(lang);
+    }));
+
+    i = 0;
+    // The same steps as language_from_country() in the core
+    bench::report(bench::run("language_from_country/alpha2_table",
+                             kIterations, [&] {
+                               auto lang = std::string(
+                                   country_index::local_language(
+                                       probes[i++ % probes.size()]));
+                               bench::do_not_optimize(lang);
+                             }));
+  } catch (const std::exception &e) {
+    std::cerr << "Benchmark failed: " << e.what() << std::endl;
+    return 1;
+  }
+
+  return 0;
+}
@@ -0,0 +1,246 @@
+/**
+ * SPDX-FileComment: End-to-end load benchmark against the mock providers.
+ * SPDX-FileType: SOURCE
+ * SPDX-FileContributor: ZHENG Robert
+ * SPDX-FileCopyrightText: 2026 ZHENG Robert
+ * SPDX-License-Identifier: MIT
+ *
+ * @file bench_e2e.cpp
+ * @brief Throughput and latency percentiles of ReverseGeocoder over real
+ *        HTTP against MockProviders, under latency, errors and 429s.
+ * @version 0.1.0
+ * @date 2026-10-19
+ *
+ * @author ZHENG Robert
+ * @license MIT License
+ */
+
+#include "mock_providers.hpp"
+
+#include "regeocode/adapter_bing.hpp"
+#include "regeocode/adapter_country_info.hpp"
+#include "regeocode/adapter_geonames_timezone.hpp"
+#include "regeocode/adapter_geonames_wikipedia.hpp"
+#include "regeocode/adapter_google.hpp"
+#include "regeocode/adapter_marea_tides.hpp"
+#include "regeocode/adapter_nominatim.hpp"
+#include "regeocode/adapter_opencage.hpp"
+#include "regeocode/adapter_openweather.hpp"
+#include "regeocode/adapter_pollution.hpp"
+#include "regeocode/adapter_seaweather.hpp"
+#include "regeocode/adapter_tides.hpp"
+#include "regeocode/re_geocode_core.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+namespace {
+using namespace regeocode;
+
+/// Value of @p key in @p section of INI text, or empty.
+std::string ini_value(std::string_view ini, std::string_view section,
+                      std::string_view key) {
+  const std::string header = "[" + std::string(section) + "]";
+  auto at = ini.find(header);
+  if (at == std::string_view::npos)
+    return {};
+  std::string_view rest = ini.substr(at + header.size());
+  while (!rest.empty()) {
+    const auto nl = rest.find('\n');
+    std::string_view line = rest.substr(0, nl);
+    rest = nl == std::string_view::npos ? std::string_view{}
+                                        : rest.substr(nl + 1);
+    if (line.starts_with('['))
+      break;
+    const auto eq = line.find('=');
+    if (eq == std::string_view::npos)
+      continue;
+    std::string_view name = line.substr(0, eq);
+    name = name.substr(0, name.find_last_not_of(' ') + 1);
+    if (name != key)
+      continue;
+    std::string_view value = line.substr(eq + 1);
+    value.remove_prefix(std::min(value.find_first_not_of(' '), value.size()));
+    return std::string(value);
+  }
+  return {};
+}
+
+/// The providers of the example config, pointed at the mock.
+std::unordered_map<std::string, ApiConfig>
+mock_apis(const std::string &ini, const RetryPolicy &retry) {
+  std::unordered_map<std::string, ApiConfig> apis;
+  for (const bench::MockRoute &route : bench::kMockRoutes) {
+    ApiConfig cfg;
+    cfg.name = route.section;
+    cfg.uri_template = ini_value(ini, route.section, "URI");
+    cfg.api_key = ini_value(ini, route.section, "API-Key");
+    cfg.adapter = ini_value(ini, route.section, "Adapter");
+    cfg.type = ini_value(ini, route.section, "type");
+    cfg.retry = retry;
+    apis.emplace(cfg.name, std::move(cfg));
+  }
+  return apis;
+}
+
+std::vector<ApiAdapterPtr> all_adapters() {
+  std::vector<ApiAdapterPtr> adapters;
+  adapters.push_back(std::make_unique<NominatimAdapter>());
+  adapters.push_back(std::make_unique<GoogleAdapter>());
+  adapters.push_back(std::make_unique<OpenCageAdapter>());
+  adapters.push_back(std::make_unique<BingAdapter>());
+  adapters.push_back(std::make_unique<CountryInfoAdapter>());
+  adapters.push_back(std::make_unique<GeoNamesTimezoneAdapter>());
+  adapters.push_back(std::make_unique<GeoNamesWikipediaAdapter>());
+  adapters.push_back(std::make_unique<OpenWeatherAdapter>());
+  adapters.push_back(std::make_unique<PollutionAdapter>());
+  adapters.push_back(std::make_unique<MareaTidesAdapter>());
+  adapters.push_back(std::make_unique<TidesAdapter>());
+  adapters.push_back(std::make_unique<SeaWeatherAdapter>());
+  return adapters;
+}
+
+double percentile(std::vector<double> &sorted, double p) {
+  const auto i = static_cast<std::size_t>(p * (sorted.size() - 1));
+  return sorted[i];
+}
+
+struct Scenario {
+  const char *name;
+  bench::MockOptions mock;
+  int attempts;
+  /// Empty: every request goes to the next provider of the example config
+  /// in turn. Otherwise a fallback chain.
+  std::vector<std::string> chain;
+};
+} // namespace
+
+int main(int argc, char **argv) {
+  using namespace std::chrono_literals;
+  const std::string fixture_dir = argc > 1 ? argv[1] : "tests/fixtures";
+  const std::string ini_path =
+      argc > 2 ? argv[2] : "data/re-geocode.ini_example";
+  constexpr std::size_t kThreads = 16;
+  constexpr std::size_t kPerThread = 128;
+
+  std::ifstream f(ini_path);
+  if (!f.is_open()) {
+    std::cerr << "Missing " << ini_path << std::endl;
+    return 1;
+  }
+  std::stringstream ss;
+  ss << f.rdbuf();
+  const std::string example = ss.str();
+
+  std::vector<Coordinates> points;
+  for (std::size_t i = 0; i < 256; ++i)
+    points.push_back({47.0 + 0.01 * static_cast<double>(i % 16),
+                      11.0 + 0.01 * static_cast<double>(i / 16), "de"});
+
+  auto mock = [](auto configure) {
+    bench::MockOptions o;
+    o.retry_after = "0";
+    configure(o);
+    return o;
+  };
+  const std::vector<std::string> chain = {"nominatim", "google", "opencage"};
+  const Scenario scenarios[] = {
+      {"all-providers/2ms", mock([](auto &o) { o.latency = 2ms; }), 1, {}},
+      {"lognormal/2ms", mock([](auto &o) {
+         o.distribution = bench::MockOptions::Latency::LogNormal;
+         o.latency = 2ms;
+         o.sigma = 0.8;
+       }),
+       1, chain},
+      {"errors-5%/no-retry", mock([](auto &o) {
+         o.latency = 2ms;
+         o.error_rate = 0.05;
+       }),
+       1, chain},
+      {"errors-5%/retry", mock([](auto &o) {
+         o.latency = 2ms;
+         o.error_rate = 0.05;
+       }),
+       3, chain},
+      {"rate-limit-1000rps", mock([](auto &o) {
+         o.latency = 2ms;
+         o.max_rps = 1000;
+       }),
+       2, chain},
+  };
+
+  std::printf("%-20s %8s %8s %8s %8s %6s %6s %6s %6s\n", "scenario", "req/s",
+              "p50 ms", "p95 ms", "p99 ms", "429", "5xx", "retry", "failed");
+  for (const Scenario &s : scenarios) {
+    bench::MockProviders providers(fixture_dir, s.mock);
+    const bench::StandInServer server(
+        [&providers](std::string_view target) { return providers(target); });
+    RetryPolicy retry;
+    retry.max_attempts = s.attempts;
+    retry.base_delay = 2ms;
+    retry.max_delay = 20ms;
+    HttpClientOptions client_options;
+    client_options.multiplex = true;
+    const ReverseGeocoder geocoder(
+        mock_apis(bench::mock_config(example, server.base_url()), retry),
+        all_adapters(), std::make_unique<HttpClient>(client_options),
+        (std::filesystem::temp_directory_path() / "bench_e2e_quota.json")
+            .string());
+
+    std::vector<std::vector<double>> latencies(kThreads);
+    std::atomic<std::size_t> failed{0};
+    const auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> threads;
+    for (std::size_t t = 0; t < kThreads; ++t)
+      threads.emplace_back([&, t] {
+        for (std::size_t i = 0; i < kPerThread; ++i) {
+          const std::size_t n = t * kPerThread + i;
+          const Coordinates &where = points[n % points.size()];
+          const auto begin = std::chrono::steady_clock::now();
+          const auto json =
+              s.chain.empty()
+                  ? geocoder.reverse_geocode_json(
+                        where,
+                        bench::kMockRoutes[n % bench::kMockRoutes.size()]
+                            .section)
+                  : geocoder.reverse_geocode_fallback(where, s.chain);
+          latencies[t].push_back(std::chrono::duration<double, std::milli>(
+                                     std::chrono::steady_clock::now() - begin)
+                                     .count());
+          if (json.contains("error"))
+            ++failed;
+        }
+      });
+    for (auto &t : threads)
+      t.join();
+    const double seconds = std::chrono::duration<double>(
+                               std::chrono::steady_clock::now() - start)
+                               .count();
+
+    std::vector<double> all;
+    for (const auto &l : latencies)
+      all.insert(all.end(), l.begin(), l.end());
+    std::sort(all.begin(), all.end());
+    std::size_t throttled = 0, errors = 0, retries = 0;
+    for (const bench::MockRoute &route : bench::kMockRoutes) {
+      const auto c = providers.count(route.section);
+      throttled += c.throttled;
+      errors += c.errors;
+      retries += geocoder.transfer_stats(route.section).retries;
+    }
+    std::printf("%-20s %8.0f %8.2f %8.2f %8.2f %6zu %6zu %6zu %6zu\n", s.name,
+                static_cast<double>(all.size()) / seconds,
+                percentile(all, 0.50), percentile(all, 0.95),
+                percentile(all, 0.99), throttled, errors, retries,
+                failed.load());
+  }
+  std::filesystem::remove(std::filesystem::temp_directory_path() /
+                          "bench_e2e_quota.json");
+  return 0;
+}
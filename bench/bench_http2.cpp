@@ -0,0 +1,159 @@
+/**
+ * SPDX-FileComment: Benchmark for HTTP/2 multiplexing against HTTP/1.1.
+ * SPDX-FileType: SOURCE
+ * SPDX-FileContributor: ZHENG Robert
+ * SPDX-FileCopyrightText: 2026 ZHENG Robert
+ * SPDX-License-Identifier: MIT
+ *
+ * @file bench_http2.cpp
+ * @brief Concurrent requests per transfer engine and protocol version, and
+ *        many clients with and without a shared engine.
+ * @version 0.1.0
+ * @date 2026-10-19
+ *
+ * @author ZHENG Robert
+ * @license MIT License
+ */
+
+#include "bench_common.hpp"
+#include "stand_in_server.hpp"
+
+#include "regeocode/http_client.hpp"
+
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+namespace {
+struct Mode {
+  const char *name;
+  bool multiplex;
+  regeocode::HttpVersion version;
+};
+} // namespace
+
+int main(int argc, char **argv) {
+  using namespace regeocode;
+  using namespace std::chrono_literals;
+
+  const std::string fixture_dir = argc > 1 ? argv[1] : "tests/fixtures";
+  // Every thread issues this many requests back to back
+  constexpr std::size_t kPerStream = 8;
+  // Simulated provider processing time
+  constexpr auto kLatency = 5ms;
+
+  std::ifstream f(fixture_dir + "/nominatim.json");
+  if (!f.is_open()) {
+    std::cerr << "Missing fixture for nominatim" << std::endl;
+    return 1;
+  }
+  std::stringstream ss;
+  ss << f.rdbuf();
+  const std::string body = ss.str();
+
+  const Mode modes[] = {
+      {"per-request/http1.1", false, HttpVersion::Http1_1},
+      {"pooled/http1.1", true, HttpVersion::Http1_1},
+      {"multiplexed/h2c", true, HttpVersion::Http2PriorKnowledge},
+  };
+
+  for (const std::size_t streams : {1, 16, 256}) {
+    for (const Mode &mode : modes) {
+      // Fresh server and client per case, so connection counts add up
+      const bench::StandInServer server(body, kLatency);
+      HttpClientOptions client_options;
+      client_options.multiplex = mode.multiplex;
+      client_options.max_concurrent_streams = 1000;
+      const HttpClient client(client_options);
+      const std::string url = server.url();
+      HttpRequestOptions options;
+      options.accept_encoding = "identity";
+      options.http_version = mode.version;
+
+      std::atomic<std::size_t> failures{0};
+      auto worker = [&] {
+        for (std::size_t i = 0; i < kPerStream; ++i) {
+          const auto resp = client.get(url, 30, options);
+          if (resp.status_code != 200 || resp.body.size() != body.size())
+            ++failures;
+        }
+      };
+
+      const std::size_t allocs_before = bench::g_allocations.load();
+      const std::size_t bytes_before = bench::g_allocated_bytes.load();
+      const auto start = std::chrono::steady_clock::now();
+      std::vector<std::thread> threads;
+      threads.reserve(streams);
+      for (std::size_t t = 0; t < streams; ++t)
+        threads.emplace_back(worker);
+      for (auto &t : threads)
+        t.join();
+      const auto stop = std::chrono::steady_clock::now();
+
+      bench::Result r;
+      r.name = std::string(mode.name) + "/" + std::to_string(streams);
+      r.iterations = streams * kPerStream;
+      r.ns_per_op = std::chrono::duration<double, std::nano>(stop - start)
+                        .count() /
+                    static_cast<double>(r.iterations);
+      r.allocs_per_op =
+          static_cast<double>(bench::g_allocations.load() - allocs_before) /
+          static_cast<double>(r.iterations);
+      r.bytes_per_op =
+          static_cast<double>(bench::g_allocated_bytes.load() - bytes_before) /
+          static_cast<double>(r.iterations);
+      bench::report(r);
+      std::printf("%-40s %10.0f req/s %6zu connections %4zu failed\n", "",
+                  1e9 / r.ns_per_op, server.connections(), failures.load());
+    }
+  }
+
+  // Many clients (one per geocoder handle), each used by one thread
+  constexpr std::size_t kClients = 64;
+  for (const bool shared : {false, true}) {
+    const bench::StandInServer server(body, kLatency);
+    HttpClientOptions client_options;
+    client_options.multiplex = true;
+    client_options.max_concurrent_streams = 1000;
+    if (shared)
+      client_options.share = std::make_shared<HttpShare>(
+          HttpShareOptions{.max_concurrent_streams = 1000});
+    std::vector<std::unique_ptr<HttpClient>> clients;
+    for (std::size_t c = 0; c < kClients; ++c)
+      clients.push_back(std::make_unique<HttpClient>(client_options));
+    const std::string url = server.url();
+    HttpRequestOptions options;
+    options.accept_encoding = "identity";
+    options.http_version = HttpVersion::Http2PriorKnowledge;
+
+    std::atomic<std::size_t> failures{0};
+    const auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> threads;
+    for (const auto &client : clients)
+      threads.emplace_back([&, c = client.get()] {
+        for (std::size_t i = 0; i < kPerStream; ++i) {
+          const auto resp = c->get(url, 30, options);
+          if (resp.status_code != 200 || resp.body.size() != body.size())
+            ++failures;
+        }
+      });
+    for (auto &t : threads)
+      t.join();
+    const auto stop = std::chrono::steady_clock::now();
+
+    bench::Result r;
+    r.name = std::string(shared ? "shared" : "per-client") + "/h2c/" +
+             std::to_string(kClients) + "-clients";
+    r.iterations = kClients * kPerStream;
+    r.ns_per_op =
+        std::chrono::duration<double, std::nano>(stop - start).count() /
+        static_cast<double>(r.iterations);
+    bench::report(r);
+    std::printf("%-40s %10.0f req/s %6zu connections %4zu failed\n", "",
+                1e9 / r.ns_per_op, server.connections(), failures.load());
+  }
+
+  return 0;
+}
@@ -0,0 +1,237 @@
+/**
+ * SPDX-FileComment: Micro benchmark for HTTP response body buffering.
+ * SPDX-FileType: SOURCE
+ * SPDX-FileContributor: ZHENG Robert
+ * SPDX-FileCopyrightText: 2026 ZHENG Robert
+ * SPDX-License-Identifier: MIT
+ *
+ * @file bench_http_body.cpp
+ * @brief Receive throughput of HttpClient::get() for large tide responses,
+ *        plain and gzip-encoded.
+ * @version 0.1.0
+ * @date 2026-10-19
+ *
+ * @author ZHENG Robert
+ * @license MIT License
+ */
+
+#include "bench_common.hpp"
+
+#include "regeocode/http_client.hpp"
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <zlib.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <thread>
+
+namespace {
+/// gzip-compresses @p data in one shot.
+std::string gzip(const std::string &data) {
+  z_stream zs{};
+  deflateInit2(&zs, Z_DEFAULT_COMPRESSION, Z_DEFLATED, 15 + 16, 8,
+               Z_DEFAULT_STRATEGY);
+  std::string out(deflateBound(&zs, data.size()) + 32, '\0');
+  zs.next_in = reinterpret_cast<Bytef *>(const_cast<char *>(data.data()));
+  zs.avail_in = static_cast<uInt>(data.size());
+  zs.next_out = reinterpret_cast<Bytef *>(out.data());
+  zs.avail_out = static_cast<uInt>(out.size());
+  deflate(&zs, Z_FINISH);
+  out.resize(zs.total_out);
+  deflateEnd(&zs);
+  return out;
+}
+
+/**
+ * @brief How the loopback server sends its body.
+ */
+struct ServeOptions {
+  bool chunked = false;              ///< Chunked instead of Content-Length.
+  bool gzip = false;                 ///< Honour Accept-Encoding: gzip.
+  std::size_t bytes_per_second = 0;  ///< Simulated link rate (0 = unlimited).
+};
+
+/**
+ * @brief Loopback HTTP/1.1 server that answers every request with one body.
+ *
+ * The body is sent either with Content-Length or chunked, so both receive
+ * paths of the client are measured, optionally gzip-encoded and paced to a
+ * slow link.
+ */
+class LoopbackServer {
+public:
+  LoopbackServer(std::string body, ServeOptions options)
+      : body_(std::move(body)), options_(options) {
+    if (options_.gzip)
+      gzipped_ = gzip(body_);
+    fd_ = ::socket(AF_INET, SOCK_STREAM, 0);
+    int one = 1;
+    ::setsockopt(fd_, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    ::bind(fd_, reinterpret_cast<sockaddr *>(&addr), sizeof(addr));
+    ::listen(fd_, 64);
+    socklen_t len = sizeof(addr);
+    ::getsockname(fd_, reinterpret_cast<sockaddr *>(&addr), &len);
+    port_ = ntohs(addr.sin_port);
+    thread_ = std::thread([this] { serve(); });
+  }
+
+  ~LoopbackServer() {
+    stop_ = true;
+    ::shutdown(fd_, SHUT_RDWR); // unblocks accept()
+    thread_.join();
+    ::close(fd_);
+  }
+
+  std::string url() const {
+    return "http://127.0.0.1:" + std::to_string(port_) + "/tides";
+  }
+
+private:
+  void serve() {
+    while (!stop_) {
+      const int client = ::accept(fd_, nullptr, nullptr);
+      if (client < 0)
+        continue;
+      char buf[4096];
+      std::string request;
+      while (request.find("\r\n\r\n") == std::string::npos) {
+        const ssize_t n = ::read(client, buf, sizeof(buf));
+        if (n <= 0)
+          break;
+        request.append(buf, static_cast<std::size_t>(n));
+      }
+      const bool encode =
+          options_.gzip && request.find("gzip") != std::string::npos;
+      respond(client, encode ? gzipped_ : body_, encode);
+      ::close(client);
+    }
+  }
+
+  void respond(int client, const std::string &body, bool encoded) const {
+    std::string head = "HTTP/1.1 200 OK\r\nContent-Type: application/json\r\n"
+                       "Connection: close\r\n";
+    if (encoded)
+      head += "Content-Encoding: gzip\r\n";
+    constexpr std::size_t kChunk = 16 * 1024;
+    if (!options_.chunked) {
+      head += "Content-Length: " + std::to_string(body.size()) + "\r\n\r\n";
+      write_all(client, head);
+      for (std::size_t pos = 0; pos < body.size(); pos += kChunk)
+        write_all(client, std::string_view(body).substr(pos, kChunk));
+      return;
+    }
+    head += "Transfer-Encoding: chunked\r\n\r\n";
+    write_all(client, head);
+    for (std::size_t pos = 0; pos < body.size(); pos += kChunk) {
+      const std::string_view part = std::string_view(body).substr(pos, kChunk);
+      char size_line[32];
+      std::snprintf(size_line, sizeof(size_line), "%zx\r\n", part.size());
+      write_all(client, size_line);
+      write_all(client, part);
+      write_all(client, "\r\n");
+    }
+    write_all(client, "0\r\n\r\n");
+  }
+
+  void write_all(int fd, std::string_view data) const {
+    if (options_.bytes_per_second != 0)
+      std::this_thread::sleep_for(std::chrono::microseconds(
+          data.size() * 1'000'000 / options_.bytes_per_second));
+    while (!data.empty()) {
+      const ssize_t n = ::write(fd, data.data(), data.size());
+      if (n <= 0)
+        return;
+      data.remove_prefix(static_cast<std::size_t>(n));
+    }
+  }
+
+  std::string body_;
+  std::string gzipped_;
+  ServeOptions options_;
+  int fd_ = -1;
+  unsigned short port_ = 0;
+  std::atomic<bool> stop_{false};
+  std::thread thread_;
+};
+} // namespace
+
+int main(int argc, char **argv) {
+  using namespace regeocode;
+
+  const std::string fixture_dir = argc > 1 ? argv[1] : "tests/fixtures";
+  constexpr std::size_t kIterations = 500;
+
+  std::ifstream f(fixture_dir + "/tides.json");
+  if (!f.is_open()) {
+    std::cerr << "Missing fixture for tides" << std::endl;
+    return 1;
+  }
+  std::stringstream ss;
+  ss << f.rdbuf();
+  const std::string tides = ss.str();
+
+  // A multi-day tide series: the recorded day repeated to about 620 KB
+  std::string week;
+  while (week.size() < 600 * 1024)
+    week += tides;
+
+  const HttpClient client;
+  HttpRequestOptions identity;
+  identity.accept_encoding = "identity";
+  for (const auto &[name, body] :
+       {std::pair<std::string, const std::string &>{"tides", tides},
+        std::pair<std::string, const std::string &>{"tides_x4", week}}) {
+    for (const bool chunked : {false, true}) {
+      const LoopbackServer server(body, {.chunked = chunked});
+      const std::string url = server.url();
+      const std::string label =
+          name + (chunked ? "/chunked" : "/content-length");
+
+      const auto r = bench::run(label, kIterations, [&] {
+        auto resp = client.get(url, 10, identity);
+        if (resp.body.size() != body.size())
+          std::abort();
+        bench::do_not_optimize(resp);
+      });
+      bench::report(r);
+      std::printf("%-40s %12.1f MB/s\n", "", body.size() / r.ns_per_op * 1e3);
+    }
+
+    // Content-encoding negotiation, on loopback and on a 2 MB/s link
+    for (const std::size_t rate : {std::size_t{0}, std::size_t{2'000'000}}) {
+      const LoopbackServer server(
+          body, {.chunked = true, .gzip = true, .bytes_per_second = rate});
+      const std::string url = server.url();
+      for (const std::string_view encoding : {"identity", "gzip"}) {
+        HttpRequestOptions options;
+        options.accept_encoding = encoding;
+        std::size_t wire = 0;
+        const auto r = bench::run(
+            name + (rate ? "/2MBps/" : "/loopback/") + std::string(encoding),
+            rate ? 10 : kIterations, [&] {
+              auto resp = client.get(url, 10, options);
+              if (resp.body.size() != body.size())
+                std::abort();
+              wire = resp.wire_bytes;
+              bench::do_not_optimize(resp);
+            });
+        bench::report(r);
+        std::printf("%-40s %12zu wire B %10zu decoded B\n", "", wire,
+                    body.size());
+      }
+    }
+  }
+
+  return 0;
+}
@@ -0,0 +1,179 @@
+/**
+ * SPDX-FileComment: Offline benchmark of the whole ReverseGeocoder stack.
+ * SPDX-FileType: SOURCE
+ * SPDX-FileContributor: ZHENG Robert
+ * SPDX-FileCopyrightText: 2026 ZHENG Robert
+ * SPDX-License-Identifier: MIT
+ *
+ * @file bench_replay.cpp
+ * @brief Throughput and latency percentiles of ReverseGeocoder over
+ *        ReplayHttpClient, with injected provider latency and errors.
+ * @version 0.1.0
+ * @date 2026-10-19
+ *
+ * @author ZHENG Robert
+ * @license MIT License
+ */
+
+#include "bench_common.hpp"
+
+#include "regeocode/adapter_google.hpp"
+#include "regeocode/adapter_nominatim.hpp"
+#include "regeocode/re_geocode_core.hpp"
+#include "regeocode/replay_http_client.hpp"
+#include "regeocode/uri_template.hpp"
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+namespace {
+using namespace regeocode;
+
+constexpr const char *kNominatimUri =
+    "http://replay/nominatim?lat={{ latitude }}&lon={{ longitude }}";
+constexpr const char *kGoogleUri =
+    "http://replay/google?latlng={{ latitude }},{{ longitude }}&key={{ "
+    "apikey }}";
+
+std::unique_ptr<ReverseGeocoder> make_geocoder(const std::string &replay,
+                                               const ReplayOptions &options,
+                                               const RetryPolicy &retry) {
+  std::unordered_map<std::string, ApiConfig> configs;
+  for (const auto &[name, uri] :
+       {std::pair{"nominatim", kNominatimUri}, std::pair{"google", kGoogleUri}}) {
+    ApiConfig cfg;
+    cfg.name = name;
+    cfg.adapter = name;
+    cfg.api_key = "KEY";
+    cfg.uri_template = uri;
+    cfg.retry = retry;
+    configs.emplace(name, cfg);
+  }
+  std::vector<ApiAdapterPtr> adapters;
+  adapters.push_back(std::make_unique<NominatimAdapter>());
+  adapters.push_back(std::make_unique<GoogleAdapter>());
+  return std::make_unique<ReverseGeocoder>(
+      std::move(configs), std::move(adapters),
+      std::make_unique<ReplayHttpClient>(replay, options),
+      (std::filesystem::temp_directory_path() / "bench_quota.json").string());
+}
+
+double percentile(std::vector<double> &sorted, double p) {
+  const auto i = static_cast<std::size_t>(p * (sorted.size() - 1));
+  return sorted[i];
+}
+} // namespace
+
+int main(int argc, char **argv) {
+  const std::string fixture_dir = argc > 1 ? argv[1] : "tests/fixtures";
+  constexpr std::size_t kPoints = 256;
+
+  std::vector<Coordinates> points;
+  for (std::size_t i = 0; i < kPoints; ++i)
+    points.push_back({47.0 + 0.01 * static_cast<double>(i % 16),
+                      11.0 + 0.01 * static_cast<double>(i / 16), ""});
+
+  // One recording per point and provider, as a recorder would capture them
+  std::vector<Recording> recordings;
+  for (const auto &[name, uri] :
+       {std::pair{"nominatim", kNominatimUri}, std::pair{"google", kGoogleUri}}) {
+    std::ifstream f(fixture_dir + "/" + name + ".json");
+    if (!f.is_open()) {
+      std::cerr << "Missing fixture for " << name << std::endl;
+      return 1;
+    }
+    std::stringstream ss;
+    ss << f.rdbuf();
+    const UriTemplate tpl(uri);
+    for (const auto &p : points) {
+      Recording r;
+      r.key = replay_key(tpl.render({p.latitude, p.longitude, "KEY", "en", ""}));
+      r.status_code = 200;
+      r.body = ss.str();
+      recordings.push_back(std::move(r));
+    }
+  }
+  const std::string replay =
+      (std::filesystem::temp_directory_path() / "bench_replay.replay").string();
+  write_replay_file(replay, recordings);
+  std::printf("%zu recordings, %ju bytes\n", recordings.size(),
+              static_cast<std::uintmax_t>(std::filesystem::file_size(replay)));
+
+  // Stack overhead without network: single thread, no latency
+  {
+    const auto geocoder = make_geocoder(replay, {}, {});
+    for (const char *api : {"nominatim", "google"}) {
+      std::size_t i = 0;
+      const auto r = bench::run(std::string("stack/") + api, 5000, [&] {
+        auto json = geocoder->reverse_geocode_json(points[i++ % kPoints], api);
+        bench::do_not_optimize(json);
+      });
+      bench::report(r);
+    }
+  }
+
+  // Latency distribution of a fallback chain under provider faults:
+  // 2-6 ms per response, 10 % 503s on every request
+  struct Case {
+    const char *name;
+    int attempts;
+  };
+  for (const Case c : {Case{"faults/no-retry", 1}, Case{"faults/retry", 3}}) {
+    ReplayOptions options;
+    options.latency = std::chrono::milliseconds(2);
+    options.latency_jitter = std::chrono::milliseconds(4);
+    options.error_rate = 0.1;
+    RetryPolicy retry;
+    retry.max_attempts = c.attempts;
+    retry.base_delay = std::chrono::milliseconds(2);
+    retry.max_delay = std::chrono::milliseconds(20);
+    const auto geocoder = make_geocoder(replay, options, retry);
+
+    constexpr std::size_t kThreads = 16;
+    constexpr std::size_t kPerThread = 64;
+    std::vector<std::vector<double>> latencies(kThreads);
+    std::atomic<std::size_t> failed{0};
+    const auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> threads;
+    for (std::size_t t = 0; t < kThreads; ++t)
+      threads.emplace_back([&, t] {
+        for (std::size_t i = 0; i < kPerThread; ++i) {
+          const auto begin = std::chrono::steady_clock::now();
+          const auto json = geocoder->reverse_geocode_fallback(
+              points[(t * kPerThread + i) % kPoints], {"nominatim", "google"});
+          latencies[t].push_back(
+              std::chrono::duration<double, std::milli>(
+                  std::chrono::steady_clock::now() - begin)
+                  .count());
+          if (json.contains("error"))
+            ++failed;
+        }
+      });
+    for (auto &t : threads)
+      t.join();
+    const double seconds = std::chrono::duration<double>(
+                               std::chrono::steady_clock::now() - start)
+                               .count();
+
+    std::vector<double> all;
+    for (const auto &l : latencies)
+      all.insert(all.end(), l.begin(), l.end());
+    std::sort(all.begin(), all.end());
+    const auto nominatim = geocoder->transfer_stats("nominatim");
+    const auto google = geocoder->transfer_stats("google");
+    std::printf("%-24s %8.0f req/s  p50 %6.2f ms  p95 %6.2f ms  p99 %6.2f ms"
+                "  retries %4ju  google %4ju  failed %zu\n",
+                c.name, static_cast<double>(all.size()) / seconds,
+                percentile(all, 0.50), percentile(all, 0.95),
+                percentile(all, 0.99),
+                static_cast<std::uintmax_t>(nominatim.retries),
+                static_cast<std::uintmax_t>(google.requests), failed.load());
+  }
+
+  std::filesystem::remove(replay);
+  return 0;
+}
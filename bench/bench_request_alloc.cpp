@@ -0,0 +1,131 @@
+/**
+ * SPDX-FileComment: Micro benchmark for per-request allocations.
+ * SPDX-FileType: SOURCE
+ * SPDX-FileContributor: ZHENG Robert
+ * SPDX-FileCopyrightText: 2026 ZHENG Robert
+ * SPDX-License-Identifier: MIT
+ *
+ * @file bench_request_alloc.cpp
+ * @brief Measures what a reverse_geocode() call allocates around the body.
+ * @version 0.1.0
+ * @date 2026-10-19
+ *
+ * @author ZHENG Robert
+ * @license MIT License
+ */
+
+#include "bench_common.hpp"
+
+#include "regeocode/adapter_google.hpp"
+#include "regeocode/adapter_nominatim.hpp"
+#include "regeocode/re_geocode_core.hpp"
+
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <vector>
+
+namespace {
+/**
+ * @brief Answers every request with a recorded response.
+ */
+class FixtureHttpClient : public regeocode::HttpClient {
+public:
+  explicit FixtureHttpClient(std::string body) : body_(std::move(body)) {}
+
+  regeocode::HttpResponse
+  get(const std::string &url, long timeout,
+      const regeocode::HttpRequestOptions &options) const override {
+    (void)url;
+    (void)timeout;
+    (void)options;
+    // A fresh body per request, like curl produces
+    regeocode::HttpResponse response;
+    response.status_code = 200;
+    response.body = body_;
+    return response;
+  }
+
+private:
+  std::string body_;
+};
+
+regeocode::ReverseGeocoder make_geocoder(const std::string &api,
+                                         const std::string &body,
+                                         bool keep_raw_json) {
+  using namespace regeocode;
+
+  ApiConfig cfg;
+  cfg.name = api;
+  cfg.adapter = api;
+  cfg.uri_template = "http://fixture/{{ latitude }},{{ longitude }}";
+  cfg.keep_raw_json = keep_raw_json;
+
+  std::vector<ApiAdapterPtr> adapters;
+  adapters.push_back(std::make_unique<NominatimAdapter>());
+  adapters.push_back(std::make_unique<GoogleAdapter>());
+
+  const auto quota_file =
+      std::filesystem::temp_directory_path() / "regeocode_bench_quota.json";
+  return ReverseGeocoder({{api, cfg}}, std::move(adapters),
+                         std::make_unique<FixtureHttpClient>(body),
+                         quota_file.string());
+}
+} // namespace
+
+int main(int argc, char **argv) {
+  using namespace regeocode;
+
+  const std::string fixture_dir = argc > 1 ? argv[1] : "tests/fixtures";
+  constexpr std::size_t kIterations = 20'000;
+  const Coordinates coords{48.137154, 11.576124, ""};
+
+  for (const std::string api : {"nominatim", "google"}) {
+    std::ifstream f(fixture_dir + "/" + api + ".json");
+    if (!f.is_open()) {
+      std::cerr << "Missing fixture for " << api << std::endl;
+      return 1;
+    }
+    std::stringstream ss;
+    ss << f.rdbuf();
+    const std::string body = ss.str();
+    std::printf("%s: %zu byte body\n", api.c_str(), body.size());
+
+    // The previous adapter contract: parse, then copy the body into raw_json
+    const auto geocoder = make_geocoder(api, body, false);
+    const auto adapter = api == "nominatim"
+                             ? ApiAdapterPtr(std::make_unique<NominatimAdapter>())
+                             : ApiAdapterPtr(std::make_unique<GoogleAdapter>());
+    bench::report(bench::run(api + "/parse+copy_raw_json", kIterations, [&] {
+      auto r = adapter->parse_response(body);
+      r.raw_json = body;
+      bench::do_not_optimize(r);
+    }));
+    bench::report(bench::run(api + "/parse_response", kIterations, [&] {
+      auto r = adapter->parse_response(body);
+      bench::do_not_optimize(r);
+    }));
+
+    // Whole request path, including the body the HTTP client hands over
+    bench::report(bench::run(api + "/reverse_geocode", kIterations, [&] {
+      auto r = geocoder.reverse_geocode(coords, api);
+      bench::do_not_optimize(r);
+    }));
+
+    bench::report(
+        bench::run(api + "/reverse_geocode_json", kIterations, [&] {
+          auto j = geocoder.reverse_geocode_json(coords, api);
+          bench::do_not_optimize(j);
+        }));
+
+    const auto raw_geocoder = make_geocoder(api, body, true);
+    bench::report(
+        bench::run(api + "/reverse_geocode+raw_json", kIterations, [&] {
+          auto r = raw_geocoder.reverse_geocode(coords, api);
+          bench::do_not_optimize(r);
+        }));
+  }
+
+  return 0;
+}
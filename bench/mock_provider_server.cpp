@@ -0,0 +1,160 @@
+/**
+ * SPDX-FileComment: Mock provider server for end-to-end load tests.
+ * SPDX-FileType: SOURCE
+ * SPDX-FileContributor: ZHENG Robert
+ * SPDX-FileCopyrightText: 2026 ZHENG Robert
+ * SPDX-License-Identifier: MIT
+ *
+ * @file mock_provider_server.cpp
+ * @brief Serves every provider of data/re-geocode.ini_example on 127.0.0.1
+ *        with configurable latency, errors and rate limits.
+ * @version 0.1.0
+ * @date 2026-10-19
+ *
+ * @author ZHENG Robert
+ * @license MIT License
+ */
+
+#include "mock_providers.hpp"
+
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <thread>
+
+namespace {
+volatile std::sig_atomic_t g_stop = 0;
+
+void usage() {
+  std::cerr
+      << "Usage: mock_provider_server [options]\n"
+         "  --port N               port on 127.0.0.1 (default 8089)\n"
+         "  --fixtures DIR         response bodies (default tests/fixtures)\n"
+         "  --latency-ms X         fixed latency or median (default 0)\n"
+         "  --distribution D       fixed | uniform | lognormal\n"
+         "  --spread-ms X          uniform: extra latency up to X\n"
+         "  --sigma S              lognormal: shape (default 0.5)\n"
+         "  --error-rate P         share of requests failing (default 0)\n"
+         "  --error-status N       status of failures (default 503)\n"
+         "  --throttle-rate P      share of requests answered 429\n"
+         "  --max-rps N            per provider, 429 above it\n"
+         "  --retry-after S        Retry-After of 429/503 (default 1)\n"
+         "  --seed N               random seed (default 1)\n"
+         "  --write-ini FILE       write a config pointing at the server\n"
+         "  --ini-template FILE    its source (default "
+         "data/re-geocode.ini_example)\n";
+}
+
+std::chrono::microseconds millis(const char *s) {
+  return std::chrono::microseconds(
+      static_cast<std::int64_t>(std::atof(s) * 1000.0));
+}
+} // namespace
+
+int main(int argc, char **argv) {
+  using namespace regeocode::bench;
+
+  unsigned short port = 8089;
+  std::string fixtures = "tests/fixtures";
+  std::string write_ini;
+  std::string ini_template = "data/re-geocode.ini_example";
+  MockOptions options;
+
+  for (int i = 1; i < argc; ++i) {
+    const std::string_view arg = argv[i];
+    if (arg == "--help" || arg == "-h") {
+      usage();
+      return 0;
+    }
+    if (i + 1 >= argc) {
+      usage();
+      return 1;
+    }
+    const char *value = argv[++i];
+    if (arg == "--port")
+      port = static_cast<unsigned short>(std::atoi(value));
+    else if (arg == "--fixtures")
+      fixtures = value;
+    else if (arg == "--latency-ms")
+      options.latency = millis(value);
+    else if (arg == "--spread-ms")
+      options.spread = millis(value);
+    else if (arg == "--sigma")
+      options.sigma = std::atof(value);
+    else if (arg == "--distribution") {
+      const std::string_view d = value;
+      if (d == "fixed")
+        options.distribution = MockOptions::Latency::Fixed;
+      else if (d == "uniform")
+        options.distribution = MockOptions::Latency::Uniform;
+      else if (d == "lognormal")
+        options.distribution = MockOptions::Latency::LogNormal;
+      else {
+        usage();
+        return 1;
+      }
+    } else if (arg == "--error-rate")
+      options.error_rate = std::atof(value);
+    else if (arg == "--error-status")
+      options.error_status = std::atoi(value);
+    else if (arg == "--throttle-rate")
+      options.throttle_rate = std::atof(value);
+    else if (arg == "--max-rps")
+      options.max_rps = std::atof(value);
+    else if (arg == "--retry-after")
+      options.retry_after = value;
+    else if (arg == "--seed")
+      options.seed = std::strtoull(value, nullptr, 10);
+    else if (arg == "--write-ini")
+      write_ini = value;
+    else if (arg == "--ini-template")
+      ini_template = value;
+    else {
+      usage();
+      return 1;
+    }
+  }
+
+  try {
+    MockProviders providers(fixtures, options);
+    const StandInServer server(
+        [&providers](std::string_view target) { return providers(target); },
+        port);
+
+    if (!write_ini.empty()) {
+      std::ifstream in(ini_template);
+      if (!in.is_open())
+        throw std::runtime_error("Cannot read " + ini_template);
+      std::stringstream ss;
+      ss << in.rdbuf();
+      std::ofstream(write_ini) << mock_config(ss.str(), server.base_url());
+      std::cout << "Wrote " << write_ini << std::endl;
+    }
+    std::cout << "Serving " << kMockRoutes.size() << " providers on "
+              << server.base_url() << " (Ctrl-C to stop)" << std::endl;
+
+    std::signal(SIGINT, [](int) { g_stop = 1; });
+    std::signal(SIGTERM, [](int) { g_stop = 1; });
+    while (!g_stop)
+      std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+    std::printf("\n%-16s %10s %10s %10s\n", "provider", "requests", "429",
+                "errors");
+    for (const MockRoute &route : kMockRoutes) {
+      const auto c = providers.count(route.section);
+      std::printf("%-16s %10zu %10zu %10zu\n", route.section, c.requests,
+                  c.throttled, c.errors);
+    }
+    std::printf("%zu connections, %zu responses\n", server.connections(),
+                server.requests());
+  } catch (const std::exception &e) {
+    std::cerr << "Error: " << e.what() << std::endl;
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,287 @@
+/**
+ * SPDX-FileComment: Mock geocoding and information providers.
+ * SPDX-FileType: SOURCE
+ * SPDX-FileContributor: ZHENG Robert
+ * SPDX-FileCopyrightText: 2026 ZHENG Robert
+ * SPDX-License-Identifier: MIT
+ *
+ * @file mock_providers.hpp
+ * @brief Routes provider URL paths to canned or templated JSON, with
+ *        latency distributions, errors and rate limiting.
+ * @version 0.1.0
+ * @date 2026-10-19
+ *
+ * @author ZHENG Robert
+ * @license MIT License
+ */
+
+#pragma once
+
+#include "stand_in_server.hpp"
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <fstream>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+namespace regeocode::bench {
+
+/**
+ * @brief A provider the mock answers for: its URL path as written in
+ * data/re-geocode.ini_example and the fixture it answers with.
+ */
+struct MockRoute {
+  const char *section; ///< INI section (API name) of the provider.
+  const char *path;    ///< Request path; a trailing '/' matches a prefix.
+  const char *fixture; ///< tests/fixtures/<fixture>.json
+};
+
+inline constexpr std::array<MockRoute, 12> kMockRoutes{{
+    {"nominatim", "/reverse", "nominatim"},
+    {"google", "/maps/api/geocode/json", "google"},
+    {"opencage", "/geocode/v1/json", "opencage"},
+    {"bing", "/search/address/reverse/json", "bing"},
+    {"nearbyWikipedia", "/findNearbyWikipediaJSON", "wikipedia"},
+    {"country_info", "/v3.1/alpha/", "country_info"},
+    {"timezone", "/timezoneJSON", "timezone"},
+    {"openweather", "/data/2.5/weather", "openweather"},
+    {"pollution", "/data/2.5/air_pollution", "pollution"},
+    {"tides", "/tides", "tides"},
+    {"marea_tides", "/v2/tides", "marea_tides"},
+    {"seaweather", "/v2/weather/point", "seaweather"},
+}};
+
+/**
+ * @brief Behaviour of the mock providers.
+ */
+struct MockOptions {
+  enum class Latency { Fixed, Uniform, LogNormal };
+
+  /// Fixed: always @c latency. Uniform: @c latency plus up to @c spread.
+  /// LogNormal: median @c latency with shape @c sigma, a long tail.
+  Latency distribution = Latency::Fixed;
+  std::chrono::microseconds latency{0};
+  std::chrono::microseconds spread{0};
+  double sigma = 0.5;
+  double error_rate = 0.0;  ///< Share of requests failing with error_status.
+  int error_status = 503;
+  double throttle_rate = 0.0; ///< Share of requests answered with a 429.
+  double max_rps = 0.0;       ///< Per provider; above it 429s. 0 = no limit.
+  std::string retry_after = "1"; ///< Retry-After of 503s and 429s.
+  std::uint64_t seed = 1;
+};
+
+/**
+ * @brief Answers requests the way the configured providers would.
+ *
+ * Each route answers with its fixture. A fixture may be a template: every
+ * "{{ name }}" is replaced with the value of query parameter @c name, so
+ * "{{ lat }}" echoes the requested latitude. Unknown paths get a 404.
+ * Meant to be the handler of a StandInServer and therefore called from its
+ * single serving thread; the counters may be read from any thread.
+ */
+class MockProviders {
+public:
+  /// @throws std::runtime_error if a fixture is missing.
+  explicit MockProviders(const std::string &fixture_dir,
+                         MockOptions options = {})
+      : options_(std::move(options)), random_(options_.seed) {
+    for (std::size_t i = 0; i < kMockRoutes.size(); ++i) {
+      const std::string file =
+          fixture_dir + "/" + kMockRoutes[i].fixture + ".json";
+      std::ifstream f(file);
+      if (!f.is_open())
+        throw std::runtime_error("Missing fixture: " + file);
+      std::stringstream ss;
+      ss << f.rdbuf();
+      bodies_[i] = ss.str();
+      templated_[i] = bodies_[i].find("{{") != std::string::npos;
+    }
+  }
+
+  Reply operator()(std::string_view target) {
+    const auto question = target.find('?');
+    const std::string_view path = target.substr(0, question);
+    const std::string_view query = question == std::string_view::npos
+                                       ? std::string_view{}
+                                       : target.substr(question + 1);
+    const std::size_t route = find_route(path);
+    Reply reply;
+    reply.latency = draw_latency();
+    if (route == kMockRoutes.size()) {
+      reply.status = 404;
+      reply.body = R"({"error":"unknown path"})";
+      return reply;
+    }
+    Counters &counters = counters_[route];
+    counters.requests.fetch_add(1, std::memory_order_relaxed);
+
+    if (over_limit(route) || unit() < options_.throttle_rate) {
+      counters.throttled.fetch_add(1, std::memory_order_relaxed);
+      reply.status = 429;
+      reply.retry_after = options_.retry_after;
+      reply.body = R"({"error":"rate limited"})";
+      return reply;
+    }
+    if (unit() < options_.error_rate) {
+      counters.errors.fetch_add(1, std::memory_order_relaxed);
+      reply.status = options_.error_status;
+      reply.retry_after = options_.retry_after;
+      reply.body = R"({"error":"injected"})";
+      return reply;
+    }
+    reply.body = templated_[route] ? render(bodies_[route], query)
+                                   : bodies_[route];
+    return reply;
+  }
+
+  /// Requests, 429s and injected errors of the provider in @p section.
+  struct Count {
+    std::size_t requests = 0;
+    std::size_t throttled = 0;
+    std::size_t errors = 0;
+  };
+  Count count(std::string_view section) const {
+    for (std::size_t i = 0; i < kMockRoutes.size(); ++i)
+      if (section == kMockRoutes[i].section)
+        return {counters_[i].requests.load(), counters_[i].throttled.load(),
+                counters_[i].errors.load()};
+    return {};
+  }
+
+private:
+  struct Counters {
+    std::atomic<std::size_t> requests{0};
+    std::atomic<std::size_t> throttled{0};
+    std::atomic<std::size_t> errors{0};
+  };
+  /// Token bucket of one provider, holding up to one second of requests.
+  struct Bucket {
+    double tokens = -1.0; // full on first use
+    std::chrono::steady_clock::time_point last;
+  };
+
+  static std::size_t find_route(std::string_view path) {
+    for (std::size_t i = 0; i < kMockRoutes.size(); ++i) {
+      const std::string_view p = kMockRoutes[i].path;
+      if (p.ends_with('/') ? path.starts_with(p) : path == p)
+        return i;
+    }
+    return kMockRoutes.size();
+  }
+
+  static std::string render(std::string_view body, std::string_view query) {
+    std::string out;
+    out.reserve(body.size());
+    std::size_t open;
+    while ((open = body.find("{{")) != std::string_view::npos) {
+      const auto close = body.find("}}", open);
+      if (close == std::string_view::npos)
+        break;
+      out.append(body.substr(0, open));
+      std::string_view name = body.substr(open + 2, close - open - 2);
+      name.remove_prefix(std::min(name.find_first_not_of(' '), name.size()));
+      name = name.substr(0, name.find(' '));
+      out.append(param(query, name));
+      body.remove_prefix(close + 2);
+    }
+    out.append(body);
+    return out;
+  }
+
+  static std::string_view param(std::string_view query, std::string_view name) {
+    while (!query.empty()) {
+      const auto amp = query.find('&');
+      const std::string_view pair = query.substr(0, amp);
+      query = amp == std::string_view::npos ? std::string_view{}
+                                            : query.substr(amp + 1);
+      const auto eq = pair.find('=');
+      if (pair.substr(0, eq) == name)
+        return eq == std::string_view::npos ? std::string_view{}
+                                            : pair.substr(eq + 1);
+    }
+    return {};
+  }
+
+  bool over_limit(std::size_t route) {
+    if (options_.max_rps <= 0.0)
+      return false;
+    Bucket &b = buckets_[route];
+    const auto now = std::chrono::steady_clock::now();
+    if (b.tokens < 0.0)
+      b.tokens = options_.max_rps;
+    else
+      b.tokens = std::min(
+          options_.max_rps,
+          b.tokens + options_.max_rps *
+                         std::chrono::duration<double>(now - b.last).count());
+    b.last = now;
+    if (b.tokens < 1.0)
+      return true;
+    b.tokens -= 1.0;
+    return false;
+  }
+
+  std::chrono::microseconds draw_latency() {
+    const double base = static_cast<double>(options_.latency.count());
+    double us = base;
+    switch (options_.distribution) {
+    case MockOptions::Latency::Fixed:
+      break;
+    case MockOptions::Latency::Uniform:
+      us = base + static_cast<double>(options_.spread.count()) * unit();
+      break;
+    case MockOptions::Latency::LogNormal:
+      us = base * std::exp(options_.sigma * normal_(random_));
+      break;
+    }
+    return std::chrono::microseconds(static_cast<std::int64_t>(us));
+  }
+
+  double unit() { return uniform_(random_); }
+
+  MockOptions options_;
+  std::array<std::string, kMockRoutes.size()> bodies_;
+  std::array<bool, kMockRoutes.size()> templated_{};
+  std::array<Counters, kMockRoutes.size()> counters_;
+  std::array<Bucket, kMockRoutes.size()> buckets_;
+  std::mt19937_64 random_;
+  std::uniform_real_distribution<double> uniform_{0.0, 1.0};
+  std::normal_distribution<double> normal_{0.0, 1.0};
+};
+
+/**
+ * @brief @p ini (the text of a re-geocode.ini) with every "URI =" pointing
+ * at @p base_url instead of the provider's host, so that the CLI and
+ * ConfigLoader talk to the mock.
+ */
+inline std::string mock_config(std::string_view ini, std::string_view base_url) {
+  std::string out;
+  while (!ini.empty()) {
+    const auto nl = ini.find('\n');
+    std::string_view line = ini.substr(0, nl);
+    ini = nl == std::string_view::npos ? std::string_view{}
+                                       : ini.substr(nl + 1);
+    const auto scheme = line.find("://");
+    if (line.starts_with("URI") && scheme != std::string_view::npos) {
+      const auto path = line.find('/', scheme + 3);
+      out.append(line.substr(0, line.find('=') + 1));
+      out.append(" ");
+      out.append(base_url);
+      line = path == std::string_view::npos ? std::string_view{}
+                                            : line.substr(path);
+    }
+    out.append(line);
+    out.push_back('\n');
+  }
+  return out;
+}
+
+} // namespace regeocode::bench
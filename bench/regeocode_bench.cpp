@@ -0,0 +1,421 @@
+/**
+ * SPDX-FileComment: Benchmark suite over the per-request hot paths.
+ * SPDX-FileType: SOURCE
+ * SPDX-FileContributor: ZHENG Robert
+ * SPDX-FileCopyrightText: 2026 ZHENG Robert
+ * SPDX-License-Identifier: MIT
+ *
+ * @file regeocode_bench.cpp
+ * @brief URI rendering, adapter parsing, quota, cache, country lookup and
+ *        result building in one run, with JSON output for regression
+ *        tracking.
+ * @version 0.1.0
+ * @date 2026-10-19
+ *
+ * Usage: regeocode_bench [--fixtures DIR] [--countries FILE] [--json FILE]
+ *                        [--baseline FILE] [--threshold X] [--filter TEXT]
+ *                        [--scale X]
+ *
+ * --json writes the results in the layout of Google Benchmark's JSON
+ * reporter (plus allocation counts), so its compare tools apply. With
+ * --baseline, cases slower than the baseline by more than the threshold
+ * (default 0.10 = 10 %) are listed and the exit code is 2.
+ *
+ * @author ZHENG Robert
+ * @license MIT License
+ */
+
+#include "bench_common.hpp"
+
+#include "regeocode/adapter_bing.hpp"
+#include "regeocode/adapter_country.hpp"
+#include "regeocode/adapter_country_info.hpp"
+#include "regeocode/adapter_geonames_timezone.hpp"
+#include "regeocode/adapter_geonames_wikipedia.hpp"
+#include "regeocode/adapter_google.hpp"
+#include "regeocode/adapter_marea_tides.hpp"
+#include "regeocode/adapter_nominatim.hpp"
+#include "regeocode/adapter_opencage.hpp"
+#include "regeocode/adapter_openweather.hpp"
+#include "regeocode/adapter_pollution.hpp"
+#include "regeocode/adapter_seaweather.hpp"
+#include "regeocode/adapter_tides.hpp"
+#include "regeocode/http_cache.hpp"
+#include "regeocode/inja.hpp"
+#include "regeocode/quota_manager.hpp"
+#include "regeocode/re_geocode_core.hpp"
+#include "regeocode/uri_template.hpp"
+
+#include <cstring>
+#include <ctime>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+using namespace regeocode;
+
+struct Options {
+  std::string fixtures = "tests/fixtures";
+  std::string countries = "data/countries.json";
+  std::string json;
+  std::string baseline;
+  std::string filter;
+  double threshold = 0.10;
+  double scale = 1.0;
+};
+
+/**
+ * @brief One provider as the suite sets it up: adapter, URI template as in
+ * data/re-geocode.ini_example (host replaced) and fixture.
+ */
+struct Provider {
+  const char *name;
+  const char *fixture;
+  const char *uri;
+  ApiAdapterPtr (*make)();
+};
+
+template <typename A> ApiAdapterPtr make() { return std::make_unique<A>(); }
+
+const Provider kProviders[] = {
+    {"nominatim", "nominatim",
+     "http://fixture/nominatim?lat={{ latitude }}&lon={{ longitude "
+     "}}&format=json&accept-language={{ lang }}",
+     make<NominatimAdapter>},
+    {"google", "google",
+     "http://fixture/google?latlng={{ latitude }},{{ longitude }}&key={{ "
+     "apikey }}&language={{ lang }}",
+     make<GoogleAdapter>},
+    {"opencage", "opencage",
+     "http://fixture/opencage?q={{ latitude }}+{{ longitude }}&key={{ apikey "
+     "}}&language={{ lang }}",
+     make<OpenCageAdapter>},
+    {"bing", "bing",
+     "http://fixture/bing?api-version=1.0&query={{ latitude }},{{ longitude "
+     "}}&subscription-key={{ apikey }}&language={{ lang }}",
+     make<BingAdapter>},
+    {"nearbyWikipedia", "wikipedia",
+     "http://fixture/wikipedia?lat={{ latitude }}&lng={{ longitude "
+     "}}&username={{ apikey }}&lang={{ lang }}",
+     make<GeoNamesWikipediaAdapter>},
+    {"country_info", "country_info",
+     "http://fixture/country_info/{{ country_code }}",
+     make<CountryInfoAdapter>},
+    {"timezone", "timezone",
+     "http://fixture/timezone?lat={{ latitude }}&lng={{ longitude "
+     "}}&username={{ apikey }}",
+     make<GeoNamesTimezoneAdapter>},
+    {"openweather", "openweather",
+     "http://fixture/openweather?lat={{ latitude }}&lon={{ longitude "
+     "}}&appid={{ apikey }}&units=metric&lang={{ lang }}",
+     make<OpenWeatherAdapter>},
+    {"pollution", "pollution",
+     "http://fixture/pollution?lat={{ latitude }}&lon={{ longitude "
+     "}}&appid={{ apikey }}",
+     make<PollutionAdapter>},
+    {"tides", "tides",
+     "http://fixture/tides?interval=60&longitude={{ longitude }}&latitude={{ "
+     "latitude }}&duration=1440&rapidapi-key={{ apikey }}",
+     make<TidesAdapter>},
+    {"marea_tides", "marea_tides",
+     "http://fixture/marea_tides?duration=1440&interval=60&latitude={{ "
+     "latitude }}&longitude={{ longitude }}&token={{ apikey }}",
+     make<MareaTidesAdapter>},
+    {"seaweather", "seaweather",
+     "http://fixture/seaweather?lat={{ latitude }}&lng={{ longitude "
+     "}}&key={{ apikey }}&params=waveHeight,airTemperature",
+     make<SeaWeatherAdapter>},
+};
+
+std::string read_file(const std::string &path) {
+  std::ifstream f(path);
+  if (!f.is_open())
+    throw std::runtime_error("Missing file: " + path);
+  std::stringstream ss;
+  ss << f.rdbuf();
+  return ss.str();
+}
+
+/**
+ * @brief HttpClient answering "http://fixture/<name>..." with that fixture,
+ * so whole requests run without a network.
+ */
+class FixtureHttpClient : public HttpClient {
+public:
+  explicit FixtureHttpClient(std::unordered_map<std::string, std::string> bodies)
+      : bodies_(std::move(bodies)) {}
+
+  HttpResponse get(const std::string &url, long /*timeout*/,
+                   const HttpRequestOptions & /*options*/) const override {
+    constexpr std::string_view kPrefix = "http://fixture/";
+    const std::string_view rest = std::string_view(url).substr(kPrefix.size());
+    const auto it =
+        bodies_.find(std::string(rest.substr(0, rest.find_first_of("/?"))));
+    HttpResponse response;
+    response.status_code = it == bodies_.end() ? 404 : 200;
+    if (it != bodies_.end())
+      response.body.assign(it->second);
+    response.wire_bytes = response.body.size();
+    return response;
+  }
+
+private:
+  std::unordered_map<std::string, std::string> bodies_;
+};
+
+/**
+ * @brief Runs the cases selected by the filter and keeps their results.
+ */
+class Suite {
+public:
+  explicit Suite(const Options &options) : options_(options) {}
+
+  template <typename Fn>
+  void add(const std::string &name, std::size_t iterations, Fn &&fn) {
+    if (!options_.filter.empty() &&
+        name.find(options_.filter) == std::string::npos)
+      return;
+    const auto n = std::max<std::size_t>(
+        1, static_cast<std::size_t>(static_cast<double>(iterations) *
+                                    options_.scale));
+    results_.push_back(bench::run(name, n, std::forward<Fn>(fn)));
+    bench::report(results_.back());
+  }
+
+  const std::vector<bench::Result> &results() const { return results_; }
+
+private:
+  const Options &options_;
+  std::vector<bench::Result> results_;
+};
+
+nlohmann::json to_json(const std::vector<bench::Result> &results) {
+  char date[32];
+  const std::time_t now = std::time(nullptr);
+  std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S%z",
+                std::localtime(&now));
+  nlohmann::json out;
+  out["context"] = {
+      {"date", date},
+      {"executable", "regeocode_bench"},
+      {"library_version", "0.1.0"},
+#ifdef NDEBUG
+      {"library_build_type", "release"},
+#else
+      {"library_build_type", "debug"},
+#endif
+      {"compiler", __VERSION__},
+  };
+  out["benchmarks"] = nlohmann::json::array();
+  for (const auto &r : results)
+    out["benchmarks"].push_back({{"name", r.name},
+                                 {"run_type", "iteration"},
+                                 {"iterations", r.iterations},
+                                 {"real_time", r.ns_per_op},
+                                 {"cpu_time", r.ns_per_op},
+                                 {"time_unit", "ns"},
+                                 {"allocs_per_op", r.allocs_per_op},
+                                 {"bytes_per_op", r.bytes_per_op}});
+  return out;
+}
+
+/// Number of cases slower than @p baseline by more than the threshold.
+std::size_t compare(const std::vector<bench::Result> &results,
+                    const Options &options) {
+  const auto baseline = nlohmann::json::parse(read_file(options.baseline));
+  std::unordered_map<std::string, double> before;
+  for (const auto &b : baseline.at("benchmarks"))
+    before.emplace(b.at("name").get<std::string>(),
+                   b.at("real_time").get<double>());
+
+  std::size_t regressions = 0;
+  std::printf("\n%-40s %12s %12s %8s\n", "vs. baseline", "before ns",
+              "now ns", "change");
+  for (const auto &r : results) {
+    const auto it = before.find(r.name);
+    if (it == before.end() || it->second <= 0.0)
+      continue;
+    const double change = r.ns_per_op / it->second - 1.0;
+    const bool slower = change > options.threshold;
+    regressions += slower ? 1 : 0;
+    std::printf("%-40s %12.1f %12.1f %+7.1f%%%s\n", r.name.c_str(),
+                it->second, r.ns_per_op, change * 100.0,
+                slower ? "  REGRESSION" : "");
+  }
+  return regressions;
+}
+
+void run_suite(Suite &suite, const Options &options) {
+  std::unordered_map<std::string, std::string> bodies;
+  for (const Provider &p : kProviders)
+    bodies.emplace(p.fixture, read_file(options.fixtures + "/" + p.fixture +
+                                        ".json"));
+  const UriValues values{48.137154, 11.576124, "KEY", "de", "de"};
+
+  // URI rendering: the compiled template, and inja as every request used
+  // to run it (parse the template, build the data object, render)
+  for (const Provider &p : {kProviders[0], kProviders[1]}) {
+    const UriTemplate tpl(p.uri);
+    suite.add(std::string("uri/template/") + p.name, 200'000, [&] {
+      auto url = tpl.render(values);
+      bench::do_not_optimize(url);
+    });
+    suite.add(std::string("uri/inja/") + p.name, 20'000, [&] {
+      inja::Environment env;
+      const nlohmann::json data = {{"latitude", values.latitude},
+                                   {"longitude", values.longitude},
+                                   {"apikey", values.apikey},
+                                   {"lang", values.lang}};
+      auto url = env.render(p.uri, data);
+      bench::do_not_optimize(url);
+    });
+  }
+
+  // Adapter parse_response on every provider's recorded response
+  for (const Provider &p : kProviders) {
+    const auto adapter = p.make();
+    const std::string &body = bodies.at(p.fixture);
+    suite.add(std::string("parse/") + p.name, 20'000, [&] {
+      auto r = adapter->parse_response(body);
+      bench::do_not_optimize(r);
+    });
+  }
+
+  // Quota: unlimited APIs return early, limited ones persist every call
+  {
+    const auto path =
+        (std::filesystem::temp_directory_path() / "regeocode_bench_quota.json")
+            .string();
+    QuotaManager quota(path);
+    suite.add("quota/try_consume/unlimited", 1'000'000, [&] {
+      bench::do_not_optimize(quota.try_consume("nominatim", 0));
+    });
+    suite.add("quota/try_consume/limited", 2'000, [&] {
+      bench::do_not_optimize(quota.try_consume("nominatim", 1'000'000'000));
+    });
+    std::filesystem::remove(path);
+  }
+
+  // Response cache: lookups of a fresh entry and stores
+  {
+    HttpCache cache;
+    HttpResponse response;
+    response.status_code = 200;
+    response.cache_control = "max-age=3600";
+    response.etag = "\"v1\"";
+    response.body.assign(bodies.at("country_info"));
+    std::vector<std::string> urls;
+    for (int i = 0; i < 64; ++i)
+      urls.push_back("http://fixture/country_info/" + std::to_string(i));
+    for (const auto &url : urls)
+      cache.store(url, response, std::chrono::microseconds(100));
+    std::size_t i = 0;
+    suite.add("cache/fresh_hit", 500'000, [&] {
+      auto hit = cache.fresh(urls[i++ % urls.size()]);
+      bench::do_not_optimize(hit);
+    });
+    suite.add("cache/fresh_miss", 500'000, [&] {
+      auto hit = cache.fresh("http://fixture/none");
+      bench::do_not_optimize(hit);
+    });
+    suite.add("cache/store", 50'000, [&] {
+      cache.store(urls[i++ % urls.size()], response,
+                  std::chrono::microseconds(100));
+    });
+  }
+
+  // Local country data
+  {
+    const CountryAdapter countries(options.countries);
+    suite.add("country/get_country", 200'000, [&] {
+      auto j = countries.get_country("DE");
+      bench::do_not_optimize(j);
+    });
+    suite.add("country/find", 1'000'000, [&] {
+      bench::do_not_optimize(countries.find("DEU"));
+    });
+  }
+
+  // Whole requests without network: render, fetch, parse, build the JSON
+  {
+    std::unordered_map<std::string, ApiConfig> configs;
+    std::vector<ApiAdapterPtr> adapters;
+    for (const Provider &p : kProviders) {
+      ApiConfig cfg;
+      cfg.name = p.name;
+      cfg.adapter = p.make()->name();
+      cfg.uri_template = p.uri;
+      cfg.api_key = "KEY";
+      configs.emplace(p.name, std::move(cfg));
+      adapters.push_back(p.make());
+    }
+    const auto quota =
+        (std::filesystem::temp_directory_path() / "regeocode_bench_quota.json")
+            .string();
+    const ReverseGeocoder geocoder(
+        std::move(configs), std::move(adapters),
+        std::make_unique<FixtureHttpClient>(bodies), quota);
+    const Coordinates where{48.137154, 11.576124, "de"};
+    for (const Provider &p : kProviders)
+      suite.add(std::string("geocode_json/") + p.name, 10'000, [&] {
+        auto j = geocoder.reverse_geocode_json(where, p.name);
+        bench::do_not_optimize(j);
+      });
+    std::filesystem::remove(quota);
+  }
+}
+} // namespace
+
+int main(int argc, char **argv) {
+  Options options;
+  for (int i = 1; i < argc; ++i) {
+    const std::string_view arg = argv[i];
+    if (i + 1 >= argc) {
+      std::cerr << "Missing value for " << arg << std::endl;
+      return 1;
+    }
+    const char *value = argv[++i];
+    if (arg == "--fixtures")
+      options.fixtures = value;
+    else if (arg == "--countries")
+      options.countries = value;
+    else if (arg == "--json")
+      options.json = value;
+    else if (arg == "--baseline")
+      options.baseline = value;
+    else if (arg == "--threshold")
+      options.threshold = std::atof(value);
+    else if (arg == "--filter")
+      options.filter = value;
+    else if (arg == "--scale")
+      options.scale = std::atof(value);
+    else {
+      std::cerr << "Unknown option " << arg << std::endl;
+      return 1;
+    }
+  }
+
+  try {
+    Suite suite(options);
+    run_suite(suite, options);
+
+    if (!options.json.empty()) {
+      std::ofstream out(options.json);
+      out << to_json(suite.results()).dump(2) << '\n';
+      if (!out)
+        throw std::runtime_error("Cannot write " + options.json);
+    }
+    if (!options.baseline.empty() && compare(suite.results(), options) > 0)
+      return 2;
+  } catch (const std::exception &e) {
+    std::cerr << "Error: " << e.what() << std::endl;
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,393 @@
+/**
+ * SPDX-FileComment: Local provider stand-in server for the benchmarks.
+ * SPDX-FileType: SOURCE
+ * SPDX-FileContributor: ZHENG Robert
+ * SPDX-FileCopyrightText: 2026 ZHENG Robert
+ * SPDX-License-Identifier: MIT
+ *
+ * @file stand_in_server.hpp
+ * @brief Loopback HTTP/1.1 + h2c server answering from a handler.
+ * @version 0.1.0
+ * @date 2026-10-19
+ *
+ * @author ZHENG Robert
+ * @license MIT License
+ */
+
+#pragma once
+
+#include <nghttp2/nghttp2.h>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <list>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace regeocode::bench {
+
+/**
+ * @brief What the server answers to one request.
+ */
+struct Reply {
+  int status = 200;
+  std::string body;
+  std::chrono::microseconds latency{0}; ///< Delay before the answer.
+  std::string retry_after;              ///< Sent as Retry-After if set.
+};
+
+/// Builds the reply for a request target ("/path?query").
+using Handler = std::function<Reply(std::string_view target)>;
+
+/**
+ * @brief Stand-in for a geocoding provider on 127.0.0.1.
+ *
+ * Speaks HTTP/1.1 with keep-alive and HTTP/2 with prior knowledge (h2c) on
+ * the same port, answers every GET with the handler's reply after the
+ * reply's latency and counts connections, so pooling and multiplexing
+ * become visible. A single thread serves all connections and calls the
+ * handler; it is a measuring aid, not a web server.
+ */
+class StandInServer {
+public:
+  /// Answers every request with @p body after @p latency.
+  StandInServer(std::string body, std::chrono::microseconds latency)
+      : StandInServer([reply = Reply{200, std::move(body), latency, {}}](
+                          std::string_view) { return reply; }) {}
+
+  /// Answers with @p handler; @p port 0 picks a free port.
+  /// @throws std::runtime_error if the port cannot be bound.
+  explicit StandInServer(Handler handler, unsigned short port = 0)
+      : handler_(std::move(handler)) {
+    listen_fd_ = ::socket(AF_INET, SOCK_STREAM, 0);
+    int one = 1;
+    ::setsockopt(listen_fd_, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = htons(port);
+    if (::bind(listen_fd_, reinterpret_cast<sockaddr *>(&addr),
+               sizeof(addr)) != 0 ||
+        ::listen(listen_fd_, 1024) != 0) {
+      ::close(listen_fd_);
+      throw std::runtime_error("Cannot listen on 127.0.0.1:" +
+                               std::to_string(port));
+    }
+    socklen_t len = sizeof(addr);
+    ::getsockname(listen_fd_, reinterpret_cast<sockaddr *>(&addr), &len);
+    port_ = ntohs(addr.sin_port);
+    thread_ = std::thread([this] { serve(); });
+  }
+
+  ~StandInServer() {
+    stop_ = true;
+    thread_.join();
+    for (auto &c : connections_)
+      close_connection(*c);
+    ::close(listen_fd_);
+  }
+
+  StandInServer(const StandInServer &) = delete;
+  StandInServer &operator=(const StandInServer &) = delete;
+
+  /// Scheme, host and port of the server.
+  std::string base_url() const {
+    return "http://127.0.0.1:" + std::to_string(port_);
+  }
+  /// A request URL on the server.
+  std::string url() const { return base_url() + "/reverse"; }
+  unsigned short port() const { return port_; }
+  /// Connections accepted so far.
+  std::size_t connections() const { return accepted_.load(); }
+  /// Requests answered so far.
+  std::size_t requests() const { return answered_.load(); }
+
+private:
+  struct Connection {
+    int fd = -1;
+    bool detected = false;
+    nghttp2_session *session = nullptr; // set for h2c
+    std::string input;                  // HTTP/1.1 request bytes
+    std::unordered_map<std::int32_t, std::string> targets; // h2 :path
+    std::unordered_map<std::int32_t, std::pair<Reply, std::size_t>>
+        sent; // h2 replies and body offsets
+    bool closed = false;
+  };
+
+  struct Pending {
+    std::chrono::steady_clock::time_point due;
+    Connection *connection;
+    std::int32_t stream_id; // 0 for HTTP/1.1
+    Reply reply;
+  };
+
+  void serve() {
+    std::vector<pollfd> fds;
+    while (!stop_) {
+      fds.clear();
+      fds.push_back({listen_fd_, POLLIN, 0});
+      for (const auto &c : connections_)
+        fds.push_back({c->fd, POLLIN, 0});
+
+      int timeout_ms = 20;
+      if (!pending_.empty()) {
+        const auto next = std::min_element(
+            pending_.begin(), pending_.end(),
+            [](const Pending &a, const Pending &b) { return a.due < b.due; });
+        const auto wait = std::chrono::duration_cast<std::chrono::milliseconds>(
+            next->due - std::chrono::steady_clock::now());
+        timeout_ms = static_cast<int>(std::clamp<long long>(wait.count(), 0, 20));
+      }
+      ::poll(fds.data(), fds.size(), timeout_ms);
+
+      if (fds[0].revents & POLLIN)
+        accept_connection();
+      std::size_t i = 1;
+      for (auto &c : connections_) {
+        if (i < fds.size() && fds[i].fd == c->fd &&
+            (fds[i].revents & (POLLIN | POLLHUP | POLLERR)))
+          read_from(*c);
+        ++i;
+      }
+      answer_due();
+      connections_.remove_if([this](const std::unique_ptr<Connection> &c) {
+        if (!c->closed)
+          return false;
+        std::erase_if(pending_, [&](const Pending &p) {
+          return p.connection == c.get();
+        });
+        close_connection(*c);
+        return true;
+      });
+    }
+  }
+
+  void accept_connection() {
+    const int fd = ::accept(listen_fd_, nullptr, nullptr);
+    if (fd < 0)
+      return;
+    int one = 1;
+    ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    auto c = std::make_unique<Connection>();
+    c->fd = fd;
+    connections_.push_back(std::move(c));
+    ++accepted_;
+  }
+
+  void read_from(Connection &c) {
+    char buf[16 * 1024];
+    const ssize_t n = ::read(c.fd, buf, sizeof(buf));
+    if (n <= 0) {
+      c.closed = true;
+      return;
+    }
+    std::string_view data(buf, static_cast<std::size_t>(n));
+    if (!c.detected) {
+      c.input.append(data);
+      if (c.input.size() < 3)
+        return;
+      c.detected = true;
+      if (c.input.starts_with("PRI")) {
+        start_h2(c);
+        data = c.input;
+      }
+      if (!c.session) {
+        data = {};
+      }
+    } else if (!c.session) {
+      c.input.append(data);
+      data = {};
+    }
+
+    if (c.session) {
+      current_ = &c;
+      if (nghttp2_session_mem_recv(
+              c.session, reinterpret_cast<const std::uint8_t *>(data.data()),
+              data.size()) < 0)
+        c.closed = true;
+      c.input.clear();
+      flush(c);
+      return;
+    }
+    // HTTP/1.1: one GET per header block, "GET <target> HTTP/1.1" first
+    std::size_t end;
+    while ((end = c.input.find("\r\n\r\n")) != std::string::npos) {
+      const std::string_view line =
+          std::string_view(c.input).substr(0, c.input.find("\r\n"));
+      const auto from = line.find(' ') + 1;
+      queue(c, 0, line.substr(from, line.rfind(' ') - from));
+      c.input.erase(0, end + 4);
+    }
+  }
+
+  void queue(Connection &c, std::int32_t stream_id, std::string_view target) {
+    Reply reply = handler_(target);
+    const auto due = std::chrono::steady_clock::now() + reply.latency;
+    pending_.push_back({due, &c, stream_id, std::move(reply)});
+  }
+
+  void start_h2(Connection &c) {
+    nghttp2_session_callbacks *callbacks;
+    nghttp2_session_callbacks_new(&callbacks);
+    nghttp2_session_callbacks_set_on_frame_recv_callback(
+        callbacks, [](nghttp2_session *, const nghttp2_frame *frame,
+                      void *user) -> int {
+          auto *self = static_cast<StandInServer *>(user);
+          if ((frame->hd.type == NGHTTP2_HEADERS ||
+               frame->hd.type == NGHTTP2_DATA) &&
+              (frame->hd.flags & NGHTTP2_FLAG_END_STREAM)) {
+            Connection &c = *self->current_;
+            self->queue(c, frame->hd.stream_id, c.targets[frame->hd.stream_id]);
+            c.targets.erase(frame->hd.stream_id);
+          }
+          return 0;
+        });
+    nghttp2_session_callbacks_set_on_header_callback(
+        callbacks,
+        [](nghttp2_session *, const nghttp2_frame *frame,
+           const std::uint8_t *name, std::size_t namelen,
+           const std::uint8_t *value, std::size_t valuelen, std::uint8_t,
+           void *user) -> int {
+          if (std::string_view(reinterpret_cast<const char *>(name), namelen) ==
+              ":path")
+            static_cast<StandInServer *>(user)
+                ->current_->targets[frame->hd.stream_id]
+                .assign(reinterpret_cast<const char *>(value), valuelen);
+          return 0;
+        });
+    nghttp2_session_callbacks_set_on_stream_close_callback(
+        callbacks, [](nghttp2_session *, std::int32_t stream_id, std::uint32_t,
+                      void *user) -> int {
+          static_cast<StandInServer *>(user)->current_->sent.erase(stream_id);
+          return 0;
+        });
+    nghttp2_session_server_new(&c.session, callbacks, this);
+    nghttp2_session_callbacks_del(callbacks);
+
+    const nghttp2_settings_entry settings[] = {
+        {NGHTTP2_SETTINGS_MAX_CONCURRENT_STREAMS, 1000}};
+    nghttp2_submit_settings(c.session, NGHTTP2_FLAG_NONE, settings, 1);
+    current_ = &c;
+  }
+
+  void answer_due() {
+    const auto now = std::chrono::steady_clock::now();
+    for (auto it = pending_.begin(); it != pending_.end();) {
+      if (it->due > now) {
+        ++it;
+        continue;
+      }
+      Connection &c = *it->connection;
+      if (c.session) {
+        respond_h2(c, it->stream_id, std::move(it->reply));
+      } else {
+        const Reply &reply = it->reply;
+        std::string head = "HTTP/1.1 " + std::to_string(reply.status) +
+                           (reply.status == 200 ? " OK" : " Error") +
+                           "\r\nContent-Type: application/json\r\n";
+        if (!reply.retry_after.empty())
+          head += "Retry-After: " + reply.retry_after + "\r\n";
+        head += "Content-Length: " + std::to_string(reply.body.size()) +
+                "\r\n\r\n";
+        write_all(c, head + reply.body);
+      }
+      ++answered_;
+      it = pending_.erase(it);
+    }
+  }
+
+  void respond_h2(Connection &c, std::int32_t stream_id, Reply reply) {
+    // The body must outlive this call: the data provider reads it later
+    const Reply &stored =
+        c.sent.insert_or_assign(stream_id, std::pair{std::move(reply), 0uz})
+            .first->second.first;
+    const std::string status = std::to_string(stored.status);
+    const std::string length = std::to_string(stored.body.size());
+    auto nv = [](const char *name, std::string_view value) {
+      return nghttp2_nv{
+          reinterpret_cast<std::uint8_t *>(const_cast<char *>(name)),
+          reinterpret_cast<std::uint8_t *>(const_cast<char *>(value.data())),
+          std::strlen(name), value.size(), NGHTTP2_NV_FLAG_NONE};
+    };
+    const nghttp2_nv headers[] = {nv(":status", status),
+                                  nv("content-type", "application/json"),
+                                  nv("content-length", length),
+                                  nv("retry-after", stored.retry_after)};
+    nghttp2_data_provider provider{};
+    provider.read_callback = [](nghttp2_session *, std::int32_t id,
+                                std::uint8_t *buf, std::size_t size,
+                                std::uint32_t *flags, nghttp2_data_source *,
+                                void *user) -> ssize_t {
+      auto &[reply, offset] =
+          static_cast<StandInServer *>(user)->current_->sent[id];
+      const std::size_t n = std::min(size, reply.body.size() - offset);
+      std::memcpy(buf, reply.body.data() + offset, n);
+      offset += n;
+      if (offset == reply.body.size())
+        *flags |= NGHTTP2_DATA_FLAG_EOF;
+      return static_cast<ssize_t>(n);
+    };
+    current_ = &c;
+    nghttp2_submit_response(c.session, stream_id, headers,
+                            stored.retry_after.empty() ? 3 : 4, &provider);
+    flush(c);
+  }
+
+  void flush(Connection &c) {
+    current_ = &c;
+    const std::uint8_t *data;
+    ssize_t n;
+    while ((n = nghttp2_session_mem_send(c.session, &data)) > 0)
+      write_all(c, {reinterpret_cast<const char *>(data),
+                    static_cast<std::size_t>(n)});
+  }
+
+  static void write_all(Connection &c, std::string_view data) {
+    while (!data.empty()) {
+      const ssize_t n = ::write(c.fd, data.data(), data.size());
+      if (n <= 0) {
+        c.closed = true;
+        return;
+      }
+      data.remove_prefix(static_cast<std::size_t>(n));
+    }
+  }
+
+  static void close_connection(Connection &c) {
+    if (c.session)
+      nghttp2_session_del(c.session);
+    c.session = nullptr;
+    if (c.fd >= 0)
+      ::close(c.fd);
+    c.fd = -1;
+  }
+
+  Handler handler_;
+  int listen_fd_ = -1;
+  unsigned short port_ = 0;
+  std::atomic<bool> stop_{false};
+  std::atomic<std::size_t> accepted_{0};
+  std::atomic<std::size_t> answered_{0};
+  std::list<std::unique_ptr<Connection>> connections_;
+  std::vector<Pending> pending_;
+  Connection *current_ = nullptr; // connection nghttp2 callbacks refer to
+  std::thread thread_;
+};
+
+} // namespace regeocode::bench
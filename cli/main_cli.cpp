@@ -21,7 +21,11 @@
 #include <vector>
 
 #include "regeocode/http_client.hpp"
+#include "regeocode/metrics.hpp"
 #include "regeocode/re_geocode_core.hpp"
+#include "regeocode/replay_http_client.hpp"
+#include "regeocode/track.hpp"
+#include "regeocode/tracing.hpp"
 
 // Adapter Headers
 #include "regeocode/adapter_bing.hpp"
@@ -77,6 +81,13 @@ int main(int argc, char **argv) {
 
   std::string lang_override = "";
   bool batch_mode = false;
+  regeocode::BatchOptions batch_options;
+  std::string track_path;
+  regeocode::TrackOptions track_options;
+  std::string record_path;
+  std::string replay_path;
+  std::string metrics_path;
+  std::string trace_path;
 
   app.add_option("--lat", lat, "Latitude");
   app.add_option("--lon", lon, "Longitude");
@@ -91,6 +102,24 @@ int main(int argc, char **argv) {
 
   app.add_option("--lang", lang_override, "Language");
   app.add_flag("--batch", batch_mode, "Run a demo batch process");
+  app.add_option("--quantum", batch_options.quantum_m,
+                 "Batch: merge points closer than this grid (metres)");
+  app.add_option("--cell", batch_options.cell_m,
+                 "Batch: one thread per cell of this size (metres)");
+  app.add_option("--track", track_path,
+                 "Geocode a GPX track or NMEA log into labelled segments");
+  app.add_option("--probe-every", track_options.probe_every,
+                 "Track: look up every n-th point, then bisect changes");
+  app.add_option("--probe-m", track_options.probe_m,
+                 "Track: also look up after this many metres");
+  app.add_option("--record", record_path,
+                 "Record provider responses to a replay file");
+  app.add_option("--replay", replay_path,
+                 "Answer from a replay file instead of the network");
+  app.add_option("--metrics", metrics_path,
+                 "Write per-API metrics as a Prometheus text file");
+  app.add_option("--trace", trace_path,
+                 "Write lookup stages as a Chrome trace-event file");
 
   CLI11_PARSE(app, argc, argv);
 
@@ -115,13 +144,40 @@ int main(int argc, char **argv) {
     adapters.push_back(std::make_unique<regeocode::SeaWeatherAdapter>());
 
     // 3. Instantiate geocoder
-    auto client = std::make_unique<regeocode::HttpClient>();
+    // Whatever an API calls its key parameter, it stays out of recordings
+    std::vector<std::string> uri_templates;
+    for (const auto &[name, cfg] : config_result.apis)
+      uri_templates.push_back(cfg.uri_template);
+    const auto ignored_params = regeocode::credential_params(uri_templates);
+
+    std::unique_ptr<regeocode::HttpClient> client;
+    const regeocode::RecordingHttpClient *recorder = nullptr;
+    if (!replay_path.empty()) {
+      regeocode::ReplayOptions replay_options;
+      replay_options.ignored_params = ignored_params;
+      client = std::make_unique<regeocode::ReplayHttpClient>(replay_path,
+                                                             replay_options);
+    } else {
+      client = std::make_unique<regeocode::HttpClient>(config_result.http);
+    }
+    if (!record_path.empty()) {
+      auto recording = std::make_unique<regeocode::RecordingHttpClient>(
+          std::move(client), ignored_params);
+      recorder = recording.get();
+      client = std::move(recording);
+    }
 
     regeocode::ReverseGeocoder geocoder(
         std::move(config_result.apis), std::move(adapters), std::move(client),
         config_result.quota_file_path // <--- New parameter
     );
 
+    std::shared_ptr<regeocode::ChromeTraceSink> trace_sink;
+    if (!trace_path.empty()) {
+      trace_sink = std::make_shared<regeocode::ChromeTraceSink>(trace_path);
+      geocoder.set_trace_sink(trace_sink);
+    }
+
     // --- LOGIC FIX: --api vs --strategy ---
     std::vector<std::string> priority_list;
 
@@ -134,7 +190,16 @@ int main(int argc, char **argv) {
     }
     // --------------------------------------
 
-    if (batch_mode) {
+    if (!track_path.empty()) {
+      const auto track = regeocode::read_track(track_path);
+      const regeocode::TrackResult result =
+          regeocode::geocode_track(geocoder, track, priority_list,
+                                   lang_override, {}, track_options);
+      std::cerr << result.points << " points, " << result.lookups
+                << " lookups, " << result.segments.size() << " segments\n";
+      std::cout << result.to_json().dump(4) << std::endl;
+
+    } else if (batch_mode) {
       std::cout << "Starting DEMO Batch Processing...\n";
       // Demo coordinates
       std::vector<regeocode::Coordinates> batch_inputs = {
@@ -145,8 +210,12 @@ int main(int argc, char **argv) {
           {40.7128, -74.0060} // New York
       };
 
-      auto results = geocoder.batch_reverse_geocode(batch_inputs, priority_list,
-                                                    lang_override);
+      regeocode::BatchReport report;
+      auto results = geocoder.batch_reverse_geocode(
+          batch_inputs, priority_list, lang_override, {}, batch_options,
+          &report);
+      std::cerr << report.points << " points, " << report.requests
+                << " requests, unique ratio " << report.unique_ratio() << "\n";
 
       nlohmann::json batch_output = results;
       std::cout << batch_output.dump(4) << std::endl;
@@ -163,6 +232,17 @@ int main(int argc, char **argv) {
       std::cout << result.dump(4) << std::endl;
     }
 
+    if (!metrics_path.empty())
+      regeocode::write_prometheus_file(geocoder.metrics(), metrics_path);
+    if (trace_sink)
+      trace_sink->flush();
+
+    if (recorder) {
+      recorder->save(record_path);
+      std::cerr << "Recorded " << recorder->size() << " responses to "
+                << record_path << "\n";
+    }
+
   } catch (const std::exception &e) {
     std::cerr << "Fatal Error: " << e.what() << std::endl;
     return 1;
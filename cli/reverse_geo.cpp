@@ -30,8 +30,12 @@
 
 #include <CLI/CLI.hpp>
 
+#include <pthread.h>
+#include <signal.h>
+
 #include <algorithm>
 #include <cctype>
+#include <cstdlib>
 #include <execution>
 #include <filesystem>
 #include <future>
@@ -41,7 +45,9 @@
 #include <mutex>
 #include <optional>
 #include <sstream>
+#include <stop_token>
 #include <string>
+#include <thread>
 #include <unordered_map>
 #include <vector>
 
@@ -55,6 +61,7 @@
 #include "regeocode/adapter_bing.hpp"
 #include "regeocode/adapter_country.hpp"
 #include "regeocode/adapter_country_info.hpp"
+#include "regeocode/adapter_country_info_local.hpp"
 #include "regeocode/adapter_geonames_timezone.hpp"
 #include "regeocode/adapter_geonames_wikipedia.hpp"
 #include "regeocode/adapter_google.hpp"
@@ -184,6 +191,32 @@ private:
 
 static GeoCache GEO_CACHE(1024);
 
+/* ---------------------------
+   Abbruch (Ctrl-C)
+   --------------------------- */
+
+// Requested by the first SIGINT/SIGTERM: lookups in flight are aborted and
+// their quota slots given back; files not started yet are skipped
+static std::stop_source STOP;
+
+// Must run before any other thread starts, so all of them inherit the mask
+// and the signals only reach the watcher
+static void install_interrupt_handler() {
+  sigset_t signals;
+  sigemptyset(&signals);
+  sigaddset(&signals, SIGINT);
+  sigaddset(&signals, SIGTERM);
+  pthread_sigmask(SIG_BLOCK, &signals, nullptr);
+  std::thread([signals] {
+    int sig = 0;
+    sigwait(&signals, &sig);
+    std::cerr << "\nInterrupted, cancelling lookups (again to quit)...\n";
+    STOP.request_stop();
+    sigwait(&signals, &sig);
+    std::_Exit(128 + sig);
+  }).detach();
+}
+
 /* ---------------------------
    Async wrapper für Geocoder
    --------------------------- */
@@ -218,7 +251,8 @@ async_reverse_geocode_cached(regeocode::ReverseGeocoder &geocoder, double lat,
                     [&geocoder, lat, lon, priority_list, lang_override, key]() {
                       regeocode::Coordinates coords{lat, lon};
                       auto result = geocoder.reverse_geocode_fallback(
-                          coords, priority_list, lang_override);
+                          coords, priority_list, lang_override,
+                          STOP.get_token());
                       GEO_CACHE.put(key, result);
                       return result;
                     })
@@ -501,6 +535,9 @@ process_image_file(const fs::path &file_path,
       }
     }
 
+  } catch (const regeocode::LookupCancelled &) {
+    // Thrown before writeMetadata(), so the file is left as it was
+    std::cerr << "  Cancelled: " << file_path << std::endl;
   } catch (const Exiv2::Error &e) {
     std::cerr << "  Exiv2 error for file " << file_path << ": " << e.what()
               << std::endl;
@@ -542,6 +579,8 @@ static void process_folder(const fs::path &folder, bool recursive,
   // Parallel processing: each file processed independently
   std::for_each(std::execution::par, files.begin(), files.end(),
                 [&](const fs::path &p) {
+                  if (STOP.stop_requested())
+                    return;
                   process_image_file(p, geocoder,
                                      priority_list, lang_override,
                                      copyright_opt, rename_mode);
@@ -566,6 +605,8 @@ int main(int argc, char **argv) {
   bool recursive = false;
   bool rename_mode = false;
   std::string copyright_text = "";
+  std::string country_data_path = "data/countries.json";
+  bool online_country_info = false;
 
   app.add_option("--lat", lat, "Latitude");
   app.add_option("--lon", lon, "Longitude");
@@ -581,9 +622,15 @@ int main(int argc, char **argv) {
   app.add_flag("--rename", rename_mode, "Rename files by timestamp");
   app.add_option("--copyright", copyright_text,
                  "Copyright text to write into metadata");
+  app.add_option("--country-data", country_data_path,
+                 "Local countries.json answering country_info lookups");
+  app.add_flag("--online-country-info", online_country_info,
+               "Always query restcountries.com for country_info");
 
   CLI11_PARSE(app, argc, argv);
 
+  install_interrupt_handler();
+
   // Apply defaults for empty strings where appropriate
   config_path = default_if_empty(config_path, "re-geocode.ini");
   strategy_raw = default_if_empty(strategy_raw, "nominatim");
@@ -600,7 +647,14 @@ int main(int argc, char **argv) {
     adapters.push_back(std::make_unique<regeocode::GoogleAdapter>());
     adapters.push_back(std::make_unique<regeocode::OpenCageAdapter>());
     adapters.push_back(std::make_unique<regeocode::BingAdapter>());
-    adapters.push_back(std::make_unique<regeocode::CountryInfoAdapter>());
+    // country_info: prefer the local dataset, saves one request per image
+    if (!online_country_info && fs::exists(country_data_path)) {
+      adapters.push_back(
+          std::make_unique<regeocode::LocalCountryInfoAdapter>(
+              country_data_path));
+    } else {
+      adapters.push_back(std::make_unique<regeocode::CountryInfoAdapter>());
+    }
     adapters.push_back(std::make_unique<regeocode::GeoNamesTimezoneAdapter>());
     adapters.push_back(std::make_unique<regeocode::GeoNamesWikipediaAdapter>());
     adapters.push_back(std::make_unique<regeocode::OpenWeatherAdapter>());
@@ -609,7 +663,7 @@ int main(int argc, char **argv) {
     adapters.push_back(std::make_unique<regeocode::TidesAdapter>());
     adapters.push_back(std::make_unique<regeocode::SeaWeatherAdapter>());
 
-    auto client = std::make_unique<regeocode::HttpClient>();
+    auto client = std::make_unique<regeocode::HttpClient>(config_result.http);
 
     regeocode::ReverseGeocoder geocoder(std::move(config_result.apis),
                                         std::move(adapters), std::move(client),
@@ -630,7 +684,7 @@ int main(int argc, char **argv) {
                                  : std::optional<std::string>(copyright_text);
       process_folder(fs::path(folder_path), recursive, geocoder,
                      priority_list, lang_override, cp_opt, rename_mode);
-      return 0;
+      return STOP.stop_requested() ? 130 : 0;
     }
 
     // Batch demo
@@ -643,8 +697,8 @@ int main(int argc, char **argv) {
           {48.2082, 16.3738}, // Vienna
           {40.7128, -74.0060} // New York
       };
-      auto results = geocoder.batch_reverse_geocode(batch_inputs, priority_list,
-                                                    lang_override);
+      auto results = geocoder.batch_reverse_geocode(
+          batch_inputs, priority_list, lang_override, STOP.get_token());
       nlohmann::json batch_output = results;
       std::cout << batch_output.dump(4) << std::endl;
       return 0;
@@ -656,9 +710,12 @@ int main(int argc, char **argv) {
       return 1;
     }
     nlohmann::json result = geocoder.reverse_geocode_fallback(
-        {lat, lon}, priority_list, lang_override);
+        {lat, lon}, priority_list, lang_override, STOP.get_token());
     std::cout << result.dump(4) << std::endl;
 
+  } catch (const regeocode::LookupCancelled &e) {
+    std::cerr << e.what() << std::endl;
+    return 130;
   } catch (const std::exception &e) {
     std::cerr << "Fatal Error: " << e.what() << std::endl;
     return 1;
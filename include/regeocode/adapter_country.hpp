@@ -19,18 +19,36 @@
 #pragma once
 
 #include <nlohmann/json.hpp>
+#include <optional>
 #include <string>
 #include <string_view>
 #include <unordered_map>
+#include <vector>
 
 namespace regeocode {
 
+/**
+ * @brief Country details held by the CountryAdapter.
+ */
+struct CountryRecord {
+  std::string cca2;          ///< ISO 3166-1 alpha-2 code (upper case).
+  std::string name_common;   ///< Common name.
+  std::string name_official; ///< Official name.
+  std::string capital;       ///< First capital, empty if none.
+  std::string region;        ///< Region (e.g. "Europe").
+  std::string flag;          ///< Flag emoji.
+  std::string flag_url;      ///< URL of the SVG flag.
+};
+
 /**
  * @class CountryAdapter
  * @brief Provides access to country information stored in a local JSON file.
  *
  * This adapter allows querying country details such as common name, official name,
- * capital, region, and flag using an ISO 3166-1 alpha-2 country code.
+ * capital, region, and flag using an ISO 3166-1 country code. Records are
+ * stored by their ordinal in country_index::kCountries, so a lookup is a
+ * direct table access without hashing or allocation. Codes the static index
+ * does not know are kept in a hash map and found by their alpha-2 code.
  */
 class CountryAdapter {
 public:
@@ -44,7 +62,7 @@ public:
   /**
    * @brief Retrieves country details for a given country code.
    *
-   * @param country_code ISO 3166-1 alpha-2 country code (e.g., "de", "cn").
+   * @param country_code ISO 3166-1 country code (e.g., "de", "cn", "DEU").
    * @return nlohmann::json A JSON object containing the requested country details:
    *         - name.common
    *         - name.official
@@ -56,8 +74,28 @@ public:
   [[nodiscard]] nlohmann::json
   get_country(std::string_view country_code) const;
 
+  /**
+   * @brief Finds the record for a given country code without allocating.
+   *
+   * @param country_code ISO 3166-1 alpha-2, alpha-3 or numeric code, in any
+   *        letter case (e.g., "de", "DEU", "276").
+   * @return const CountryRecord* The record, or nullptr if not found.
+   */
+  [[nodiscard]] const CountryRecord *
+  find(std::string_view country_code) const noexcept;
+
 private:
-  std::unordered_map<std::string, nlohmann::json> indexed_data_;
+  struct CodeHash {
+    using is_transparent = void;
+    std::size_t operator()(std::string_view s) const noexcept {
+      return std::hash<std::string_view>{}(s);
+    }
+  };
+
+  std::vector<std::optional<CountryRecord>> records_;
+  /// Records whose code is not in country_index, keyed by upper-case code.
+  std::unordered_map<std::string, CountryRecord, CodeHash, std::equal_to<>>
+      unindexed_;
 };
 
 } // namespace regeocode
@@ -0,0 +1,62 @@
+/**
+ * SPDX-FileComment: Header file for the local Country Info adapter.
+ * SPDX-FileType: SOURCE
+ * SPDX-FileContributor: ZHENG Robert
+ * SPDX-FileCopyrightText: 2026 ZHENG Robert
+ * SPDX-License-Identifier: MIT
+ *
+ * @file adapter_country_info_local.hpp
+ * @brief Country Info adapter answering from data/countries.json.
+ * @version 0.1.0
+ * @date 2026-10-19
+ *
+ * @author ZHENG Robert
+ * @license MIT License
+ */
+
+#pragma once
+
+#include "adapter_country_info.hpp"
+
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace regeocode {
+
+/**
+ * @brief Country Info adapter that prefers the local dataset over the network.
+ *
+ * Registered under the same name as CountryInfoAdapter ("country_info") and
+ * produces the same attribute set (cca2, cca3, capital, region, subregion,
+ * continents, name_official, name_common, currencies, flag_png, flag_svg,
+ * flag_alt) from data/countries.json. Codes missing from the dataset fall
+ * back to the configured RestCountries request.
+ *
+ * The dataset has no "continents", "flags" or "maps" fields: continents are
+ * derived from region/subregion, flag URLs follow the flagcdn.com scheme used
+ * by RestCountries, flag_alt stays empty and maps_osm is omitted.
+ */
+class LocalCountryInfoAdapter : public CountryInfoAdapter {
+public:
+  /**
+   * @brief Loads the countries dataset.
+   * @param json_path The filesystem path to data/countries.json.
+   * @throws std::runtime_error if the file cannot be opened or parsed.
+   */
+  explicit LocalCountryInfoAdapter(const std::string &json_path);
+
+  /**
+   * @brief Answers the request from the local dataset.
+   * @param request The request; only country_code is used.
+   * @return std::optional<AddressResult> The result, or std::nullopt if the
+   *         country code is not in the dataset.
+   */
+  std::optional<AddressResult>
+  resolve_local(const LocalRequest &request) const override;
+
+private:
+  std::vector<std::optional<AddressResult>> records_;
+};
+
+} // namespace regeocode
@@ -41,7 +41,7 @@ public:
    * @return AddressResult The parsed address result (containing Wikipedia
    * info).
    */
-  AddressResult parse_response(const std::string &response_body) const override;
+  AddressResult parse_response(std::string_view response_body) const override;
 };
 
 } // namespace regeocode
\ No newline at end of file
@@ -36,7 +36,7 @@ public:
    * @param response_body The raw JSON response string.
    * @return AddressResult The parsed address result.
    */
-  AddressResult parse_response(const std::string &response_body) const override;
+  AddressResult parse_response(std::string_view response_body) const override;
 };
 
 } // namespace regeocode
\ No newline at end of file
@@ -16,9 +16,12 @@
 
 #pragma once
 
-#include <map>
+#include "regeocode/attribute_map.hpp"
+
 #include <memory>
+#include <optional>
 #include <string>
+#include <string_view>
 
 namespace regeocode {
 
@@ -28,9 +31,19 @@ namespace regeocode {
 struct AddressResult {
   std::string address_english; ///< Address in English.
   std::string address_local;   ///< Address in local language.
-  std::string raw_json;        ///< Raw JSON response from the API.
+  std::string raw_json;        ///< Raw JSON response (only with raw-json).
   std::string country_code;    ///< ISO country code.
-  std::map<std::string, std::string> attributes; ///< Additional attributes.
+  AttributeMap attributes;     ///< Additional attributes.
+};
+
+/**
+ * @brief Request parameters handed to adapters that can answer locally.
+ */
+struct LocalRequest {
+  double latitude{};              ///< Latitude.
+  double longitude{};             ///< Longitude.
+  std::string_view country_code;  ///< Country code (from coords or API-Key).
+  std::string_view language_code; ///< Requested language.
 };
 
 /**
@@ -51,11 +64,33 @@ public:
 
   /**
    * @brief Parses the JSON response from the API.
-   * @param response_body The raw JSON response string.
+   *
+   * The body is borrowed, not copied: the view is only valid for the
+   * duration of the call, so everything kept in the result must be copied
+   * out of it.
+   *
+   * @param response_body The raw JSON response.
    * @return AddressResult The parsed address result.
    */
   virtual AddressResult
-  parse_response(const std::string &response_body) const = 0;
+  parse_response(std::string_view response_body) const = 0;
+
+  /**
+   * @brief Answers a request from local data, without an HTTP round-trip.
+   *
+   * The default implementation has no local data. If an adapter returns a
+   * result here, the ReverseGeocoder neither sends a request nor consumes
+   * quota for it.
+   *
+   * @param request The request parameters.
+   * @return std::optional<AddressResult> The result, or std::nullopt to fall
+   *         back to the network.
+   */
+  virtual std::optional<AddressResult>
+  resolve_local(const LocalRequest &request) const {
+    (void)request;
+    return std::nullopt;
+  }
 };
 
 using ApiAdapterPtr = std::unique_ptr<ApiAdapter>;
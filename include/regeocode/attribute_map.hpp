@@ -0,0 +1,273 @@
+/**
+ * SPDX-FileComment: Header file for the flat attribute container.
+ * SPDX-FileType: SOURCE
+ * SPDX-FileContributor: ZHENG Robert
+ * SPDX-FileCopyrightText: 2026 ZHENG Robert
+ * SPDX-License-Identifier: MIT
+ *
+ * @file attribute_map.hpp
+ * @brief Sorted, allocation-light string map for AddressResult attributes.
+ * @version 0.1.0
+ * @date 2026-10-19
+ *
+ * @author ZHENG Robert
+ * @license MIT License
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <map>
+#include <nlohmann/json_fwd.hpp>
+#include <optional>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace regeocode {
+
+/// Most distinct attribute names interned process-wide.
+inline constexpr std::size_t kMaxInternedAttributeKeys = 4096;
+
+/**
+ * @brief Interns an attribute name process-wide.
+ *
+ * Attribute names come from a small, fixed vocabulary per provider, so each
+ * distinct name is stored once and shared by every result. Providers that
+ * echo arbitrary field names cannot grow the pool past
+ * kMaxInternedAttributeKeys; later names are kept by each map instead. Each
+ * thread caches the names it has seen, so only the first lookup of a name
+ * per thread takes the pool lock.
+ *
+ * @param key The attribute name.
+ * @return A view that stays valid for the program lifetime, or std::nullopt
+ *         if @p key is new and the pool is full.
+ */
+std::optional<std::string_view> intern_attribute_key(std::string_view key);
+
+/**
+ * @brief String-to-string map with the lookup API of std::map.
+ *
+ * Entries live in one vector sorted by key; keys are interned and values
+ * are appended to a single per-map character buffer (as are keys the full
+ * intern pool turns away). Filling a map with a few dozen attributes
+ * therefore costs a handful of allocations instead of one node plus two
+ * strings per entry. Bytes left behind by erased or regrown values are
+ * reclaimed once they outweigh the live ones; copies take live bytes only.
+ *
+ * Views handed out by lookups or iteration are invalidated by the next
+ * modification of the map, like iterators of a std::vector.
+ */
+class AttributeMap {
+  struct Entry {
+    const char *pooled = nullptr; ///< Interned key, or null if in values_.
+    std::uint32_t key_offset = 0; ///< Key start in values_ if not pooled.
+    std::uint32_t key_length = 0; ///< Key length.
+    std::uint32_t offset = 0;     ///< Value start in values_.
+    std::uint32_t length = 0;     ///< Value length.
+  };
+
+public:
+  using key_type = std::string_view;
+  using mapped_type = std::string_view;
+  using value_type = std::pair<std::string_view, std::string_view>;
+  using size_type = std::size_t;
+
+  class const_iterator;
+
+  /**
+   * @brief Assignable reference to one value, returned by operator[].
+   */
+  class reference {
+  public:
+    /// Replaces the value.
+    reference &operator=(std::string_view value) {
+      map_->assign(map_->locate(pooled_, key(), index_), value);
+      return *this;
+    }
+    /// Replaces the value with the value of @p other.
+    reference &operator=(const reference &other) {
+      return *this = other.view();
+    }
+    /// The current value.
+    std::string_view view() const noexcept {
+      return map_->value_at(map_->locate(pooled_, key(), index_));
+    }
+    operator std::string_view() const noexcept { return view(); }
+    operator std::string() const { return std::string(view()); }
+    /// Whether the value is empty.
+    bool empty() const noexcept { return view().empty(); }
+
+    friend bool operator==(const reference &a, std::string_view b) noexcept {
+      return a.view() == b;
+    }
+    friend std::ostream &operator<<(std::ostream &os, const reference &r) {
+      return os << r.view();
+    }
+
+  private:
+    friend class AttributeMap;
+    reference(AttributeMap *map, const Entry &entry, std::size_t index)
+        : map_(map), pooled_(entry.pooled), length_(entry.key_length),
+          index_(index) {
+      // Keys kept by the map move when it compacts, so hold a copy
+      if (!pooled_)
+        spilled_ = map->key_of(entry);
+    }
+    std::string_view key() const noexcept {
+      return pooled_ ? std::string_view(pooled_, length_) : spilled_;
+    }
+
+    AttributeMap *map_;
+    const char *pooled_; // interned key, or null for spilled_
+    std::uint32_t length_;
+    std::string spilled_;
+    std::size_t index_; // position when created; rechecked on access
+  };
+
+  AttributeMap() = default;
+  /// Copies the entries; the copy holds no dead bytes.
+  AttributeMap(const AttributeMap &other);
+  AttributeMap &operator=(const AttributeMap &other);
+  /// Leaves @p other empty.
+  AttributeMap(AttributeMap &&other) noexcept;
+  AttributeMap &operator=(AttributeMap &&other) noexcept;
+
+  /**
+   * @brief Returns the value for @p key, inserting an empty one if missing.
+   *
+   * Unlike std::map this returns a proxy, not a std::string&: assign to it,
+   * compare it or convert it, but do not bind a std::string& to it or
+   * append to it in place.
+   */
+  reference operator[](std::string_view key);
+
+  /**
+   * @brief Returns the value for @p key.
+   * @throws std::out_of_range if the key is missing.
+   */
+  std::string_view at(std::string_view key) const;
+
+  /**
+   * @brief Iterator to the entry for @p key, or end().
+   */
+  const_iterator find(std::string_view key) const noexcept;
+
+  /// Whether @p key is present.
+  bool contains(std::string_view key) const noexcept;
+  /// 1 if @p key is present, else 0.
+  size_type count(std::string_view key) const noexcept {
+    return contains(key) ? 1 : 0;
+  }
+  /// Removes @p key; returns the number of removed entries.
+  size_type erase(std::string_view key);
+
+  /// Number of entries.
+  size_type size() const noexcept { return entries_.size(); }
+  /// Whether the map is empty.
+  bool empty() const noexcept { return entries_.empty(); }
+  /// Removes all entries.
+  void clear() noexcept;
+  /// Bytes held for values and map-kept keys, dead ones included.
+  std::size_t buffer_size() const noexcept { return values_.size(); }
+
+  const_iterator begin() const noexcept;
+  const_iterator end() const noexcept;
+
+  /// Copies the entries into a std::map.
+  std::map<std::string, std::string> to_map() const;
+
+  bool operator==(const AttributeMap &other) const;
+
+private:
+  std::string_view key_of(const Entry &e) const noexcept {
+    return {e.pooled ? e.pooled : values_.data() + e.key_offset, e.key_length};
+  }
+  std::size_t lower_bound(std::string_view key) const noexcept;
+  /// Position of @p key (interned as @p pooled, or null), trying @p hint
+  /// first (inserts and erases shift positions).
+  std::size_t locate(const char *pooled, std::string_view key,
+                     std::size_t hint) const noexcept {
+    if (hint < entries_.size() &&
+        (pooled ? entries_[hint].pooled == pooled
+                : !entries_[hint].pooled && key_of(entries_[hint]) == key))
+      return hint;
+    return lower_bound(key);
+  }
+  std::string_view value_at(std::size_t index) const noexcept {
+    const Entry &e = entries_[index];
+    return {values_.data() + e.offset, e.length};
+  }
+  void assign(std::size_t index, std::string_view value);
+  /// Appends @p bytes, which may point into values_; returns their offset.
+  std::uint32_t append(std::string_view bytes);
+  /// Rebuilds values_ from the live bytes of entries_ in @p source.
+  void pack(std::string_view source);
+  /// Packs values_ once dead bytes outweigh live ones.
+  void reclaim();
+
+  std::vector<Entry> entries_; // sorted by key
+  std::string values_;         // value arena
+  std::size_t dead_ = 0;       // bytes of values_ no entry uses
+};
+
+/**
+ * @brief Forward iterator over (key, value) views in key order.
+ */
+class AttributeMap::const_iterator {
+public:
+  using iterator_category = std::forward_iterator_tag;
+  using value_type = AttributeMap::value_type;
+  using difference_type = std::ptrdiff_t;
+  using reference = value_type;
+
+  /// Holds the pair for operator->.
+  struct pointer {
+    value_type value;
+    const value_type *operator->() const noexcept { return &value; }
+  };
+
+  const_iterator() = default;
+
+  value_type operator*() const noexcept {
+    return {map_->key_of(map_->entries_[index_]), map_->value_at(index_)};
+  }
+  pointer operator->() const noexcept { return {**this}; }
+  const_iterator &operator++() noexcept {
+    ++index_;
+    return *this;
+  }
+  const_iterator operator++(int) noexcept {
+    const_iterator tmp = *this;
+    ++index_;
+    return tmp;
+  }
+  bool operator==(const const_iterator &other) const noexcept = default;
+
+private:
+  friend class AttributeMap;
+  const_iterator(const AttributeMap *map, std::size_t index) noexcept
+      : map_(map), index_(index) {}
+
+  const AttributeMap *map_ = nullptr;
+  std::size_t index_ = 0;
+};
+
+inline AttributeMap::const_iterator AttributeMap::begin() const noexcept {
+  return {this, 0};
+}
+
+inline AttributeMap::const_iterator AttributeMap::end() const noexcept {
+  return {this, entries_.size()};
+}
+
+/**
+ * @brief Converts the attributes to a JSON object (used by nlohmann::json).
+ */
+void to_json(nlohmann::json &j, const AttributeMap &attributes);
+
+} // namespace regeocode
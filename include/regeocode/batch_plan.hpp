@@ -0,0 +1,75 @@
+/**
+ * SPDX-FileComment: Header file for batch planning.
+ * SPDX-FileType: SOURCE
+ * SPDX-FileContributor: ZHENG Robert
+ * SPDX-FileCopyrightText: 2026 ZHENG Robert
+ * SPDX-License-Identifier: MIT
+ *
+ * @file batch_plan.hpp
+ * @brief Deduplicates the coordinates of a batch on a metric grid, groups
+ *        them by spatial cell, and fans the answers back out (see
+ *        BatchOptions).
+ * @version 0.1.0
+ * @date 2026-10-19
+ *
+ * @author ZHENG Robert
+ * @license MIT License
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <span>
+#include <utility>
+#include <vector>
+
+#include "regeocode/re_geocode_core.hpp"
+
+namespace regeocode {
+
+/**
+ * @brief Dispatch plan of one batch: the unique points, their groups, and
+ * which unique point answers each input point.
+ */
+class BatchPlan {
+public:
+  BatchPlan(std::span<const Coordinates> coords, const BatchOptions &options);
+
+  /// Points to look up, grouped by cell; each is the first input point of
+  /// its grid cell.
+  const std::vector<Coordinates> &unique() const noexcept { return unique_; }
+
+  /// Offsets into unique() where each group starts, plus unique().size().
+  const std::vector<std::size_t> &group_starts() const noexcept {
+    return group_starts_;
+  }
+
+  /// Index into unique() answering input point @p i.
+  std::size_t source(std::size_t i) const noexcept { return source_[i]; }
+
+  /**
+   * @brief Results in input order from @p results, one per unique point;
+   * merged points receive copies.
+   */
+  template <typename T>
+  std::vector<T> fan_out(std::vector<T> results) const {
+    std::vector<T> out;
+    out.reserve(source_.size());
+    std::vector<std::size_t> remaining(results.size(), 0);
+    for (const std::size_t s : source_)
+      ++remaining[s];
+    // The last input point using a result takes it over
+    for (const std::size_t s : source_)
+      out.push_back(--remaining[s] == 0 ? std::move(results[s]) : results[s]);
+    return out;
+  }
+
+  BatchReport report() const noexcept;
+
+private:
+  std::vector<Coordinates> unique_;
+  std::vector<std::size_t> group_starts_;
+  std::vector<std::size_t> source_;
+};
+
+} // namespace regeocode
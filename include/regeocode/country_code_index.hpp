@@ -0,0 +1,278 @@
+/**
+ * SPDX-FileComment: Header file for the ISO 3166-1 country code index.
+ * SPDX-FileType: SOURCE
+ * SPDX-FileContributor: ZHENG Robert
+ * SPDX-FileCopyrightText: 2026 ZHENG Robert
+ * SPDX-License-Identifier: MIT
+ *
+ * @file country_code_index.hpp
+ * @brief Constant-time, allocation-free lookup of ISO 3166-1 country codes.
+ * @version 0.1.0
+ * @date 2026-10-19
+ *
+ * @author ZHENG Robert
+ * @license MIT License
+ */
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+#include <utility>
+
+namespace regeocode::country_index {
+
+/**
+ * @brief One ISO 3166-1 entry (alpha-2, alpha-3 and numeric code).
+ */
+struct CountryCode {
+  std::string_view alpha2; ///< ISO 3166-1 alpha-2 code (upper case).
+  std::string_view alpha3; ///< ISO 3166-1 alpha-3 code (upper case).
+  std::uint16_t numeric;   ///< ISO 3166-1 numeric code (0 = none, e.g. XK).
+};
+
+/**
+ * @brief All known countries, sorted by alpha-2 code.
+ *
+ * Generated from data/countries.json (cca2, cca3, ccn3). The position of an
+ * entry is its ordinal, which is what the lookup functions return.
+ */
+inline constexpr std::array<CountryCode, 250> kCountries = {{
+    {"AD", "AND", 20}, {"AE", "ARE", 784}, {"AF", "AFG", 4}, {"AG", "ATG", 28},
+    {"AI", "AIA", 660}, {"AL", "ALB", 8}, {"AM", "ARM", 51}, {"AO", "AGO", 24},
+    {"AQ", "ATA", 10}, {"AR", "ARG", 32}, {"AS", "ASM", 16}, {"AT", "AUT", 40},
+    {"AU", "AUS", 36}, {"AW", "ABW", 533}, {"AX", "ALA", 248}, {"AZ", "AZE", 31},
+    {"BA", "BIH", 70}, {"BB", "BRB", 52}, {"BD", "BGD", 50}, {"BE", "BEL", 56},
+    {"BF", "BFA", 854}, {"BG", "BGR", 100}, {"BH", "BHR", 48}, {"BI", "BDI", 108},
+    {"BJ", "BEN", 204}, {"BL", "BLM", 652}, {"BM", "BMU", 60}, {"BN", "BRN", 96},
+    {"BO", "BOL", 68}, {"BQ", "BES", 535}, {"BR", "BRA", 76}, {"BS", "BHS", 44},
+    {"BT", "BTN", 64}, {"BV", "BVT", 74}, {"BW", "BWA", 72}, {"BY", "BLR", 112},
+    {"BZ", "BLZ", 84}, {"CA", "CAN", 124}, {"CC", "CCK", 166}, {"CD", "COD", 180},
+    {"CF", "CAF", 140}, {"CG", "COG", 178}, {"CH", "CHE", 756}, {"CI", "CIV", 384},
+    {"CK", "COK", 184}, {"CL", "CHL", 152}, {"CM", "CMR", 120}, {"CN", "CHN", 156},
+    {"CO", "COL", 170}, {"CR", "CRI", 188}, {"CU", "CUB", 192}, {"CV", "CPV", 132},
+    {"CW", "CUW", 531}, {"CX", "CXR", 162}, {"CY", "CYP", 196}, {"CZ", "CZE", 203},
+    {"DE", "DEU", 276}, {"DJ", "DJI", 262}, {"DK", "DNK", 208}, {"DM", "DMA", 212},
+    {"DO", "DOM", 214}, {"DZ", "DZA", 12}, {"EC", "ECU", 218}, {"EE", "EST", 233},
+    {"EG", "EGY", 818}, {"EH", "ESH", 732}, {"ER", "ERI", 232}, {"ES", "ESP", 724},
+    {"ET", "ETH", 231}, {"FI", "FIN", 246}, {"FJ", "FJI", 242}, {"FK", "FLK", 238},
+    {"FM", "FSM", 583}, {"FO", "FRO", 234}, {"FR", "FRA", 250}, {"GA", "GAB", 266},
+    {"GB", "GBR", 826}, {"GD", "GRD", 308}, {"GE", "GEO", 268}, {"GF", "GUF", 254},
+    {"GG", "GGY", 831}, {"GH", "GHA", 288}, {"GI", "GIB", 292}, {"GL", "GRL", 304},
+    {"GM", "GMB", 270}, {"GN", "GIN", 324}, {"GP", "GLP", 312}, {"GQ", "GNQ", 226},
+    {"GR", "GRC", 300}, {"GS", "SGS", 239}, {"GT", "GTM", 320}, {"GU", "GUM", 316},
+    {"GW", "GNB", 624}, {"GY", "GUY", 328}, {"HK", "HKG", 344}, {"HM", "HMD", 334},
+    {"HN", "HND", 340}, {"HR", "HRV", 191}, {"HT", "HTI", 332}, {"HU", "HUN", 348},
+    {"ID", "IDN", 360}, {"IE", "IRL", 372}, {"IL", "ISR", 376}, {"IM", "IMN", 833},
+    {"IN", "IND", 356}, {"IO", "IOT", 86}, {"IQ", "IRQ", 368}, {"IR", "IRN", 364},
+    {"IS", "ISL", 352}, {"IT", "ITA", 380}, {"JE", "JEY", 832}, {"JM", "JAM", 388},
+    {"JO", "JOR", 400}, {"JP", "JPN", 392}, {"KE", "KEN", 404}, {"KG", "KGZ", 417},
+    {"KH", "KHM", 116}, {"KI", "KIR", 296}, {"KM", "COM", 174}, {"KN", "KNA", 659},
+    {"KP", "PRK", 408}, {"KR", "KOR", 410}, {"KW", "KWT", 414}, {"KY", "CYM", 136},
+    {"KZ", "KAZ", 398}, {"LA", "LAO", 418}, {"LB", "LBN", 422}, {"LC", "LCA", 662},
+    {"LI", "LIE", 438}, {"LK", "LKA", 144}, {"LR", "LBR", 430}, {"LS", "LSO", 426},
+    {"LT", "LTU", 440}, {"LU", "LUX", 442}, {"LV", "LVA", 428}, {"LY", "LBY", 434},
+    {"MA", "MAR", 504}, {"MC", "MCO", 492}, {"MD", "MDA", 498}, {"ME", "MNE", 499},
+    {"MF", "MAF", 663}, {"MG", "MDG", 450}, {"MH", "MHL", 584}, {"MK", "MKD", 807},
+    {"ML", "MLI", 466}, {"MM", "MMR", 104}, {"MN", "MNG", 496}, {"MO", "MAC", 446},
+    {"MP", "MNP", 580}, {"MQ", "MTQ", 474}, {"MR", "MRT", 478}, {"MS", "MSR", 500},
+    {"MT", "MLT", 470}, {"MU", "MUS", 480}, {"MV", "MDV", 462}, {"MW", "MWI", 454},
+    {"MX", "MEX", 484}, {"MY", "MYS", 458}, {"MZ", "MOZ", 508}, {"NA", "NAM", 516},
+    {"NC", "NCL", 540}, {"NE", "NER", 562}, {"NF", "NFK", 574}, {"NG", "NGA", 566},
+    {"NI", "NIC", 558}, {"NL", "NLD", 528}, {"NO", "NOR", 578}, {"NP", "NPL", 524},
+    {"NR", "NRU", 520}, {"NU", "NIU", 570}, {"NZ", "NZL", 554}, {"OM", "OMN", 512},
+    {"PA", "PAN", 591}, {"PE", "PER", 604}, {"PF", "PYF", 258}, {"PG", "PNG", 598},
+    {"PH", "PHL", 608}, {"PK", "PAK", 586}, {"PL", "POL", 616}, {"PM", "SPM", 666},
+    {"PN", "PCN", 612}, {"PR", "PRI", 630}, {"PS", "PSE", 275}, {"PT", "PRT", 620},
+    {"PW", "PLW", 585}, {"PY", "PRY", 600}, {"QA", "QAT", 634}, {"RE", "REU", 638},
+    {"RO", "ROU", 642}, {"RS", "SRB", 688}, {"RU", "RUS", 643}, {"RW", "RWA", 646},
+    {"SA", "SAU", 682}, {"SB", "SLB", 90}, {"SC", "SYC", 690}, {"SD", "SDN", 729},
+    {"SE", "SWE", 752}, {"SG", "SGP", 702}, {"SH", "SHN", 654}, {"SI", "SVN", 705},
+    {"SJ", "SJM", 744}, {"SK", "SVK", 703}, {"SL", "SLE", 694}, {"SM", "SMR", 674},
+    {"SN", "SEN", 686}, {"SO", "SOM", 706}, {"SR", "SUR", 740}, {"SS", "SSD", 728},
+    {"ST", "STP", 678}, {"SV", "SLV", 222}, {"SX", "SXM", 534}, {"SY", "SYR", 760},
+    {"SZ", "SWZ", 748}, {"TC", "TCA", 796}, {"TD", "TCD", 148}, {"TF", "ATF", 260},
+    {"TG", "TGO", 768}, {"TH", "THA", 764}, {"TJ", "TJK", 762}, {"TK", "TKL", 772},
+    {"TL", "TLS", 626}, {"TM", "TKM", 795}, {"TN", "TUN", 788}, {"TO", "TON", 776},
+    {"TR", "TUR", 792}, {"TT", "TTO", 780}, {"TV", "TUV", 798}, {"TW", "TWN", 158},
+    {"TZ", "TZA", 834}, {"UA", "UKR", 804}, {"UG", "UGA", 800}, {"UM", "UMI", 581},
+    {"US", "USA", 840}, {"UY", "URY", 858}, {"UZ", "UZB", 860}, {"VA", "VAT", 336},
+    {"VC", "VCT", 670}, {"VE", "VEN", 862}, {"VG", "VGB", 92}, {"VI", "VIR", 850},
+    {"VN", "VNM", 704}, {"VU", "VUT", 548}, {"WF", "WLF", 876}, {"WS", "WSM", 882},
+    {"XK", "UNK", 0}, {"YE", "YEM", 887}, {"YT", "MYT", 175}, {"ZA", "ZAF", 710},
+    {"ZM", "ZMB", 894}, {"ZW", "ZWE", 716},
+}};
+
+/// Number of entries in kCountries.
+inline constexpr std::size_t kCountryCount = kCountries.size();
+
+namespace detail {
+
+/// Maps an ASCII letter (either case) to 0..25, anything else to -1.
+constexpr int letter(char c) noexcept {
+  if (c >= 'A' && c <= 'Z')
+    return c - 'A';
+  if (c >= 'a' && c <= 'z')
+    return c - 'a';
+  return -1;
+}
+
+constexpr int digit(char c) noexcept {
+  return (c >= '0' && c <= '9') ? c - '0' : -1;
+}
+
+constexpr int alpha2_slot(std::string_view code) noexcept {
+  if (code.size() != 2)
+    return -1;
+  const int a = letter(code[0]);
+  const int b = letter(code[1]);
+  if (a < 0 || b < 0)
+    return -1;
+  return a * 26 + b;
+}
+
+constexpr int alpha3_slot(std::string_view code) noexcept {
+  if (code.size() != 3)
+    return -1;
+  const int a = letter(code[0]);
+  const int b = letter(code[1]);
+  const int c = letter(code[2]);
+  if (a < 0 || b < 0 || c < 0)
+    return -1;
+  return (a * 26 + b) * 26 + c;
+}
+
+// Tables store ordinal + 1, so that 0 means "no such country".
+
+inline constexpr auto kAlpha2Table = [] {
+  std::array<std::uint16_t, 26 * 26> table{};
+  for (std::size_t i = 0; i < kCountryCount; ++i)
+    table[alpha2_slot(kCountries[i].alpha2)] =
+        static_cast<std::uint16_t>(i + 1);
+  return table;
+}();
+
+inline constexpr auto kAlpha3Table = [] {
+  std::array<std::uint16_t, 26 * 26 * 26> table{};
+  for (std::size_t i = 0; i < kCountryCount; ++i)
+    table[alpha3_slot(kCountries[i].alpha3)] =
+        static_cast<std::uint16_t>(i + 1);
+  return table;
+}();
+
+inline constexpr auto kNumericTable = [] {
+  std::array<std::uint16_t, 1000> table{};
+  for (std::size_t i = 0; i < kCountryCount; ++i)
+    if (kCountries[i].numeric != 0)
+      table[kCountries[i].numeric] = static_cast<std::uint16_t>(i + 1);
+  return table;
+}();
+
+constexpr std::optional<std::size_t> to_ordinal(std::uint16_t v) noexcept {
+  if (v == 0)
+    return std::nullopt;
+  return static_cast<std::size_t>(v - 1);
+}
+
+} // namespace detail
+
+/**
+ * @brief Looks up an alpha-2 code ("de", "CN", ...), case-insensitive.
+ * @param code The two-letter code.
+ * @return The ordinal into kCountries, or std::nullopt if unknown.
+ */
+constexpr std::optional<std::size_t>
+find_alpha2(std::string_view code) noexcept {
+  const int slot = detail::alpha2_slot(code);
+  if (slot < 0)
+    return std::nullopt;
+  return detail::to_ordinal(detail::kAlpha2Table[slot]);
+}
+
+/**
+ * @brief Looks up an alpha-3 code ("deu", "CHN", ...), case-insensitive.
+ * @param code The three-letter code.
+ * @return The ordinal into kCountries, or std::nullopt if unknown.
+ */
+constexpr std::optional<std::size_t>
+find_alpha3(std::string_view code) noexcept {
+  const int slot = detail::alpha3_slot(code);
+  if (slot < 0)
+    return std::nullopt;
+  return detail::to_ordinal(detail::kAlpha3Table[slot]);
+}
+
+/**
+ * @brief Looks up a numeric code (276, 156, ...).
+ * @param code The numeric code.
+ * @return The ordinal into kCountries, or std::nullopt if unknown.
+ */
+constexpr std::optional<std::size_t> find_numeric(int code) noexcept {
+  if (code <= 0 || code >= 1000)
+    return std::nullopt;
+  return detail::to_ordinal(detail::kNumericTable[code]);
+}
+
+/**
+ * @brief Looks up any ISO 3166-1 code form.
+ *
+ * Two letters are treated as alpha-2, three letters as alpha-3 and one to
+ * three digits ("276", "040") as numeric.
+ *
+ * @param code The code to look up.
+ * @return The ordinal into kCountries, or std::nullopt if unknown.
+ */
+constexpr std::optional<std::size_t> find(std::string_view code) noexcept {
+  if (!code.empty() && code.size() <= 3 && detail::digit(code[0]) >= 0) {
+    int value = 0;
+    for (char c : code) {
+      const int d = detail::digit(c);
+      if (d < 0)
+        return std::nullopt;
+      value = value * 10 + d;
+    }
+    return find_numeric(value);
+  }
+  if (code.size() == 2)
+    return find_alpha2(code);
+  if (code.size() == 3)
+    return find_alpha3(code);
+  return std::nullopt;
+}
+
+namespace detail {
+// Local language per country, indexed by ordinal; "en" where none is known.
+inline constexpr auto kLanguageTable = [] {
+  std::array<std::string_view, kCountryCount> table{};
+  table.fill("en");
+  constexpr std::pair<std::string_view, std::string_view> overrides[] = {
+      {"de", "de"}, {"at", "de"}, {"ch", "de"},    {"ae", "ar"},
+      {"sa", "ar"}, {"eg", "ar"}, {"cn", "zh-CN"}, {"tw", "zh-TW"},
+      {"jp", "ja"}, {"kr", "ko"}, {"fr", "fr"},    {"es", "es"},
+      {"it", "it"}, {"ru", "ru"}, {"pt", "pt"},    {"nl", "nl"}};
+  for (const auto &[cc, lang] : overrides)
+    table[*find_alpha2(cc)] = lang;
+  return table;
+}();
+} // namespace detail
+
+/**
+ * @brief Language used for local-language lookups in a country.
+ * @param alpha2 The two-letter code, case-insensitive.
+ * @return The language tag, "en" for unknown codes.
+ */
+constexpr std::string_view local_language(std::string_view alpha2) noexcept {
+  if (auto ordinal = find_alpha2(alpha2))
+    return detail::kLanguageTable[*ordinal];
+  return "en";
+}
+
+static_assert(find_alpha2("de") == find_alpha3("DEU"));
+static_assert(local_language("AT") == "de" && local_language("xx") == "en");
+static_assert(find_numeric(276) == find("de"));
+static_assert(!find_alpha2("XX").has_value());
+
+} // namespace regeocode::country_index
@@ -0,0 +1,150 @@
+/**
+ * SPDX-FileComment: Header file for the HTTP response cache.
+ * SPDX-FileType: SOURCE
+ * SPDX-FileContributor: ZHENG Robert
+ * SPDX-FileCopyrightText: 2026 ZHENG Robert
+ * SPDX-License-Identifier: MIT
+ *
+ * @file http_cache.hpp
+ * @brief In-memory HTTP cache with Cache-Control freshness and
+ *        ETag/Last-Modified revalidation.
+ * @version 0.1.0
+ * @date 2026-10-19
+ *
+ * @author ZHENG Robert
+ * @license MIT License
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+
+#include "regeocode/http_client.hpp"
+
+namespace regeocode {
+
+/**
+ * @brief A stored 200 response and what is needed to reuse it.
+ */
+struct CachedResponse {
+  std::string body;
+  std::string etag;          ///< Validator for If-None-Match.
+  std::string last_modified; ///< Validator for If-Modified-Since.
+  /// Freshness granted by the last response, renewed on a 304.
+  std::chrono::steady_clock::duration lifetime{};
+  /// Served without asking the provider until then.
+  std::chrono::steady_clock::time_point fresh_until;
+  /// How long the full fetch took; what a hit saves.
+  std::chrono::microseconds fetch_time{};
+};
+
+/**
+ * @brief How a request was answered by HttpCache::fetch().
+ */
+struct CacheOutcome {
+  enum class Kind {
+    Miss,        ///< Full response from the provider.
+    Fresh,       ///< Served from the cache without a request.
+    Revalidated  ///< Provider answered 304, body served from the cache.
+  };
+  Kind kind = Kind::Miss;
+  std::size_t saved_bytes = 0;            ///< Body bytes not transferred.
+  std::chrono::microseconds saved_time{}; ///< Latency not paid.
+};
+
+/**
+ * @brief Private HTTP cache for GET responses, keyed by URL.
+ *
+ * Follows the caching headers of each response: max-age (less Age) or
+ * Expires set the freshness, no-store keeps a response out and no-cache
+ * stores it for revalidation only. As one geocoder serves many callers,
+ * private responses are not stored either, nor are responses that Vary on
+ * a request header other than Accept-Encoding (bodies are kept decoded). Stale entries with an ETag or
+ * Last-Modified are revalidated with a conditional request; a 304 renews
+ * them without transferring the body again. Responses without freshness or
+ * validators are not stored. Bounded in bytes, least recently used entries
+ * are evicted first. Thread-safe.
+ */
+class HttpCache {
+public:
+  static constexpr std::size_t kDefaultCapacity = 16 * 1024 * 1024;
+
+  explicit HttpCache(std::size_t capacity_bytes = kDefaultCapacity);
+
+  HttpCache(const HttpCache &) = delete;
+  HttpCache &operator=(const HttpCache &) = delete;
+
+  /**
+   * @brief The stored response for @p url if it is still fresh.
+   * @return nullptr when absent or stale.
+   */
+  std::shared_ptr<const CachedResponse> fresh(const std::string &url) const;
+
+  /**
+   * @brief GET through @p client, using and updating the cache.
+   *
+   * Fresh entries are returned without a request, stale ones revalidated.
+   * The returned response always carries the full body; a 304 is reported
+   * as 200 with the cached body and Kind::Revalidated.
+   */
+  HttpResponse fetch(const HttpClient &client, const std::string &url,
+                     long timeout, HttpRequestOptions options,
+                     CacheOutcome *outcome = nullptr);
+
+  /**
+   * @brief First half of fetch(), for callers running the request
+   * themselves (e.g. with HttpClient::get_async()).
+   *
+   * @return The fresh cached response, or nullopt when a request is needed;
+   * @p options then carries the validators of the stale entry kept in
+   * @p stale, which must outlive the request.
+   */
+  std::optional<HttpResponse>
+  begin_fetch(const std::string &url, HttpRequestOptions &options,
+              std::shared_ptr<const CachedResponse> &stale,
+              CacheOutcome &outcome) const;
+
+  /**
+   * @brief Second half of fetch(): stores or renews from @p response, which
+   * took @p elapsed, and turns a 304 into the cached 200.
+   */
+  void end_fetch(const std::string &url,
+                 const std::shared_ptr<const CachedResponse> &stale,
+                 HttpResponse &response, std::chrono::microseconds elapsed,
+                 CacheOutcome &outcome);
+
+  /// Stores @p response (if cacheable) as fetched from @p url.
+  void store(const std::string &url, const HttpResponse &response,
+             std::chrono::microseconds fetch_time);
+
+  std::size_t size_bytes() const; ///< Body and validator bytes held.
+  std::size_t entries() const;    ///< Number of stored responses.
+  void clear();
+
+private:
+  struct Slot {
+    std::string url;
+    std::shared_ptr<const CachedResponse> entry;
+  };
+  using Lru = std::list<Slot>; // most recently used first
+
+  std::shared_ptr<const CachedResponse> find(const std::string &url) const;
+  void put(const std::string &url,
+           std::shared_ptr<const CachedResponse> entry);
+  static std::size_t cost(const CachedResponse &entry);
+
+  std::size_t capacity_;
+  std::size_t size_ = 0;
+  mutable Lru lru_;
+  std::unordered_map<std::string, Lru::iterator> index_;
+  mutable std::mutex mutex_;
+};
+
+} // namespace regeocode
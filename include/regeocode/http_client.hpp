@@ -16,16 +16,171 @@
 
 #pragma once
 
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <stop_token>
 #include <string>
+#include <string_view>
+
 
 namespace regeocode {
 
+/**
+ * @brief Phases of one transfer as timed by libcurl; zero when not measured
+ * or skipped (a reused connection needs no DNS, connect or TLS).
+ */
+struct HttpTimings {
+  std::chrono::microseconds dns{};      ///< Name resolution.
+  std::chrono::microseconds connect{};  ///< TCP connect.
+  std::chrono::microseconds tls{};      ///< TLS handshake.
+  std::chrono::microseconds wait{};     ///< Until the first response byte.
+  std::chrono::microseconds transfer{}; ///< Receiving the body.
+};
+
 /**
  * @brief Structure to hold HTTP response data.
  */
 struct HttpResponse {
   long status_code{}; ///< HTTP status code (e.g., 200, 404).
   std::string body;   ///< Response body content.
+  /// Body bytes as received, before content decoding (0 = not reported;
+  /// treat as body.size()).
+  std::size_t wire_bytes{};
+  /// Retry-After header of the final response, empty when absent.
+  std::string retry_after;
+  /// Caching headers of the final response, empty when absent.
+  std::string etag;
+  std::string last_modified; ///< Last-Modified
+  std::string cache_control; ///< Cache-Control
+  std::string expires;       ///< Expires
+  std::string age;           ///< Age
+  std::string vary;          ///< Vary
+  HttpTimings timings;       ///< Phases of the transfer.
+  /// Ended early through its stop token (status 599).
+  bool cancelled = false;
+};
+
+/// Receives the response of HttpClient::get_async().
+using ResponseCallback = std::function<void(HttpResponse)>;
+
+/**
+ * @brief HTTP protocol version to use for a request.
+ */
+enum class HttpVersion {
+  Auto,               ///< libcurl default: HTTP/2 over TLS via ALPN, else 1.1.
+  Http1_1,            ///< HTTP/1.1 only.
+  Http2,              ///< HTTP/2 over TLS, HTTP/1.1 for plain http://.
+  Http2PriorKnowledge ///< HTTP/2 without negotiation (h2c for http://).
+};
+
+/**
+ * @brief Parses an "http-version" INI value: auto, 1.1, 2 or
+ * 2-prior-knowledge.
+ * @throws std::invalid_argument for any other value.
+ */
+HttpVersion parse_http_version(std::string_view value);
+
+/**
+ * @brief Parses an HTTP-date in the IMF-fixdate form
+ * ("Sun, 06 Nov 1994 08:49:37 GMT").
+ * @return nullopt for malformed values.
+ */
+std::optional<std::chrono::system_clock::time_point>
+parse_http_date(std::string_view value);
+
+/**
+ * @brief Per-request transfer options.
+ */
+struct HttpRequestOptions {
+  /// Content codings to offer in Accept-Encoding: "auto" for every coding
+  /// libcurl was built with, "identity" for none, or a list such as
+  /// "gzip, br". Codings libcurl cannot decode are dropped.
+  std::string_view accept_encoding = "auto";
+  /// Protocol version to negotiate.
+  HttpVersion http_version = HttpVersion::Auto;
+  /// Validators of a cached response; sent as If-None-Match and
+  /// If-Modified-Since when not empty.
+  std::string_view if_none_match;
+  std::string_view if_modified_since;
+  /// Aborts get() when requested: the transfer ends at once on the engine,
+  /// and within about a second (libcurl's progress callback) otherwise.
+  /// get_async() takes its stop token as a parameter instead.
+  std::stop_token stop;
+};
+
+namespace detail {
+class TransferEngine;
+}
+
+/**
+ * @brief Settings of an HttpShare.
+ */
+struct HttpShareOptions {
+  bool dns = true;          ///< Share the DNS cache.
+  bool tls_sessions = true; ///< Share TLS sessions (resumption).
+  /// Connection limit per host for the shared engine (0 = unlimited).
+  long max_host_connections = 0;
+  /// Concurrent HTTP/2 streams per connection for the shared engine.
+  long max_concurrent_streams = 100;
+};
+
+/**
+ * @brief Caches shared by every HttpClient attached to it.
+ *
+ * Holds a curl share with the DNS cache and TLS session cache, and one
+ * transfer engine whose connection cache (and HTTP/2 connections) all
+ * attached multiplexing clients use. A service with many geocoder handles
+ * thus resolves, handshakes and connects once per host instead of once per
+ * handle. Thread-safe; clients keep their share alive.
+ */
+class HttpShare {
+public:
+  explicit HttpShare(const HttpShareOptions &options = {});
+  ~HttpShare();
+
+  HttpShare(const HttpShare &) = delete;
+  HttpShare &operator=(const HttpShare &) = delete;
+
+  /**
+   * @brief The process-wide share with @p options, created on first use.
+   *
+   * Callers asking for the same options get the same share. A handle
+   * configured with other engine limits gets a share (and engine) of its
+   * own, so that its limits hold.
+   */
+  static std::shared_ptr<HttpShare>
+  process(const HttpShareOptions &options = {});
+
+private:
+  friend class HttpClient;
+
+  /// The shared engine, started on first use.
+  std::shared_ptr<detail::TransferEngine> engine();
+
+  struct State;
+  std::unique_ptr<State> state_;
+};
+
+/**
+ * @brief Client-wide transfer engine settings.
+ */
+struct HttpClientOptions {
+  /// Run all transfers on one shared curl multi handle: connections are
+  /// pooled across calls and threads, and concurrent requests to an HTTP/2
+  /// host are multiplexed over one connection. When false every get()
+  /// opens its own connection.
+  bool multiplex = false;
+  /// Connection limit per host for the shared engine (0 = unlimited).
+  long max_host_connections = 0;
+  /// Concurrent HTTP/2 streams per connection for the shared engine.
+  long max_concurrent_streams = 100;
+  /// Caches to attach to. With multiplex, the share's engine replaces the
+  /// client's own, and the two limits above come from the share's
+  /// HttpShareOptions instead.
+  std::shared_ptr<HttpShare> share;
 };
 
 /**
@@ -38,19 +193,70 @@ public:
    */
   HttpClient();
 
+  /**
+   * @brief Constructor with engine settings.
+   * @param options Engine settings; see HttpClientOptions.
+   */
+  explicit HttpClient(const HttpClientOptions &options);
+
   /**
    * @brief Destructor.
    */
-  ~HttpClient();
+  virtual ~HttpClient();
 
   /**
    * @brief Performs an HTTP GET request.
    *
+   * Compressed responses are decoded while they stream in, so the body is
+   * always the decoded content. Safe to call from several threads; with
+   * HttpClientOptions::multiplex the calls share the engine's connections.
+   * A request stopped through HttpRequestOptions::stop returns a response
+   * with cancelled set.
+   *
    * @param url The URL to request.
    * @param timeout Timeout in seconds. Default is 10.
+   * @param options Transfer options such as content-encoding negotiation.
    * @return HttpResponse The response including status code and body.
    */
-  virtual HttpResponse get(const std::string &url, long timeout = 10) const;
+  virtual HttpResponse get(const std::string &url, long timeout = 10,
+                           const HttpRequestOptions &options = {}) const;
+
+  /**
+   * @brief Starts an HTTP GET request and calls @p done with the response.
+   *
+   * With HttpClientOptions::multiplex the transfer runs on the engine and
+   * this returns at once; @p done is then called on the engine's thread and
+   * must not block. Otherwise (and in clients overriding only get()) the
+   * request runs inline and @p done is called before this returns.
+   *
+   * Requesting @p stop aborts the transfer; @p done then receives a
+   * response with cancelled set.
+   */
+  virtual void get_async(const std::string &url, long timeout,
+                         const HttpRequestOptions &options,
+                         std::stop_token stop, ResponseCallback done) const;
+
+  /**
+   * @brief Calls @p done after @p delay, with true when @p stop was
+   * requested first.
+   *
+   * On the engine this is a timer on the engine's thread; otherwise the
+   * calling thread sleeps.
+   */
+  virtual void wait_async(std::chrono::milliseconds delay,
+                          std::stop_token stop,
+                          std::function<void(bool cancelled)> done) const;
+
+  /**
+   * @brief True when get_async() and wait_async() return at once and call
+   * back later, so waiting on them holds no thread; i.e. with
+   * HttpClientOptions::multiplex.
+   */
+  virtual bool asynchronous() const noexcept;
+
+private:
+  std::shared_ptr<HttpShare> share_;
+  std::shared_ptr<detail::TransferEngine> engine_; // set when multiplexing
 };
 
 } // namespace regeocode
@@ -0,0 +1,210 @@
+/**
+ * SPDX-FileComment: Header file for the on-demand JSON scanner.
+ * SPDX-FileType: SOURCE
+ * SPDX-FileContributor: ZHENG Robert
+ * SPDX-FileCopyrightText: 2026 ZHENG Robert
+ * SPDX-License-Identifier: MIT
+ *
+ * @file json_scan.hpp
+ * @brief Extracts a declared set of paths from a JSON text in one pass.
+ * @version 0.1.0
+ * @date 2026-10-19
+ *
+ * @author ZHENG Robert
+ * @license MIT License
+ */
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <functional>
+#include <initializer_list>
+#include <memory_resource>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace regeocode::scan {
+
+/**
+ * @brief Thrown when the scanner hits malformed JSON.
+ */
+class parse_error : public std::runtime_error {
+public:
+  using std::runtime_error::runtime_error;
+};
+
+/// Maximum number of '*' segments in one path.
+inline constexpr std::size_t kMaxCaptures = 4;
+
+/**
+ * @brief A compiled list of paths an adapter wants from a response.
+ *
+ * Paths are dot-separated. A numeric segment selects an array element, any
+ * other segment selects an object member and "*" selects every element or
+ * member. Examples: "display_name", "results.0.formatted_address",
+ * "results.0.address_components.*.types.*".
+ *
+ * The position of a path in the list is its id in the ScanResult.
+ */
+class PathSet {
+public:
+  /**
+   * @brief Compiles the given paths.
+   * @param paths The paths to extract.
+   * @throws std::invalid_argument if a path is empty or has too many '*'.
+   */
+  PathSet(std::initializer_list<std::string_view> paths);
+
+  /**
+   * @brief Number of declared paths.
+   */
+  std::size_t size() const noexcept { return paths_.size(); }
+
+private:
+  friend class Scanner;
+
+  struct Segment {
+    std::string key;         ///< Member name (objects).
+    std::size_t index{};     ///< Element index (arrays).
+    bool is_index = false;   ///< Numeric segment.
+    bool is_wildcard = false;
+  };
+
+  std::vector<std::vector<Segment>> paths_;
+};
+
+/**
+ * @brief Kind of a matched value.
+ */
+enum class Kind { String, Number, Boolean, Null, Object, Array };
+
+/**
+ * @brief Key or index matched by a '*' segment.
+ */
+struct Capture {
+  std::string_view key; ///< Member name as written (empty for arrays).
+  std::size_t index{};  ///< Element index (arrays only).
+
+  /// Member name with JSON escapes resolved.
+  std::string key_string() const;
+};
+
+/**
+ * @brief One value matched by a declared path.
+ *
+ * Views point into the scanned text, which must outlive the field.
+ */
+struct Field {
+  std::size_t path{}; ///< Id of the matched path.
+  Kind kind{};        ///< Kind of the value.
+  /// Source text: string content without quotes (still escaped), the number
+  /// or literal, or the complete object/array text.
+  std::string_view raw;
+  bool escaped = false;                       ///< String contains escapes.
+  std::array<Capture, kMaxCaptures> captures; ///< Wildcard matches in order.
+  std::size_t capture_count = 0;              ///< Used entries in captures.
+
+  /// String content with escapes resolved ("" for non-strings).
+  std::string str() const;
+  /// Number value (0.0 for non-numbers).
+  double as_double() const noexcept;
+  /// Integer value; fractional numbers are truncated (0 for non-numbers).
+  long as_long() const noexcept;
+  /// Whether the number is written without fraction or exponent.
+  bool is_integer() const noexcept;
+  /// Capture @p i (i < capture_count).
+  const Capture &capture(std::size_t i) const noexcept { return captures[i]; }
+};
+
+/**
+ * @brief All fields matched by one scan.
+ *
+ * Allocated from request_resource(): a result produced inside a
+ * RequestArena must not outlive it.
+ */
+class ScanResult {
+public:
+  /**
+   * @brief First field matched by path @p path, or nullptr.
+   */
+  const Field *get(std::size_t path) const noexcept;
+
+  /**
+   * @brief Whether path @p path matched at all (any kind, including null).
+   */
+  bool has(std::size_t path) const noexcept { return get(path) != nullptr; }
+
+  /**
+   * @brief Whether path @p path matched an object.
+   */
+  bool is_object(std::size_t path) const noexcept;
+
+  /**
+   * @brief String value of path @p path, or "" if missing or not a string.
+   */
+  std::string string(std::size_t path) const;
+
+  /**
+   * @brief All matched fields in document order (containers after their
+   * children).
+   */
+  std::span<const Field> fields() const noexcept { return fields_; }
+
+private:
+  friend class Scanner;
+
+  explicit ScanResult(std::pmr::memory_resource *resource)
+      : fields_(resource), first_(resource) {}
+
+  std::pmr::vector<Field> fields_;
+  std::pmr::vector<std::ptrdiff_t> first_; // index into fields_ per path,
+                                           // -1 = none
+};
+
+/**
+ * @brief Scans @p text once and returns the values at the declared paths.
+ *
+ * Subtrees no path can match are skipped without decoding. The scanner
+ * checks structure only as far as it needs to; it is not a validator.
+ *
+ * @param text The JSON text. Must outlive the result.
+ * @param paths The paths to extract.
+ * @return ScanResult The matched fields.
+ * @throws parse_error on malformed input.
+ */
+ScanResult scan(std::string_view text, const PathSet &paths);
+
+/**
+ * @brief Receives each matched field; returning false stops the scan.
+ */
+using FieldCallback = std::function<bool(const Field &)>;
+
+/**
+ * @brief Streams the values at the declared paths to @p on_field.
+ *
+ * Matches exactly like scan() but hands each field over as soon as it is
+ * complete instead of collecting it, so memory use does not grow with the
+ * response. Once the callback returns false the rest of the text is not
+ * read, which lets an adapter stop as soon as it has what it needs.
+ *
+ * @param text The JSON text. Must outlive the callback invocations.
+ * @param paths The paths to extract.
+ * @param on_field Called for every matched field in document order
+ * (containers after their children).
+ * @return bool true if the whole text was scanned, false if stopped early.
+ * @throws parse_error on malformed input before the stop point.
+ */
+bool scan_each(std::string_view text, const PathSet &paths,
+               const FieldCallback &on_field);
+
+/**
+ * @brief Resolves JSON string escapes (\\n, \\uXXXX, ...) to UTF-8.
+ * @param escaped String content without the surrounding quotes.
+ */
+std::string unescape(std::string_view escaped);
+
+} // namespace regeocode::scan
@@ -0,0 +1,241 @@
+/**
+ * SPDX-FileComment: Header file for the per-API metrics.
+ * SPDX-FileType: SOURCE
+ * SPDX-FileContributor: ZHENG Robert
+ * SPDX-FileCopyrightText: 2026 ZHENG Robert
+ * SPDX-License-Identifier: MIT
+ *
+ * @file metrics.hpp
+ * @brief Lock-free per-API counters and latency histograms, snapshots and
+ *        Prometheus text export.
+ * @version 0.1.0
+ * @date 2026-10-19
+ *
+ * @author ZHENG Robert
+ * @license MIT License
+ */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace regeocode {
+
+/**
+ * @brief Event counts kept per API.
+ */
+enum class Counter : std::uint8_t {
+  Lookups,        ///< reverse_geocode() calls.
+  Failures,       ///< Lookups that threw (HTTP errors, quota, parsing).
+  Requests,       ///< HTTP requests completed, retries included.
+  Retries,        ///< Requests that were repeats.
+  WireBytes,      ///< Body bytes as received.
+  DecodedBytes,   ///< Body bytes after decoding.
+  TransferMicros, ///< Summed request wall time.
+  CacheHits,      ///< Served fresh from the HTTP cache.
+  Revalidations,  ///< Answered 304 Not Modified.
+  SavedBytes,     ///< Body bytes not transferred thanks to the cache.
+  SavedMicros,    ///< Request time not spent thanks to the cache.
+  LocalAnswers,   ///< Answered from local data by the adapter.
+  QuotaConsumed,  ///< Daily quota slots used.
+  QuotaRejected,  ///< Requests refused by the daily limit.
+  QuotaReleased,  ///< Slots given back: request cancelled or cache-served.
+  Cancelled,      ///< Lookups ended through their stop token.
+  Count_
+};
+
+/**
+ * @brief Timed stages of a lookup, each with its own histogram.
+ *
+ * The network stages come from libcurl's timing of the final transfer
+ * (zero on reused connections): name resolution, TCP connect, TLS
+ * handshake, waiting for the first byte and receiving the body.
+ */
+enum class Stage : std::uint8_t {
+  Lookup,   ///< Whole reverse_geocode() call, retries included.
+  Dns,      ///< Name resolution.
+  Connect,  ///< TCP connect.
+  Tls,      ///< TLS handshake.
+  Wait,     ///< Request sent until the first response byte.
+  Transfer, ///< First until last response byte.
+  Parse,    ///< Adapter parse_response().
+  Count_
+};
+
+inline constexpr std::size_t kCounterCount =
+    static_cast<std::size_t>(Counter::Count_);
+inline constexpr std::size_t kStageCount =
+    static_cast<std::size_t>(Stage::Count_);
+
+/// Name of @p c in exports ("requests", "cache_hits", "transfer_seconds",
+/// ...).
+std::string_view counter_name(Counter c);
+/// Name of @p s in exports ("lookup", "dns", ...).
+std::string_view stage_name(Stage s);
+
+/**
+ * @brief A latency histogram read out of ApiMetrics.
+ *
+ * Log-linear buckets over microseconds in the style of HdrHistogram:
+ * values below 8 us have their own bucket, above that every power of two is
+ * split into 8 equal buckets, so any value is reported within 12.5 %.
+ * Values beyond about 18 minutes land in the last bucket.
+ */
+struct HistogramSnapshot {
+  static constexpr unsigned kSubBucketBits = 3;
+  static constexpr std::size_t kSubBuckets = 1u << kSubBucketBits;
+  static constexpr unsigned kMaxExponent = 30; ///< 2^30 us
+  static constexpr std::size_t kBuckets =
+      kSubBuckets + (kMaxExponent - kSubBucketBits) * kSubBuckets;
+
+  std::array<std::uint64_t, kBuckets> buckets{};
+  std::uint64_t count = 0;
+  std::uint64_t sum_micros = 0;
+
+  /// Bucket holding @p micros.
+  static std::size_t bucket_of(std::uint64_t micros) noexcept;
+  /// Largest value counted in bucket @p i.
+  static std::uint64_t bucket_limit(std::size_t i) noexcept;
+
+  /// Value at or below which a fraction @p p of the samples lie (0 if empty).
+  std::chrono::microseconds percentile(double p) const noexcept;
+  std::chrono::microseconds mean() const noexcept;
+  void merge(const HistogramSnapshot &other) noexcept;
+};
+
+/**
+ * @brief Counters and histograms of one API at one point in time.
+ */
+struct ApiSnapshot {
+  std::array<std::uint64_t, kCounterCount> counters{};
+  std::array<HistogramSnapshot, kStageCount> stages{};
+
+  std::uint64_t operator[](Counter c) const noexcept {
+    return counters[static_cast<std::size_t>(c)];
+  }
+  const HistogramSnapshot &operator[](Stage s) const noexcept {
+    return stages[static_cast<std::size_t>(s)];
+  }
+  /// Cache hits per lookup that needed a response (0 without traffic).
+  double cache_hit_ratio() const noexcept;
+};
+
+/// Deepest fallback position counted on its own; deeper ones share a slot.
+inline constexpr std::size_t kMaxFallbackDepth = 8;
+
+/**
+ * @brief All metrics of a ReverseGeocoder at one point in time.
+ */
+struct MetricsSnapshot {
+  std::map<std::string, ApiSnapshot, std::less<>> apis;
+  /// Fallback lookups by the position of the provider that answered
+  /// (1 = first choice); index 0 counts lookups where every provider failed.
+  std::array<std::uint64_t, kMaxFallbackDepth + 1> fallback_depth{};
+};
+
+/**
+ * @brief Recording side of one API's metrics.
+ *
+ * Every thread writes to a cache-line aligned slot of its own with relaxed
+ * atomic increments, so concurrent lookups neither lock nor bounce a shared
+ * cache line; snapshot() merges the slots. A slot (about 13 KB) is made
+ * when a thread first records, so an idle API costs none, and passes to a
+ * new thread when its thread ends. Beyond the hardware concurrency, further
+ * threads share the existing slots.
+ */
+class ApiMetrics {
+public:
+  ApiMetrics();
+  ~ApiMetrics();
+  ApiMetrics(const ApiMetrics &) = delete;
+  ApiMetrics &operator=(const ApiMetrics &) = delete;
+
+  void add(Counter c, std::uint64_t n = 1) noexcept;
+  void record(Stage s, std::chrono::microseconds duration) noexcept;
+  ApiSnapshot snapshot() const;
+
+private:
+  struct Slot;
+  struct Registry;
+  /// The calling thread's slot, taken on first use.
+  Slot &slot() noexcept;
+
+  std::shared_ptr<Registry> registry_;
+};
+
+/**
+ * @brief Metrics of a set of APIs fixed at construction, plus fallback
+ * depths. Lookups of API entries need no lock.
+ */
+class Metrics {
+public:
+  explicit Metrics(const std::vector<std::string> &apis);
+
+  /// The entry of @p api, nullptr for APIs not given at construction.
+  ApiMetrics *api(std::string_view api) noexcept;
+  /// Counts a fallback lookup answered at @p depth (1-based), 0 = none.
+  void record_fallback(std::size_t depth) noexcept;
+
+  MetricsSnapshot snapshot() const;
+
+private:
+  std::map<std::string, std::unique_ptr<ApiMetrics>, std::less<>> apis_;
+  std::array<std::atomic<std::uint64_t>, kMaxFallbackDepth + 1> fallback_{};
+};
+
+/**
+ * @brief @p snapshot in the Prometheus text exposition format.
+ *
+ * Counters become regeocode_<counter>_total{api="..."}, time sums in
+ * seconds (regeocode_transfer_seconds_total), stages a summary
+ * regeocode_stage_seconds{api="...",stage="...",quantile="..."} with _sum
+ * and _count, fallback depths regeocode_fallback_depth_total{depth="..."}.
+ */
+std::string to_prometheus(const MetricsSnapshot &snapshot);
+
+/**
+ * @brief Writes to_prometheus(@p snapshot) to @p path through a temporary
+ * file and a rename, so a collector never reads half a file (node_exporter
+ * textfile collector).
+ * @throws std::runtime_error if the file cannot be written.
+ */
+void write_prometheus_file(const MetricsSnapshot &snapshot,
+                           const std::string &path);
+
+/**
+ * @brief Hands a snapshot to a callback at a fixed interval from its own
+ * thread, and once more when destroyed.
+ */
+class MetricsReporter {
+public:
+  MetricsReporter(std::function<MetricsSnapshot()> source,
+                  std::function<void(const MetricsSnapshot &)> sink,
+                  std::chrono::milliseconds interval);
+  ~MetricsReporter();
+  MetricsReporter(const MetricsReporter &) = delete;
+  MetricsReporter &operator=(const MetricsReporter &) = delete;
+
+private:
+  std::function<MetricsSnapshot()> source_;
+  std::function<void(const MetricsSnapshot &)> sink_;
+  std::chrono::milliseconds interval_;
+  std::mutex mutex_;
+  std::condition_variable wake_;
+  bool stop_ = false;
+  std::thread thread_;
+};
+
+} // namespace regeocode
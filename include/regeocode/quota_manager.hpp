@@ -48,6 +48,18 @@ public:
    */
   bool try_consume(const std::string &api_name, long limit);
 
+  /**
+   * @brief Gives back a slot reserved by try_consume() for a request that
+   * was cancelled before it was answered.
+   *
+   * Slots of a previous day are not given back, as the count already
+   * restarted.
+   *
+   * @param api_name Name of the API.
+   * @param limit Daily limit for the API (as passed to try_consume()).
+   */
+  void release(const std::string &api_name, long limit);
+
 private:
   void load();
   void save();
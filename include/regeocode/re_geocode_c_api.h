@@ -1,6 +1,14 @@
 #pragma once
 
+#include <stddef.h>
+
 #ifdef __cplusplus
+#include <memory>
+
+namespace regeocode {
+class ReverseGeocoder;
+}
+
 extern "C" {
 #endif
 
@@ -28,9 +36,106 @@ geocode_result_t geocoder_lookup(geocoder_t *handle, double lat, double lon,
                                  const char *api_name,
                                  const char *local_lang_override);
 
-// Ergebnis freigeben
+// Ergebnis freigeben (the four strings share one allocation, owned by
+// json_full: never free them individually and do not modify json_full; the
+// other fields may be set to NULL, which does not affect freeing)
 void geocoder_result_free(geocode_result_t *res);
 
+// One attribute of a record; both strings are NUL-terminated.
+typedef struct {
+  const char *key;
+  const char *value;
+} geocode_attribute_t;
+
+// Typed lookup result without JSON. The record, its strings and attributes
+// live in one block, valid until geocoder_record_free() (or, for records of
+// a result set, geocoder_result_set_free()); on success no string is NULL.
+typedef struct {
+  int success;       // 1 = ok, 0 = error
+  const char *error; // Message when success == 0, else NULL
+
+  const char *api;
+  const char *type; // "geocoding", "info", ...
+  double latitude;
+  double longitude;
+
+  const char *address_english; // Title for info APIs
+  const char *address_local;   // Summary for info APIs
+  const char *country_code;
+
+  const geocode_attribute_t *attributes; // Sorted by key
+  size_t attribute_count;
+
+  void *internal; // Owned storage, do not touch
+} geocode_record_t;
+
+// Lookup returning the typed record (no JSON is built). Like every entry
+// point below, it reports internal failures (e.g. out of memory) as a failed
+// record, NULL or 0 instead of throwing.
+geocode_record_t geocoder_lookup_record(geocoder_t *handle, double lat,
+                                        double lon, const char *api_name,
+                                        const char *local_lang_override);
+
+// The record as the JSON document of json_full, serialised on the first call
+// (also when several threads call at once) and owned by the record; NULL for
+// failed lookups
+const char *geocoder_record_json(const geocode_record_t *record);
+
+// Record freigeben (does nothing for records of a result set)
+void geocoder_record_free(geocode_record_t *record);
+
+// Results of several lookups in one block: records, strings and attributes
+typedef struct geocode_result_set_t geocode_result_set_t;
+
+// Looks up count coordinates like geocoder_lookup_batch() and returns them
+// as one result set (NULL for invalid arguments)
+geocode_result_set_t *geocoder_lookup_set(geocoder_t *handle,
+                                          const double *lats,
+                                          const double *lons, size_t count,
+                                          const char *api_name,
+                                          const char *local_lang_override);
+
+// Number of records and the records, in input order
+size_t geocoder_result_set_size(const geocode_result_set_t *set);
+const geocode_record_t *
+geocoder_result_set_records(const geocode_result_set_t *set);
+
+// Frees the set with every record in it
+void geocoder_result_set_free(geocode_result_set_t *set);
+
+// Looks up count coordinates on the geocoder's worker threads (and the
+// calling one) and fills results[i] for lats[i]/lons[i]; each record is freed
+// with geocoder_record_free(). The records share one allocation, released
+// with the last of them. Duplicate coordinates are looked up once.
+// Returns the number of successful lookups.
+size_t geocoder_lookup_batch(geocoder_t *handle, const double *lats,
+                             const double *lons, size_t count,
+                             const char *api_name,
+                             const char *local_lang_override,
+                             geocode_record_t *results);
+
+// Receives an asynchronous result on a worker thread. The callback owns the
+// record: it stays valid after the callback returns (e.g. handed to another
+// thread) until geocoder_record_free(), which releases the record itself.
+typedef void (*geocode_callback_t)(geocode_record_t *record, void *user_data);
+
+// Queues a lookup on the geocoder's worker threads and returns at once:
+// 1 = queued, 0 = invalid arguments or the lookup could not be queued (the
+// callback is not called).
+// geocoder_free() waits for queued lookups and their callbacks.
+int geocoder_lookup_async(geocoder_t *handle, double lat, double lon,
+                          const char *api_name,
+                          const char *local_lang_override,
+                          geocode_callback_t callback, void *user_data);
+
+// Cancels every lookup of the handle that is running or queued: transfers
+// are aborted, their quota slots given back, and the records fail with a
+// "Lookup cancelled" error. Lookups started afterwards run normally.
+void geocoder_cancel(geocoder_t *handle);
+
 #ifdef __cplusplus
 }
-#endif
\ No newline at end of file
+
+// Hands an existing geocoder (e.g. with a mocked HttpClient) to the C API
+geocoder_t *geocoder_wrap(std::unique_ptr<regeocode::ReverseGeocoder> geocoder);
+#endif
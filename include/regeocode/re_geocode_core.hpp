@@ -16,16 +16,32 @@
 
 #pragma once
 
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
 #include <memory>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <stop_token>
 #include <string>
+#include <string_view>
 #include <unordered_map>
 #include <vector>
 
 #include <nlohmann/json.hpp>
 
 #include "regeocode/api_adapter.hpp"
+#include "regeocode/http_cache.hpp"
 #include "regeocode/http_client.hpp"
+#include "regeocode/metrics.hpp"
 #include "regeocode/quota_manager.hpp"
+#include "regeocode/retry_policy.hpp"
+#include "regeocode/task.hpp"
+#include "regeocode/tracing.hpp"
+#include "regeocode/uri_template.hpp"
+#include "regeocode/worker_pool.hpp"
 
 namespace regeocode {
 
@@ -49,12 +65,102 @@ struct ApiConfig {
   std::string type;         ///< API type.
   long timeout = 10;        ///< Request timeout in seconds.
   long daily_limit = 0;     ///< Daily request limit.
+  bool keep_raw_json = false; ///< Hand the response body out as raw_json.
+  /// Content codings to negotiate ("auto", "identity" or e.g. "gzip, br").
+  std::string accept_encoding = "auto";
+  /// Protocol version to negotiate ("http-version" in the INI).
+  HttpVersion http_version = HttpVersion::Auto;
+  /// Repeats transient failures ("retry-*" keys in the INI).
+  RetryPolicy retry;
+  /// Keep responses as their caching headers allow and revalidate them
+  /// ("http-cache" in the INI; on by default for info APIs).
+  bool http_cache = false;
+};
+
+/**
+ * @brief HTTP transfer totals for one API.
+ */
+struct TransferStats {
+  std::uint64_t requests = 0;         ///< HTTP requests completed.
+  std::uint64_t wire_bytes = 0;       ///< Body bytes as received.
+  std::uint64_t decoded_bytes = 0;    ///< Body bytes after decoding.
+  std::uint64_t transfer_micros = 0;  ///< Summed request wall time.
+  std::uint64_t retries = 0;          ///< Requests that were repeats.
+  std::uint64_t cache_hits = 0;       ///< Served fresh from the HTTP cache.
+  std::uint64_t revalidations = 0;    ///< Answered 304 Not Modified.
+  std::uint64_t saved_bytes = 0;      ///< Body bytes not transferred.
+  std::uint64_t saved_micros = 0;     ///< Request time not spent.
+};
+
+/**
+ * @brief How a batch is reduced before dispatch (see BatchPlan).
+ *
+ * Points are snapped to a grid of roughly square cells: rows of quantum_m
+ * metres of latitude, each split into columns of quantum_m metres of
+ * longitude at the row's latitude. Points in one cell with the same
+ * country code are answered by one lookup of the first of them.
+ */
+struct BatchOptions {
+  /// Grid step in metres; 0 merges exact duplicates only. Points a few
+  /// metres apart can still fall into neighbouring cells.
+  double quantum_m = 0.0;
+  /// Size in metres of the cells unique points are grouped by; 0 keeps
+  /// input order. Groups run in Z-order, so neighbouring cells are looked
+  /// up close together in time.
+  double cell_m = 0.0;
+};
+
+/**
+ * @brief What a batch cost.
+ */
+struct BatchReport {
+  std::size_t points = 0;   ///< Coordinates passed in.
+  std::size_t requests = 0; ///< Unique lookups dispatched.
+  std::size_t groups = 0;   ///< Spatial cells (1 without grouping).
+
+  /// Unique lookups per input point; 1.0 means nothing was merged.
+  double unique_ratio() const noexcept {
+    return points == 0 ? 1.0
+                       : static_cast<double>(requests) /
+                             static_cast<double>(points);
+  }
+};
+
+/**
+ * @brief Typed result of a dual-language lookup with its metadata.
+ *
+ * What reverse_geocode_json() returns, without building a JSON document;
+ * to_json() serialises it on request. For info APIs address_english holds
+ * the title and address_local the summary.
+ */
+struct LookupResult {
+  std::string api;          ///< API that answered.
+  std::string type;         ///< API type ("geocoding", "info", ...).
+  double latitude = 0.0;    ///< Latitude asked for.
+  double longitude = 0.0;   ///< Longitude asked for.
+  AddressResult address;    ///< Addresses, country code and attributes.
+
+  bool is_geocoding() const noexcept { return type == "geocoding"; }
+  /// The document reverse_geocode_json() returns.
+  nlohmann::json to_json() const;
+};
+
+/**
+ * @brief Thrown by the lookups when their stop token was requested; a
+ * fallback chain does not try further providers then.
+ */
+class LookupCancelled : public std::runtime_error {
+public:
+  explicit LookupCancelled(const std::string &api_name)
+      : std::runtime_error("Lookup cancelled: " + api_name) {}
 };
 
 // NEW: Container for the entire config result
 struct Configuration {
   std::unordered_map<std::string, ApiConfig> apis;
   std::string quota_file_path = "quota_status.json"; // Default
+  /// HttpClient engine settings ("multiplex" etc. in the [config] section).
+  HttpClientOptions http;
 };
 
 class ConfigLoader {
@@ -78,70 +184,223 @@ public:
 
   // ... (Rest of methods remain the same) ...
 
+  /**
+   * @name Cancellation
+   *
+   * Every lookup takes an optional stop token. Requesting it aborts the
+   * transfer in flight (at once on the engine, within about a second
+   * otherwise) and any retry back-off, gives the quota slot of the
+   * unanswered request back, and fails the lookup with LookupCancelled.
+   * @{
+   */
+
   /**
    * @brief Performs reverse geocoding using a specific API.
    * @param coords Coordinates to lookup.
    * @param api_name Name of the API to use.
    * @param language_code Language code (default: en).
+   * @param stop Cancels the lookup when requested.
    * @return AddressResult The result.
    */
   AddressResult reverse_geocode(const Coordinates &coords,
                                 const std::string &api_name,
-                                const std::string &language_code = "en") const;
+                                const std::string &language_code = "en",
+                                std::stop_token stop = {}) const;
 
   /**
    * @brief Performs reverse geocoding with dual language support.
    * @param coords Coordinates to lookup.
    * @param api_name Name of the API to use.
    * @param user_lang User's preferred language.
+   * @param stop Cancels the lookup when requested.
    * @return AddressResult The result with dual language info.
    */
   AddressResult
   reverse_geocode_dual_language(const Coordinates &coords,
                                 const std::string &api_name,
-                                const std::string &user_lang) const;
+                                const std::string &user_lang,
+                                std::stop_token stop = {}) const;
+
+  /**
+   * @brief Performs a dual-language lookup and returns it typed.
+   * @param coords Coordinates to lookup.
+   * @param api_name Name of the API to use.
+   * @param lang_override Language override.
+   * @param stop Cancels the lookup when requested.
+   * @return LookupResult The result with its metadata.
+   */
+  LookupResult lookup(const Coordinates &coords, const std::string &api_name,
+                      const std::string &lang_override = "",
+                      std::stop_token stop = {}) const;
 
   /**
    * @brief Performs reverse geocoding and returns JSON.
    * @param coords Coordinates to lookup.
    * @param api_name Name of the API to use.
    * @param lang_override Language override.
+   * @param stop Cancels the lookup when requested.
    * @return nlohmann::json JSON result.
    */
   nlohmann::json
   reverse_geocode_json(const Coordinates &coords, const std::string &api_name,
-                       const std::string &lang_override = "") const;
+                       const std::string &lang_override = "",
+                       std::stop_token stop = {}) const;
 
   /**
    * @brief Performs reverse geocoding with fallback strategy.
    * @param coords Coordinates to lookup.
    * @param priority_list List of APIs to try in order.
    * @param lang_override Language override.
+   * @param stop Cancels the lookup when requested; no further provider is
+   * tried then.
    * @return nlohmann::json JSON result.
    */
   nlohmann::json
   reverse_geocode_fallback(const Coordinates &coords,
                            const std::vector<std::string> &priority_list,
-                           const std::string &lang_override = "") const;
+                           const std::string &lang_override = "",
+                           std::stop_token stop = {}) const;
 
   /**
    * @brief Performs batch reverse geocoding.
+   *
+   * Duplicate points (or, with BatchOptions::quantum_m, points in one grid
+   * cell) are looked up once, and every input point receives a copy of
+   * that answer. Its meta coordinates are its own; when the answer is that
+   * of another point, meta.looked_up_at holds where it was looked up.
+   * Each unique point runs on a thread of its own, or with
+   * BatchOptions::cell_m each cell runs its points one after another. With
+   * HttpClientOptions::multiplex the batch runs as
+   * batch_reverse_geocode_async() instead, so retry back-offs are engine
+   * timers rather than sleeping threads.
+   *
    * @param coords_list List of coordinates.
    * @param priority_list Priority list of APIs.
    * @param lang_override Language override.
-   * @return std::vector<nlohmann::json> List of JSON results.
+   * @param stop Cancels every lookup of the batch when requested; the call
+   * then throws LookupCancelled once all threads returned.
+   * @param options Deduplication grid and grouping.
+   * @param report Receives the number of points, requests and groups.
+   * @return std::vector<nlohmann::json> List of JSON results, in input
+   * order.
    */
   std::vector<nlohmann::json>
   batch_reverse_geocode(const std::vector<Coordinates> &coords_list,
                         const std::vector<std::string> &priority_list,
-                        const std::string &lang_override = "") const;
+                        const std::string &lang_override = "",
+                        std::stop_token stop = {},
+                        const BatchOptions &options = {},
+                        BatchReport *report = nullptr) const;
+  /// @}
+
+  /**
+   * @name Awaitable lookups
+   *
+   * Coroutine versions of the lookups above, for callers with their own
+   * event loop: `co_await geocoder.reverse_geocode_async(...)`. Arguments
+   * are taken by value, as the task may run after the caller's temporaries
+   * are gone; the geocoder must outlive the task.
+   *
+   * With HttpClientOptions::multiplex the transfers and retry back-offs run
+   * on the client's engine, so no thread blocks and thousands of lookups in
+   * flight cost one coroutine frame each. What follows a transfer or a
+   * back-off (parsing, quota bookkeeping) runs on the geocoder's worker
+   * threads, never on the engine's, and the awaiting coroutine resumes
+   * there; use sync_wait() from plain threads. Other clients complete each
+   * step inline.
+   *
+   * Requesting @p stop cancels them as it cancels the blocking lookups.
+   * @{
+   */
+
+  /// Awaitable reverse_geocode().
+  Task<AddressResult> reverse_geocode_async(Coordinates coords,
+                                            std::string api_name,
+                                            std::string language_code = "en",
+                                            std::stop_token stop = {}) const;
+
+  /// Awaitable lookup(), i.e. reverse_geocode_dual_language() with metadata.
+  Task<LookupResult> lookup_async(Coordinates coords, std::string api_name,
+                                  std::string lang_override = "",
+                                  std::stop_token stop = {}) const;
+
+  /// Awaitable reverse_geocode_fallback().
+  Task<nlohmann::json>
+  reverse_geocode_fallback_async(Coordinates coords,
+                                 std::vector<std::string> priority_list,
+                                 std::string lang_override = "",
+                                 std::stop_token stop = {}) const;
+
+  /// Awaitable batch_reverse_geocode(); all unique points run
+  /// concurrently, started group by group. @p report is filled when the
+  /// task starts and must outlive it.
+  Task<std::vector<nlohmann::json>>
+  batch_reverse_geocode_async(std::vector<Coordinates> coords_list,
+                              std::vector<std::string> priority_list,
+                              std::string lang_override = "",
+                              std::stop_token stop = {},
+                              BatchOptions options = {},
+                              BatchReport *report = nullptr) const;
+  /// @}
+
+  /**
+   * @brief HTTP transfer totals for an API since construction.
+   * @param api_name Name of the API.
+   * @return TransferStats Zeroes for unknown APIs or APIs not used yet.
+   */
+  TransferStats transfer_stats(const std::string &api_name) const;
+
+  /**
+   * @brief Counters and latency histograms of every API since construction,
+   * and fallback depths; see to_prometheus() and MetricsReporter.
+   */
+  MetricsSnapshot metrics() const;
+
+  /**
+   * @brief Sends a span for every stage of later lookups to @p sink (URI
+   * rendering, quota, HTTP phases, parsing, each language of a dual-language
+   * lookup); nullptr stops tracing. May be called while lookups run.
+   */
+  void set_trace_sink(std::shared_ptr<TraceSink> sink);
 
 private:
+  // Steps shared by the blocking and the awaitable lookups
+  const ApiConfig &config(const std::string &api_name) const;
+  const ApiAdapter &adapter(const ApiConfig &cfg) const;
+  void consume_quota(const ApiConfig &cfg, ApiMetrics &metrics) const;
+  /// Gives back the quota slot of a request that was not answered.
+  void release_quota(const ApiConfig &cfg, ApiMetrics &metrics) const;
+  /// Counts a cancelled lookup, gives back the quota slot of its unanswered
+  /// request when @p reserved, and throws LookupCancelled.
+  [[noreturn]] void cancelled(const ApiConfig &cfg, ApiMetrics &metrics,
+                              bool reserved) const;
+  AddressResult parse(const ApiConfig &cfg, const ApiAdapter &adapter,
+                      ApiMetrics &metrics, std::string_view body) const;
+  /// Accounts one HTTP attempt; returns the back-off before the next one,
+  /// nullopt when @p resp is final, or throws when it may not be repeated.
+  std::optional<std::chrono::milliseconds>
+  settle_attempt(const ApiConfig &cfg, ApiMetrics &metrics, int attempt,
+                 const HttpResponse &resp, const CacheOutcome &outcome,
+                 std::chrono::microseconds elapsed) const;
+
   std::unordered_map<std::string, ApiConfig> configs_;
+  std::unordered_map<std::string, UriTemplate> uri_templates_; // per API
   std::unordered_map<std::string, ApiAdapterPtr> adapters_;
   std::unique_ptr<HttpClient> http_client_;
+  mutable HttpCache http_cache_; // for APIs with http_cache set
+  // Keys fixed at construction, so lookups need no lock
+  mutable Metrics metrics_;
+  Tracer tracer_;
+  mutable std::unordered_map<std::string, RetryBudget> retry_budgets_;
 
   mutable QuotaManager quota_manager_;
+
+  /// Threads the awaitable lookups continue on once the engine answered,
+  /// started by the first such answer; declared last, so continuations
+  /// still queued finish while everything above is alive.
+  WorkerPool &continuations() const;
+  mutable std::once_flag continuations_started_;
+  mutable std::unique_ptr<WorkerPool> continuations_;
 };
 
 } // namespace regeocode
\ No newline at end of file
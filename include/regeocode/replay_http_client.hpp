@@ -0,0 +1,168 @@
+/**
+ * SPDX-FileComment: Header file for the record/replay HTTP clients.
+ * SPDX-FileType: SOURCE
+ * SPDX-FileContributor: ZHENG Robert
+ * SPDX-FileCopyrightText: 2026 ZHENG Robert
+ * SPDX-License-Identifier: MIT
+ *
+ * @file replay_http_client.hpp
+ * @brief Serve recorded responses offline, with latency and error
+ *        injection, and record them from a live client.
+ * @version 0.1.0
+ * @date 2026-10-19
+ *
+ * @author ZHENG Robert
+ * @license MIT License
+ */
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "regeocode/http_client.hpp"
+
+namespace regeocode {
+
+/// Query parameters left out of replay keys: credentials differ between
+/// recording and replay and must not end up in fixture files.
+inline const std::vector<std::string> kDefaultIgnoredParams = {
+    "key",      "apikey", "api_key",          "appid",
+    "username", "token",  "subscription-key", "rapidapi-key"};
+
+/**
+ * @brief @p ignored plus every query parameter one of @p uri_templates
+ * fills with the API key ("subscription-key={{ apikey }}"), so credentials
+ * stay out of recordings whatever a provider calls them.
+ */
+std::vector<std::string>
+credential_params(const std::vector<std::string> &uri_templates,
+                  std::vector<std::string> ignored = kDefaultIgnoredParams);
+
+/**
+ * @brief The key a response is recorded and looked up under: @p url without
+ * the @p ignored query parameters.
+ */
+std::string replay_key(std::string_view url,
+                       const std::vector<std::string> &ignored =
+                           kDefaultIgnoredParams);
+
+/**
+ * @brief One recorded exchange.
+ */
+struct Recording {
+  std::string key; ///< replay_key() of the request URL.
+  long status_code = 0;
+  std::size_t wire_bytes = 0;
+  std::string body;
+  std::string retry_after;
+  std::string etag;
+  std::string last_modified;
+  std::string cache_control;
+  std::string expires;
+  std::string age;
+};
+
+/**
+ * @brief Writes @p recordings as a replay file.
+ *
+ * Layout (integers little-endian): the magic "RGREPLY1", the records (status,
+ * wire bytes, then key, body and headers as length-prefixed strings), an
+ * index of (key hash, record offset) pairs sorted by hash, and the index
+ * offset as the last 8 bytes. Records of one key keep their order.
+ *
+ * @throws std::runtime_error if the file cannot be written.
+ */
+void write_replay_file(const std::string &path,
+                       const std::vector<Recording> &recordings);
+
+/**
+ * @brief Faults and delays added by ReplayHttpClient.
+ */
+struct ReplayOptions {
+  std::chrono::microseconds latency{0};        ///< Added to every response.
+  std::chrono::microseconds latency_jitter{0}; ///< Uniform extra latency.
+  double error_rate = 0.0;                     ///< Share of failed requests.
+  long error_status = 503;                     ///< Status of injected errors.
+  std::string error_retry_after;  ///< Retry-After of injected errors.
+  long missing_status = 404;      ///< Status for keys never recorded.
+  std::uint64_t seed = 1;         ///< Same seed, same faults and delays.
+  std::vector<std::string> ignored_params = kDefaultIgnoredParams;
+};
+
+/**
+ * @brief HttpClient answering from a replay file instead of the network.
+ *
+ * The file is read once; records are decoded on lookup. A key recorded
+ * several times answers with its recordings in turn and then repeats the
+ * last one, so a recorded 503 followed by a 200 replays a retry. Requests
+ * carrying a matching If-None-Match get a 304. Injected latency is slept on
+ * the calling thread. Thread-safe.
+ */
+class ReplayHttpClient : public HttpClient {
+public:
+  /// @throws std::runtime_error for missing or malformed files.
+  explicit ReplayHttpClient(const std::string &path,
+                            ReplayOptions options = {});
+
+  HttpResponse get(const std::string &url, long timeout,
+                   const HttpRequestOptions &options = {}) const override;
+
+  std::size_t size() const { return index_.size(); } ///< Records in the file.
+  std::size_t served() const { return served_.load(); } ///< Requests so far.
+
+private:
+  struct IndexEntry {
+    std::uint64_t hash;
+    std::uint64_t offset;
+  };
+
+  HttpResponse decode(std::uint64_t offset) const;
+  /// Uniform [0, 1) value number @p draw for request number @p request.
+  double unit(std::uint64_t request, std::uint64_t draw) const;
+
+  std::string data_;
+  std::vector<IndexEntry> index_;
+  ReplayOptions options_;
+  mutable std::atomic<std::uint64_t> served_{0};
+  mutable std::mutex cursor_mutex_;
+  mutable std::unordered_map<std::string, std::size_t> cursors_;
+};
+
+/**
+ * @brief HttpClient that forwards to another client and records the
+ * exchanges for ReplayHttpClient.
+ *
+ * A response identical to the previous one for its key is not recorded
+ * again, so repeated lookups keep the file small while changing answers
+ * (a 503, then a 200) are kept in order.
+ */
+class RecordingHttpClient : public HttpClient {
+public:
+  explicit RecordingHttpClient(
+      std::unique_ptr<HttpClient> inner,
+      std::vector<std::string> ignored_params = kDefaultIgnoredParams);
+
+  HttpResponse get(const std::string &url, long timeout,
+                   const HttpRequestOptions &options = {}) const override;
+
+  /// Writes what was recorded so far; see write_replay_file().
+  void save(const std::string &path) const;
+  std::size_t size() const; ///< Recordings so far.
+
+private:
+  std::unique_ptr<HttpClient> inner_;
+  std::vector<std::string> ignored_params_;
+  mutable std::mutex mutex_;
+  mutable std::vector<Recording> recordings_;
+  mutable std::unordered_map<std::string, std::size_t> last_; // per key
+};
+
+} // namespace regeocode
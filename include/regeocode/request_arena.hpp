@@ -0,0 +1,72 @@
+/**
+ * SPDX-FileComment: Header file for the request-scoped memory arena.
+ * SPDX-FileType: SOURCE
+ * SPDX-FileContributor: ZHENG Robert
+ * SPDX-FileCopyrightText: 2026 ZHENG Robert
+ * SPDX-License-Identifier: MIT
+ *
+ * @file request_arena.hpp
+ * @brief Per-thread pooled std::pmr arena for the duration of one request.
+ * @version 0.1.0
+ * @date 2026-10-19
+ *
+ * @author ZHENG Robert
+ * @license MIT License
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <memory_resource>
+
+namespace regeocode {
+
+/**
+ * @brief Memory resource for request-scoped temporaries.
+ *
+ * Returns the arena of the innermost active RequestArena on this thread, or
+ * std::pmr::get_default_resource() when no request is in flight. Objects
+ * allocated from it must not outlive the RequestArena scope.
+ */
+std::pmr::memory_resource *request_resource() noexcept;
+
+/**
+ * @brief RAII scope that routes request_resource() to a monotonic arena.
+ *
+ * Each thread owns one pooled buffer. Opening the outermost scope puts a
+ * std::pmr::monotonic_buffer_resource on top of it; closing the scope
+ * releases everything at once. Nested scopes join the enclosing arena.
+ *
+ * When a request overflows the pooled buffer, the overflow is taken from
+ * the heap and the buffer grows by that amount for the next request on the
+ * thread (capped at kMaxPoolBytes), so steady-state requests stay inside
+ * one block.
+ */
+class RequestArena {
+public:
+  /// Initial pooled buffer per thread.
+  static constexpr std::size_t kInitialPoolBytes = 16 * 1024;
+  /// Largest buffer a thread keeps between requests.
+  static constexpr std::size_t kMaxPoolBytes = 4 * 1024 * 1024;
+
+  RequestArena();
+  ~RequestArena();
+
+  RequestArena(const RequestArena &) = delete;
+  RequestArena &operator=(const RequestArena &) = delete;
+
+  /**
+   * @brief The arena this scope allocates from.
+   */
+  std::pmr::memory_resource *resource() const noexcept;
+
+  /**
+   * @brief Size of the calling thread's pooled buffer in bytes.
+   */
+  static std::size_t pool_size() noexcept;
+
+private:
+  bool outermost_;
+};
+
+} // namespace regeocode
@@ -0,0 +1,118 @@
+/**
+ * SPDX-FileComment: Header file for the per-API retry policy.
+ * SPDX-FileType: SOURCE
+ * SPDX-FileContributor: ZHENG Robert
+ * SPDX-FileCopyrightText: 2026 ZHENG Robert
+ * SPDX-License-Identifier: MIT
+ *
+ * @file retry_policy.hpp
+ * @brief Jittered exponential backoff, Retry-After and a retry budget.
+ * @version 0.1.0
+ * @date 2026-10-19
+ *
+ * @author ZHENG Robert
+ * @license MIT License
+ */
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+#include <vector>
+
+namespace regeocode {
+
+/**
+ * @brief When and how often a failed request to one API is repeated.
+ *
+ * The default makes a single attempt, so APIs without retry settings behave
+ * as before.
+ */
+struct RetryPolicy {
+  int max_attempts = 1; ///< Attempts including the first (1 = no retry).
+  /// Backoff before the first retry; doubles with every further retry.
+  std::chrono::milliseconds base_delay{100};
+  std::chrono::milliseconds max_delay{5000}; ///< Backoff ceiling.
+  /// Fraction of the backoff drawn at random: 1.0 waits anywhere between
+  /// zero and the backoff ("full jitter"), 0.0 waits exactly the backoff.
+  double jitter = 1.0;
+  bool honour_retry_after = true; ///< Wait as long as Retry-After asks.
+  /// A longer Retry-After gives up instead, so a fallback chain moves on.
+  std::chrono::milliseconds max_retry_after{30000};
+  /// Retries allowed per request on average (see RetryBudget).
+  double budget_ratio = 0.1;
+  /// Retries allowed regardless of traffic, so low-volume APIs can retry.
+  unsigned budget_min_retries = 10;
+  /// Status codes worth repeating; 599 is a transport failure.
+  std::vector<long> retry_on{408, 429, 502, 503, 504, 599};
+
+  /// True when @p status_code is in retry_on.
+  bool retryable(long status_code) const;
+};
+
+/**
+ * @brief Caps retries at a fraction of the requests to one API.
+ *
+ * Every request deposits budget_ratio of a retry, every retry withdraws a
+ * whole one; the balance starts at, and never exceeds,
+ * budget_min_retries. Over any period retries thus stay below
+ * ratio × requests + min_retries, and an outage cannot multiply the load
+ * on a provider. Lock-free; shared by all threads using the API.
+ */
+class RetryBudget {
+public:
+  RetryBudget(double ratio, unsigned min_retries);
+  explicit RetryBudget(const RetryPolicy &policy)
+      : RetryBudget(policy.budget_ratio, policy.budget_min_retries) {}
+
+  /// Credits one first attempt.
+  void record_request();
+  /// Withdraws one retry; false when the budget is spent.
+  bool try_spend();
+  /// Retries currently available, rounded down.
+  std::int64_t available() const;
+
+private:
+  static constexpr std::int64_t kUnit = 1000; // balance is in 1/1000 retries
+  std::int64_t deposit_;
+  std::int64_t cap_;
+  std::atomic<std::int64_t> balance_;
+};
+
+/**
+ * @brief Backoff before retry number @p retry (1 for the first retry).
+ * @param unit_random Uniform random value in [0, 1) used for the jitter.
+ */
+std::chrono::milliseconds backoff_delay(const RetryPolicy &policy, int retry,
+                                        double unit_random);
+
+/**
+ * @brief Parses a Retry-After value: delay-seconds or an HTTP-date.
+ * @param now Reference time for HTTP-dates.
+ * @return The delay (zero for dates in the past), nullopt if malformed.
+ */
+std::optional<std::chrono::milliseconds>
+parse_retry_after(std::string_view value,
+                  std::chrono::system_clock::time_point now =
+                      std::chrono::system_clock::now());
+
+/**
+ * @brief Decides whether attempt @p attempt is repeated and after how long.
+ *
+ * Only decides, never waits: synchronous callers sleep for the returned
+ * delay, asynchronous ones can schedule the next attempt instead of holding
+ * a thread. A retry is spent from @p budget only when everything else
+ * allows it.
+ *
+ * @param attempt Attempts made so far (1 after the first).
+ * @param retry_after Retry-After header of the failed response, or empty.
+ * @return The delay before the next attempt, or nullopt to give up.
+ */
+std::optional<std::chrono::milliseconds>
+retry_delay(const RetryPolicy &policy, int attempt, long status_code,
+            std::string_view retry_after, RetryBudget &budget);
+
+} // namespace regeocode
@@ -0,0 +1,282 @@
+/**
+ * SPDX-FileComment: Header file for the coroutine task type.
+ * SPDX-FileType: SOURCE
+ * SPDX-FileContributor: ZHENG Robert
+ * SPDX-FileCopyrightText: 2026 ZHENG Robert
+ * SPDX-License-Identifier: MIT
+ *
+ * @file task.hpp
+ * @brief Lazy coroutine task for the awaitable lookups, with when_all() and
+ *        sync_wait().
+ * @version 0.1.0
+ * @date 2026-10-19
+ *
+ * @author ZHENG Robert
+ * @license MIT License
+ */
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <coroutine>
+#include <cstddef>
+#include <exception>
+#include <mutex>
+#include <optional>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace regeocode {
+
+template <typename T = void> class Task;
+
+namespace detail {
+
+struct TaskPromiseBase {
+  /// Resumed when the task finishes; nothing until it is awaited.
+  std::coroutine_handle<> continuation = std::noop_coroutine();
+  std::exception_ptr error;
+
+  struct FinalAwaiter {
+    bool await_ready() const noexcept { return false; }
+    template <typename Promise>
+    std::coroutine_handle<>
+    await_suspend(std::coroutine_handle<Promise> self) const noexcept {
+      return self.promise().continuation;
+    }
+    void await_resume() const noexcept {}
+  };
+
+  std::suspend_always initial_suspend() const noexcept { return {}; }
+  FinalAwaiter final_suspend() const noexcept { return {}; }
+  void unhandled_exception() noexcept { error = std::current_exception(); }
+};
+
+template <typename T> struct TaskPromise : TaskPromiseBase {
+  std::optional<T> value;
+
+  Task<T> get_return_object() noexcept;
+  template <typename U = T> void return_value(U &&v) {
+    value.emplace(std::forward<U>(v));
+  }
+  T take() {
+    if (error)
+      std::rethrow_exception(error);
+    return std::move(*value);
+  }
+};
+
+template <> struct TaskPromise<void> : TaskPromiseBase {
+  Task<void> get_return_object() noexcept;
+  void return_void() const noexcept {}
+  void take() const {
+    if (error)
+      std::rethrow_exception(error);
+  }
+};
+
+/**
+ * @brief Fire-and-forget coroutine: starts at once and frees its frame when
+ * it returns. Used to drive tasks from non-coroutine code.
+ */
+struct Detached {
+  struct promise_type {
+    Detached get_return_object() const noexcept { return {}; }
+    std::suspend_never initial_suspend() const noexcept { return {}; }
+    std::suspend_never final_suspend() const noexcept { return {}; }
+    void return_void() const noexcept {}
+    void unhandled_exception() const noexcept { std::terminate(); }
+  };
+};
+
+} // namespace detail
+
+/**
+ * @brief Result of an asynchronous operation, produced by a coroutine.
+ *
+ * Lazy: nothing runs until the task is co_awaited (or handed to
+ * sync_wait()). The awaiting coroutine is resumed by symmetric transfer on
+ * whichever thread finished the task, so long chains of tasks that complete
+ * inline do not grow the stack. Exceptions propagate to the awaiter. A task
+ * is awaited at most once; destroying one that never ran frees its frame.
+ */
+template <typename T> class [[nodiscard]] Task {
+public:
+  using promise_type = detail::TaskPromise<T>;
+  using value_type = T;
+
+  Task(Task &&other) noexcept : handle_(std::exchange(other.handle_, {})) {}
+  Task &operator=(Task &&other) noexcept {
+    if (this != &other) {
+      if (handle_)
+        handle_.destroy();
+      handle_ = std::exchange(other.handle_, {});
+    }
+    return *this;
+  }
+  Task(const Task &) = delete;
+  Task &operator=(const Task &) = delete;
+  ~Task() {
+    if (handle_)
+      handle_.destroy();
+  }
+
+  auto operator co_await() && noexcept {
+    struct Awaiter {
+      std::coroutine_handle<promise_type> handle;
+
+      bool await_ready() const noexcept { return false; }
+      std::coroutine_handle<>
+      await_suspend(std::coroutine_handle<> awaiting) const noexcept {
+        handle.promise().continuation = awaiting;
+        return handle;
+      }
+      T await_resume() const { return handle.promise().take(); }
+    };
+    return Awaiter{handle_};
+  }
+
+private:
+  friend promise_type;
+  explicit Task(std::coroutine_handle<promise_type> handle) noexcept
+      : handle_(handle) {}
+
+  std::coroutine_handle<promise_type> handle_;
+};
+
+namespace detail {
+
+template <typename T> Task<T> TaskPromise<T>::get_return_object() noexcept {
+  return Task<T>(std::coroutine_handle<TaskPromise>::from_promise(*this));
+}
+
+inline Task<void> TaskPromise<void>::get_return_object() noexcept {
+  return Task<void>(std::coroutine_handle<TaskPromise>::from_promise(*this));
+}
+
+/// Value and error of one task driven by sync_wait() or when_all().
+template <typename T> struct Outcome {
+  std::optional<T> value;
+  std::exception_ptr error;
+};
+template <> struct Outcome<void> {
+  bool value = false;
+  std::exception_ptr error;
+};
+
+template <typename T>
+Task<void> capture(Task<T> task, Outcome<T> &outcome) {
+  try {
+    if constexpr (std::is_void_v<T>) {
+      co_await std::move(task);
+      outcome.value = true;
+    } else {
+      outcome.value.emplace(co_await std::move(task));
+    }
+  } catch (...) {
+    outcome.error = std::current_exception();
+  }
+}
+
+/// Counts finished tasks; the last one resumes the awaiting coroutine.
+struct Latch {
+  explicit Latch(std::size_t count) : remaining(count + 1) {}
+
+  /// Called by each task as it finishes.
+  void arrive() noexcept {
+    if (remaining.fetch_sub(1, std::memory_order_acq_rel) == 1)
+      awaiting.resume();
+  }
+
+  std::atomic<std::size_t> remaining;
+  std::coroutine_handle<> awaiting;
+};
+
+template <typename T>
+Detached arrive_when_done(Task<T> task, Outcome<T> &outcome, Latch &latch) {
+  co_await capture(std::move(task), outcome);
+  latch.arrive();
+}
+
+} // namespace detail
+
+/**
+ * @brief Runs all @p tasks concurrently and returns their results in order.
+ *
+ * The tasks start one after the other on the awaiting thread; each runs
+ * until it first suspends (e.g. on a transfer). The first exception (by
+ * position) is rethrown once every task finished.
+ */
+template <typename T>
+Task<std::vector<T>> when_all(std::vector<Task<T>> tasks) {
+  std::vector<detail::Outcome<T>> outcomes(tasks.size());
+  detail::Latch latch(tasks.size());
+
+  struct StartAll {
+    std::vector<Task<T>> &tasks;
+    std::vector<detail::Outcome<T>> &outcomes;
+    detail::Latch &latch;
+
+    bool await_ready() const noexcept { return tasks.empty(); }
+    bool await_suspend(std::coroutine_handle<> awaiting) {
+      latch.awaiting = awaiting;
+      for (std::size_t i = 0; i < tasks.size(); ++i)
+        detail::arrive_when_done(std::move(tasks[i]), outcomes[i], latch);
+      // Suspend unless every task already finished inline
+      return latch.remaining.fetch_sub(1, std::memory_order_acq_rel) != 1;
+    }
+    void await_resume() const noexcept {}
+  };
+  co_await StartAll{tasks, outcomes, latch};
+
+  std::vector<T> results;
+  results.reserve(outcomes.size());
+  for (auto &outcome : outcomes) {
+    if (outcome.error)
+      std::rethrow_exception(outcome.error);
+    results.push_back(std::move(*outcome.value));
+  }
+  co_return results;
+}
+
+namespace detail {
+struct SyncState {
+  std::mutex mutex;
+  std::condition_variable finished;
+  bool done = false;
+};
+
+template <typename T>
+Detached notify_when_done(Task<T> task, Outcome<T> &outcome,
+                          SyncState &state) {
+  co_await capture(std::move(task), outcome);
+  // Notify under the lock: the waiter destroys the state once it sees done
+  std::lock_guard lock(state.mutex);
+  state.done = true;
+  state.finished.notify_all();
+}
+} // namespace detail
+
+/**
+ * @brief Runs @p task and blocks the calling thread until it finished.
+ *
+ * For callers without an event loop (tests, the CLI). Must not be called
+ * on the thread that completes the task's transfers.
+ */
+template <typename T> T sync_wait(Task<T> task) {
+  detail::Outcome<T> outcome;
+  detail::SyncState state;
+  detail::notify_when_done(std::move(task), outcome, state);
+  {
+    std::unique_lock lock(state.mutex);
+    state.finished.wait(lock, [&] { return state.done; });
+  }
+  if (outcome.error)
+    std::rethrow_exception(outcome.error);
+  if constexpr (!std::is_void_v<T>)
+    return std::move(*outcome.value);
+}
+
+} // namespace regeocode
@@ -0,0 +1,157 @@
+/**
+ * SPDX-FileComment: Header file for lookup tracing.
+ * SPDX-FileType: SOURCE
+ * SPDX-FileContributor: ZHENG Robert
+ * SPDX-FileCopyrightText: 2026 ZHENG Robert
+ * SPDX-License-Identifier: MIT
+ *
+ * @file tracing.hpp
+ * @brief Timed spans for the stages of a lookup, handed to a pluggable
+ *        sink such as a Chrome trace-event file.
+ * @version 0.1.0
+ * @date 2026-10-19
+ *
+ * Built with REGEOCODE_TRACING=0 (CMake option REGEOCODE_TRACING=OFF) the
+ * library records no spans at all; otherwise a span costs one relaxed
+ * atomic load while no sink is set.
+ *
+ * @author ZHENG Robert
+ * @license MIT License
+ */
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#ifndef REGEOCODE_TRACING
+#define REGEOCODE_TRACING 1
+#endif
+
+namespace regeocode {
+
+/**
+ * @brief One finished span.
+ *
+ * The views are only valid during TraceSink::record(); sinks keeping them
+ * must copy.
+ */
+struct SpanRecord {
+  std::string_view name;   ///< Stage, e.g. "render_uri" or "http".
+  std::string_view api;    ///< API the span belongs to, may be empty.
+  std::string_view detail; ///< Free text, e.g. "lang=de" or "status=503".
+  std::chrono::microseconds start{}; ///< Since trace_clock_origin().
+  std::chrono::microseconds duration{};
+  std::uint32_t thread = 0; ///< Small per-thread number, 1 upwards.
+};
+
+/**
+ * @brief Receives finished spans; called from the recording threads.
+ */
+class TraceSink {
+public:
+  virtual ~TraceSink() = default;
+  virtual void record(const SpanRecord &span) = 0;
+};
+
+/**
+ * @brief Collects spans and writes them as Chrome trace-event JSON
+ * (chrome://tracing, Perfetto): complete ("X") events with the API and
+ * detail as arguments. Written on flush() and on destruction.
+ */
+class ChromeTraceSink : public TraceSink {
+public:
+  explicit ChromeTraceSink(std::string path);
+  ~ChromeTraceSink() override;
+
+  void record(const SpanRecord &span) override;
+  /// Writes every span so far. @throws std::runtime_error on I/O errors.
+  void flush();
+  std::size_t size() const; ///< Spans so far.
+
+private:
+  std::string path_;
+  mutable std::mutex mutex_;
+  std::vector<std::string> events_; // one JSON object each
+};
+
+/// Start of the trace time axis (first use in the process).
+std::chrono::steady_clock::time_point trace_clock_origin() noexcept;
+/// Number of the calling thread in traces.
+std::uint32_t trace_thread_id() noexcept;
+
+/**
+ * @brief Where a component's spans go; empty until set. Thread-safe.
+ */
+class Tracer {
+public:
+  void set_sink(std::shared_ptr<TraceSink> sink);
+  std::shared_ptr<TraceSink> sink() const;
+  bool enabled() const noexcept {
+    return REGEOCODE_TRACING && enabled_.load(std::memory_order_relaxed);
+  }
+
+private:
+  std::atomic<bool> enabled_{false};
+  mutable std::mutex mutex_;
+  std::shared_ptr<TraceSink> sink_;
+};
+
+#if REGEOCODE_TRACING
+/**
+ * @brief Records the time from construction to destruction (or end()) as
+ * a span, if the tracer has a sink when the span starts.
+ */
+class TraceSpan {
+public:
+  TraceSpan(const Tracer &tracer, std::string_view name,
+            std::string_view api = {}) {
+    if (tracer.enabled()) {
+      sink_ = tracer.sink();
+      name_ = name;
+      api_ = api;
+      start_ = std::chrono::steady_clock::now();
+    }
+  }
+  ~TraceSpan() { end(); }
+  TraceSpan(const TraceSpan &) = delete;
+  TraceSpan &operator=(const TraceSpan &) = delete;
+
+  bool active() const noexcept { return sink_ != nullptr; }
+  /// Sets the span's detail text; only evaluate costly text if active().
+  void detail(std::string text) { detail_ = std::move(text); }
+  void end();
+
+private:
+  std::shared_ptr<TraceSink> sink_;
+  std::string_view name_;
+  std::string_view api_;
+  std::string detail_;
+  std::chrono::steady_clock::time_point start_;
+};
+#else
+class TraceSpan {
+public:
+  TraceSpan(const Tracer &, std::string_view, std::string_view = {}) {}
+  bool active() const noexcept { return false; }
+  void detail(std::string) {}
+  void end() {}
+};
+#endif
+
+/**
+ * @brief Records a span with explicit times, e.g. transfer phases reported
+ * after the fact. Does nothing without a sink.
+ */
+void trace_span(const Tracer &tracer, std::string_view name,
+                std::string_view api, std::chrono::steady_clock::time_point start,
+                std::chrono::microseconds duration,
+                std::string_view detail = {});
+
+} // namespace regeocode
@@ -0,0 +1,107 @@
+/**
+ * SPDX-FileComment: Header file for track geocoding.
+ * SPDX-FileType: SOURCE
+ * SPDX-FileContributor: ZHENG Robert
+ * SPDX-FileCopyrightText: 2026 ZHENG Robert
+ * SPDX-License-Identifier: MIT
+ *
+ * @file track.hpp
+ * @brief Reads GPX and NMEA tracks and geocodes them adaptively: points are
+ *        probed at intervals and looked up between probes only where the
+ *        labels differ.
+ * @version 0.1.0
+ * @date 2026-10-19
+ *
+ * @author ZHENG Robert
+ * @license MIT License
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <stop_token>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+#include "regeocode/re_geocode_core.hpp"
+
+namespace regeocode {
+
+/**
+ * @brief How a track is probed and what counts as a boundary.
+ */
+struct TrackOptions {
+  /// Probe every n-th point; a region entered and left again between two
+  /// probes with the same label is not seen.
+  std::size_t probe_every = 64;
+  /// Also probe once the track has run this many metres since the last
+  /// probe; 0 probes by point count only.
+  double probe_m = 0.0;
+  /// Result details compared, besides the country code, to tell two
+  /// points apart.
+  std::vector<std::string> label_keys{"state", "city"};
+};
+
+/**
+ * @brief Consecutive points with the same label.
+ */
+struct TrackSegment {
+  std::size_t first = 0; ///< Index of the segment's first point.
+  std::size_t last = 0;  ///< Index of its last point, inclusive.
+  /// Lookup of the segment's first point. Its label holds for every point
+  /// of the segment; finer details (road, postcode) only for that point.
+  nlohmann::json result;
+};
+
+/**
+ * @brief Segments covering a whole track, in track order.
+ */
+struct TrackResult {
+  std::vector<TrackSegment> segments;
+  std::size_t points = 0;  ///< Points in the track.
+  std::size_t lookups = 0; ///< Points actually looked up.
+
+  /// Segment containing point @p i.
+  const TrackSegment &segment_of(std::size_t i) const;
+
+  /// {"points", "lookups", "segments": [{"first", "last", "result"}]}.
+  nlohmann::json to_json() const;
+};
+
+/// Track and route points of a GPX document, in document order.
+std::vector<Coordinates> parse_gpx(std::string_view xml);
+
+/// Fixes of the RMC and GGA sentences of an NMEA log. Sentences with a bad
+/// checksum or without a valid fix are skipped, and so are repeats of the
+/// previous fix.
+std::vector<Coordinates> parse_nmea(std::string_view log);
+
+/// Reads a GPX file or an NMEA log; throws std::runtime_error when the
+/// file cannot be read.
+std::vector<Coordinates> read_track(const std::string &path);
+
+/**
+ * @brief Geocodes an ordered track with as few lookups as possible.
+ *
+ * Probes are looked up first, as one batch. Wherever two neighbouring
+ * looked-up points have different labels, the point halfway between them
+ * is looked up, until every label change lies between two adjacent
+ * points. The points in between inherit the label of their neighbours.
+ * Each round of midpoints runs as one batch_reverse_geocode().
+ *
+ * A failed lookup has a label of its own, so a provider outage shows up
+ * as a segment of errors.
+ *
+ * @param stop Cancels the lookups; the call then throws LookupCancelled.
+ */
+TrackResult geocode_track(const ReverseGeocoder &geocoder,
+                          const std::vector<Coordinates> &track,
+                          const std::vector<std::string> &priority_list,
+                          const std::string &lang_override = "",
+                          std::stop_token stop = {},
+                          const TrackOptions &options = {});
+
+} // namespace regeocode
@@ -0,0 +1,102 @@
+/**
+ * SPDX-FileComment: Header file for precompiled request URI templates.
+ * SPDX-FileType: SOURCE
+ * SPDX-FileContributor: ZHENG Robert
+ * SPDX-FileCopyrightText: 2026 ZHENG Robert
+ * SPDX-License-Identifier: MIT
+ *
+ * @file uri_template.hpp
+ * @brief URI template compiled once per API instead of once per request.
+ * @version 0.1.0
+ * @date 2026-10-19
+ *
+ * @author ZHENG Robert
+ * @license MIT License
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace regeocode {
+
+/**
+ * @brief Values a request URI can refer to.
+ */
+struct UriValues {
+  double latitude{};            ///< {{ latitude }}
+  double longitude{};           ///< {{ longitude }}
+  std::string_view apikey;      ///< {{ apikey }}
+  std::string_view lang;        ///< {{ lang }}
+  std::string_view country_code; ///< {{ country_code }}
+};
+
+/**
+ * @brief A compiled "URI" template from the INI file.
+ *
+ * Templates that only substitute the plain variables of UriValues are split
+ * into literal and variable pieces once and rendered by concatenation, with
+ * the same number formatting as inja. Anything else (statements, comments,
+ * filters, whitespace control) is parsed once by inja and rendered through
+ * it, so every template inja accepts keeps working.
+ */
+class UriTemplate {
+public:
+  /**
+   * @brief Compiles @p source.
+   *
+   * An inja syntax error does not throw here; it is reported by every
+   * render() so one broken API section does not disable the others.
+   */
+  explicit UriTemplate(std::string source);
+  ~UriTemplate();
+
+  UriTemplate(UriTemplate &&) noexcept;
+  UriTemplate &operator=(UriTemplate &&) noexcept;
+
+  /**
+   * @brief Renders the URI for @p values.
+   * @throws std::runtime_error (inja::InjaError) if the template is invalid.
+   */
+  std::string render(const UriValues &values) const;
+
+  /**
+   * @brief Whether the template renders without inja.
+   */
+  bool is_simple() const noexcept { return fallback_ == nullptr; }
+
+  /**
+   * @brief The template text.
+   */
+  const std::string &source() const noexcept { return source_; }
+
+private:
+  enum class Slot : std::uint8_t {
+    Literal,
+    Latitude,
+    Longitude,
+    ApiKey,
+    Lang,
+    CountryCode
+  };
+
+  struct Piece {
+    Slot slot = Slot::Literal;
+    std::size_t offset = 0; ///< Literal start in source_.
+    std::size_t length = 0; ///< Literal length.
+  };
+
+  struct Fallback;
+
+  std::string source_;
+  std::vector<Piece> pieces_;
+  std::size_t literal_bytes_ = 0;
+  std::unique_ptr<Fallback> fallback_;
+};
+
+} // namespace regeocode
@@ -0,0 +1,75 @@
+/**
+ * SPDX-FileComment: Header file for the worker pool.
+ * SPDX-FileType: SOURCE
+ * SPDX-FileContributor: ZHENG Robert
+ * SPDX-FileCopyrightText: 2026 ZHENG Robert
+ * SPDX-License-Identifier: MIT
+ *
+ * @file worker_pool.hpp
+ * @brief Fixed set of threads running queued lookups, for batch and
+ *        asynchronous entry points.
+ * @version 0.1.0
+ * @date 2026-10-19
+ *
+ * @author ZHENG Robert
+ * @license MIT License
+ */
+
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace regeocode {
+
+/**
+ * @brief Runs submitted jobs on a fixed number of threads, first in first
+ * out.
+ *
+ * Lookups block in the HTTP client, so the thread count bounds how many
+ * run at once, instead of one thread per coordinate.
+ */
+class WorkerPool {
+public:
+  /// @param threads Number of workers; 0 picks default_size().
+  explicit WorkerPool(std::size_t threads = 0);
+  /// Runs the jobs still queued, then joins the workers.
+  ~WorkerPool();
+  WorkerPool(const WorkerPool &) = delete;
+  WorkerPool &operator=(const WorkerPool &) = delete;
+
+  /// Queues @p job; jobs must not throw.
+  void submit(std::function<void()> job);
+
+  /**
+   * @brief Calls @p fn for every index below @p count on the workers and the
+   * calling thread, and returns once all calls finished.
+   *
+   * The caller works along, so this completes even when every worker is
+   * busy (e.g. when called from a job). The first exception thrown by
+   * @p fn is rethrown after all indices are done.
+   */
+  void parallel_for(std::size_t count,
+                    const std::function<void(std::size_t)> &fn);
+
+  std::size_t size() const noexcept { return threads_.size(); }
+
+  /// Twice the hardware threads, at least 4: lookups mostly wait.
+  static std::size_t default_size() noexcept;
+
+private:
+  void run();
+
+  std::mutex mutex_;
+  std::condition_variable wake_;
+  std::deque<std::function<void()>> jobs_;
+  bool stop_ = false;
+  std::vector<std::thread> threads_;
+};
+
+} // namespace regeocode
@@ -15,11 +15,22 @@
  */
 
 #include "regeocode/adapter_bing.hpp"
+#include "regeocode/json_scan.hpp"
 
 namespace regeocode {
 
+namespace {
+enum Path : std::size_t { kAddressFields, kPosition };
+
+const scan::PathSet &paths() {
+  static const scan::PathSet set{"addresses.0.address.*",
+                                 "addresses.0.position"};
+  return set;
+}
+} // namespace
+
 AddressResult
-BingAdapter::parse_response(const std::string &response_body) const {
+BingAdapter::parse_response(std::string_view response_body) const {
   AddressResult result;
 
   // Default values
@@ -28,58 +39,52 @@ BingAdapter::parse_response(const std::string &response_body) const {
   result.country_code = "";
 
   try {
-    auto root = nlohmann::json::parse(response_body);
-
     // Azure Maps / Bing Structure: { "addresses": [ { "address": { ... } } ] }
-    if (root.contains("addresses") && root["addresses"].is_array() &&
-        !root["addresses"].empty()) {
+    const scan::ScanResult root = scan::scan(response_body, paths());
 
-      const auto &first_hit = root["addresses"][0];
+    // Fill attributes (Take all fields from "address")
+    for (const auto &f : root.fields()) {
+      if (f.path != kAddressFields)
+        continue;
+      const std::string key = f.capture(0).key_string();
 
-      if (first_hit.contains("address")) {
-        const auto &addr = first_hit["address"];
+      if (f.kind == scan::Kind::String) {
+        std::string val = f.str();
 
         // 1. Main address (freeformAddress is usually best readable)
-        if (addr.contains("freeformAddress")) {
-          result.address_english = addr["freeformAddress"].get<std::string>();
+        if (key == "freeformAddress") {
+          result.address_english = val;
           // For Azure Maps, the language is controlled via API parameter,
           // so the result is usually already localized.
-          result.address_local = result.address_english;
+          result.address_local = val;
         }
-
         // 2. Country code
-        if (addr.contains("countryCode")) {
-          result.country_code = addr["countryCode"].get<std::string>();
+        if (key == "countryCode") {
+          result.country_code = val;
         }
-
-        // 3. Fill attributes (Take all fields from "address")
-        for (auto &[key, val] : addr.items()) {
-          if (val.is_string()) {
-            result.attributes[key] = val.get<std::string>();
-            if (key == "countrySubdivision") {
-              result.attributes["state"] = val.get<std::string>();
-            }
-            if (key == "municipality") {
-              result.attributes["city"] = val.get<std::string>();
-            }
-          } else if (val.is_number()) {
-            // Convert numbers to strings
-            if (val.is_number_integer()) {
-              result.attributes[key] = std::to_string(val.get<long>());
-            } else {
-              result.attributes[key] = std::to_string(val.get<double>());
-            }
-          } else if (val.is_boolean()) {
-            result.attributes[key] = val.get<bool>() ? "true" : "false";
-          }
+        if (key == "countrySubdivision") {
+          result.attributes["state"] = val;
+        }
+        if (key == "municipality") {
+          result.attributes["city"] = val;
+        }
+        result.attributes[key] = std::move(val);
+      } else if (f.kind == scan::Kind::Number) {
+        // Convert numbers to strings
+        if (f.is_integer()) {
+          result.attributes[key] = std::to_string(f.as_long());
+        } else {
+          result.attributes[key] = std::to_string(f.as_double());
         }
+      } else if (f.kind == scan::Kind::Boolean) {
+        result.attributes[key] = f.raw == "true" ? "true" : "false";
       }
+    }
 
-      // Optional: Get position from root object of hit, if necessary
-      if (first_hit.contains("position")) {
-        result.attributes["position_raw"] =
-            first_hit["position"].get<std::string>();
-      }
+    // Optional: Get position from root object of hit, if necessary
+    if (const auto *pos = root.get(kPosition);
+        pos != nullptr && pos->kind == scan::Kind::String) {
+      result.attributes["position_raw"] = pos->str();
     }
 
   } catch (const std::exception &e) {
@@ -90,4 +95,4 @@ BingAdapter::parse_response(const std::string &response_body) const {
   return result;
 }
 
-} // namespace regeocode
\ No newline at end of file
+} // namespace regeocode
@@ -7,8 +7,8 @@
  *
  * @file adapter_country.cpp
  * @brief Implementation of the Country info lookup from a local JSON file.
- * @version 0.1.0
- * @date 2026-04-04
+ * @version 0.2.0
+ * @date 2026-10-19
  *
  * @author ZHENG Robert (robert@hase-zheng.net)
  * @copyright Copyright (c) 2026 ZHENG Robert
@@ -17,6 +17,8 @@
  */
 
 #include "regeocode/adapter_country.hpp"
+#include "regeocode/country_code_index.hpp"
+
 #include <algorithm>
 #include <cctype>
 #include <fstream>
@@ -25,7 +27,8 @@
 
 namespace regeocode {
 
-CountryAdapter::CountryAdapter(const std::string &json_path) {
+CountryAdapter::CountryAdapter(const std::string &json_path)
+    : records_(country_index::kCountryCount) {
   std::ifstream f(json_path);
   if (!f.is_open()) {
     throw std::runtime_error("Could not open country data file: " + json_path);
@@ -41,56 +44,74 @@ CountryAdapter::CountryAdapter(const std::string &json_path) {
   for (const auto &item : countries_data) {
     if (item.contains("cca2") && item["cca2"].is_string()) {
       std::string code = item["cca2"].get<std::string>();
-      std::ranges::transform(code, code.begin(),
-                             [](unsigned char c) {
-                               return static_cast<char>(std::toupper(c));
-                             });
+      std::ranges::transform(code, code.begin(), [](unsigned char c) {
+        return static_cast<char>(std::toupper(c));
+      });
+      const auto ordinal = country_index::find_alpha2(code);
+
+      CountryRecord entry;
+      entry.cca2 = code;
 
-      nlohmann::json entry;
       if (item.contains("name")) {
-        entry["name.common"] = item["name"].value("common", "");
-        entry["name.official"] = item["name"].value("official", "");
-      } else {
-        entry["name.common"] = "";
-        entry["name.official"] = "";
+        entry.name_common = item["name"].value("common", "");
+        entry.name_official = item["name"].value("official", "");
       }
 
       if (item.contains("capital") && item["capital"].is_array() &&
-          !item["capital"].empty()) {
-        entry["capital"] = item["capital"][0];
-      } else {
-        entry["capital"] = "";
+          !item["capital"].empty() && item["capital"][0].is_string()) {
+        entry.capital = item["capital"][0].get<std::string>();
       }
 
-      entry["region"] = item.value("region", "");
-      entry["flag"] = item.value("flag", "");
+      entry.region = item.value("region", "");
+      entry.flag = item.value("flag", "");
 
-      std::string code_lower = code;
+      std::string code_lower = entry.cca2;
       std::ranges::transform(code_lower, code_lower.begin(),
                              [](unsigned char c) {
                                return static_cast<char>(std::tolower(c));
                              });
-      entry["flag_url"] =
+      entry.flag_url =
           "https://github.com/lipis/flag-icons/blob/main/flags/4x3/" +
           code_lower + ".svg";
 
-      indexed_data_[code] = std::move(entry);
+      if (ordinal)
+        records_[*ordinal] = std::move(entry);
+      else
+        unindexed_.insert_or_assign(code, std::move(entry));
     }
   }
 }
 
+const CountryRecord *
+CountryAdapter::find(std::string_view country_code) const noexcept {
+  if (auto ordinal = country_index::find(country_code)) {
+    return records_[*ordinal] ? &*records_[*ordinal] : nullptr;
+  }
+  if (unindexed_.empty() || country_code.size() > 8)
+    return nullptr;
+  char upper[8];
+  for (std::size_t i = 0; i < country_code.size(); ++i)
+    upper[i] = static_cast<char>(
+        std::toupper(static_cast<unsigned char>(country_code[i])));
+  const auto it =
+      unindexed_.find(std::string_view(upper, country_code.size()));
+  return it == unindexed_.end() ? nullptr : &it->second;
+}
+
 nlohmann::json CountryAdapter::get_country(std::string_view country_code) const {
-  std::string target_code{country_code};
-  std::ranges::transform(target_code, target_code.begin(),
-                         [](unsigned char c) {
-                           return static_cast<char>(std::toupper(c));
-                         });
-
-  if (auto it = indexed_data_.find(target_code); it != indexed_data_.end()) {
-    return it->second;
+  const CountryRecord *record = find(country_code);
+  if (record == nullptr) {
+    return nlohmann::json::object();
   }
 
-  return nlohmann::json::object();
+  nlohmann::json entry = nlohmann::json::object();
+  entry["name.common"] = record->name_common;
+  entry["name.official"] = record->name_official;
+  entry["capital"] = record->capital;
+  entry["region"] = record->region;
+  entry["flag"] = record->flag;
+  entry["flag_url"] = record->flag_url;
+  return entry;
 }
 
 } // namespace regeocode
@@ -15,80 +15,92 @@
  */
 
 #include "regeocode/adapter_country_info.hpp"
+#include "regeocode/json_scan.hpp"
 
 #include <nlohmann/json.hpp>
 
 namespace regeocode {
 
 namespace {
-/**
- * @brief Safely extracts a string from a JSON object.
- *
- * @param j The JSON object.
- * @param key The key to look for.
- * @return std::string The value if it's a string, otherwise an empty string.
- */
-std::string get_string_safe(const nlohmann::json &j, const std::string &key) {
-  if (j.contains(key) && j[key].is_string()) {
-    return j[key].get<std::string>();
-  }
-  return "";
+enum Path : std::size_t {
+  kCca2,
+  kCca3,
+  kCapital,
+  kRegion,
+  kSubregion,
+  kMaps,
+  kMapsOsm,
+  kContinents,
+  kName,
+  kNameOfficial,
+  kNameCommon,
+  kCurrencies,
+  kFlags,
+  kFlagPng,
+  kFlagSvg,
+  kFlagAlt
+};
+
+const scan::PathSet &paths() {
+  static const scan::PathSet set{
+      "0.cca2",       "0.cca3",          "0.capital",
+      "0.region",     "0.subregion",     "0.maps",
+      "0.maps.openStreetMaps",           "0.continents",
+      "0.name",       "0.name.official", "0.name.common",
+      "0.currencies", "0.flags",         "0.flags.png",
+      "0.flags.svg",  "0.flags.alt"};
+  return set;
 }
 
 /**
- * @brief Safely extracts and stringifies a field (array or object).
+ * @brief Stringifies a field (array or object) like nlohmann's dump().
  *
- * @param j The JSON object.
- * @param key The key to look for.
- * @return std::string The stringified value or empty string.
+ * @param j The scan result.
+ * @param path The path id.
+ * @return std::string The string value, the compact dump or empty string.
  */
-std::string get_stringified_safe(const nlohmann::json &j, const std::string &key) {
-  if (j.contains(key)) {
-    if (j[key].is_string()) {
-      return j[key].get<std::string>();
-    }
-    return j[key].dump();
-  }
-  return "";
+std::string get_stringified_safe(const scan::ScanResult &j, std::size_t path) {
+  const scan::Field *f = j.get(path);
+  if (f == nullptr)
+    return "";
+  if (f->kind == scan::Kind::String)
+    return f->str();
+  if (f->kind == scan::Kind::Object || f->kind == scan::Kind::Array)
+    return nlohmann::json::parse(f->raw).dump();
+  return std::string(f->raw);
 }
 } // namespace
 
 AddressResult
-CountryInfoAdapter::parse_response(const std::string &response_body) const {
-  nlohmann::json full_json = nlohmann::json::parse(response_body);
+CountryInfoAdapter::parse_response(std::string_view response_body) const {
+  const scan::ScanResult j = scan::scan(response_body, paths());
   AddressResult res;
-  res.raw_json = response_body;
-
-  if (full_json.is_array() && !full_json.empty()) {
-    const auto &j = full_json[0];
-
-    res.country_code = get_string_safe(j, "cca2");
-    res.address_english = get_stringified_safe(j.at("name"), "official");
-    res.address_local = get_stringified_safe(j.at("name"), "common");
+  if (j.is_object(kName)) {
+    res.country_code = j.string(kCca2);
+    res.address_english = get_stringified_safe(j, kNameOfficial);
+    res.address_local = get_stringified_safe(j, kNameCommon);
 
     res.attributes["cca2"] = res.country_code;
-    res.attributes["cca3"] = get_string_safe(j, "cca3");
-    res.attributes["capital"] = get_stringified_safe(j, "capital");
-    res.attributes["region"] = get_string_safe(j, "region");
-    res.attributes["subregion"] = get_string_safe(j, "subregion");
-    
-    if (j.contains("maps") && j["maps"].is_object()) {
-      res.attributes["maps_osm"] = get_string_safe(j["maps"], "openStreetMaps");
-    }
-    
-    res.attributes["continents"] = get_stringified_safe(j, "continents");
-    
-    if (j.contains("name") && j["name"].is_object()) {
-      res.attributes["name_official"] = get_string_safe(j["name"], "official");
-      res.attributes["name_common"] = get_string_safe(j["name"], "common");
+    res.attributes["cca3"] = j.string(kCca3);
+    res.attributes["capital"] = get_stringified_safe(j, kCapital);
+    res.attributes["region"] = j.string(kRegion);
+    res.attributes["subregion"] = j.string(kSubregion);
+
+    if (j.is_object(kMaps)) {
+      res.attributes["maps_osm"] = j.string(kMapsOsm);
     }
-    
-    res.attributes["currencies"] = get_stringified_safe(j, "currencies");
-    
-    if (j.contains("flags") && j["flags"].is_object()) {
-      res.attributes["flag_png"] = get_string_safe(j["flags"], "png");
-      res.attributes["flag_svg"] = get_string_safe(j["flags"], "svg");
-      res.attributes["flag_alt"] = get_string_safe(j["flags"], "alt");
+
+    res.attributes["continents"] = get_stringified_safe(j, kContinents);
+
+    res.attributes["name_official"] = j.string(kNameOfficial);
+    res.attributes["name_common"] = j.string(kNameCommon);
+
+    res.attributes["currencies"] = get_stringified_safe(j, kCurrencies);
+
+    if (j.is_object(kFlags)) {
+      res.attributes["flag_png"] = j.string(kFlagPng);
+      res.attributes["flag_svg"] = j.string(kFlagSvg);
+      res.attributes["flag_alt"] = j.string(kFlagAlt);
     }
   }
 
@@ -0,0 +1,129 @@
+/**
+ * SPDX-FileComment: Implementation of the local Country Info adapter.
+ * SPDX-FileType: SOURCE
+ * SPDX-FileContributor: ZHENG Robert
+ * SPDX-FileCopyrightText: 2026 ZHENG Robert
+ * SPDX-License-Identifier: MIT
+ *
+ * @file adapter_country_info_local.cpp
+ * @brief Builds RestCountries-compatible results from data/countries.json.
+ * @version 0.1.0
+ * @date 2026-10-19
+ *
+ * @author ZHENG Robert
+ * @license MIT License
+ */
+
+#include "regeocode/adapter_country_info_local.hpp"
+#include "regeocode/country_code_index.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <fstream>
+#include <nlohmann/json.hpp>
+#include <stdexcept>
+
+namespace regeocode {
+
+namespace {
+std::string get_string_safe(const nlohmann::json &j, const std::string &key) {
+  if (j.contains(key) && j[key].is_string()) {
+    return j[key].get<std::string>();
+  }
+  return "";
+}
+
+std::string get_stringified_safe(const nlohmann::json &j,
+                                  const std::string &key) {
+  if (j.contains(key)) {
+    if (j[key].is_string()) {
+      return j[key].get<std::string>();
+    }
+    return j[key].dump();
+  }
+  return "";
+}
+
+/**
+ * @brief Derives the RestCountries "continents" array from region/subregion.
+ */
+nlohmann::json continents_for(const std::string &region,
+                              const std::string &subregion) {
+  if (region == "Americas") {
+    return nlohmann::json::array(
+        {subregion == "South America" ? "South America" : "North America"});
+  }
+  if (region == "Antarctic") {
+    return nlohmann::json::array({"Antarctica"});
+  }
+  if (region.empty()) {
+    return nlohmann::json::array();
+  }
+  return nlohmann::json::array({region});
+}
+} // namespace
+
+LocalCountryInfoAdapter::LocalCountryInfoAdapter(const std::string &json_path)
+    : records_(country_index::kCountryCount) {
+  std::ifstream f(json_path);
+  if (!f.is_open()) {
+    throw std::runtime_error("Could not open country data file: " + json_path);
+  }
+
+  nlohmann::json countries_data;
+  f >> countries_data;
+
+  if (!countries_data.is_array()) {
+    throw std::runtime_error("Invalid country data format: expected an array.");
+  }
+
+  for (const auto &j : countries_data) {
+    auto ordinal = country_index::find_alpha2(get_string_safe(j, "cca2"));
+    if (!ordinal)
+      continue;
+
+    AddressResult res;
+    res.country_code = get_string_safe(j, "cca2");
+
+    std::string region = get_string_safe(j, "region");
+    std::string subregion = get_string_safe(j, "subregion");
+
+    res.attributes["cca2"] = res.country_code;
+    res.attributes["cca3"] = get_string_safe(j, "cca3");
+    res.attributes["capital"] = get_stringified_safe(j, "capital");
+    res.attributes["region"] = region;
+    res.attributes["subregion"] = subregion;
+    res.attributes["continents"] = continents_for(region, subregion).dump();
+
+    if (j.contains("name") && j["name"].is_object()) {
+      res.address_english = get_string_safe(j["name"], "official");
+      res.address_local = get_string_safe(j["name"], "common");
+      res.attributes["name_official"] = res.address_english;
+      res.attributes["name_common"] = res.address_local;
+    }
+
+    res.attributes["currencies"] = get_stringified_safe(j, "currencies");
+
+    std::string code_lower = res.country_code;
+    std::ranges::transform(code_lower, code_lower.begin(),
+                           [](unsigned char c) {
+                             return static_cast<char>(std::tolower(c));
+                           });
+    res.attributes["flag_png"] =
+        "https://flagcdn.com/w320/" + code_lower + ".png";
+    res.attributes["flag_svg"] = "https://flagcdn.com/" + code_lower + ".svg";
+    res.attributes["flag_alt"] = "";
+
+    records_[*ordinal] = std::move(res);
+  }
+}
+
+std::optional<AddressResult>
+LocalCountryInfoAdapter::resolve_local(const LocalRequest &request) const {
+  auto ordinal = country_index::find(request.country_code);
+  if (!ordinal || !records_[*ordinal])
+    return std::nullopt;
+  return records_[*ordinal];
+}
+
+} // namespace regeocode
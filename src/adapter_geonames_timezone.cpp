@@ -15,47 +15,57 @@
  */
 
 #include "regeocode/adapter_geonames_timezone.hpp"
-#include <nlohmann/json.hpp>
+#include "regeocode/json_scan.hpp"
+
 #include <sstream>
 
 namespace regeocode {
 
+namespace {
+enum Path : std::size_t {
+  kStatus,
+  kCountryCode,
+  kTimezoneId,
+  kTime,
+  kGmtOffset,
+  kCountryName
+};
+
+const scan::PathSet &paths() {
+  static const scan::PathSet set{"status",    "countryCode", "timezoneId",
+                                 "time",      "gmtOffset",   "countryName"};
+  return set;
+}
+} // namespace
+
 AddressResult GeoNamesTimezoneAdapter::parse_response(
-    const std::string &response_body) const {
+    std::string_view response_body) const {
   AddressResult res;
-  res.raw_json = response_body;
-
   try {
-    auto j = nlohmann::json::parse(response_body);
+    const scan::ScanResult j = scan::scan(response_body, paths());
 
     // Error handling: GeoNames often returns a "status" object on errors
-    if (j.contains("status")) {
-      const auto &status = j["status"];
-      std::string msg = status.value("message", "Unknown GeoNames error");
-      int code        = status.value("value", -1);
-      //std::err << "GeoNames API error (code " << code << "): " << msg << std::endl;
+    if (j.has(kStatus)) {
       return res; // Return empty result on error
     }
 
     // Mapping fields
-    if (j.contains("countryCode")) {
-      res.country_code = j["countryCode"].get<std::string>();
+    if (j.has(kCountryCode)) {
+      res.country_code = j.string(kCountryCode);
     }
 
     // We use address_english for the timezone ID
-    if (j.contains("timezoneId")) {
-      res.address_english = j["timezoneId"].get<std::string>();
+    if (j.has(kTimezoneId)) {
+      res.address_english = j.string(kTimezoneId);
       res.attributes["timezone_id"] = res.address_english;
     }
-    if (j.contains("time")) {
-      res.address_local = j["time"].get<std::string>(); // For display
+    if (j.has(kTime)) {
+      res.address_local = j.string(kTime);            // For display
       res.attributes["local_time"] = res.address_local; // For JSON Data
     }
-    if (j.contains("gmtOffset")) {
-      //res.attributes["gmt_offset"] =
-      //    std::to_string(j["gmtOffset"].get<double>());
-
-      double offset = j["gmtOffset"].get<double>();
+    if (const auto *gmt = j.get(kGmtOffset);
+        gmt != nullptr && gmt->kind == scan::Kind::Number) {
+      double offset = gmt->as_double();
       // Format without trailing zeros: 5.5 → "5.5", 3.0 → "3"
       std::ostringstream oss;
       oss << offset;
@@ -65,8 +75,8 @@ AddressResult GeoNamesTimezoneAdapter::parse_response(
     // Optional: If countryName exists and we don't have an "address" yet,
     // we could append it. Here we append it to the timezone so the user
     // has more info.
-    if (j.contains("countryName")) {
-      std::string cname = j["countryName"].get<std::string>();
+    if (j.has(kCountryName)) {
+      std::string cname = j.string(kCountryName);
       if (!res.address_english.empty()) {
         res.address_english += " (" + cname + ")";
       } else {
@@ -74,11 +84,11 @@ AddressResult GeoNamesTimezoneAdapter::parse_response(
       }
     }
 
-  } catch (const nlohmann::json::exception &) {
-    // Ignore JSON errors, return empty result (or raw_json remains set)
+  } catch (const scan::parse_error &) {
+    // Ignore JSON errors, return empty result
   }
 
   return res;
 }
 
-} // namespace regeocode
\ No newline at end of file
+} // namespace regeocode
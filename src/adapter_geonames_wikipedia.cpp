@@ -15,60 +15,63 @@
  */
 
 #include "regeocode/adapter_geonames_wikipedia.hpp"
-#include <nlohmann/json.hpp>
+#include "regeocode/json_scan.hpp"
 
 namespace regeocode {
 
+namespace {
+enum Path : std::size_t { kTitle, kSummary, kWikipediaUrl, kCountryCode };
+
+// GeoNames often delivers a "geonames" array, we take the first element
+// (usually the nearest)
+const scan::PathSet &paths() {
+  static const scan::PathSet set{
+      "geonames.0.title", "geonames.0.summary", "geonames.0.wikipediaUrl",
+      "geonames.0.countryCode"};
+  return set;
+}
+} // namespace
+
 AddressResult GeoNamesWikipediaAdapter::parse_response(
-    const std::string &response_body) const {
+    std::string_view response_body) const {
   AddressResult res;
-  res.raw_json = response_body;
-
   try {
-    auto j = nlohmann::json::parse(response_body);
-
-    // GeoNames often delivers a "geonames" array
-    if (j.contains("geonames") && j["geonames"].is_array() &&
-        !j["geonames"].empty()) {
-
-      // We take the first element (usually the nearest)
-      const auto &first = j["geonames"][0];
+    const scan::ScanResult j = scan::scan(response_body, paths());
 
-      // Title -> English (e.g. "Glärnisch")
-      if (first.contains("title")) {
-        res.address_english = first["title"].get<std::string>();
-      }
+    // Title -> English (e.g. "Glärnisch")
+    if (j.has(kTitle)) {
+      res.address_english = j.string(kTitle);
+    }
 
-      // Summary -> Local
-      if (first.contains("summary")) {
-        res.address_local = first["summary"].get<std::string>();
-      }
+    // Summary -> Local
+    if (j.has(kSummary)) {
+      res.address_local = j.string(kSummary);
+    }
 
-      // Wikipedia URL -> Append to Local
-      if (first.contains("wikipediaUrl")) {
-        std::string wikiUrl = first["wikipediaUrl"].get<std::string>();
+    // Wikipedia URL -> Append to Local
+    if (j.has(kWikipediaUrl)) {
+      std::string wikiUrl = j.string(kWikipediaUrl);
 
-        // GeoNames often returns URLs without protocol (e.g.
-        // "en.wikipedia.org/..."). We leave it "raw" but put it in
-        // parentheses behind.
-        if (!res.address_local.empty()) {
-          res.address_local += " (" + wikiUrl + ")";
-        } else {
-          // If no summary is there, the URL is the only content
-          res.address_local = wikiUrl;
-        }
+      // GeoNames often returns URLs without protocol (e.g.
+      // "en.wikipedia.org/..."). We leave it "raw" but put it in
+      // parentheses behind.
+      if (!res.address_local.empty()) {
+        res.address_local += " (" + wikiUrl + ")";
+      } else {
+        // If no summary is there, the URL is the only content
+        res.address_local = wikiUrl;
       }
+    }
 
-      if (first.contains("countryCode")) {
-        res.country_code = first["countryCode"].get<std::string>();
-      }
+    if (j.has(kCountryCode)) {
+      res.country_code = j.string(kCountryCode);
     }
 
-  } catch (const nlohmann::json::exception &) {
+  } catch (const scan::parse_error &) {
     // Ignore parsing errors, return empty result
   }
 
   return res;
 }
 
-} // namespace regeocode
\ No newline at end of file
+} // namespace regeocode
@@ -15,57 +15,80 @@
  */
 
 #include "regeocode/adapter_google.hpp"
+#include "regeocode/json_scan.hpp"
 
-#include <algorithm>
-#include <nlohmann/json.hpp>
+#include <vector>
 
 namespace regeocode {
 
 namespace {
-std::string get_string_safe(const nlohmann::json &j, const std::string &key) {
-  if (j.contains(key) && j[key].is_string()) {
-    return j[key].get<std::string>();
-  }
-  return "";
+enum Path : std::size_t { kFormatted, kTypes, kShortName, kLongName };
+
+const scan::PathSet &paths() {
+  static const scan::PathSet set{
+      "results.0.formatted_address",
+      "results.0.address_components.*.types.*",
+      "results.0.address_components.*.short_name",
+      "results.0.address_components.*.long_name"};
+  return set;
 }
+
+/**
+ * @brief The parts of one address component the adapter uses.
+ */
+struct Component {
+  bool country = false;
+  bool state = false;
+  bool locality = false;
+  std::string short_name;
+  std::string long_name;
+};
 } // namespace
 
 AddressResult
-GoogleAdapter::parse_response(const std::string &response_body) const {
-  nlohmann::json j = nlohmann::json::parse(response_body);
+GoogleAdapter::parse_response(std::string_view response_body) const {
+  const scan::ScanResult j = scan::scan(response_body, paths());
 
   AddressResult res;
-  res.raw_json = response_body;
-
-  if (j.contains("results") && j["results"].is_array() &&
-      !j["results"].empty()) {
-    const auto &first = j["results"][0];
+  res.address_english = j.string(kFormatted);
+  res.address_local = res.address_english;
 
-    res.address_english = get_string_safe(first, "formatted_address");
-    res.address_local = res.address_english;
+  // Regroup the flat matches by component index
+  std::vector<Component> components;
+  for (const auto &f : j.fields()) {
+    if (f.path == kFormatted)
+      continue;
+    const std::size_t idx = f.capture(0).index;
+    if (components.size() <= idx)
+      components.resize(idx + 1);
+    auto &comp = components[idx];
 
-    if (first.contains("address_components") &&
-        first["address_components"].is_array()) {
-      for (const auto &comp : first["address_components"]) {
-        if (!comp.is_object() || !comp.contains("types"))
-          continue;
-
-        const auto &types = comp["types"];
-        if (!types.is_array())
-          continue;
+    if (f.path == kTypes) {
+      if (f.kind != scan::Kind::String)
+        continue;
+      if (f.raw == "country")
+        comp.country = true;
+      else if (f.raw == "administrative_area_level_1")
+        comp.state = true;
+      else if (f.raw == "locality")
+        comp.locality = true;
+    } else if (f.path == kShortName) {
+      comp.short_name = f.str();
+    } else if (f.path == kLongName) {
+      comp.long_name = f.str();
+    }
+  }
 
-        if (std::find(types.begin(), types.end(), "country") != types.end()) {
-          res.country_code = get_string_safe(comp, "short_name");
-          res.attributes["country"] = get_string_safe(comp, "long_name");
-        }
-        if (std::find(types.begin(), types.end(),
-                      "administrative_area_level_1") != types.end()) {
-          res.attributes["state"] = get_string_safe(comp, "long_name");
-        }
-        if (std::find(types.begin(), types.end(), "locality") != types.end()) {
-          res.attributes["city"] = get_string_safe(comp, "long_name");
-        }
-      }
+  for (const auto &comp : components) {
+    if (comp.country) {
+      res.country_code = comp.short_name;
+      res.attributes["country"] = comp.long_name;
+    }
+    if (comp.state) {
+      res.attributes["state"] = comp.long_name;
+    }
+    if (comp.locality) {
+      res.attributes["city"] = comp.long_name;
     }
   }
 
@@ -15,16 +15,80 @@
  */
 
 #include "regeocode/adapter_marea_tides.hpp"
+#include "regeocode/json_scan.hpp"
+
 #include <iomanip>
-#include <nlohmann/json.hpp>
+#include <optional>
 #include <sstream>
 #include <string>
-#include <vector>
 
 namespace regeocode {
 
+namespace {
+enum Path : std::size_t {
+  kUnit,
+  kCopyright,
+  kSource,
+  kOriginDistance,
+  kOriginUnit,
+  kOrigin,
+  kDatum,
+  kDatums,
+  kExtremeState,
+  kExtremeTime,
+  kExtremeHeight,
+  kExtreme,
+  kExtremes,
+  kCurrentHeight,
+  kCurrentState,
+  kCurrent
+};
+
+const scan::PathSet &paths() {
+  static const scan::PathSet set{
+      "unit",
+      "copyright",
+      "source",
+      "origin.distance",
+      "origin.unit",
+      "origin",
+      "datums.*",
+      "datums",
+      "extremes.*.state",
+      "extremes.*.datetime",
+      "extremes.*.height",
+      "extremes.*",
+      "extremes",
+      "heights.0.height",
+      "heights.0.state",
+      "heights.0"};
+  return set;
+}
+
+constexpr std::size_t kMaxEvents = 5;
+
+// Sections of the response; the scan stops once all of them are seen, so
+// the bulk of the per-minute "heights" array is never read.
+enum Section : unsigned {
+  kSeenUnit = 1u << 0,
+  kSeenCopyright = 1u << 1,
+  kSeenSource = 1u << 2,
+  kSeenOrigin = 1u << 3,
+  kSeenDatums = 1u << 4,
+  kSeenExtremes = 1u << 5,
+  kSeenCurrent = 1u << 6,
+  kSeenAll = (1u << 7) - 1
+};
+
+struct Event {
+  std::string state;
+  std::string time;
+  double height = 0.0;
+};
+} // namespace
+
 AddressResult
-MareaTidesAdapter::parse_response(const std::string &response_body) const {
+MareaTidesAdapter::parse_response(std::string_view response_body) const {
   AddressResult result;
 
   // Defaults
@@ -33,83 +97,110 @@ MareaTidesAdapter::parse_response(const std::string &response_body) const {
   result.country_code = "";
 
   try {
-    auto root = nlohmann::json::parse(response_body);
-
-    // 1. Metadata
     std::string unit = "m";
-    if (root.contains("unit"))
-      unit = root["unit"].get<std::string>();
-    result.attributes["unit"] = unit;
-
-    if (root.contains("copyright"))
-      result.attributes["copyright"] = root["copyright"].get<std::string>();
-    if (root.contains("source"))
-      result.attributes["source"] = root["source"].get<std::string>();
-
-    // 2. Origin / Station Distance
-    if (root.contains("origin")) {
-      auto origin = root["origin"];
-      if (origin.contains("distance") && origin.contains("unit")) {
-        std::stringstream ss;
-        ss << std::fixed << std::setprecision(2)
-           << origin["distance"].get<double>() << " "
-           << origin["unit"].get<std::string>();
-        result.attributes["station_distance"] = ss.str();
-      }
-    }
-
-    // 3. Datums (Reference heights like LAT, HAT, MSL)
-    if (root.contains("datums")) {
-      auto datums = root["datums"];
-      for (auto &[key, val] : datums.items()) {
-        if (val.is_number()) {
-          result.attributes["datum_" + key] = std::to_string(val.get<double>());
-        }
-      }
-    }
-
-    // 4. Extreme values (High/Low Tides)
-    if (root.contains("extremes") && root["extremes"].is_array() &&
-        !root["extremes"].empty()) {
-      int i = 0;
-      std::string summary_text = "";
-
-      for (const auto &item : root["extremes"]) {
-        std::string prefix = "event_" + std::to_string(i);
-
-        std::string state = item["state"];
-        std::string time = item["datetime"];
-        double height = item["height"].get<double>();
-
-        result.attributes[prefix + "_state"] = state;
-        result.attributes[prefix + "_time"] = time;
-        result.attributes[prefix + "_height"] = std::to_string(height);
-
-        // Create summary for the very first event
-        if (i == 0) {
+    std::optional<double> distance;
+    std::optional<std::string> distance_unit;
+    Event first_event;
+    std::size_t events = 0;
+    unsigned seen = 0;
+
+    scan::scan_each(response_body, paths(), [&](const scan::Field &f) {
+      switch (f.path) {
+      // 1. Metadata
+      case kUnit:
+        unit = f.str();
+        seen |= kSeenUnit;
+        break;
+      case kCopyright:
+        result.attributes["copyright"] = f.str();
+        seen |= kSeenCopyright;
+        break;
+      case kSource:
+        result.attributes["source"] = f.str();
+        seen |= kSeenSource;
+        break;
+
+      // 2. Origin / Station Distance
+      case kOriginDistance:
+        distance = f.as_double();
+        break;
+      case kOriginUnit:
+        distance_unit = f.str();
+        break;
+      case kOrigin:
+        if (distance && distance_unit) {
           std::stringstream ss;
-          ss << state << " (" << std::fixed << std::setprecision(2) << height
-             << unit << ") at " << time;
-          summary_text = ss.str();
+          ss << std::fixed << std::setprecision(2) << *distance << " "
+             << *distance_unit;
+          result.attributes["station_distance"] = ss.str();
         }
-
-        i++;
-        if (i >= 5)
+        seen |= kSeenOrigin;
+        break;
+
+      // 3. Datums (Reference heights like LAT, HAT, MSL)
+      case kDatum:
+        if (f.kind == scan::Kind::Number)
+          result.attributes["datum_" + f.capture(0).key_string()] =
+              std::to_string(f.as_double());
+        break;
+      case kDatums:
+        seen |= kSeenDatums;
+        break;
+
+      // 4. Extreme values (High/Low Tides), first kMaxEvents only
+      case kExtremeState:
+      case kExtremeTime:
+      case kExtremeHeight: {
+        const std::size_t i = f.capture(0).index;
+        if (i >= kMaxEvents)
           break;
+        const std::string prefix = "event_" + std::to_string(i);
+        if (f.path == kExtremeState) {
+          result.attributes[prefix + "_state"] = f.str();
+          if (i == 0)
+            first_event.state = f.str();
+        } else if (f.path == kExtremeTime) {
+          result.attributes[prefix + "_time"] = f.str();
+          if (i == 0)
+            first_event.time = f.str();
+        } else {
+          result.attributes[prefix + "_height"] = std::to_string(f.as_double());
+          if (i == 0)
+            first_event.height = f.as_double();
+        }
+        break;
       }
-      result.address_local = summary_text;
-    }
+      case kExtreme:
+        events = f.capture(0).index + 1;
+        if (events >= kMaxEvents)
+          seen |= kSeenExtremes;
+        break;
+      case kExtremes:
+        seen |= kSeenExtremes;
+        break;
+
+      // 5. Current trend (from "heights" array, first entry)
+      case kCurrentHeight:
+        result.attributes["current_height"] = std::to_string(f.as_double());
+        break;
+      case kCurrentState:
+        result.attributes["current_state"] = f.str();
+        break;
+      case kCurrent:
+        seen |= kSeenCurrent;
+        break;
+      }
+      return seen != kSeenAll;
+    });
+
+    result.attributes["unit"] = unit;
 
-    // 5. Current trend (from "heights" array, first entry)
-    if (root.contains("heights") && root["heights"].is_array() &&
-        !root["heights"].empty()) {
-      const auto &current = root["heights"][0];
-      if (current.contains("height"))
-        result.attributes["current_height"] =
-            std::to_string(current["height"].get<double>());
-      if (current.contains("state"))
-        result.attributes["current_state"] =
-            current["state"].get<std::string>();
+    // Create summary for the very first event
+    if (events > 0) {
+      std::stringstream ss;
+      ss << first_event.state << " (" << std::fixed << std::setprecision(2)
+         << first_event.height << unit << ") at " << first_event.time;
+      result.address_local = ss.str();
     }
 
   } catch (const std::exception &e) {
@@ -119,4 +210,4 @@ MareaTidesAdapter::parse_response(const std::string &response_body) const {
   return result;
 }
 
-} // namespace regeocode
\ No newline at end of file
+} // namespace regeocode
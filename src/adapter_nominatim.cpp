@@ -15,49 +15,50 @@
  */
 
 #include "regeocode/adapter_nominatim.hpp"
-
-#include <nlohmann/json.hpp>
+#include "regeocode/json_scan.hpp"
 
 namespace regeocode {
 
 namespace {
-/**
- * @brief Safely extracts a string from a JSON object.
- *
- * @param j The JSON object.
- * @param key The key to look for.
- * @return std::string The value if it's a string, otherwise an empty string.
- */
-std::string get_string_safe(const nlohmann::json &j, const std::string &key) {
-  if (j.contains(key) && j[key].is_string()) {
-    return j[key].get<std::string>();
-  }
-  return "";
+enum Path : std::size_t {
+  kDisplayName,
+  kAddress,
+  kCountryCode,
+  kCountry,
+  kState,
+  kCity,
+  kTown,
+  kVillage
+};
+
+const scan::PathSet &paths() {
+  static const scan::PathSet set{
+      "display_name",      "address",       "address.country_code",
+      "address.country",   "address.state", "address.city",
+      "address.town",      "address.village"};
+  return set;
 }
 } // namespace
 
 AddressResult
-NominatimAdapter::parse_response(const std::string &response_body) const {
-  nlohmann::json j = nlohmann::json::parse(response_body);
+NominatimAdapter::parse_response(std::string_view response_body) const {
+  const scan::ScanResult j = scan::scan(response_body, paths());
 
   AddressResult res;
-  res.raw_json = response_body;
-
-  res.address_english = get_string_safe(j, "display_name");
+  res.address_english = j.string(kDisplayName);
   res.address_local = res.address_english;
 
-  if (j.contains("address") && j["address"].is_object()) {
-    const auto &addr = j["address"];
-    res.country_code = get_string_safe(addr, "country_code");
-    res.attributes["country"] = get_string_safe(addr, "country");
-    res.attributes["state"] = get_string_safe(addr, "state");
+  if (j.is_object(kAddress)) {
+    res.country_code = j.string(kCountryCode);
+    res.attributes["country"] = j.string(kCountry);
+    res.attributes["state"] = j.string(kState);
 
-    if (addr.contains("city")) {
-      res.attributes["city"] = get_string_safe(addr, "city");
-    } else if (addr.contains("town")) {
-      res.attributes["city"] = get_string_safe(addr, "town");
-    } else if (addr.contains("village")) {
-      res.attributes["city"] = get_string_safe(addr, "village");
+    if (j.has(kCity)) {
+      res.attributes["city"] = j.string(kCity);
+    } else if (j.has(kTown)) {
+      res.attributes["city"] = j.string(kTown);
+    } else if (j.has(kVillage)) {
+      res.attributes["city"] = j.string(kVillage);
     } else {
       res.attributes["city"] = "";
     }
@@ -15,50 +15,59 @@
  */
 
 #include "regeocode/adapter_opencage.hpp"
-
-#include <nlohmann/json.hpp>
+#include "regeocode/json_scan.hpp"
 
 namespace regeocode {
 
 namespace {
-std::string get_string_safe(const nlohmann::json &j, const std::string &key) {
-  if (j.contains(key) && j[key].is_string()) {
-    return j[key].get<std::string>();
-  }
-  return "";
+enum Path : std::size_t {
+  kFormatted,
+  kComponents,
+  kCountryCode,
+  kContinent,
+  kCountry,
+  kState,
+  kCity,
+  kTown,
+  kVillage
+};
+
+const scan::PathSet &paths() {
+  static const scan::PathSet set{"results.0.formatted",
+                                 "results.0.components",
+                                 "results.0.components.country_code",
+                                 "results.0.components.continent",
+                                 "results.0.components.country",
+                                 "results.0.components.state",
+                                 "results.0.components.city",
+                                 "results.0.components.town",
+                                 "results.0.components.village"};
+  return set;
 }
 } // namespace
 
 AddressResult
-OpenCageAdapter::parse_response(const std::string &response_body) const {
-  nlohmann::json j = nlohmann::json::parse(response_body);
+OpenCageAdapter::parse_response(std::string_view response_body) const {
+  const scan::ScanResult j = scan::scan(response_body, paths());
 
   AddressResult res;
-  res.raw_json = response_body;
-
-  if (j.contains("results") && j["results"].is_array() &&
-      !j["results"].empty()) {
-    const auto &first = j["results"][0];
-
-    res.address_english = get_string_safe(first, "formatted");
-    res.address_local = res.address_english;
+  res.address_english = j.string(kFormatted);
+  res.address_local = res.address_english;
 
-    if (first.contains("components") && first["components"].is_object()) {
-      const auto &comp = first["components"];
-      res.country_code = get_string_safe(comp, "country_code");
-      res.attributes["continent"] = get_string_safe(comp, "continent");
-      res.attributes["country"] = get_string_safe(comp, "country");
-      res.attributes["state"] = get_string_safe(comp, "state");
+  if (j.is_object(kComponents)) {
+    res.country_code = j.string(kCountryCode);
+    res.attributes["continent"] = j.string(kContinent);
+    res.attributes["country"] = j.string(kCountry);
+    res.attributes["state"] = j.string(kState);
 
-      if (comp.contains("city")) {
-        res.attributes["city"] = get_string_safe(comp, "city");
-      } else if (comp.contains("town")) {
-        res.attributes["city"] = get_string_safe(comp, "town");
-      } else if (comp.contains("village")) {
-        res.attributes["city"] = get_string_safe(comp, "village");
-      } else {
-        res.attributes["city"] = "";
-      }
+    if (j.has(kCity)) {
+      res.attributes["city"] = j.string(kCity);
+    } else if (j.has(kTown)) {
+      res.attributes["city"] = j.string(kTown);
+    } else if (j.has(kVillage)) {
+      res.attributes["city"] = j.string(kVillage);
+    } else {
+      res.attributes["city"] = "";
     }
   }
 
@@ -15,50 +15,83 @@
  */
 
 #include "regeocode/adapter_openweather.hpp"
-#include <iomanip>
-#include <nlohmann/json.hpp>
-#include <sstream>
+#include "regeocode/json_scan.hpp"
+
 #include <string>
 
 namespace regeocode {
 
+namespace {
+enum Path : std::size_t {
+  kName,
+  kCountry,
+  kDescription,
+  kMain,
+  kTemp,
+  kFeelsLike,
+  kPressure,
+  kHumidity,
+  kWind,
+  kWindSpeed,
+  kWindDeg
+};
+
+const scan::PathSet &paths() {
+  static const scan::PathSet set{
+      "name",          "sys.country",   "weather.0.description",
+      "main",          "main.temp",     "main.feels_like",
+      "main.pressure", "main.humidity", "wind",
+      "wind.speed",    "wind.deg"};
+  return set;
+}
+
+/// Number at @p path, or 0 when missing (like json::value(key, 0)).
+double number_or_zero(const scan::ScanResult &j, std::size_t path) {
+  const scan::Field *f = j.get(path);
+  return f != nullptr ? f->as_double() : 0.0;
+}
+
+long integer_or_zero(const scan::ScanResult &j, std::size_t path) {
+  const scan::Field *f = j.get(path);
+  return f != nullptr ? f->as_long() : 0;
+}
+} // namespace
+
 AddressResult
-OpenWeatherAdapter::parse_response(const std::string &response_body) const {
+OpenWeatherAdapter::parse_response(std::string_view response_body) const {
   AddressResult res;
-  res.raw_json = response_body;
-
   try {
-    auto j = nlohmann::json::parse(response_body);
+    const scan::ScanResult j = scan::scan(response_body, paths());
 
     // Title & Country
-    if (j.contains("name"))
-      res.address_english = j["name"].get<std::string>();
-    if (j.contains("sys") && j["sys"].contains("country")) {
-      res.country_code = j["sys"]["country"].get<std::string>();
+    if (j.has(kName))
+      res.address_english = j.string(kName);
+    if (j.has(kCountry)) {
+      res.country_code = j.string(kCountry);
     }
 
     // Fill attributes
-    if (j.contains("weather") && !j["weather"].empty()) {
-      res.address_local = j["weather"][0]["description"].get<std::string>();
+    if (j.has(kDescription)) {
+      res.address_local = j.string(kDescription);
       res.attributes["condition"] = res.address_local;
     }
 
-    if (j.contains("main")) {
-      auto &m = j["main"];
-      res.attributes["temp"] = std::to_string(m.value("temp", 0.0));
-      res.attributes["feels_like"] = std::to_string(m.value("feels_like", 0.0));
-      res.attributes["pressure"] = std::to_string(m.value("pressure", 0));
-      res.attributes["humidity"] = std::to_string(m.value("humidity", 0));
+    if (j.has(kMain)) {
+      res.attributes["temp"] = std::to_string(number_or_zero(j, kTemp));
+      res.attributes["feels_like"] =
+          std::to_string(number_or_zero(j, kFeelsLike));
+      res.attributes["pressure"] = std::to_string(integer_or_zero(j, kPressure));
+      res.attributes["humidity"] = std::to_string(integer_or_zero(j, kHumidity));
     }
 
-    if (j.contains("wind")) {
+    if (j.has(kWind)) {
       res.attributes["wind_speed"] =
-          std::to_string(j["wind"].value("speed", 0.0));
-      res.attributes["wind_deg"] = std::to_string(j["wind"].value("deg", 0));
+          std::to_string(number_or_zero(j, kWindSpeed));
+      res.attributes["wind_deg"] = std::to_string(integer_or_zero(j, kWindDeg));
     }
 
   } catch (...) {
   }
   return res;
 }
-} // namespace regeocode
\ No newline at end of file
+} // namespace regeocode
@@ -15,43 +15,47 @@
  */
 
 #include "regeocode/adapter_pollution.hpp"
-#include <nlohmann/json.hpp>
+#include "regeocode/json_scan.hpp"
 
 namespace regeocode {
 
+namespace {
+enum Path : std::size_t { kAqi, kComponents };
+
+const scan::PathSet &paths() {
+  static const scan::PathSet set{"list.0.main.aqi", "list.0.components.*"};
+  return set;
+}
+} // namespace
+
 AddressResult
-PollutionAdapter::parse_response(const std::string &response_body) const {
+PollutionAdapter::parse_response(std::string_view response_body) const {
   AddressResult res;
-  res.raw_json = response_body;
-
   try {
-    auto j = nlohmann::json::parse(response_body);
-    if (j.contains("list") && !j["list"].empty()) {
-      const auto &first = j["list"][0];
-
-      // AQI
-      if (first.contains("main") && first["main"].contains("aqi")) {
-        int aqi = first["main"]["aqi"].get<int>();
-        res.attributes["aqi"] = std::to_string(aqi);
-
-        static const char *ratings[] = {"",         "Good", "Fair",
-                                        "Moderate", "Poor", "Very Poor"};
-        if (aqi >= 1 && aqi <= 5)
-          res.address_english = std::string("Air Quality: ") + ratings[aqi];
-        else
-          res.address_english = "Air Quality: Unknown";
-      }
-
-      // Push components into the map
-      if (first.contains("components")) {
-        for (auto &el : first["components"].items()) {
-          // Saves e.g. "co" -> "331.41"
-          res.attributes[el.key()] = std::to_string(el.value().get<double>());
-        }
-      }
+    const scan::ScanResult j = scan::scan(response_body, paths());
+
+    // AQI
+    if (const auto *aqi_field = j.get(kAqi)) {
+      long aqi = aqi_field->as_long();
+      res.attributes["aqi"] = std::to_string(aqi);
+
+      static const char *ratings[] = {"",         "Good", "Fair",
+                                      "Moderate", "Poor", "Very Poor"};
+      if (aqi >= 1 && aqi <= 5)
+        res.address_english = std::string("Air Quality: ") + ratings[aqi];
+      else
+        res.address_english = "Air Quality: Unknown";
+    }
+
+    // Push components into the map
+    for (const auto &f : j.fields()) {
+      if (f.path != kComponents)
+        continue;
+      // Saves e.g. "co" -> "331.41"
+      res.attributes[f.capture(0).key_string()] = std::to_string(f.as_double());
     }
   } catch (...) {
   }
   return res;
 }
-} // namespace regeocode
\ No newline at end of file
+} // namespace regeocode
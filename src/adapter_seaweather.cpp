@@ -15,15 +15,54 @@
  */
 
 #include "regeocode/adapter_seaweather.hpp"
-#include <iostream>
-#include <nlohmann/json.hpp>
+#include "regeocode/json_scan.hpp"
+
+#include <algorithm>
 #include <sstream>
 #include <string>
+#include <tuple>
+#include <vector>
 
 namespace regeocode {
 
+namespace {
+enum Path : std::size_t {
+  kMetaLat,
+  kMetaLng,
+  kMetaDailyQuota,
+  kMetaRequestCount,
+  kMeta,
+  kTime,
+  kReading,
+  kCurrent
+};
+
+const scan::PathSet &paths() {
+  static const scan::PathSet set{
+      "meta.lat",        "meta.lng", "meta.dailyQuota",
+      "meta.requestCount", "meta",   "hours.0.time",
+      "hours.0.*.*",     "hours.0"};
+  return set;
+}
+
+// The scan stops once both sections are seen; only the first hour of the
+// (typically ten day) "hours" array is ever decoded.
+enum Section : unsigned {
+  kSeenMeta = 1u << 0,
+  kSeenCurrent = 1u << 1,
+  kSeenAll = (1u << 2) - 1
+};
+
+/// One provider value of one parameter, e.g. waveHeight/noaa.
+struct Reading {
+  std::string key;
+  std::string source;
+  std::string value;
+};
+} // namespace
+
 AddressResult
-SeaWeatherAdapter::parse_response(const std::string &response_body) const {
+SeaWeatherAdapter::parse_response(std::string_view response_body) const {
   AddressResult result;
 
   // Defaults
@@ -32,97 +71,90 @@ SeaWeatherAdapter::parse_response(const std::string &response_body) const {
   result.country_code = "";
 
   try {
-    auto root = nlohmann::json::parse(response_body);
-
-    // 1. Process Metadata
-    if (root.contains("meta")) {
-      const auto &meta = root["meta"];
-      if (meta.contains("lat"))
-        result.attributes["meta_lat"] =
-            std::to_string(meta["lat"].get<double>());
-      if (meta.contains("lng"))
-        result.attributes["meta_lng"] =
-            std::to_string(meta["lng"].get<double>());
-      if (meta.contains("dailyQuota"))
-        result.attributes["meta_dailyQuota"] =
-            std::to_string(meta["dailyQuota"].get<long>());
-      if (meta.contains("requestCount"))
-        result.attributes["meta_requestCount"] =
-            std::to_string(meta["requestCount"].get<long>());
-    }
-
-    // 2. Weather data (Hours)
-    // We focus on the first entry (current hour) to avoid exploding the
-    // attributes.
-    if (root.contains("hours") && root["hours"].is_array() &&
-        !root["hours"].empty()) {
-      const auto &current = root["hours"][0];
+    std::string time;
+    bool has_time = false;
+    bool has_current = false;
+    std::vector<Reading> readings;
+    unsigned seen = 0;
+
+    scan::scan_each(response_body, paths(), [&](const scan::Field &f) {
+      switch (f.path) {
+      // 1. Process Metadata
+      case kMetaLat:
+        result.attributes["meta_lat"] = std::to_string(f.as_double());
+        break;
+      case kMetaLng:
+        result.attributes["meta_lng"] = std::to_string(f.as_double());
+        break;
+      case kMetaDailyQuota:
+        result.attributes["meta_dailyQuota"] = std::to_string(f.as_long());
+        break;
+      case kMetaRequestCount:
+        result.attributes["meta_requestCount"] = std::to_string(f.as_long());
+        break;
+      case kMeta:
+        seen |= kSeenMeta;
+        break;
+
+      // 2. Weather data (Hours)
+      // We focus on the first entry (current hour) to avoid exploding the
+      // attributes.
+      case kTime:
+        time = f.str();
+        has_time = true;
+        break;
+      case kReading: {
+        Reading r{f.capture(0).key_string(), f.capture(1).key_string(), {}};
+        if (r.key == "time")
+          break; // Already handled
+        if (f.kind == scan::Kind::Number)
+          r.value = std::to_string(f.as_double());
+        else if (f.kind == scan::Kind::String)
+          r.value = f.str();
+        readings.push_back(std::move(r));
+        break;
+      }
+      case kCurrent:
+        has_current = true;
+        seen |= kSeenCurrent;
+        break;
+      }
+      return seen != kSeenAll;
+    });
+
+    if (has_current) {
+      // Parameters (airTemperature, waveHeight, etc.) and providers (smhi,
+      // noaa, sg, etc.) in key order, as the summary picks the first one
+      std::stable_sort(readings.begin(), readings.end(),
+                       [](const Reading &a, const Reading &b) {
+                         return std::tie(a.key, a.source) <
+                                std::tie(b.key, b.source);
+                       });
 
       std::stringstream summary_ss;
-      bool first_summary_item = true;
 
       // Timestamp
-      if (current.contains("time")) {
-        std::string t = current["time"].get<std::string>();
-        result.attributes["time"] = t;
-        summary_ss << "Time: " << t << " | ";
+      if (has_time) {
+        result.attributes["time"] = time;
+        summary_ss << "Time: " << time << " | ";
       }
 
-      // Iterate dynamically through all parameters (airTemperature, waveHeight,
-      // etc.)
-      for (auto &[key, val_obj] : current.items()) {
-        if (key == "time")
-          continue; // Already handled
-
-        if (val_obj.is_object()) {
-          // Iterate through providers (smhi, noaa, sg, etc.)
-          for (auto &[source, value] : val_obj.items()) {
-            std::string attr_key = key + "_" + source;
-            std::string attr_val;
-
-            if (value.is_number()) {
-              attr_val = std::to_string(value.get<double>());
-            } else if (value.is_string()) {
-              attr_val = value.get<std::string>();
-            }
-
-            result.attributes[attr_key] = attr_val;
-
-            // For the summary we only take the first found provider per
-            // category to keep the string short (e.g. only sg or noaa)
-            if (first_summary_item) {
-              summary_ss << key << ": " << attr_val;
-              first_summary_item = false;
-            }
-          }
-          if (!first_summary_item) {
-            // Reset flag for next category (but we want simple summary,
-            // so we don't add anything complicated here, maybe only for the
-            // very first key) Better Summary Logic:
-          }
-        }
-      }
+      for (const auto &r : readings)
+        result.attributes[r.key + "_" + r.source] = r.value;
 
-      // Attempt at a clean summary: prioritize temperature and wave height
-      std::string temp = "";
-      std::string wave = "";
+      // For the generic summary we only take the very first provider value
+      if (!readings.empty())
+        summary_ss << readings.front().key << ": " << readings.front().value;
 
-      // Helper lambda to get any value from the object
+      // Attempt at a clean summary: prioritize temperature and wave height
       auto get_any_value = [&](const std::string &key) -> std::string {
-        if (current.contains(key) && current[key].is_object() &&
-            !current[key].empty()) {
-          // Take the first provider (e.g. begin()->value())
-          auto it = current[key].begin();
-          if (it.value().is_number())
-            return std::to_string(it.value().get<double>());
-          if (it.value().is_string())
-            return it.value().get<std::string>();
-        }
-        return "";
+        auto it = std::find_if(readings.begin(), readings.end(),
+                               [&](const Reading &r) { return r.key == key; });
+        return it != readings.end() ? it->value : "";
       };
 
-      temp = get_any_value("airTemperature");
-      wave = get_any_value("waveHeight");
+      const std::string temp = get_any_value("airTemperature");
+      const std::string wave = get_any_value("waveHeight");
 
       std::stringstream loc;
       if (!temp.empty())
@@ -144,4 +176,4 @@ SeaWeatherAdapter::parse_response(const std::string &response_body) const {
   return result;
 }
 
-} // namespace regeocode
\ No newline at end of file
+} // namespace regeocode
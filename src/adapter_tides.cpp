@@ -15,16 +15,65 @@
  */
 
 #include "regeocode/adapter_tides.hpp"
+#include "regeocode/json_scan.hpp"
+
 #include <iomanip>
-#include <nlohmann/json.hpp>
+#include <optional>
 #include <sstream>
 #include <string>
-#include <vector>
 
 namespace regeocode {
 
+namespace {
+enum Path : std::size_t {
+  kUnit,
+  kDisclaimer,
+  kOriginDistance,
+  kOriginUnit,
+  kOrigin,
+  kExtremeState,
+  kExtremeTime,
+  kExtremeHeight,
+  kExtreme,
+  kExtremes,
+  kCurrentHeight,
+  kCurrentState,
+  kCurrent
+};
+
+const scan::PathSet &paths() {
+  static const scan::PathSet set{
+      "unit",
+      "disclaimer",
+      "origin.distance",
+      "origin.unit",
+      "origin",
+      "extremes.*.state",
+      "extremes.*.datetime",
+      "extremes.*.height",
+      "extremes.*",
+      "extremes",
+      "heights.0.height",
+      "heights.0.state",
+      "heights.0"};
+  return set;
+}
+
+constexpr std::size_t kMaxEvents = 5; // Save max 5 entries
+
+// Sections of the response; the scan stops once all of them are seen.
+enum Section : unsigned {
+  kSeenUnit = 1u << 0,
+  kSeenDisclaimer = 1u << 1,
+  kSeenOrigin = 1u << 2,
+  kSeenExtremes = 1u << 3,
+  kSeenCurrent = 1u << 4,
+  kSeenAll = (1u << 5) - 1
+};
+} // namespace
+
 AddressResult
-TidesAdapter::parse_response(const std::string &response_body) const {
+TidesAdapter::parse_response(std::string_view response_body) const {
   AddressResult result;
 
   // Defaults
@@ -33,71 +82,97 @@ TidesAdapter::parse_response(const std::string &response_body) const {
   result.country_code = ""; // Tides often don't have a country code in the root
 
   try {
-    auto root = nlohmann::json::parse(response_body);
-
-    // 1. Basic information
     std::string unit = "m";
-    if (root.contains("unit"))
-      unit = root["unit"].get<std::string>();
-    result.attributes["unit"] = unit;
-
-    if (root.contains("disclaimer")) {
-      result.attributes["disclaimer"] = root["disclaimer"].get<std::string>();
-    }
-
-    // 2. Origin / Station Distance
-    if (root.contains("origin")) {
-      auto origin = root["origin"];
-      if (origin.contains("distance") && origin.contains("unit")) {
-        std::string dist = std::to_string(origin["distance"].get<double>()) +
-                           " " + origin["unit"].get<std::string>();
-        result.attributes["station_distance"] = dist;
-      }
-    }
-
-    // 3. Process extreme values (High/Low Tides)
-    // This is usually the most important thing for the user
-    if (root.contains("extremes") && root["extremes"].is_array() &&
-        !root["extremes"].empty()) {
-      int i = 0;
-      std::string summary_text = "";
-
-      for (const auto &item : root["extremes"]) {
-        std::string prefix =
+    std::optional<double> distance;
+    std::optional<std::string> distance_unit;
+    std::string first_state;
+    std::string first_time;
+    double first_height = 0.0;
+    std::size_t events = 0;
+    unsigned seen = 0;
+
+    scan::scan_each(response_body, paths(), [&](const scan::Field &f) {
+      switch (f.path) {
+      // 1. Basic information
+      case kUnit:
+        unit = f.str();
+        seen |= kSeenUnit;
+        break;
+      case kDisclaimer:
+        result.attributes["disclaimer"] = f.str();
+        seen |= kSeenDisclaimer;
+        break;
+
+      // 2. Origin / Station Distance
+      case kOriginDistance:
+        distance = f.as_double();
+        break;
+      case kOriginUnit:
+        distance_unit = f.str();
+        break;
+      case kOrigin:
+        if (distance && distance_unit)
+          result.attributes["station_distance"] =
+              std::to_string(*distance) + " " + *distance_unit;
+        seen |= kSeenOrigin;
+        break;
+
+      // 3. Extreme values (High/Low Tides), usually the most important
+      // thing for the user
+      case kExtremeState:
+      case kExtremeTime:
+      case kExtremeHeight: {
+        const std::size_t i = f.capture(0).index;
+        if (i >= kMaxEvents)
+          break;
+        const std::string prefix =
             "event_" + std::to_string(i); // event_0, event_1 ...
-
-        std::string state = item["state"];
-        std::string time = item["datetime"];
-        double height = item["height"].get<double>();
-
-        // Write to attribute map
-        result.attributes[prefix + "_state"] = state;
-        result.attributes[prefix + "_time"] = time;
-        result.attributes[prefix + "_height"] = std::to_string(height);
-
-        // Use the very first entry as "Summary"
-        if (i == 0) {
-          std::stringstream ss;
-          ss << state << " (" << std::fixed << std::setprecision(2) << height
-             << unit << ") at " << time;
-          summary_text = ss.str();
+        if (f.path == kExtremeState) {
+          result.attributes[prefix + "_state"] = f.str();
+          if (i == 0)
+            first_state = f.str();
+        } else if (f.path == kExtremeTime) {
+          result.attributes[prefix + "_time"] = f.str();
+          if (i == 0)
+            first_time = f.str();
+        } else {
+          result.attributes[prefix + "_height"] = std::to_string(f.as_double());
+          if (i == 0)
+            first_height = f.as_double();
         }
-
-        i++;
-        if (i >= 5)
-          break; // Save max 5 entries
+        break;
+      }
+      case kExtreme:
+        events = f.capture(0).index + 1;
+        if (events >= kMaxEvents)
+          seen |= kSeenExtremes;
+        break;
+      case kExtremes:
+        seen |= kSeenExtremes;
+        break;
+
+      // 4. Current/Next hourly forecast (optional)
+      case kCurrentHeight:
+        result.attributes["current_height"] = std::to_string(f.as_double());
+        break;
+      case kCurrentState:
+        result.attributes["current_state"] = f.str();
+        break;
+      case kCurrent:
+        seen |= kSeenCurrent;
+        break;
       }
+      return seen != kSeenAll;
+    });
 
-      result.address_local = summary_text;
-    }
+    result.attributes["unit"] = unit;
 
-    // 4. Current/Next hourly forecast (optional)
-    if (root.contains("heights") && root["heights"].is_array() &&
-        !root["heights"].empty()) {
-      const auto &current = root["heights"][0];
-      result.attributes["current_height"] =
-          std::to_string(current["height"].get<double>());
-      result.attributes["current_state"] = current["state"];
+    // Use the very first entry as "Summary"
+    if (events > 0) {
+      std::stringstream ss;
+      ss << first_state << " (" << std::fixed << std::setprecision(2)
+         << first_height << unit << ") at " << first_time;
+      result.address_local = ss.str();
     }
 
   } catch (const std::exception &e) {
@@ -108,4 +183,4 @@ TidesAdapter::parse_response(const std::string &response_body) const {
   return result;
 }
 
-} // namespace regeocode
\ No newline at end of file
+} // namespace regeocode
@@ -0,0 +1,243 @@
+/**
+ * SPDX-FileComment: Implementation of the flat attribute container.
+ * SPDX-FileType: SOURCE
+ * SPDX-FileContributor: ZHENG Robert
+ * SPDX-FileCopyrightText: 2026 ZHENG Robert
+ * SPDX-License-Identifier: MIT
+ *
+ * @file attribute_map.cpp
+ * @brief Sorted entry vector with interned keys and a value arena.
+ * @version 0.1.0
+ * @date 2026-10-19
+ *
+ * @author ZHENG Robert
+ * @license MIT License
+ */
+
+#include "regeocode/attribute_map.hpp"
+
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <mutex>
+#include <nlohmann/json.hpp>
+#include <shared_mutex>
+#include <stdexcept>
+#include <unordered_set>
+#include <utility>
+
+namespace regeocode {
+
+namespace {
+// Initial capacity: one allocation each covers most geocoding results
+constexpr std::size_t kInitialEntries = 8;
+constexpr std::size_t kInitialValueBytes = 128;
+
+struct KeyHash {
+  using is_transparent = void;
+  std::size_t operator()(std::string_view key) const noexcept {
+    return std::hash<std::string_view>{}(key);
+  }
+};
+} // namespace
+
+std::optional<std::string_view> intern_attribute_key(std::string_view key) {
+  // Views of pool entries this thread has looked up; bounded by the pool
+  thread_local std::unordered_set<std::string_view, KeyHash> seen;
+  if (auto it = seen.find(key); it != seen.end())
+    return *it;
+
+  // Node-based set: element addresses are stable across rehashing
+  static std::shared_mutex mutex;
+  static std::unordered_set<std::string, KeyHash, std::equal_to<>> pool;
+
+  std::string_view interned;
+  {
+    std::shared_lock lock(mutex);
+    if (auto it = pool.find(key); it != pool.end())
+      interned = *it;
+  }
+  if (interned.data() == nullptr) {
+    std::unique_lock lock(mutex);
+    if (auto it = pool.find(key); it != pool.end())
+      interned = *it;
+    else if (pool.size() < kMaxInternedAttributeKeys)
+      interned = *pool.emplace(key).first;
+    else
+      return std::nullopt;
+  }
+  seen.insert(interned);
+  return interned;
+}
+
+std::size_t AttributeMap::lower_bound(std::string_view key) const noexcept {
+  auto it = std::lower_bound(
+      entries_.begin(), entries_.end(), key,
+      [this](const Entry &e, std::string_view k) { return key_of(e) < k; });
+  return static_cast<std::size_t>(it - entries_.begin());
+}
+
+AttributeMap::reference AttributeMap::operator[](std::string_view key) {
+  std::size_t i = lower_bound(key);
+  if (i == entries_.size() || key_of(entries_[i]) != key) {
+    if (entries_.empty()) {
+      entries_.reserve(kInitialEntries);
+      values_.reserve(kInitialValueBytes);
+    }
+    Entry e;
+    if (const auto interned = intern_attribute_key(key))
+      e.pooled = interned->data();
+    else
+      e.key_offset = append(key);
+    e.key_length = static_cast<std::uint32_t>(key.size());
+    e.offset = static_cast<std::uint32_t>(values_.size());
+    entries_.insert(entries_.begin() + static_cast<std::ptrdiff_t>(i), e);
+  }
+  return {this, entries_[i], i};
+}
+
+std::uint32_t AttributeMap::append(std::string_view bytes) {
+  if (values_.size() + bytes.size() >
+      std::numeric_limits<std::uint32_t>::max())
+    throw std::length_error("AttributeMap value store exceeds 4 GiB");
+
+  const auto offset = static_cast<std::uint32_t>(values_.size());
+  // The bytes may point into our own buffer, which append() can reallocate
+  const char *data = values_.data();
+  if (bytes.data() >= data && bytes.data() < data + values_.size())
+    values_.append(values_, static_cast<std::size_t>(bytes.data() - data),
+                   bytes.size());
+  else
+    values_.append(bytes);
+  return offset;
+}
+
+void AttributeMap::assign(std::size_t index, std::string_view value) {
+  Entry &e = entries_[index];
+  if (value.size() <= e.length) {
+    // Shrinking or same size: overwrite in place (memmove handles overlap)
+    std::char_traits<char>::move(values_.data() + e.offset, value.data(),
+                                 value.size());
+    dead_ += e.length - value.size();
+    e.length = static_cast<std::uint32_t>(value.size());
+    return;
+  }
+
+  const std::uint32_t old_length = e.length;
+  e.offset = append(value);
+  e.length = static_cast<std::uint32_t>(value.size());
+  dead_ += old_length;
+  reclaim();
+}
+
+void AttributeMap::pack(std::string_view source) {
+  std::size_t live = 0;
+  for (const Entry &e : entries_)
+    live += e.length + (e.pooled ? 0 : e.key_length);
+  std::string packed;
+  packed.reserve(live);
+  for (Entry &e : entries_) {
+    if (!e.pooled) {
+      const auto key_offset = static_cast<std::uint32_t>(packed.size());
+      packed.append(source.substr(e.key_offset, e.key_length));
+      e.key_offset = key_offset;
+    }
+    const auto offset = static_cast<std::uint32_t>(packed.size());
+    packed.append(source.substr(e.offset, e.length));
+    e.offset = offset;
+  }
+  values_.swap(packed);
+  dead_ = 0;
+}
+
+void AttributeMap::reclaim() {
+  if (dead_ > values_.size() - dead_)
+    pack(values_);
+}
+
+AttributeMap::AttributeMap(const AttributeMap &other)
+    : entries_(other.entries_) {
+  pack(other.values_);
+}
+
+AttributeMap &AttributeMap::operator=(const AttributeMap &other) {
+  if (this != &other) {
+    entries_ = other.entries_;
+    pack(other.values_);
+  }
+  return *this;
+}
+
+AttributeMap::AttributeMap(AttributeMap &&other) noexcept
+    : entries_(std::move(other.entries_)), values_(std::move(other.values_)),
+      dead_(std::exchange(other.dead_, 0)) {
+  other.clear();
+}
+
+AttributeMap &AttributeMap::operator=(AttributeMap &&other) noexcept {
+  if (this != &other) {
+    entries_ = std::move(other.entries_);
+    values_ = std::move(other.values_);
+    dead_ = std::exchange(other.dead_, 0);
+    other.clear();
+  }
+  return *this;
+}
+
+std::string_view AttributeMap::at(std::string_view key) const {
+  std::size_t i = lower_bound(key);
+  if (i == entries_.size() || key_of(entries_[i]) != key)
+    throw std::out_of_range("Unknown attribute: " + std::string(key));
+  return value_at(i);
+}
+
+AttributeMap::const_iterator
+AttributeMap::find(std::string_view key) const noexcept {
+  std::size_t i = lower_bound(key);
+  if (i == entries_.size() || key_of(entries_[i]) != key)
+    return end();
+  return {this, i};
+}
+
+bool AttributeMap::contains(std::string_view key) const noexcept {
+  std::size_t i = lower_bound(key);
+  return i != entries_.size() && key_of(entries_[i]) == key;
+}
+
+AttributeMap::size_type AttributeMap::erase(std::string_view key) {
+  std::size_t i = lower_bound(key);
+  if (i == entries_.size() || key_of(entries_[i]) != key)
+    return 0;
+  const Entry &e = entries_[i];
+  dead_ += e.length + (e.pooled ? 0 : e.key_length);
+  entries_.erase(entries_.begin() + static_cast<std::ptrdiff_t>(i));
+  reclaim();
+  return 1;
+}
+
+void AttributeMap::clear() noexcept {
+  entries_.clear();
+  values_.clear();
+  dead_ = 0;
+}
+
+std::map<std::string, std::string> AttributeMap::to_map() const {
+  std::map<std::string, std::string> out;
+  for (const auto &[key, value] : *this)
+    out.emplace_hint(out.end(), key, value);
+  return out;
+}
+
+bool AttributeMap::operator==(const AttributeMap &other) const {
+  return std::equal(begin(), end(), other.begin(), other.end());
+}
+
+void to_json(nlohmann::json &j, const AttributeMap &attributes) {
+  j = nlohmann::json::object();
+  // Entries are sorted, so every insert goes to the end of the object
+  auto &object = j.get_ref<nlohmann::json::object_t &>();
+  for (const auto &[key, value] : attributes)
+    object.emplace_hint(object.end(), key, value);
+}
+
+} // namespace regeocode
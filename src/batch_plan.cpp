@@ -0,0 +1,142 @@
+/**
+ * SPDX-FileComment: Implementation of batch planning.
+ * SPDX-FileType: SOURCE
+ * SPDX-FileContributor: ZHENG Robert
+ * SPDX-FileCopyrightText: 2026 ZHENG Robert
+ * SPDX-License-Identifier: MIT
+ *
+ * @file batch_plan.cpp
+ * @brief Grid snapping, deduplication and Z-order grouping of batches.
+ * @version 0.1.0
+ * @date 2026-10-19
+ *
+ * @author ZHENG Robert
+ * @license MIT License
+ */
+
+#include "regeocode/batch_plan.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <numeric>
+#include <string_view>
+#include <tuple>
+#include <unordered_map>
+
+namespace regeocode {
+
+namespace {
+constexpr double kMetresPerDegree = 111320.0;
+constexpr double kPi = 3.14159265358979323846;
+
+/// Grid cell of a point: row and column, or the exact bits for step 0.
+struct Cell {
+  std::int64_t row;
+  std::int64_t col;
+  bool operator==(const Cell &) const = default;
+};
+
+Cell cell_of(const Coordinates &c, double step_m) {
+  if (step_m <= 0.0) {
+    // + 0.0 folds -0.0 into 0.0
+    return {std::bit_cast<std::int64_t>(c.latitude + 0.0),
+            std::bit_cast<std::int64_t>(c.longitude + 0.0)};
+  }
+  const double lat_step = step_m / kMetresPerDegree;
+  const auto row = static_cast<std::int64_t>(std::floor(c.latitude / lat_step));
+  // Columns as wide as the row is tall, measured at the row's middle
+  const double middle = (static_cast<double>(row) + 0.5) * lat_step;
+  const double shrink = std::max(std::cos(middle * kPi / 180.0), 1e-9);
+  const double lon_step = std::min(lat_step / shrink, 360.0);
+  const auto col = static_cast<std::int64_t>(
+      std::floor((c.longitude + 180.0) / lon_step));
+  return {row, col};
+}
+
+struct PointKey {
+  Cell cell;
+  std::string_view country_code;
+  bool operator==(const PointKey &) const = default;
+};
+
+struct PointKeyHash {
+  std::size_t operator()(const PointKey &k) const noexcept {
+    std::size_t h = std::hash<std::int64_t>{}(k.cell.row);
+    h ^= std::hash<std::int64_t>{}(k.cell.col) + 0x9e3779b97f4a7c15ULL +
+         (h << 6) + (h >> 2);
+    h ^= std::hash<std::string_view>{}(k.country_code) + 0x9e3779b97f4a7c15ULL +
+         (h << 6) + (h >> 2);
+    return h;
+  }
+};
+
+/// Interleaves the low 32 bits of row and column (Z-order curve).
+std::uint64_t morton(const Cell &c) {
+  auto spread = [](std::uint64_t v) {
+    v &= 0xffffffffULL;
+    v = (v | (v << 16)) & 0x0000ffff0000ffffULL;
+    v = (v | (v << 8)) & 0x00ff00ff00ff00ffULL;
+    v = (v | (v << 4)) & 0x0f0f0f0f0f0f0f0fULL;
+    v = (v | (v << 2)) & 0x3333333333333333ULL;
+    v = (v | (v << 1)) & 0x5555555555555555ULL;
+    return v;
+  };
+  return spread(static_cast<std::uint64_t>(c.row)) << 1 |
+         spread(static_cast<std::uint64_t>(c.col));
+}
+} // namespace
+
+BatchPlan::BatchPlan(std::span<const Coordinates> coords,
+                     const BatchOptions &options) {
+  // Deduplicate: the first point of each cell (and country) answers for all
+  std::vector<std::size_t> firsts; // input index of each unique point
+  std::unordered_map<PointKey, std::size_t, PointKeyHash> seen;
+  seen.reserve(coords.size());
+  source_.reserve(coords.size());
+  for (std::size_t i = 0; i < coords.size(); ++i) {
+    const PointKey key{cell_of(coords[i], options.quantum_m),
+                       coords[i].country_code};
+    const auto [it, inserted] = seen.try_emplace(key, firsts.size());
+    if (inserted)
+      firsts.push_back(i);
+    source_.push_back(it->second);
+  }
+
+  // Group by cell, cells in Z-order; input order within a cell
+  std::vector<std::size_t> order(firsts.size());
+  std::iota(order.begin(), order.end(), std::size_t{0});
+  std::vector<Cell> cells;
+  if (options.cell_m > 0.0) {
+    cells.reserve(firsts.size());
+    for (const std::size_t i : firsts)
+      cells.push_back(cell_of(coords[i], options.cell_m));
+    std::stable_sort(order.begin(), order.end(),
+                     [&cells](std::size_t a, std::size_t b) {
+                       const Cell &x = cells[a];
+                       const Cell &y = cells[b];
+                       return std::tuple(morton(x), x.row, x.col) <
+                              std::tuple(morton(y), y.row, y.col);
+                     });
+  }
+
+  std::vector<std::size_t> position(order.size());
+  unique_.reserve(order.size());
+  for (std::size_t k = 0; k < order.size(); ++k) {
+    position[order[k]] = k;
+    if (k == 0 || (!cells.empty() && !(cells[order[k]] == cells[order[k - 1]])))
+      group_starts_.push_back(k);
+    unique_.push_back(coords[firsts[order[k]]]);
+  }
+  group_starts_.push_back(unique_.size());
+  for (std::size_t &s : source_)
+    s = position[s];
+}
+
+BatchReport BatchPlan::report() const noexcept {
+  return {source_.size(), unique_.size(), group_starts_.size() - 1};
+}
+
+} // namespace regeocode
@@ -0,0 +1,278 @@
+/**
+ * SPDX-FileComment: Implementation of the HTTP response cache.
+ * SPDX-FileType: SOURCE
+ * SPDX-FileContributor: ZHENG Robert
+ * SPDX-FileCopyrightText: 2026 ZHENG Robert
+ * SPDX-License-Identifier: MIT
+ *
+ * @file http_cache.cpp
+ * @brief Freshness from Cache-Control/Expires, conditional revalidation and
+ *        LRU eviction.
+ * @version 0.1.0
+ * @date 2026-10-19
+ *
+ * @author ZHENG Robert
+ * @license MIT License
+ */
+
+#include "regeocode/http_cache.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <optional>
+#include <string_view>
+
+namespace regeocode {
+
+namespace {
+using Clock = std::chrono::steady_clock;
+
+std::string_view trim(std::string_view s) {
+  constexpr std::string_view kWs = " \t\r\n";
+  const auto first = s.find_first_not_of(kWs);
+  if (first == std::string_view::npos)
+    return {};
+  return s.substr(first, s.find_last_not_of(kWs) - first + 1);
+}
+
+bool iequals(std::string_view a, std::string_view b) {
+  return std::ranges::equal(a, b, [](char x, char y) {
+    return std::tolower(static_cast<unsigned char>(x)) ==
+           std::tolower(static_cast<unsigned char>(y));
+  });
+}
+
+std::optional<long long> parse_seconds(std::string_view s) {
+  s = trim(s);
+  if (!s.empty() && s.front() == '"' && s.back() == '"' && s.size() >= 2)
+    s = s.substr(1, s.size() - 2);
+  long long value = 0;
+  const auto [ptr, ec] = std::from_chars(s.data(), s.data() + s.size(), value);
+  if (ec != std::errc() || ptr != s.data() + s.size() || value < 0)
+    return std::nullopt;
+  return value;
+}
+
+/**
+ * @brief What the caching headers of a response allow.
+ */
+struct Directives {
+  bool no_store = false;
+  bool explicit_freshness = false; ///< Cache-Control or Expires present.
+  Clock::duration lifetime{};      ///< Freshness left on arrival.
+};
+
+Directives directives(const HttpResponse &response) {
+  Directives d;
+  std::optional<long long> max_age;
+  bool no_cache = false;
+
+  std::string_view rest = response.cache_control;
+  while (!rest.empty()) {
+    const auto comma = rest.find(',');
+    const std::string_view token = trim(rest.substr(0, comma));
+    rest = comma == std::string_view::npos ? std::string_view{}
+                                           : rest.substr(comma + 1);
+    const auto eq = token.find('=');
+    const std::string_view name = trim(token.substr(0, eq));
+    // A geocoder answers many callers, so it is not a cache for one user
+    if (iequals(name, "no-store") || iequals(name, "private"))
+      d.no_store = true;
+    else if (iequals(name, "no-cache"))
+      no_cache = true;
+    else if (iequals(name, "max-age") && eq != std::string_view::npos)
+      max_age = parse_seconds(token.substr(eq + 1));
+  }
+
+  // Entries are keyed by URL alone. Bodies are stored decoded, so only
+  // Accept-Encoding may select between representations
+  rest = response.vary;
+  while (!rest.empty() && !d.no_store) {
+    const auto comma = rest.find(',');
+    const std::string_view header = trim(rest.substr(0, comma));
+    rest = comma == std::string_view::npos ? std::string_view{}
+                                           : rest.substr(comma + 1);
+    if (!header.empty() && !iequals(header, "accept-encoding"))
+      d.no_store = true;
+  }
+
+  if (no_cache) {
+    d.explicit_freshness = true; // stored, but revalidated on every use
+  } else if (max_age) {
+    const long long age = parse_seconds(response.age).value_or(0);
+    d.explicit_freshness = true;
+    d.lifetime = std::chrono::seconds(std::max(0LL, *max_age - age));
+  } else if (!response.expires.empty()) {
+    // An invalid Expires means already expired
+    d.explicit_freshness = true;
+    if (const auto expires = parse_http_date(response.expires)) {
+      const auto left = *expires - std::chrono::system_clock::now();
+      d.lifetime = std::max<Clock::duration>(
+          Clock::duration::zero(),
+          std::chrono::duration_cast<Clock::duration>(left));
+    }
+  }
+  return d;
+}
+} // namespace
+
+HttpCache::HttpCache(std::size_t capacity_bytes) : capacity_(capacity_bytes) {}
+
+std::size_t HttpCache::cost(const CachedResponse &entry) {
+  return entry.body.size() + entry.etag.size() + entry.last_modified.size();
+}
+
+std::shared_ptr<const CachedResponse>
+HttpCache::find(const std::string &url) const {
+  std::lock_guard lock(mutex_);
+  const auto it = index_.find(url);
+  if (it == index_.end())
+    return nullptr;
+  lru_.splice(lru_.begin(), lru_, it->second);
+  return it->second->entry;
+}
+
+void HttpCache::put(const std::string &url,
+                    std::shared_ptr<const CachedResponse> entry) {
+  std::lock_guard lock(mutex_);
+  if (const auto it = index_.find(url); it != index_.end()) {
+    size_ -= cost(*it->second->entry);
+    lru_.erase(it->second);
+    index_.erase(it);
+  }
+  if (!entry)
+    return;
+  size_ += cost(*entry);
+  lru_.push_front({url, std::move(entry)});
+  index_.emplace(url, lru_.begin());
+  while (size_ > capacity_ && !lru_.empty()) {
+    size_ -= cost(*lru_.back().entry);
+    index_.erase(lru_.back().url);
+    lru_.pop_back();
+  }
+}
+
+std::shared_ptr<const CachedResponse>
+HttpCache::fresh(const std::string &url) const {
+  auto entry = find(url);
+  if (entry && Clock::now() < entry->fresh_until)
+    return entry;
+  return nullptr;
+}
+
+void HttpCache::store(const std::string &url, const HttpResponse &response,
+                      std::chrono::microseconds fetch_time) {
+  const Directives d = directives(response);
+  const bool validators =
+      !response.etag.empty() || !response.last_modified.empty();
+  if (response.status_code != 200 || d.no_store ||
+      (d.lifetime == Clock::duration::zero() && !validators) ||
+      response.body.size() > capacity_ / 8) {
+    put(url, nullptr); // drop what the provider no longer lets us keep
+    return;
+  }
+
+  auto entry = std::make_shared<CachedResponse>();
+  entry->body.assign(response.body);
+  entry->etag = response.etag;
+  entry->last_modified = response.last_modified;
+  entry->lifetime = d.lifetime;
+  entry->fresh_until = Clock::now() + d.lifetime;
+  entry->fetch_time = fetch_time;
+  put(url, std::move(entry));
+}
+
+std::optional<HttpResponse>
+HttpCache::begin_fetch(const std::string &url, HttpRequestOptions &options,
+                       std::shared_ptr<const CachedResponse> &stale,
+                       CacheOutcome &outcome) const {
+  outcome = {};
+  stale = find(url);
+  if (stale && Clock::now() < stale->fresh_until) {
+    HttpResponse response;
+    response.status_code = 200;
+    response.body.assign(stale->body);
+    response.etag = stale->etag;
+    response.last_modified = stale->last_modified;
+    outcome = {CacheOutcome::Kind::Fresh, stale->body.size(),
+               stale->fetch_time};
+    stale.reset();
+    return response;
+  }
+  if (stale) {
+    options.if_none_match = stale->etag;
+    options.if_modified_since = stale->last_modified;
+  }
+  return std::nullopt;
+}
+
+void HttpCache::end_fetch(const std::string &url,
+                          const std::shared_ptr<const CachedResponse> &stale,
+                          HttpResponse &response,
+                          std::chrono::microseconds elapsed,
+                          CacheOutcome &outcome) {
+  if (stale && response.status_code == 304) {
+    // Renew the entry; a 304 may update validators and freshness
+    const Directives d = directives(response);
+    auto renewed = std::make_shared<CachedResponse>(*stale);
+    if (!response.etag.empty())
+      renewed->etag = response.etag;
+    if (!response.last_modified.empty())
+      renewed->last_modified = response.last_modified;
+    // Without caching headers in the 304, the original lifetime applies
+    if (d.explicit_freshness)
+      renewed->lifetime = d.lifetime;
+    renewed->fresh_until = Clock::now() + renewed->lifetime;
+    put(url, renewed);
+
+    response.status_code = 200;
+    response.body.assign(stale->body);
+    response.etag = renewed->etag;
+    response.last_modified = renewed->last_modified;
+    outcome = {CacheOutcome::Kind::Revalidated, stale->body.size(),
+               std::max(std::chrono::microseconds::zero(),
+                        stale->fetch_time - elapsed)};
+    return;
+  }
+
+  if (response.status_code == 200)
+    store(url, response, elapsed);
+}
+
+HttpResponse HttpCache::fetch(const HttpClient &client, const std::string &url,
+                              long timeout, HttpRequestOptions options,
+                              CacheOutcome *outcome) {
+  CacheOutcome local;
+  CacheOutcome &out = outcome ? *outcome : local;
+
+  std::shared_ptr<const CachedResponse> stale;
+  if (auto fresh = begin_fetch(url, options, stale, out))
+    return std::move(*fresh);
+
+  const auto started = Clock::now();
+  HttpResponse response = client.get(url, timeout, options);
+  const auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(
+      Clock::now() - started);
+  end_fetch(url, stale, response, elapsed, out);
+  return response;
+}
+
+std::size_t HttpCache::size_bytes() const {
+  std::lock_guard lock(mutex_);
+  return size_;
+}
+
+std::size_t HttpCache::entries() const {
+  std::lock_guard lock(mutex_);
+  return index_.size();
+}
+
+void HttpCache::clear() {
+  std::lock_guard lock(mutex_);
+  lru_.clear();
+  index_.clear();
+  size_ = 0;
+}
+
+} // namespace regeocode
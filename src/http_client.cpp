@@ -16,64 +16,792 @@
 
 #include "regeocode/http_client.hpp"
 #include <curl/curl.h>
+
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <charconv>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
 #include <string>
+#include <stop_token>
+#include <string_view>
+#include <thread>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
 
 namespace regeocode {
 
+namespace {
+// Content-Length is trusted up to this size; larger bodies grow as they arrive
+constexpr curl_off_t kMaxReserve = 64 * 1024 * 1024;
+// Receive buffers above this size are released instead of kept for reuse
+constexpr std::size_t kMaxPooledReceive = 4 * 1024 * 1024;
+
+/**
+ * @brief Where WriteCallback puts the body of one transfer.
+ *
+ * With a known Content-Length the body is reserved once and written in
+ * place. Otherwise the chunks go to a per-thread buffer whose capacity is
+ * kept across requests, and the body is copied from it once at the end, so
+ * neither path pays for geometric regrowth. A buffer owned by the transfer
+ * (asynchronous transfers) is moved into the body instead. Content-Length
+ * of an encoded response is the compressed size, so those take the second
+ * path too.
+ */
+struct ReceiveContext {
+  CURL *curl = nullptr;
+  HttpResponse *response = nullptr;
+  std::string *pool = nullptr;  ///< The calling thread's receive buffer.
+  std::string *spill = nullptr; ///< Set to pool while the length is unknown.
+  bool owned = false; ///< pool belongs to this transfer, not to the thread.
+  bool started = false;
+  bool encoded = false; ///< Response carries a Content-Encoding.
+};
+
+std::string &receive_buffer() {
+  thread_local std::string buffer;
+  return buffer;
+}
+
+bool iequals(std::string_view a, std::string_view b) noexcept {
+  return std::ranges::equal(a, b, [](char x, char y) {
+    return std::tolower(static_cast<unsigned char>(x)) ==
+           std::tolower(static_cast<unsigned char>(y));
+  });
+}
+
+std::string_view trim(std::string_view s) noexcept {
+  constexpr std::string_view kWs = " \t\r\n";
+  const auto first = s.find_first_not_of(kWs);
+  if (first == std::string_view::npos)
+    return {};
+  return s.substr(first, s.find_last_not_of(kWs) - first + 1);
+}
+
+/// Whether this libcurl can decode @p coding.
+bool coding_supported(std::string_view coding) noexcept {
+  const curl_version_info_data *info = curl_version_info(CURLVERSION_NOW);
+  if (iequals(coding, "gzip") || iequals(coding, "deflate"))
+    return (info->features & CURL_VERSION_LIBZ) != 0;
+  if (iequals(coding, "br"))
+    return (info->features & CURL_VERSION_BROTLI) != 0;
+  if (iequals(coding, "zstd"))
+    return (info->features & CURL_VERSION_ZSTD) != 0;
+  return false;
+}
+
+/**
+ * @brief Value for CURLOPT_ACCEPT_ENCODING, or nullptr to send none.
+ *
+ * The result for the last configured list is kept per thread, as each API
+ * keeps its setting for the whole run.
+ */
+const char *accept_encoding(std::string_view configured) {
+  configured = trim(configured);
+  if (configured.empty() || iequals(configured, "identity") ||
+      iequals(configured, "none"))
+    return nullptr;
+  if (iequals(configured, "auto"))
+    return ""; // libcurl offers everything it was built with
+
+  thread_local std::string last_configured;
+  thread_local std::string last_value;
+  if (configured != last_configured) {
+    last_configured = configured;
+    last_value.clear();
+    std::string_view rest = configured;
+    while (!rest.empty()) {
+      const auto comma = rest.find(',');
+      const std::string_view coding = trim(rest.substr(0, comma));
+      rest = comma == std::string_view::npos ? std::string_view{}
+                                             : rest.substr(comma + 1);
+      if (!coding_supported(coding))
+        continue;
+      if (!last_value.empty())
+        last_value += ", ";
+      last_value += coding;
+    }
+  }
+  return last_value.empty() ? nullptr : last_value.c_str();
+}
+long curl_http_version(HttpVersion version) noexcept {
+  switch (version) {
+  case HttpVersion::Http1_1:
+    return CURL_HTTP_VERSION_1_1;
+  case HttpVersion::Http2:
+    return CURL_HTTP_VERSION_2TLS;
+  case HttpVersion::Http2PriorKnowledge:
+    return CURL_HTTP_VERSION_2_PRIOR_KNOWLEDGE;
+  case HttpVersion::Auto:
+    break;
+  }
+  return CURL_HTTP_VERSION_NONE;
+}
+
+/**
+ * @brief Phase durations of a finished transfer. libcurl reports times
+ * since the start; phases a reused connection skips come out as zero.
+ */
+HttpTimings transfer_timings(CURL *curl) {
+  auto at = [curl](CURLINFO info) {
+    curl_off_t t = 0;
+    curl_easy_getinfo(curl, info, &t);
+    return t;
+  };
+  const curl_off_t dns = at(CURLINFO_NAMELOOKUP_TIME_T);
+  const curl_off_t connect = std::max(dns, at(CURLINFO_CONNECT_TIME_T));
+  const curl_off_t tls = at(CURLINFO_APPCONNECT_TIME_T);
+  const curl_off_t sent = std::max(connect, at(CURLINFO_PRETRANSFER_TIME_T));
+  const curl_off_t first = std::max(sent, at(CURLINFO_STARTTRANSFER_TIME_T));
+  const curl_off_t total = std::max(first, at(CURLINFO_TOTAL_TIME_T));
+  using us = std::chrono::microseconds;
+  HttpTimings t;
+  t.dns = us(dns);
+  t.connect = us(connect - dns);
+  t.tls = us(tls > connect ? tls - connect : 0);
+  t.wait = us(first - sent);
+  t.transfer = us(total - first);
+  return t;
+}
+} // namespace
+
+HttpVersion parse_http_version(std::string_view value) {
+  value = trim(value);
+  if (value.empty() || iequals(value, "auto"))
+    return HttpVersion::Auto;
+  if (value == "1.1")
+    return HttpVersion::Http1_1;
+  if (value == "2")
+    return HttpVersion::Http2;
+  if (iequals(value, "2-prior-knowledge"))
+    return HttpVersion::Http2PriorKnowledge;
+  throw std::invalid_argument("Unknown HTTP version: " + std::string(value));
+}
+
+std::optional<std::chrono::system_clock::time_point>
+parse_http_date(std::string_view value) {
+  constexpr std::array<std::string_view, 12> kMonths = {
+      "Jan", "Feb", "Mar", "Apr", "May", "Jun",
+      "Jul", "Aug", "Sep", "Oct", "Nov", "Dec"};
+  // IMF-fixdate, e.g. "Sun, 06 Nov 1994 08:49:37 GMT"
+  std::string_view s = trim(value);
+  const auto comma = s.find(", ");
+  if (comma == std::string_view::npos)
+    return std::nullopt;
+  s.remove_prefix(comma + 2);
+  if (s.size() != 24 || s.substr(20) != " GMT" || s[2] != ' ' ||
+      s[6] != ' ' || s[11] != ' ' || s[14] != ':' || s[17] != ':')
+    return std::nullopt;
+  auto number = [&](std::size_t pos, std::size_t len, int &out) {
+    const char *first = s.data() + pos;
+    const auto [ptr, ec] = std::from_chars(first, first + len, out);
+    return ec == std::errc() && ptr == first + len;
+  };
+  int day, year, hour, minute, second;
+  if (!number(0, 2, day) || !number(7, 4, year) || !number(12, 2, hour) ||
+      !number(15, 2, minute) || !number(18, 2, second))
+    return std::nullopt;
+  const auto month = std::find(kMonths.begin(), kMonths.end(), s.substr(3, 3));
+  if (month == kMonths.end())
+    return std::nullopt;
+
+  using namespace std::chrono;
+  const year_month_day date{
+      std::chrono::year{year},
+      std::chrono::month{static_cast<unsigned>(month - kMonths.begin() + 1)},
+      std::chrono::day{static_cast<unsigned>(day)}};
+  if (!date.ok() || hour > 23 || minute > 59 || second > 60)
+    return std::nullopt;
+  return sys_days{date} + hours{hour} + minutes{minute} + seconds{second};
+}
+
+/**
+ * @brief One curl multi handle driven by a worker thread.
+ *
+ * Owned by one HttpClient, or by an HttpShare for all attached clients.
+ *
+ * perform() hands its easy handle over and blocks until the transfer is
+ * done; submit() returns at once and calls back on the worker. Meanwhile
+ * the worker runs every submitted transfer concurrently, so connections
+ * (and HTTP/2 streams) are shared by all callers. The worker also fires
+ * timers, which asynchronous retries wait on instead of a thread.
+ * Transfers and timers are cancelled by id; the worker then calls back
+ * with CURLE_ABORTED_BY_CALLBACK, or true for a timer.
+ */
+namespace detail {
+class TransferEngine {
+public:
+  using Clock = std::chrono::steady_clock;
+
+  TransferEngine(long max_host_connections, long max_concurrent_streams)
+      : multi_(curl_multi_init()) {
+    if (!multi_)
+      throw std::runtime_error("curl_multi_init failed");
+    curl_multi_setopt(multi_, CURLMOPT_PIPELINING, CURLPIPE_MULTIPLEX);
+    if (max_host_connections > 0)
+      curl_multi_setopt(multi_, CURLMOPT_MAX_HOST_CONNECTIONS,
+                        max_host_connections);
+    curl_multi_setopt(multi_, CURLMOPT_MAX_CONCURRENT_STREAMS,
+                      max_concurrent_streams);
+    worker_ = std::thread([this] { run(); });
+  }
+
+  ~TransferEngine() {
+    {
+      std::lock_guard lock(mutex_);
+      stop_ = true;
+    }
+    curl_multi_wakeup(multi_);
+    worker_.join();
+    curl_multi_cleanup(multi_);
+  }
+
+  TransferEngine(const TransferEngine &) = delete;
+  TransferEngine &operator=(const TransferEngine &) = delete;
+
+  /// Runs @p easy on the shared handle and waits for the result;
+  /// requesting @p stop cancels it.
+  CURLcode perform(CURL *easy, std::stop_token stop = {}) {
+    std::promise<CURLcode> done;
+    auto result = done.get_future();
+    const std::uint64_t id =
+        submit(easy, [&done](CURLcode code) { done.set_value(code); });
+    const std::stop_callback on_stop(std::move(stop),
+                                     [this, id] { cancel(id); });
+    return result.get();
+  }
+
+  /// Runs @p easy on the shared handle; @p done is called on the worker.
+  std::uint64_t submit(CURL *easy, std::function<void(CURLcode)> done) {
+    std::uint64_t id;
+    {
+      std::lock_guard lock(mutex_);
+      id = ++last_id_;
+      submitted_.push_back({easy, id, std::move(done)});
+    }
+    curl_multi_wakeup(multi_);
+    return id;
+  }
+
+  /// Calls @p fire(false) on the worker at @p at (true if cancelled).
+  std::uint64_t schedule(Clock::time_point at,
+                         std::function<void(bool)> fire) {
+    std::uint64_t id;
+    {
+      std::lock_guard lock(mutex_);
+      id = ++last_id_;
+      scheduled_.push_back({at, id, std::move(fire)});
+    }
+    curl_multi_wakeup(multi_);
+    return id;
+  }
+
+  /// Ends a transfer or timer early; ids already finished are ignored.
+  void cancel(std::uint64_t id) {
+    {
+      std::lock_guard lock(mutex_);
+      cancelled_.push_back(id);
+    }
+    curl_multi_wakeup(multi_);
+  }
+
+private:
+  struct Transfer {
+    CURL *easy;
+    std::uint64_t id;
+    std::function<void(CURLcode)> done;
+  };
+  struct Timer {
+    Clock::time_point at;
+    std::uint64_t id;
+    std::function<void(bool)> fire;
+  };
+
+  void run() {
+    // Only touched by the worker
+    std::unordered_map<std::uint64_t, Transfer> active;
+    std::multimap<Clock::time_point, Timer> timers;
+    std::vector<Transfer> incoming;
+    std::vector<Timer> new_timers;
+    std::vector<std::uint64_t> cancels;
+    int running = 0;
+    for (;;) {
+      bool stopping;
+      {
+        std::lock_guard lock(mutex_);
+        incoming.swap(submitted_);
+        new_timers.swap(scheduled_);
+        cancels.swap(cancelled_);
+        stopping = stop_;
+      }
+      for (Transfer &t : incoming) {
+        curl_easy_setopt(t.easy, CURLOPT_PRIVATE,
+                         reinterpret_cast<void *>(static_cast<std::uintptr_t>(t.id)));
+        if (CURLMcode rc = curl_multi_add_handle(multi_, t.easy);
+            rc != CURLM_OK)
+          t.done(CURLE_FAILED_INIT);
+        else
+          active.emplace(t.id, std::move(t));
+      }
+      incoming.clear();
+      for (Timer &t : new_timers)
+        timers.emplace(t.at, std::move(t));
+      new_timers.clear();
+      for (const std::uint64_t id : cancels) {
+        if (const auto it = active.find(id); it != active.end()) {
+          curl_multi_remove_handle(multi_, it->second.easy);
+          auto done = std::move(it->second.done);
+          active.erase(it);
+          done(CURLE_ABORTED_BY_CALLBACK);
+        } else if (const auto timer = std::ranges::find_if(
+                       timers, [id](const auto &e) { return e.second.id == id; });
+                   timer != timers.end()) {
+          auto fire = std::move(timer->second.fire);
+          timers.erase(timer);
+          fire(true);
+        }
+      }
+      cancels.clear();
+      if (stopping) {
+        // Nobody is left to wait for the timers
+        while (!timers.empty()) {
+          auto fire = std::move(timers.begin()->second.fire);
+          timers.erase(timers.begin());
+          fire(true);
+        }
+        if (active.empty()) {
+          std::lock_guard lock(mutex_);
+          if (submitted_.empty() && scheduled_.empty())
+            return;
+        }
+      }
+
+      curl_multi_perform(multi_, &running);
+      int queued = 0;
+      while (CURLMsg *msg = curl_multi_info_read(multi_, &queued)) {
+        if (msg->msg != CURLMSG_DONE)
+          continue;
+        char *id = nullptr;
+        curl_easy_getinfo(msg->easy_handle, CURLINFO_PRIVATE, &id);
+        const CURLcode result = msg->data.result;
+        curl_multi_remove_handle(multi_, msg->easy_handle);
+        const auto it = active.find(reinterpret_cast<std::uintptr_t>(id));
+        auto done = std::move(it->second.done);
+        active.erase(it);
+        done(result);
+      }
+
+      const auto now = Clock::now();
+      while (!timers.empty() && timers.begin()->first <= now) {
+        auto fire = std::move(timers.begin()->second.fire);
+        timers.erase(timers.begin());
+        fire(false);
+      }
+      int timeout_ms = 1000;
+      if (!timers.empty())
+        timeout_ms = static_cast<int>(std::clamp<std::int64_t>(
+            std::chrono::ceil<std::chrono::milliseconds>(
+                timers.begin()->first - Clock::now())
+                .count(),
+            0, timeout_ms));
+      curl_multi_poll(multi_, nullptr, 0, timeout_ms, nullptr);
+    }
+  }
+
+  CURLM *multi_;
+  std::mutex mutex_;
+  std::vector<Transfer> submitted_;
+  std::vector<Timer> scheduled_;
+  std::vector<std::uint64_t> cancelled_;
+  std::uint64_t last_id_ = 0;
+  bool stop_ = false;
+  std::thread worker_;
+};
+} // namespace detail
+
+// -------------------------
+// HttpShare
+// -------------------------
+
+struct HttpShare::State {
+  CURLSH *share = nullptr;
+  std::array<std::mutex, CURL_LOCK_DATA_LAST> locks;
+  HttpShareOptions options;
+  std::mutex engine_mutex;
+  std::shared_ptr<detail::TransferEngine> engine;
+};
+
+HttpShare::HttpShare(const HttpShareOptions &options)
+    : state_(std::make_unique<State>()) {
+  state_->options = options;
+  state_->share = curl_share_init();
+  if (!state_->share)
+    throw std::runtime_error("curl_share_init failed");
+  curl_share_setopt(
+      state_->share, CURLSHOPT_LOCKFUNC,
+      +[](CURL *, curl_lock_data data, curl_lock_access, void *userp) {
+        static_cast<State *>(userp)->locks[data].lock();
+      });
+  curl_share_setopt(state_->share, CURLSHOPT_UNLOCKFUNC,
+                    +[](CURL *, curl_lock_data data, void *userp) {
+                      static_cast<State *>(userp)->locks[data].unlock();
+                    });
+  curl_share_setopt(state_->share, CURLSHOPT_USERDATA, state_.get());
+  if (options.dns)
+    curl_share_setopt(state_->share, CURLSHOPT_SHARE, CURL_LOCK_DATA_DNS);
+  if (options.tls_sessions)
+    curl_share_setopt(state_->share, CURLSHOPT_SHARE,
+                      CURL_LOCK_DATA_SSL_SESSION);
+  // Connections are not put in the curl share: libcurl does not support
+  // using shared connections from concurrent threads. They live in the
+  // shared engine's multi handle instead.
+}
+
+HttpShare::~HttpShare() {
+  state_->engine.reset(); // before the share its handles point to
+  curl_share_cleanup(state_->share);
+}
+
+std::shared_ptr<HttpShare> HttpShare::process(const HttpShareOptions &options) {
+  // Kept for the program lifetime; one per distinct set of options
+  static std::mutex mutex;
+  static std::map<std::tuple<bool, bool, long, long>,
+                  std::shared_ptr<HttpShare>>
+      shares;
+  std::lock_guard lock(mutex);
+  auto &share = shares[{options.dns, options.tls_sessions,
+                        options.max_host_connections,
+                        options.max_concurrent_streams}];
+  if (!share)
+    share = std::make_shared<HttpShare>(options);
+  return share;
+}
+
+std::shared_ptr<detail::TransferEngine> HttpShare::engine() {
+  std::lock_guard lock(state_->engine_mutex);
+  if (!state_->engine)
+    state_->engine = std::make_shared<detail::TransferEngine>(
+        state_->options.max_host_connections,
+        state_->options.max_concurrent_streams);
+  return state_->engine;
+}
+
 // --- FIX START: Implement Constructor & Destructor ---
 // These were missing and caused the linker error.
 HttpClient::HttpClient() {
   // We could call curl_global_init here, but it's often optional
 }
 
-HttpClient::~HttpClient() {
-  // We could do cleanup here
+HttpClient::HttpClient(const HttpClientOptions &options)
+    : share_(options.share) {
+  if (!options.multiplex)
+    return;
+  engine_ = share_ ? share_->engine()
+                   : std::make_shared<detail::TransferEngine>(
+                         options.max_host_connections,
+                         options.max_concurrent_streams);
 }
+
+HttpClient::~HttpClient() = default;
 // --- FIX END ----------------------------------------------
 
+static size_t HeaderCallback(char *buffer, size_t size, size_t nitems,
+                             void *userp) {
+  size_t total_size = size * nitems;
+  auto *ctx = static_cast<ReceiveContext *>(userp);
+  const std::string_view line(buffer, total_size);
+  // Headers kept in the response, by lower-case name
+  static constexpr std::pair<std::string_view, std::string HttpResponse::*>
+      kKept[] = {{"retry-after", &HttpResponse::retry_after},
+                 {"etag", &HttpResponse::etag},
+                 {"last-modified", &HttpResponse::last_modified},
+                 {"cache-control", &HttpResponse::cache_control},
+                 {"expires", &HttpResponse::expires},
+                 {"age", &HttpResponse::age},
+                 {"vary", &HttpResponse::vary}};
+
+  if (line.starts_with("HTTP/")) {
+    // A new (possibly final) response starts
+    ctx->encoded = false;
+    for (const auto &[name, field] : kKept)
+      (ctx->response->*field).clear();
+    return total_size;
+  }
+  const auto colon = line.find(':');
+  if (colon == std::string_view::npos)
+    return total_size;
+  const std::string_view name = line.substr(0, colon);
+  const std::string_view value = trim(line.substr(colon + 1));
+  if (iequals(name, "content-encoding")) {
+    ctx->encoded = !value.empty() && !iequals(value, "identity");
+    return total_size;
+  }
+  for (const auto &[kept, field] : kKept) {
+    if (iequals(name, kept)) {
+      (ctx->response->*field).assign(value);
+      break;
+    }
+  }
+  return total_size;
+}
+
 // Callback must be defined before use
 static size_t WriteCallback(void *contents, size_t size, size_t nmemb,
                             void *userp) {
   size_t total_size = size * nmemb;
-  std::string *str = static_cast<std::string *>(userp);
-  str->append(static_cast<char *>(contents), total_size);
+  auto *ctx = static_cast<ReceiveContext *>(userp);
+  if (!ctx->started) {
+    // Headers are complete by the first body chunk
+    ctx->started = true;
+    curl_off_t length = -1;
+    if (!ctx->encoded &&
+        curl_easy_getinfo(ctx->curl, CURLINFO_CONTENT_LENGTH_DOWNLOAD_T,
+                          &length) == CURLE_OK &&
+        length >= 0) {
+      ctx->response->body.reserve(static_cast<std::size_t>(
+          std::min<curl_off_t>(length, kMaxReserve)));
+    } else {
+      ctx->spill = ctx->pool;
+      ctx->spill->clear();
+    }
+  }
+  if (ctx->spill)
+    ctx->spill->append(static_cast<char *>(contents), total_size);
+  else
+    ctx->response->body.append(static_cast<char *>(contents), total_size);
   return total_size;
 }
 
-HttpResponse HttpClient::get(const std::string &url, long timeout) const {
+namespace {
+/**
+ * @brief Sets up @p curl for a GET of @p url writing into @p receive.
+ * @return Request headers to free after the transfer, or nullptr.
+ */
+curl_slist *configure(CURL *curl, const std::string &url, long timeout,
+                      const HttpRequestOptions &options,
+                      ReceiveContext &receive, bool pipewait,
+                      CURLSH *share) {
+  curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
+  curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, WriteCallback);
+  curl_easy_setopt(curl, CURLOPT_WRITEDATA, &receive);
+  curl_easy_setopt(curl, CURLOPT_HEADERFUNCTION, HeaderCallback);
+  curl_easy_setopt(curl, CURLOPT_HEADERDATA, &receive);
+
+  // Compressed transfer; libcurl decodes while the body streams in
+  if (const char *codings = accept_encoding(options.accept_encoding))
+    curl_easy_setopt(curl, CURLOPT_ACCEPT_ENCODING, codings);
+
+  // Timeouts
+  curl_easy_setopt(curl, CURLOPT_CONNECTTIMEOUT, timeout);
+  curl_easy_setopt(curl, CURLOPT_TIMEOUT, timeout);
+
+  // Protocol version; on the shared engine wait for a connection that
+  // can multiplex instead of opening another one
+  if (const long version = curl_http_version(options.http_version);
+      version != CURL_HTTP_VERSION_NONE)
+    curl_easy_setopt(curl, CURLOPT_HTTP_VERSION, version);
+  if (pipewait)
+    curl_easy_setopt(curl, CURLOPT_PIPEWAIT, 1L);
+
+  // DNS cache and TLS sessions outlive this handle
+  if (share)
+    curl_easy_setopt(curl, CURLOPT_SHARE, share);
+
+  // User Agent
+  curl_easy_setopt(curl, CURLOPT_USERAGENT, "regeocode-cpp/1.0");
+
+  // Conditional request revalidating a cached response
+  curl_slist *headers = nullptr;
+  if (!options.if_none_match.empty())
+    headers = curl_slist_append(
+        headers,
+        ("If-None-Match: " + std::string(options.if_none_match)).c_str());
+  if (!options.if_modified_since.empty())
+    headers = curl_slist_append(
+        headers,
+        ("If-Modified-Since: " + std::string(options.if_modified_since))
+            .c_str());
+  if (headers)
+    curl_easy_setopt(curl, CURLOPT_HTTPHEADER, headers);
+  return headers;
+}
+
+/// Fills the status, body and transfer details of a finished transfer.
+void finish(CURL *curl, CURLcode res, ReceiveContext &receive,
+            HttpResponse &response) {
+  if (res != CURLE_OK) {
+    response.status_code = 599; // 599 = Network Connect Timeout Error
+    response.body.assign(curl_easy_strerror(res));
+  } else {
+    long http_code = 0;
+    curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &http_code);
+    response.status_code = static_cast<int>(http_code);
+    if (receive.spill && receive.owned) // nobody reuses it: hand it over
+      response.body = std::move(*receive.spill);
+    else if (receive.spill) // one exact-size copy out of the thread's buffer
+      response.body.assign(*receive.spill);
+    curl_off_t wire = 0;
+    if (curl_easy_getinfo(curl, CURLINFO_SIZE_DOWNLOAD_T, &wire) == CURLE_OK)
+      response.wire_bytes = static_cast<std::size_t>(wire);
+    response.timings = transfer_timings(curl);
+  }
+  if (receive.spill && receive.spill->capacity() > kMaxPooledReceive)
+    std::string().swap(*receive.spill);
+}
+
+/// Marks @p response as ended early by its stop token.
+void mark_cancelled(HttpResponse &response) {
+  response.status_code = 599;
+  response.body.assign("request cancelled");
+  response.cancelled = true;
+}
+
+/// Progress callback aborting a blocking transfer once its stop token
+/// (CURLOPT_XFERINFODATA) is requested.
+int abort_when_stopped(void *stop, curl_off_t, curl_off_t, curl_off_t,
+                       curl_off_t) {
+  return static_cast<const std::stop_token *>(stop)->stop_requested() ? 1 : 0;
+}
+
+/// What a transfer ended early by its stop token completes with.
+HttpResponse cancelled_response() {
+  HttpResponse response;
+  mark_cancelled(response);
+  return response;
+}
+
+/**
+ * @brief State of one asynchronous transfer, alive until its callback ran.
+ *
+ * Nothing here may depend on the submitting thread: the spill buffer is
+ * the transfer's own.
+ */
+struct AsyncTransfer {
   CURL *curl = curl_easy_init();
   HttpResponse response;
+  std::string spill;
+  ReceiveContext receive{curl, &response, &spill, nullptr, true};
+  curl_slist *headers = nullptr;
+  std::optional<std::stop_callback<std::function<void()>>> on_stop;
+
+  AsyncTransfer() = default;
+  AsyncTransfer(const AsyncTransfer &) = delete;
+  AsyncTransfer &operator=(const AsyncTransfer &) = delete;
+  ~AsyncTransfer() {
+    curl_easy_cleanup(curl);
+    curl_slist_free_all(headers);
+  }
+};
+} // namespace
+
+HttpResponse HttpClient::get(const std::string &url, long timeout,
+                             const HttpRequestOptions &options) const {
+  HttpResponse response;
   response.status_code = 0;
+  if (options.stop.stop_requested()) {
+    mark_cancelled(response);
+    return response;
+  }
 
+  CURL *curl = curl_easy_init();
   if (curl) {
-    std::string response_string;
+    ReceiveContext receive{curl, &response, &receive_buffer()};
+    curl_slist *headers =
+        configure(curl, url, timeout, options, receive, engine_ != nullptr,
+                  share_ ? share_->state_->share : nullptr);
+    // The engine cancels by id; a blocking transfer polls its token
+    if (!engine_ && options.stop.stop_possible()) {
+      curl_easy_setopt(curl, CURLOPT_XFERINFOFUNCTION, abort_when_stopped);
+      curl_easy_setopt(curl, CURLOPT_XFERINFODATA, &options.stop);
+      curl_easy_setopt(curl, CURLOPT_NOPROGRESS, 0L);
+    }
 
-    curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
-    curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, WriteCallback);
-    curl_easy_setopt(curl, CURLOPT_WRITEDATA, &response_string);
+    CURLcode res = engine_ ? engine_->perform(curl, options.stop)
+                           : curl_easy_perform(curl);
+    finish(curl, res, receive, response);
+    if (res == CURLE_ABORTED_BY_CALLBACK)
+      mark_cancelled(response);
 
-    // Timeouts
-    curl_easy_setopt(curl, CURLOPT_CONNECTTIMEOUT, timeout);
-    curl_easy_setopt(curl, CURLOPT_TIMEOUT, timeout);
+    curl_easy_cleanup(curl);
+    curl_slist_free_all(headers);
+  }
+  return response;
+}
 
-    // User Agent
-    curl_easy_setopt(curl, CURLOPT_USERAGENT, "regeocode-cpp/1.0");
+void HttpClient::get_async(const std::string &url, long timeout,
+                           const HttpRequestOptions &options,
+                           std::stop_token stop, ResponseCallback done) const {
+  if (stop.stop_requested()) {
+    done(cancelled_response());
+    return;
+  }
+  if (!engine_) {
+    // Only the engine runs transfers in the background
+    HttpRequestOptions stoppable = options;
+    stoppable.stop = std::move(stop);
+    done(get(url, timeout, stoppable));
+    return;
+  }
 
-    CURLcode res = curl_easy_perform(curl);
+  auto transfer = std::make_shared<AsyncTransfer>();
+  if (!transfer->curl) {
+    done(HttpResponse{});
+    return;
+  }
+  transfer->headers =
+      configure(transfer->curl, url, timeout, options, transfer->receive,
+                true, share_ ? share_->state_->share : nullptr);
+  const std::uint64_t id = engine_->submit(
+      transfer->curl,
+      [transfer, done = std::move(done)](CURLcode res) mutable {
+        if (res == CURLE_ABORTED_BY_CALLBACK) {
+          done(cancelled_response());
+          return;
+        }
+        finish(transfer->curl, res, transfer->receive, transfer->response);
+        done(std::move(transfer->response));
+      });
+  // Registered after submitting, so a cancel always finds the transfer
+  // submitted; the engine outlives its transfers
+  if (stop.stop_possible())
+    transfer->on_stop.emplace(std::move(stop), [engine = engine_.get(), id] {
+      engine->cancel(id);
+    });
+}
 
-    if (res != CURLE_OK) {
-      response.status_code = 599; // 599 = Network Connect Timeout Error
-      response.body = curl_easy_strerror(res);
-    } else {
-      long http_code = 0;
-      curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &http_code);
-      response.status_code = static_cast<int>(http_code);
-      response.body = response_string;
-    }
+bool HttpClient::asynchronous() const noexcept { return engine_ != nullptr; }
 
-    curl_easy_cleanup(curl);
+void HttpClient::wait_async(std::chrono::milliseconds delay,
+                            std::stop_token stop,
+                            std::function<void(bool)> done) const {
+  if (!engine_) {
+    std::mutex mutex;
+    std::condition_variable_any wake;
+    std::unique_lock lock(mutex);
+    wake.wait_for(lock, stop, delay, [] { return false; });
+    done(stop.stop_requested());
+    return;
   }
-  return response;
+
+  struct Wait {
+    std::optional<std::stop_callback<std::function<void()>>> on_stop;
+  };
+  auto wait = std::make_shared<Wait>();
+  const std::uint64_t id = engine_->schedule(
+      detail::TransferEngine::Clock::now() + delay,
+      [wait, done = std::move(done)](bool cancelled) { done(cancelled); });
+  if (stop.stop_possible())
+    wait->on_stop.emplace(std::move(stop), [engine = engine_.get(), id] {
+      engine->cancel(id);
+    });
 }
 
 } // namespace regeocode
\ No newline at end of file
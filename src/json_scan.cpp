@@ -0,0 +1,630 @@
+/**
+ * SPDX-FileComment: Implementation of the on-demand JSON scanner.
+ * SPDX-FileType: SOURCE
+ * SPDX-FileContributor: ZHENG Robert
+ * SPDX-FileCopyrightText: 2026 ZHENG Robert
+ * SPDX-License-Identifier: MIT
+ *
+ * @file json_scan.cpp
+ * @brief Single-pass path extraction without building a DOM.
+ * @version 0.1.0
+ * @date 2026-10-19
+ *
+ * @author ZHENG Robert
+ * @license MIT License
+ */
+
+#include "regeocode/json_scan.hpp"
+#include "regeocode/request_arena.hpp"
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <cstring>
+#include <cstdint>
+
+namespace regeocode::scan {
+
+namespace {
+constexpr std::size_t kMaxDepth = 512;
+
+bool is_ws(char c) noexcept {
+  return c == ' ' || c == '\n' || c == '\r' || c == '\t';
+}
+
+void append_utf8(std::string &out, std::uint32_t cp) {
+  if (cp < 0x80) {
+    out += static_cast<char>(cp);
+  } else if (cp < 0x800) {
+    out += static_cast<char>(0xC0 | (cp >> 6));
+    out += static_cast<char>(0x80 | (cp & 0x3F));
+  } else if (cp < 0x10000) {
+    out += static_cast<char>(0xE0 | (cp >> 12));
+    out += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+    out += static_cast<char>(0x80 | (cp & 0x3F));
+  } else {
+    out += static_cast<char>(0xF0 | (cp >> 18));
+    out += static_cast<char>(0x80 | ((cp >> 12) & 0x3F));
+    out += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+    out += static_cast<char>(0x80 | (cp & 0x3F));
+  }
+}
+
+std::uint32_t parse_hex4(std::string_view s, std::size_t pos) {
+  if (pos + 4 > s.size())
+    throw parse_error("Truncated \\u escape");
+  std::uint32_t v = 0;
+  for (std::size_t i = pos; i < pos + 4; ++i) {
+    char c = s[i];
+    v <<= 4;
+    if (c >= '0' && c <= '9')
+      v |= static_cast<std::uint32_t>(c - '0');
+    else if (c >= 'a' && c <= 'f')
+      v |= static_cast<std::uint32_t>(c - 'a' + 10);
+    else if (c >= 'A' && c <= 'F')
+      v |= static_cast<std::uint32_t>(c - 'A' + 10);
+    else
+      throw parse_error("Invalid \\u escape");
+  }
+  return v;
+}
+enum SkipClass : unsigned char { kPlain, kQuote, kOpen, kClose };
+
+constexpr auto kSkipClass = [] {
+  std::array<unsigned char, 256> t{};
+  t['"'] = kQuote;
+  t['{'] = kOpen;
+  t['['] = kOpen;
+  t['}'] = kClose;
+  t[']'] = kClose;
+  return t;
+}();
+
+/// Returns the position after the closing quote of a string whose body
+/// starts at @p p.
+const char *skip_string_body(const char *p, const char *end) {
+  while (true) {
+    const auto *quote = static_cast<const char *>(
+        std::memchr(p, '"', static_cast<std::size_t>(end - p)));
+    if (quote == nullptr)
+      throw parse_error("Unterminated string");
+    // The quote is escaped if preceded by an odd number of backslashes
+    const char *b = quote;
+    while (b > p && b[-1] == '\\')
+      --b;
+    p = quote + 1;
+    if ((quote - b) % 2 == 0)
+      return p;
+  }
+}
+} // namespace
+
+std::string unescape(std::string_view s) {
+  std::string out;
+  out.reserve(s.size());
+  for (std::size_t i = 0; i < s.size(); ++i) {
+    char c = s[i];
+    if (c != '\\') {
+      out += c;
+      continue;
+    }
+    if (++i >= s.size())
+      throw parse_error("Truncated escape");
+    switch (s[i]) {
+    case '"':
+      out += '"';
+      break;
+    case '\\':
+      out += '\\';
+      break;
+    case '/':
+      out += '/';
+      break;
+    case 'b':
+      out += '\b';
+      break;
+    case 'f':
+      out += '\f';
+      break;
+    case 'n':
+      out += '\n';
+      break;
+    case 'r':
+      out += '\r';
+      break;
+    case 't':
+      out += '\t';
+      break;
+    case 'u': {
+      std::uint32_t cp = parse_hex4(s, i + 1);
+      i += 4;
+      if (cp >= 0xD800 && cp <= 0xDBFF && i + 6 < s.size() &&
+          s[i + 1] == '\\' && s[i + 2] == 'u') {
+        std::uint32_t lo = parse_hex4(s, i + 3);
+        if (lo >= 0xDC00 && lo <= 0xDFFF) {
+          cp = 0x10000 + ((cp - 0xD800) << 10) + (lo - 0xDC00);
+          i += 6;
+        }
+      }
+      append_utf8(out, cp);
+      break;
+    }
+    default:
+      throw parse_error("Invalid escape");
+    }
+  }
+  return out;
+}
+
+// -------------------------
+// PathSet
+// -------------------------
+
+PathSet::PathSet(std::initializer_list<std::string_view> paths) {
+  paths_.reserve(paths.size());
+  for (std::string_view path : paths) {
+    if (path.empty())
+      throw std::invalid_argument("Empty JSON path");
+
+    std::vector<Segment> segments;
+    std::size_t wildcards = 0;
+    std::size_t start = 0;
+    while (start <= path.size()) {
+      std::size_t dot = path.find('.', start);
+      if (dot == std::string_view::npos)
+        dot = path.size();
+      std::string_view part = path.substr(start, dot - start);
+
+      Segment seg;
+      if (part == "*") {
+        seg.is_wildcard = true;
+        ++wildcards;
+      } else if (!part.empty() &&
+                 part.find_first_not_of("0123456789") ==
+                     std::string_view::npos) {
+        seg.is_index = true;
+        std::from_chars(part.data(), part.data() + part.size(), seg.index);
+      } else {
+        seg.key = std::string(part);
+      }
+      segments.push_back(std::move(seg));
+      start = dot + 1;
+    }
+
+    if (wildcards > kMaxCaptures)
+      throw std::invalid_argument("Too many wildcards in JSON path: " +
+                                  std::string(path));
+    paths_.push_back(std::move(segments));
+  }
+}
+
+// -------------------------
+// Field / ScanResult
+// -------------------------
+
+std::string Capture::key_string() const {
+  if (key.find('\\') == std::string_view::npos)
+    return std::string(key);
+  return unescape(key);
+}
+
+std::string Field::str() const {
+  if (kind != Kind::String)
+    return "";
+  if (!escaped)
+    return std::string(raw);
+  return unescape(raw);
+}
+
+bool Field::is_integer() const noexcept {
+  return kind == Kind::Number &&
+         raw.find_first_of(".eE") == std::string_view::npos;
+}
+
+double Field::as_double() const noexcept {
+  if (kind != Kind::Number)
+    return 0.0;
+  double v = 0.0;
+  std::from_chars(raw.data(), raw.data() + raw.size(), v);
+  return v;
+}
+
+long Field::as_long() const noexcept {
+  if (kind != Kind::Number)
+    return 0;
+  if (!is_integer())
+    return static_cast<long>(as_double());
+  long v = 0;
+  std::from_chars(raw.data(), raw.data() + raw.size(), v);
+  return v;
+}
+
+const Field *ScanResult::get(std::size_t path) const noexcept {
+  if (path >= first_.size() || first_[path] < 0)
+    return nullptr;
+  return &fields_[static_cast<std::size_t>(first_[path])];
+}
+
+bool ScanResult::is_object(std::size_t path) const noexcept {
+  const Field *f = get(path);
+  return f != nullptr && f->kind == Kind::Object;
+}
+
+std::string ScanResult::string(std::size_t path) const {
+  const Field *f = get(path);
+  return f != nullptr ? f->str() : std::string();
+}
+
+// -------------------------
+// Scanner
+// -------------------------
+
+class Scanner {
+public:
+  Scanner(std::string_view text, const PathSet &paths)
+      : text_(text), paths_(paths.paths_), active_(request_resource()),
+        steps_(request_resource()), result_(request_resource()) {
+    result_.first_.assign(paths_.size(), -1);
+    result_.fields_.reserve(paths_.size());
+    active_.resize(2);
+    active_[0].reserve(paths_.size());
+    for (std::size_t i = 0; i < paths_.size(); ++i)
+      active_[0].push_back(i);
+  }
+
+  ScanResult run() {
+    document();
+    return std::move(result_);
+  }
+
+  bool run_each(const FieldCallback &on_field) {
+    sink_ = &on_field;
+    document();
+    return !stopped_;
+  }
+
+private:
+  /// Current key or index per depth, used to fill captures.
+  struct Step {
+    std::string_view key;
+    std::size_t index{};
+  };
+
+  void document() {
+    skip_ws();
+    value(0);
+    if (stopped_)
+      return;
+    skip_ws();
+    if (pos_ != text_.size())
+      fail("Unexpected trailing characters");
+  }
+
+  [[noreturn]] void fail(const char *what) const {
+    throw parse_error(std::string(what) + " at offset " +
+                      std::to_string(pos_));
+  }
+
+  char peek() const {
+    if (pos_ >= text_.size())
+      throw parse_error("Unexpected end of JSON");
+    return text_[pos_];
+  }
+
+  void skip_ws() noexcept {
+    while (pos_ < text_.size() && is_ws(text_[pos_]))
+      ++pos_;
+  }
+
+  void expect(char c) {
+    if (peek() != c)
+      fail("Unexpected character");
+    ++pos_;
+  }
+
+  /// Reads a string starting at the opening quote; returns its content.
+  std::string_view string(bool &escaped) {
+    expect('"');
+    const std::size_t start = pos_;
+    escaped = false;
+    for (std::size_t i = pos_; i < text_.size(); ++i) {
+      const char ch = text_[i];
+      if (ch == '\\') {
+        escaped = true;
+        ++i;
+      } else if (ch == '"') {
+        pos_ = i + 1;
+        return text_.substr(start, i - start);
+      }
+    }
+    throw parse_error("Unterminated string");
+  }
+
+  void skip_string() {
+    bool escaped = false;
+    string(escaped);
+  }
+
+  std::string_view literal() {
+    const std::size_t start = pos_;
+    while (pos_ < text_.size()) {
+      char c = text_[pos_];
+      if (c == ',' || c == '}' || c == ']' || is_ws(c))
+        break;
+      ++pos_;
+    }
+    if (pos_ == start)
+      fail("Expected value");
+    return text_.substr(start, pos_ - start);
+  }
+
+  /// Skips any value by bracket matching.
+  void skip_value() {
+    const char c = peek();
+    if (c == '"') {
+      skip_string();
+      return;
+    }
+    if (c != '{' && c != '[') {
+      literal();
+      return;
+    }
+    skip_nested(0);
+  }
+
+  /// Advances past the bracket closing the @p depth innermost open
+  /// containers (0: the container starting at pos_).
+  void skip_nested(std::size_t depth) {
+    // Hot path for large unwanted subtrees: a table lookup per byte and
+    // memchr() over string bodies
+    const char *const begin = text_.data();
+    const char *const end = begin + text_.size();
+    const char *p = begin + pos_;
+    while (p != end) {
+      switch (kSkipClass[static_cast<unsigned char>(*p)]) {
+      case kPlain:
+        ++p;
+        break;
+      case kQuote:
+        p = skip_string_body(p + 1, end);
+        break;
+      case kOpen:
+        ++depth;
+        ++p;
+        break;
+      case kClose:
+        ++p;
+        if (--depth == 0) {
+          pos_ = static_cast<std::size_t>(p - begin);
+          return;
+        }
+        break;
+      }
+    }
+    throw parse_error("Unexpected end of JSON");
+  }
+
+  bool key_matches(const PathSet::Segment &seg, std::string_view key,
+                   bool escaped) const {
+    if (seg.is_wildcard)
+      return true;
+    if (seg.is_index)
+      return false;
+    if (!escaped)
+      return seg.key == key;
+    return seg.key == unescape(key);
+  }
+
+  void emit(std::size_t path, Kind kind, std::string_view raw, bool escaped,
+            std::size_t depth) {
+    Field f;
+    f.path = path;
+    f.kind = kind;
+    f.raw = raw;
+    f.escaped = escaped;
+    const auto &segments = paths_[path];
+    for (std::size_t d = 0; d < depth && d < segments.size(); ++d) {
+      if (segments[d].is_wildcard) {
+        f.captures[f.capture_count++] = {steps_[d].key, steps_[d].index};
+      }
+    }
+    if (sink_ != nullptr) {
+      if (!(*sink_)(f))
+        stopped_ = true;
+      return;
+    }
+    if (result_.first_[path] < 0)
+      result_.first_[path] = static_cast<std::ptrdiff_t>(result_.fields_.size());
+    result_.fields_.push_back(f);
+  }
+
+  /// Parses the value at @p depth against active_[depth].
+  void value(std::size_t depth) {
+    if (depth >= kMaxDepth)
+      fail("JSON nested too deeply");
+
+    const auto &active = active_[depth];
+    bool terminal = false;
+    bool continuing = false;
+    for (std::size_t p : active) {
+      if (paths_[p].size() == depth)
+        terminal = true;
+      else
+        continuing = true;
+    }
+
+    if (!terminal && !continuing) {
+      skip_value();
+      return;
+    }
+
+    const std::size_t start = pos_;
+    const char c = peek();
+    Kind kind;
+    std::string_view raw;
+    bool escaped = false;
+
+    if (c == '{' || c == '[') {
+      kind = c == '{' ? Kind::Object : Kind::Array;
+      if (continuing) {
+        if (c == '{')
+          object(depth);
+        else
+          array(depth);
+      } else {
+        skip_value();
+      }
+      if (stopped_)
+        return;
+      raw = text_.substr(start, pos_ - start);
+    } else if (c == '"') {
+      kind = Kind::String;
+      raw = string(escaped);
+    } else {
+      raw = literal();
+      if (raw == "true" || raw == "false")
+        kind = Kind::Boolean;
+      else if (raw == "null")
+        kind = Kind::Null;
+      else if (raw.front() == '-' || (raw.front() >= '0' && raw.front() <= '9'))
+        kind = Kind::Number;
+      else
+        fail("Invalid literal");
+    }
+
+    if (terminal) {
+      for (std::size_t p : active_[depth]) {
+        if (stopped_)
+          break;
+        if (paths_[p].size() == depth)
+          emit(p, kind, raw, escaped, depth);
+      }
+    }
+  }
+
+  /// Narrows active_[depth] to active_[depth + 1] for the next member/element.
+  bool narrow(std::size_t depth, std::string_view key, bool escaped,
+              std::size_t index, bool is_index) {
+    if (active_.size() < depth + 2)
+      active_.resize(depth + 2);
+    if (steps_.size() < depth + 1)
+      steps_.resize(depth + 1);
+    steps_[depth] = {key, index};
+
+    auto &next = active_[depth + 1];
+    next.clear();
+    for (std::size_t p : active_[depth]) {
+      const auto &segments = paths_[p];
+      if (segments.size() <= depth)
+        continue;
+      const auto &seg = segments[depth];
+      bool match = is_index ? (seg.is_wildcard ||
+                               (seg.is_index && seg.index == index))
+                            : key_matches(seg, key, escaped);
+      if (match)
+        next.push_back(p);
+    }
+    return !next.empty();
+  }
+
+  void object(std::size_t depth) {
+    expect('{');
+    skip_ws();
+    if (peek() == '}') {
+      ++pos_;
+      return;
+    }
+    while (true) {
+      skip_ws();
+      bool escaped = false;
+      std::string_view key = string(escaped);
+      skip_ws();
+      expect(':');
+      skip_ws();
+      if (narrow(depth, key, escaped, 0, false))
+        value(depth + 1);
+      else
+        skip_value();
+      if (stopped_)
+        return;
+      skip_ws();
+      char c = peek();
+      ++pos_;
+      if (c == '}')
+        return;
+      if (c != ',')
+        fail("Expected ',' or '}'");
+    }
+  }
+
+  /// Highest element index any active path can match at @p depth
+  /// (npos for a wildcard).
+  std::size_t last_wanted_index(std::size_t depth) const {
+    std::size_t last = 0;
+    bool any = false;
+    for (std::size_t p : active_[depth]) {
+      const auto &segments = paths_[p];
+      if (segments.size() <= depth)
+        continue;
+      const auto &seg = segments[depth];
+      if (seg.is_wildcard)
+        return std::string_view::npos;
+      if (seg.is_index) {
+        last = any ? std::max(last, seg.index) : seg.index;
+        any = true;
+      }
+    }
+    return any ? last : std::string_view::npos;
+  }
+
+  void array(std::size_t depth) {
+    expect('[');
+    skip_ws();
+    if (peek() == ']') {
+      ++pos_;
+      return;
+    }
+    const std::size_t last_wanted = last_wanted_index(depth);
+    for (std::size_t index = 0;; ++index) {
+      skip_ws();
+      if (index > last_wanted) {
+        // Nothing further can match: skip the tail in one pass
+        skip_nested(1);
+        return;
+      }
+      if (narrow(depth, {}, false, index, true))
+        value(depth + 1);
+      else
+        skip_value();
+      if (stopped_)
+        return;
+      skip_ws();
+      char c = peek();
+      ++pos_;
+      if (c == ']')
+        return;
+      if (c != ',')
+        fail("Expected ',' or ']'");
+    }
+  }
+
+  std::string_view text_;
+  const std::vector<std::vector<PathSet::Segment>> &paths_;
+  std::size_t pos_ = 0;
+  std::pmr::vector<std::pmr::vector<std::size_t>> active_;
+  std::pmr::vector<Step> steps_;
+  ScanResult result_;
+  const FieldCallback *sink_ = nullptr; // streaming mode when set
+  bool stopped_ = false;
+};
+
+ScanResult scan(std::string_view text, const PathSet &paths) {
+  return Scanner(text, paths).run();
+}
+
+bool scan_each(std::string_view text, const PathSet &paths,
+               const FieldCallback &on_field) {
+  return Scanner(text, paths).run_each(on_field);
+}
+
+} // namespace regeocode::scan
@@ -0,0 +1,379 @@
+/**
+ * SPDX-FileComment: Implementation of the per-API metrics.
+ * SPDX-FileType: SOURCE
+ * SPDX-FileContributor: ZHENG Robert
+ * SPDX-FileCopyrightText: 2026 ZHENG Robert
+ * SPDX-License-Identifier: MIT
+ *
+ * @file metrics.cpp
+ * @brief Per-thread counters, log-linear histograms and Prometheus export.
+ * @version 0.1.0
+ * @date 2026-10-19
+ *
+ * @author ZHENG Robert
+ * @license MIT License
+ */
+
+#include "regeocode/metrics.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <thread>
+
+namespace regeocode {
+
+namespace {
+constexpr std::string_view kCounterNames[] = {
+    "lookups",         "failures",       "requests",      "retries",
+    "wire_bytes",      "decoded_bytes",  "transfer_seconds", "cache_hits",
+    "revalidations",   "saved_bytes",    "saved_seconds", "local_answers",
+    "quota_consumed",  "quota_rejected", "quota_released", "cancelled"};
+static_assert(std::size(kCounterNames) == kCounterCount);
+
+/// Counters summing microseconds; exports give them in seconds.
+constexpr bool in_micros(std::size_t c) noexcept {
+  return c == static_cast<std::size_t>(Counter::TransferMicros) ||
+         c == static_cast<std::size_t>(Counter::SavedMicros);
+}
+
+constexpr std::string_view kStageNames[] = {
+    "lookup", "dns", "connect", "tls", "wait", "transfer", "parse"};
+static_assert(std::size(kStageNames) == kStageCount);
+
+/// Slots per API; threads beyond this many share the existing ones.
+std::size_t max_slots() noexcept {
+  static const std::size_t n =
+      std::max<std::size_t>(4, std::thread::hardware_concurrency());
+  return n;
+}
+
+void append_number(std::string &out, double value) {
+  char buf[32];
+  std::snprintf(buf, sizeof(buf), "%.9g", value);
+  out += buf;
+}
+
+/// @p value quoted as a Prometheus label value.
+std::string label(std::string_view value) {
+  std::string out = "\"";
+  for (const char c : value) {
+    if (c == '\\' || c == '"')
+      out += '\\';
+    if (c == '\n')
+      out += "\\n";
+    else
+      out += c;
+  }
+  return out + '"';
+}
+} // namespace
+
+std::string_view counter_name(Counter c) {
+  return kCounterNames[static_cast<std::size_t>(c)];
+}
+
+std::string_view stage_name(Stage s) {
+  return kStageNames[static_cast<std::size_t>(s)];
+}
+
+// -------------------------
+// HistogramSnapshot
+// -------------------------
+
+std::size_t HistogramSnapshot::bucket_of(std::uint64_t micros) noexcept {
+  if (micros < kSubBuckets)
+    return static_cast<std::size_t>(micros);
+  const unsigned exponent = static_cast<unsigned>(std::bit_width(micros)) - 1;
+  if (exponent >= kMaxExponent)
+    return kBuckets - 1;
+  const std::size_t sub =
+      (micros >> (exponent - kSubBucketBits)) & (kSubBuckets - 1);
+  return kSubBuckets + (exponent - kSubBucketBits) * kSubBuckets + sub;
+}
+
+std::uint64_t HistogramSnapshot::bucket_limit(std::size_t i) noexcept {
+  if (i < kSubBuckets)
+    return i;
+  const unsigned shift =
+      static_cast<unsigned>((i - kSubBuckets) / kSubBuckets);
+  const std::uint64_t sub = (i - kSubBuckets) % kSubBuckets;
+  return ((kSubBuckets + sub + 1) << shift) - 1;
+}
+
+std::chrono::microseconds
+HistogramSnapshot::percentile(double p) const noexcept {
+  if (count == 0)
+    return {};
+  const auto rank = std::max<std::uint64_t>(
+      1, static_cast<std::uint64_t>(std::ceil(p * static_cast<double>(count))));
+  std::uint64_t seen = 0;
+  for (std::size_t i = 0; i < kBuckets; ++i) {
+    seen += buckets[i];
+    if (seen >= rank)
+      return std::chrono::microseconds(bucket_limit(i));
+  }
+  return std::chrono::microseconds(bucket_limit(kBuckets - 1));
+}
+
+std::chrono::microseconds HistogramSnapshot::mean() const noexcept {
+  return std::chrono::microseconds(count == 0 ? 0 : sum_micros / count);
+}
+
+void HistogramSnapshot::merge(const HistogramSnapshot &other) noexcept {
+  for (std::size_t i = 0; i < kBuckets; ++i)
+    buckets[i] += other.buckets[i];
+  count += other.count;
+  sum_micros += other.sum_micros;
+}
+
+double ApiSnapshot::cache_hit_ratio() const noexcept {
+  const std::uint64_t hits = (*this)[Counter::CacheHits];
+  const std::uint64_t fetched =
+      (*this)[Counter::Requests] - (*this)[Counter::Retries];
+  return hits + fetched == 0
+             ? 0.0
+             : static_cast<double>(hits) / static_cast<double>(hits + fetched);
+}
+
+// -------------------------
+// ApiMetrics
+// -------------------------
+
+struct alignas(64) ApiMetrics::Slot {
+  std::array<std::atomic<std::uint64_t>, kCounterCount> counters{};
+  struct Histogram {
+    std::array<std::atomic<std::uint64_t>, HistogramSnapshot::kBuckets>
+        buckets{};
+    std::atomic<std::uint64_t> sum_micros{0};
+  };
+  std::array<Histogram, kStageCount> stages{};
+};
+
+/**
+ * @brief The slots of one ApiMetrics. Threads hold it weakly, so a thread
+ * ending after its ApiMetrics has nothing to give back.
+ */
+struct ApiMetrics::Registry {
+  explicit Registry(std::uint64_t id) : id(id) {}
+
+  const std::uint64_t id; ///< Never reused, unlike the address.
+  mutable std::mutex mutex;
+  std::vector<std::unique_ptr<Slot>> slots;
+  std::vector<Slot *> idle; ///< Left by threads that ended.
+  std::size_t next_shared = 0;
+};
+
+ApiMetrics::ApiMetrics() {
+  static std::atomic<std::uint64_t> next_id{0};
+  registry_ = std::make_shared<Registry>(
+      next_id.fetch_add(1, std::memory_order_relaxed));
+}
+ApiMetrics::~ApiMetrics() = default;
+
+ApiMetrics::Slot &ApiMetrics::slot() noexcept {
+  /// Slots the calling thread uses; its own go back to their registry when
+  /// the thread ends.
+  struct Taken {
+    struct Entry {
+      std::uint64_t id;
+      std::weak_ptr<Registry> registry;
+      Slot *slot;
+      bool own;
+    };
+    std::vector<Entry> entries;
+
+    ~Taken() {
+      for (const auto &e : entries)
+        if (const auto registry = e.own ? e.registry.lock() : nullptr) {
+          std::lock_guard lock(registry->mutex);
+          registry->idle.push_back(e.slot);
+        }
+    }
+  };
+  thread_local Taken taken;
+
+  for (const auto &e : taken.entries)
+    if (e.id == registry_->id)
+      return *e.slot;
+
+  std::erase_if(taken.entries,
+                [](const Taken::Entry &e) { return e.registry.expired(); });
+  Registry &r = *registry_;
+  std::lock_guard lock(r.mutex);
+  Slot *slot;
+  bool own = true;
+  if (!r.idle.empty()) {
+    slot = r.idle.back();
+    r.idle.pop_back();
+  } else if (r.slots.size() < max_slots()) {
+    slot = r.slots.emplace_back(std::make_unique<Slot>()).get();
+  } else {
+    slot = r.slots[r.next_shared++ % r.slots.size()].get();
+    own = false;
+  }
+  taken.entries.push_back({r.id, registry_, slot, own});
+  return *slot;
+}
+
+void ApiMetrics::add(Counter c, std::uint64_t n) noexcept {
+  slot().counters[static_cast<std::size_t>(c)].fetch_add(
+      n, std::memory_order_relaxed);
+}
+
+void ApiMetrics::record(Stage s, std::chrono::microseconds duration) noexcept {
+  const auto micros =
+      static_cast<std::uint64_t>(std::max<std::int64_t>(0, duration.count()));
+  auto &h = slot().stages[static_cast<std::size_t>(s)];
+  h.buckets[HistogramSnapshot::bucket_of(micros)].fetch_add(
+      1, std::memory_order_relaxed);
+  h.sum_micros.fetch_add(micros, std::memory_order_relaxed);
+}
+
+ApiSnapshot ApiMetrics::snapshot() const {
+  ApiSnapshot out;
+  std::lock_guard lock(registry_->mutex);
+  for (const auto &slot : registry_->slots) {
+    for (std::size_t c = 0; c < kCounterCount; ++c)
+      out.counters[c] += slot->counters[c].load(std::memory_order_relaxed);
+    for (std::size_t st = 0; st < kStageCount; ++st) {
+      auto &h = out.stages[st];
+      for (std::size_t b = 0; b < HistogramSnapshot::kBuckets; ++b) {
+        const auto n =
+            slot->stages[st].buckets[b].load(std::memory_order_relaxed);
+        h.buckets[b] += n;
+        h.count += n;
+      }
+      h.sum_micros +=
+          slot->stages[st].sum_micros.load(std::memory_order_relaxed);
+    }
+  }
+  return out;
+}
+
+// -------------------------
+// Metrics
+// -------------------------
+
+Metrics::Metrics(const std::vector<std::string> &apis) {
+  for (const auto &name : apis)
+    apis_.try_emplace(name, std::make_unique<ApiMetrics>());
+}
+
+ApiMetrics *Metrics::api(std::string_view api) noexcept {
+  const auto it = apis_.find(api);
+  return it == apis_.end() ? nullptr : it->second.get();
+}
+
+void Metrics::record_fallback(std::size_t depth) noexcept {
+  fallback_[std::min(depth, kMaxFallbackDepth)].fetch_add(
+      1, std::memory_order_relaxed);
+}
+
+MetricsSnapshot Metrics::snapshot() const {
+  MetricsSnapshot out;
+  for (const auto &[name, metrics] : apis_)
+    out.apis.emplace(name, metrics->snapshot());
+  for (std::size_t i = 0; i < fallback_.size(); ++i)
+    out.fallback_depth[i] = fallback_[i].load(std::memory_order_relaxed);
+  return out;
+}
+
+// -------------------------
+// Export
+// -------------------------
+
+std::string to_prometheus(const MetricsSnapshot &snapshot) {
+  std::string out;
+  for (std::size_t c = 0; c < kCounterCount; ++c) {
+    const std::string name =
+        "regeocode_" + std::string(kCounterNames[c]) + "_total";
+    out += "# TYPE " + name + " counter\n";
+    for (const auto &[api, s] : snapshot.apis) {
+      out += name + "{api=" + label(api) + "} ";
+      if (in_micros(c))
+        append_number(out, static_cast<double>(s.counters[c]) / 1e6);
+      else
+        out += std::to_string(s.counters[c]);
+      out += '\n';
+    }
+  }
+
+  out += "# TYPE regeocode_stage_seconds summary\n";
+  for (const auto &[api, s] : snapshot.apis) {
+    for (std::size_t st = 0; st < kStageCount; ++st) {
+      const auto &h = s.stages[st];
+      const std::string labels = "api=" + label(api) + ",stage=\"" +
+                                 std::string(kStageNames[st]) + "\"";
+      for (const double q : {0.5, 0.9, 0.99, 0.999}) {
+        out += "regeocode_stage_seconds{" + labels + ",quantile=\"";
+        append_number(out, q);
+        out += "\"} ";
+        append_number(out, static_cast<double>(h.percentile(q).count()) / 1e6);
+        out += '\n';
+      }
+      out += "regeocode_stage_seconds_sum{" + labels + "} ";
+      append_number(out, static_cast<double>(h.sum_micros) / 1e6);
+      out += "\nregeocode_stage_seconds_count{" + labels + "} " +
+             std::to_string(h.count) + '\n';
+    }
+  }
+
+  out += "# TYPE regeocode_fallback_depth_total counter\n";
+  for (std::size_t d = 0; d < snapshot.fallback_depth.size(); ++d)
+    out += "regeocode_fallback_depth_total{depth=\"" +
+           (d == 0 ? std::string("none") : std::to_string(d)) + "\"} " +
+           std::to_string(snapshot.fallback_depth[d]) + '\n';
+  return out;
+}
+
+void write_prometheus_file(const MetricsSnapshot &snapshot,
+                           const std::string &path) {
+  const std::string tmp = path + ".tmp";
+  {
+    std::ofstream f(tmp, std::ios::trunc);
+    f << to_prometheus(snapshot);
+    if (!f)
+      throw std::runtime_error("Cannot write metrics file: " + tmp);
+  }
+  std::error_code ec;
+  std::filesystem::rename(tmp, path, ec);
+  if (ec)
+    throw std::runtime_error("Cannot write metrics file: " + path);
+}
+
+// -------------------------
+// MetricsReporter
+// -------------------------
+
+MetricsReporter::MetricsReporter(
+    std::function<MetricsSnapshot()> source,
+    std::function<void(const MetricsSnapshot &)> sink,
+    std::chrono::milliseconds interval)
+    : source_(std::move(source)), sink_(std::move(sink)),
+      interval_(interval) {
+  thread_ = std::thread([this] {
+    std::unique_lock lock(mutex_);
+    while (!wake_.wait_for(lock, interval_, [this] { return stop_; })) {
+      lock.unlock();
+      sink_(source_());
+      lock.lock();
+    }
+  });
+}
+
+MetricsReporter::~MetricsReporter() {
+  {
+    std::lock_guard lock(mutex_);
+    stop_ = true;
+  }
+  wake_.notify_one();
+  thread_.join();
+  sink_(source_()); // the final state
+}
+
+} // namespace regeocode
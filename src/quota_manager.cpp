@@ -82,4 +82,20 @@ bool QuotaManager::try_consume(const std::string &api_name, long limit) {
   return true;
 }
 
+void QuotaManager::release(const std::string &api_name, long limit) {
+  if (limit <= 0)
+    return; // unlimited, nothing was counted
+
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  if (!state_.contains(api_name) ||
+      state_[api_name]["date"] != get_current_date())
+    return;
+  const long current_count = state_[api_name]["count"].get<long>();
+  if (current_count <= 0)
+    return;
+  state_[api_name]["count"] = current_count - 1;
+  save();
+}
+
 } // namespace regeocode
\ No newline at end of file
@@ -15,6 +15,7 @@
  */
 
 #include "regeocode/re_geocode_c_api.h"
+#include "regeocode/batch_plan.hpp"
 #include "regeocode/re_geocode_core.hpp"
 
 // Adapter Includes
@@ -30,24 +31,236 @@
 #include "regeocode/adapter_tides.hpp"
 
 #include "regeocode/http_client.hpp"
+#include "regeocode/worker_pool.hpp"
 
+#include <atomic>
+#include <cstddef>
 #include <cstring>
+#include <functional>
 #include <iostream>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <stop_token>
+#include <string>
+#include <vector>
 #include <nlohmann/json.hpp>
 
 using namespace regeocode;
 
 struct geocoder_t {
   std::unique_ptr<ReverseGeocoder> impl;
+
+  // Shared by the lookups started since the last geocoder_cancel()
+  std::mutex stop_mutex;
+  std::stop_source stop;
+
+  // Started by the first batch or async lookup; declared last, so it is
+  // destroyed first and queued lookups (and callbacks calling back into the
+  // handle) finish while everything above is alive
+  std::once_flag workers_started;
+  std::unique_ptr<WorkerPool> workers;
+
+  WorkerPool &pool() {
+    std::call_once(workers_started,
+                   [this] { workers = std::make_unique<WorkerPool>(); });
+    return *workers;
+  }
+
+  std::stop_token stop_token() {
+    std::lock_guard lock(stop_mutex);
+    return stop.get_token();
+  }
+  void cancel() {
+    std::lock_guard lock(stop_mutex);
+    stop.request_stop();
+    stop = std::stop_source();
+  }
+};
+
+namespace {
+/// Outcome of one lookup before it is packed for C.
+struct Outcome {
+  std::optional<LookupResult> result;
+  std::string error;
 };
 
-// Helper to copy strings for C
-static char *str_dup(const std::string &s) {
-  if (s.empty())
+Outcome run_lookup(geocoder_t *handle, double lat, double lon,
+                   const char *api_name, const char *local_lang_override,
+                   std::stop_token stop) {
+  Outcome outcome;
+  try {
+    if (!handle || !handle->impl)
+      throw std::runtime_error("Invalid geocoder handle");
+    if (!api_name)
+      throw std::runtime_error("No API name given");
+    outcome.result = handle->impl->lookup(
+        {lat, lon, ""}, api_name, local_lang_override ? local_lang_override : "",
+        std::move(stop));
+  } catch (const std::exception &e) {
+    outcome.error = e.what();
+  }
+  return outcome;
+}
+
+/// What geocode_record_t::internal points to: the owning block and the
+/// record's JSON once asked for; threads sharing a record may ask at once.
+struct RecordSlot {
+  explicit RecordSlot(geocode_result_set_t *owner) : owner(owner) {}
+
+  geocode_result_set_t *owner;
+  std::once_flag json_once;
+  std::string json;
+};
+
+/// Looks up every distinct point of lats/lons once on the handle's
+/// workers and returns the outcomes in input order.
+std::vector<Outcome> run_batch(geocoder_t *handle, const double *lats,
+                               const double *lons, std::size_t count,
+                               const char *api_name,
+                               const char *local_lang_override) {
+  std::vector<Coordinates> coords;
+  coords.reserve(count);
+  for (std::size_t i = 0; i < count; ++i)
+    coords.push_back({lats[i], lons[i], {}});
+  const BatchPlan plan(coords, {});
+  const std::stop_token stop = handle->stop_token();
+  std::vector<Outcome> outcomes(plan.unique().size());
+  handle->pool().parallel_for(outcomes.size(), [&](std::size_t i) {
+    const Coordinates &c = plan.unique()[i];
+    outcomes[i] = run_lookup(handle, c.latitude, c.longitude, api_name,
+                             local_lang_override, stop);
+  });
+  return plan.fan_out(std::move(outcomes));
+}
+
+constexpr std::size_t align_up(std::size_t n) {
+  constexpr std::size_t a = alignof(std::max_align_t);
+  return (n + a - 1) / a * a;
+}
+} // namespace
+
+/**
+ * @brief Header of one heap block holding records and everything they
+ * point to:
+ *
+ *   [header][records][slots][attributes][NUL-terminated text]
+ *
+ * A standalone record is a block of one; the records of a batch share one
+ * block, released with the last of them.
+ */
+struct geocode_result_set_t {
+  std::size_t count;
+  bool shared; // records of a set are only freed with the set
+  geocode_record_t *records;
+  RecordSlot *slots;
+  std::atomic<std::size_t> live; // records not yet freed, unless shared
+};
+
+namespace {
+geocode_result_set_t *pack(std::span<const Outcome> outcomes, bool shared) {
+  // Measure
+  std::size_t attribute_count = 0;
+  std::size_t text_size = 0;
+  auto text = [&text_size](std::string_view s) { text_size += s.size() + 1; };
+  for (const Outcome &o : outcomes) {
+    if (!o.result) {
+      text(o.error);
+      continue;
+    }
+    const LookupResult &r = *o.result;
+    for (const std::string &s :
+         {std::cref(r.api), std::cref(r.type), std::cref(r.address.address_english),
+          std::cref(r.address.address_local), std::cref(r.address.country_code)})
+      text(s);
+    attribute_count += r.address.attributes.size();
+    for (const auto &[key, value] : r.address.attributes) {
+      text(key);
+      text(value);
+    }
+  }
+  const std::size_t count = outcomes.size();
+  const std::size_t records_at = align_up(sizeof(geocode_result_set_t));
+  const std::size_t slots_at =
+      records_at + align_up(count * sizeof(geocode_record_t));
+  const std::size_t attributes_at =
+      slots_at + align_up(count * sizeof(RecordSlot));
+  const std::size_t text_at =
+      attributes_at + align_up(attribute_count * sizeof(geocode_attribute_t));
+  auto *base = static_cast<std::byte *>(::operator new(text_at + text_size));
+
+  // Fill
+  auto *set = new (base) geocode_result_set_t{
+      count, shared, reinterpret_cast<geocode_record_t *>(base + records_at),
+      reinterpret_cast<RecordSlot *>(base + slots_at), count};
+  auto *attribute = reinterpret_cast<geocode_attribute_t *>(base + attributes_at);
+  auto *cursor = reinterpret_cast<char *>(base + text_at);
+  auto put = [&cursor](std::string_view s) {
+    const char *start = cursor;
+    std::memcpy(cursor, s.data(), s.size());
+    cursor += s.size();
+    *cursor++ = '\0';
+    return start;
+  };
+  for (std::size_t i = 0; i < count; ++i) {
+    const Outcome &o = outcomes[i];
+    auto *slot = new (&set->slots[i]) RecordSlot(set);
+    geocode_record_t &record = *new (&set->records[i]) geocode_record_t{};
+    record.internal = slot;
+    if (!o.result) {
+      record.error = put(o.error);
+      continue;
+    }
+    const LookupResult &r = *o.result;
+    record.success = 1;
+    record.api = put(r.api);
+    record.type = put(r.type);
+    record.latitude = r.latitude;
+    record.longitude = r.longitude;
+    record.address_english = put(r.address.address_english);
+    record.address_local = put(r.address.address_local);
+    record.country_code = put(r.address.country_code);
+    record.attributes = attribute;
+    record.attribute_count = r.address.attributes.size();
+    for (const auto &[key, value] : r.address.attributes) {
+      attribute->key = put(key);
+      attribute->value = put(value);
+      ++attribute;
+    }
+  }
+  return set;
+}
+
+void destroy(geocode_result_set_t *set) {
+  for (std::size_t i = 0; i < set->count; ++i)
+    set->slots[i].~RecordSlot();
+  ::operator delete(set);
+}
+
+geocode_record_t empty_record() {
+  geocode_record_t record;
+  std::memset(&record, 0, sizeof(record));
+  return record;
+}
+
+/// Record for a lookup that failed before it could be packed (e.g. out of
+/// memory); it owns nothing, so freeing it is a no-op.
+geocode_record_t failed_record() {
+  geocode_record_t record = empty_record();
+  record.error = "Lookup failed";
+  return record;
+}
+} // namespace
+
+geocoder_t *geocoder_wrap(std::unique_ptr<ReverseGeocoder> geocoder) {
+  if (!geocoder)
     return nullptr;
-  char *res = new char[s.size() + 1];
-  std::strcpy(res, s.c_str());
-  return res;
+  auto *ptr = new geocoder_t();
+  ptr->impl = std::move(geocoder);
+  return ptr;
 }
 
 // --- HERE IS THE IMPORTANT CHANGE ---
@@ -72,7 +285,7 @@ geocoder_t *geocoder_new(const char *ini_path) {
     adapters.push_back(std::make_unique<TidesAdapter>());
     adapters.push_back(std::make_unique<SeaWeatherAdapter>());
 
-    auto client = std::make_unique<HttpClient>();
+    auto client = std::make_unique<HttpClient>(config_result.http);
 
     auto *ptr = new geocoder_t();
 
@@ -101,35 +314,31 @@ geocode_result_t geocoder_lookup(geocoder_t *handle, double lat, double lon,
   try {
     std::string lang = local_lang_override ? local_lang_override : "";
 
-    // 1. We get the standardized JSON object from Core
-    nlohmann::json j_root =
-        handle->impl->reverse_geocode_json({lat, lon}, api_name, lang);
+    // 1. The typed result from Core; fields are copied without a JSON detour
+    const LookupResult result =
+        handle->impl->lookup({lat, lon, ""}, api_name, lang,
+                             handle->stop_token());
 
     // 2. Create JSON string for C (dump)
-    std::string json_str = j_root.dump();
-    c_res.json_full = str_dup(json_str);
-
-    // 3. Fallback mapping for old C-Struct fields
-    if (j_root.contains("result")) {
-      const auto &res = j_root["result"];
-      std::string s_eng, s_loc, s_cc;
-
-      if (res.contains("address_english"))
-        s_eng = res["address_english"];
-      else if (res.contains("title"))
-        s_eng = res["title"];
-
-      if (res.contains("address_local"))
-        s_loc = res["address_local"];
-      else if (res.contains("summary"))
-        s_loc = res["summary"];
-
-      if (res.contains("country_code"))
-        s_cc = res["country_code"];
-
-      c_res.address_english = str_dup(s_eng);
-      c_res.address_local = str_dup(s_loc);
-      c_res.country_code = str_dup(s_cc);
+    const std::string json = result.to_json().dump();
+
+    // 3. All four strings share one block that json_full (never NULL, never
+    // empty) starts and owns; the other empty ones stay NULL
+    const std::string *fields[] = {&json, &result.address.address_english,
+                                   &result.address.address_local,
+                                   &result.address.country_code};
+    std::size_t size = 0;
+    for (const std::string *f : fields)
+      size += f->empty() ? 0 : f->size() + 1;
+    char *cursor = new char[size];
+    char **targets[] = {&c_res.json_full, &c_res.address_english,
+                        &c_res.address_local, &c_res.country_code};
+    for (std::size_t i = 0; i < 4; ++i) {
+      if (fields[i]->empty())
+        continue;
+      std::memcpy(cursor, fields[i]->c_str(), fields[i]->size() + 1);
+      *targets[i] = cursor;
+      cursor += fields[i]->size() + 1;
     }
 
     c_res.success = 1;
@@ -142,12 +351,159 @@ geocode_result_t geocoder_lookup(geocoder_t *handle, double lat, double lon,
   return c_res;
 }
 
+geocode_record_t geocoder_lookup_record(geocoder_t *handle, double lat,
+                                        double lon, const char *api_name,
+                                        const char *local_lang_override) {
+  try {
+    const Outcome outcome =
+        run_lookup(handle, lat, lon, api_name, local_lang_override,
+                   handle ? handle->stop_token() : std::stop_token());
+    return pack({&outcome, 1}, false)->records[0];
+  } catch (...) {
+    return failed_record();
+  }
+}
+
+const char *geocoder_record_json(const geocode_record_t *record) {
+  if (!record || !record->success || !record->internal)
+    return nullptr;
+  auto *slot = static_cast<RecordSlot *>(record->internal);
+  std::call_once(slot->json_once, [record, slot] {
+    // Rebuilt from the record, so the layout stays LookupResult::to_json()'s
+    LookupResult result;
+    result.api = record->api;
+    result.type = record->type;
+    result.latitude = record->latitude;
+    result.longitude = record->longitude;
+    result.address.address_english = record->address_english;
+    result.address.address_local = record->address_local;
+    result.address.country_code = record->country_code;
+    for (std::size_t i = 0; i < record->attribute_count; ++i)
+      result.address.attributes[record->attributes[i].key] =
+          record->attributes[i].value;
+    slot->json = result.to_json().dump();
+  });
+  return slot->json.c_str();
+}
+
+void geocoder_record_free(geocode_record_t *record) {
+  if (!record || !record->internal)
+    return;
+  geocode_result_set_t *owner =
+      static_cast<RecordSlot *>(record->internal)->owner;
+  if (owner->shared)
+    return;
+  *record = empty_record();
+  if (owner->live.fetch_sub(1, std::memory_order_acq_rel) == 1)
+    destroy(owner);
+}
+
+size_t geocoder_lookup_batch(geocoder_t *handle, const double *lats,
+                             const double *lons, size_t count,
+                             const char *api_name,
+                             const char *local_lang_override,
+                             geocode_record_t *results) {
+  if (!results)
+    return 0;
+  if (!handle || !handle->impl || !lats || !lons) {
+    for (size_t i = 0; i < count; ++i)
+      results[i] = geocoder_lookup_record(nullptr, 0, 0, nullptr, nullptr);
+    return 0;
+  }
+
+  if (count == 0)
+    return 0;
+  const geocode_result_set_t *set = nullptr;
+  try {
+    set = pack(
+        run_batch(handle, lats, lons, count, api_name, local_lang_override),
+        false);
+  } catch (...) {
+    for (size_t i = 0; i < count; ++i)
+      results[i] = failed_record();
+    return 0;
+  }
+  size_t succeeded = 0;
+  for (size_t i = 0; i < count; ++i) {
+    results[i] = set->records[i];
+    succeeded += results[i].success ? 1 : 0;
+  }
+  return succeeded;
+}
+
+geocode_result_set_t *geocoder_lookup_set(geocoder_t *handle,
+                                          const double *lats,
+                                          const double *lons, size_t count,
+                                          const char *api_name,
+                                          const char *local_lang_override) {
+  if (!handle || !handle->impl || (count > 0 && (!lats || !lons)))
+    return nullptr;
+
+  try {
+    return pack(
+        run_batch(handle, lats, lons, count, api_name, local_lang_override),
+        true);
+  } catch (...) {
+    return nullptr;
+  }
+}
+
+size_t geocoder_result_set_size(const geocode_result_set_t *set) {
+  return set ? set->count : 0;
+}
+
+const geocode_record_t *
+geocoder_result_set_records(const geocode_result_set_t *set) {
+  return set ? set->records : nullptr;
+}
+
+void geocoder_result_set_free(geocode_result_set_t *set) {
+  if (set)
+    destroy(set);
+}
+
+int geocoder_lookup_async(geocoder_t *handle, double lat, double lon,
+                          const char *api_name,
+                          const char *local_lang_override,
+                          geocode_callback_t callback, void *user_data) {
+  if (!handle || !handle->impl || !api_name || !callback)
+    return 0;
+
+  // The caller's strings may be gone by the time a worker gets to them;
+  // the token is taken now, so a cancel also reaches queued lookups
+  try {
+    handle->pool().submit(
+        [handle, lat, lon, api = std::string(api_name),
+         lang = std::string(local_lang_override ? local_lang_override : ""),
+         callback, user_data, stop = handle->stop_token()] {
+          geocode_record_t *record = nullptr;
+          try {
+            const Outcome outcome =
+                run_lookup(handle, lat, lon, api.c_str(), lang.c_str(), stop);
+            // The block's own record, valid until geocoder_record_free()
+            record = &pack({&outcome, 1}, false)->records[0];
+          } catch (...) {
+            // Owns nothing and is never written, so one serves every caller
+            static geocode_record_t failed = failed_record();
+            record = &failed;
+          }
+          callback(record, user_data);
+        });
+  } catch (...) {
+    return 0;
+  }
+  return 1;
+}
+
+void geocoder_cancel(geocoder_t *handle) {
+  if (handle)
+    handle->cancel();
+}
+
 void geocoder_result_free(geocode_result_t *res) {
   if (!res)
     return;
-  delete[] res->address_english;
-  delete[] res->address_local;
-  delete[] res->country_code;
+  // One block, owned by json_full, see geocoder_lookup()
   delete[] res->json_full;
 
   res->address_english = nullptr;
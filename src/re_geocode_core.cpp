@@ -15,21 +15,33 @@
  */
 
 #include "regeocode/re_geocode_core.hpp"
+#include "regeocode/batch_plan.hpp"
+#include "regeocode/country_code_index.hpp"
 #include "regeocode/quota_manager.hpp"
+#include "regeocode/request_arena.hpp"
 
 #include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <chrono>
+#include <condition_variable>
+#include <coroutine>
+#include <exception>
 #include <fstream>
 #include <future>
 #include <iostream>
+#include <mutex>
+#include <optional>
 #include <sstream>
 #include <stdexcept>
+#include <stop_token>
 #include <string>
+#include <string_view>
 #include <thread>
 #include <unordered_map>
 #include <unordered_set>
 #include <utility>
 
-#include "regeocode/inja.hpp"
 #include <inicpp.h>
 #include <nlohmann/json.hpp>
 
@@ -45,22 +57,194 @@ bool is_valid_language(const std::string &lang) {
   return valid.contains(lang);
 }
 
-std::string language_from_country(const std::string &cc_raw) {
-  std::string cc = cc_raw;
-  for (auto &c : cc)
-    c = static_cast<char>(::tolower(c));
+std::string language_from_country(std::string_view cc) {
+  return std::string(country_index::local_language(cc));
+}
+
+std::chrono::microseconds since(std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration_cast<std::chrono::microseconds>(
+      std::chrono::steady_clock::now() - start);
+}
 
-  static const std::unordered_map<std::string, std::string> map = {
-      {"de", "de"}, {"at", "de"}, {"ch", "de"},    {"ae", "ar"},
-      {"sa", "ar"}, {"eg", "ar"}, {"cn", "zh-CN"}, {"tw", "zh-TW"},
-      {"jp", "ja"}, {"kr", "ko"}, {"fr", "fr"},    {"es", "es"},
-      {"it", "it"}, {"ru", "ru"}, {"pt", "pt"},    {"nl", "nl"}};
+/// Network phases of a transfer; clients that do not time them report zero.
+void record_timings(ApiMetrics &metrics, const HttpTimings &t) {
+  if (t.wait.count() == 0 && t.transfer.count() == 0)
+    return;
+  metrics.record(Stage::Dns, t.dns);
+  metrics.record(Stage::Connect, t.connect);
+  metrics.record(Stage::Tls, t.tls);
+  metrics.record(Stage::Wait, t.wait);
+  metrics.record(Stage::Transfer, t.transfer);
+}
+
+/// The same phases as spans laid end to end from @p start; the gaps libcurl
+/// does not report (e.g. sending the request) fall into "wait".
+void trace_timings(const Tracer &tracer, std::string_view api,
+                   std::chrono::steady_clock::time_point start,
+                   const HttpTimings &t) {
+  if (!tracer.enabled() || (t.wait.count() == 0 && t.transfer.count() == 0))
+    return;
+  const std::pair<std::string_view, std::chrono::microseconds> phases[] = {
+      {"dns", t.dns},   {"connect", t.connect},   {"tls", t.tls},
+      {"wait", t.wait}, {"transfer", t.transfer}};
+  for (const auto &[name, duration] : phases) {
+    if (duration.count() > 0)
+      trace_span(tracer, name, api, start, duration);
+    start += duration;
+  }
+}
+
+bool is_info(const ApiConfig &cfg) {
+  return cfg.type == "info" || cfg.type == "information";
+}
+
+/// Language of the second lookup of a dual-language lookup, empty for none:
+/// the user's language if valid, else the one of the country found.
+std::string local_language(const std::string &user_lang,
+                           const std::string &country_code) {
+  if (!user_lang.empty())
+    return is_valid_language(user_lang) ? user_lang : std::string();
+  if (country_code.empty())
+    return {};
+  return language_from_country(country_code);
+}
 
-  auto it = map.find(cc);
-  if (it != map.end())
-    return it->second;
-  return "en";
+/// HTTP status code of a retry-on entry: digits only, around blanks.
+std::optional<long> parse_status_code(std::string_view token) {
+  const auto first = token.find_first_not_of(" \t");
+  if (first == std::string_view::npos)
+    return std::nullopt;
+  token = token.substr(first, token.find_last_not_of(" \t") + 1 - first);
+  long code = 0;
+  const auto [end, ec] =
+      std::from_chars(token.data(), token.data() + token.size(), code);
+  if (ec != std::errc() || end != token.data() + token.size() || code < 100 ||
+      code > 599)
+    return std::nullopt;
+  return code;
 }
+
+std::string trim_api_name(std::string name) {
+  name.erase(0, name.find_first_not_of(' '));
+  name.erase(name.find_last_not_of(' ') + 1);
+  return name;
+}
+
+nlohmann::json provider_failed(const std::string &api_name,
+                               const std::exception &e) {
+  std::cerr << "[Warning] API '" << api_name << "' failed: " << e.what()
+            << ". Trying next provider...\n";
+  return {{"error", "Provider failed"},
+          {"provider", api_name},
+          {"details", e.what()}};
+}
+
+/// Blocks for @p delay; true when @p stop was requested first.
+bool backoff(std::chrono::milliseconds delay, std::stop_token stop) {
+  std::mutex mutex;
+  std::condition_variable_any wake;
+  std::unique_lock lock(mutex);
+  wake.wait_for(lock, stop, delay, [] { return false; });
+  return stop.stop_requested();
+}
+
+nlohmann::json all_failed(nlohmann::json last_error) {
+  nlohmann::json error_json;
+  error_json["error"] = "All providers failed";
+  error_json["last_attempt"] = std::move(last_error);
+  return error_json;
+}
+
+/// The answers of @p plan in input order, each meta naming its own input
+/// point; one answered by another point's lookup keeps that point as
+/// meta.looked_up_at.
+std::vector<nlohmann::json>
+fan_out_batch(const BatchPlan &plan, std::vector<nlohmann::json> results,
+              const std::vector<Coordinates> &coords_list) {
+  std::vector<nlohmann::json> out = plan.fan_out(std::move(results));
+  for (std::size_t i = 0; i < out.size(); ++i) {
+    const auto meta = out[i].find("meta");
+    if (meta == out[i].end() || !meta->is_object())
+      continue;
+    const Coordinates &c = coords_list[i];
+    const Coordinates &looked_up = plan.unique()[plan.source(i)];
+    if (looked_up.latitude != c.latitude ||
+        looked_up.longitude != c.longitude)
+      (*meta)["looked_up_at"] = {{"latitude", looked_up.latitude},
+                                 {"longitude", looked_up.longitude}};
+    (*meta)["latitude"] = c.latitude;
+    (*meta)["longitude"] = c.longitude;
+  }
+  return out;
+}
+
+/**
+ * @brief Awaitable for an operation that reports through a callback.
+ *
+ * @p start receives the callback and begins the operation. Whichever comes
+ * second, start() returning or the callback, continues the coroutine: an
+ * operation completing inline does not suspend, one completing on the
+ * engine has @p resume continue the coroutine elsewhere, as the engine's
+ * thread must not block.
+ */
+template <typename T, typename Start, typename Resume>
+auto on_callback(Start start, Resume resume) {
+  struct Awaiter {
+    Awaiter(Start s, Resume r) : start(std::move(s)), resume(std::move(r)) {}
+
+    Start start;
+    Resume resume;
+    std::optional<T> value;
+    std::coroutine_handle<> awaiting;
+    std::atomic<bool> second{false};
+
+    bool await_ready() const noexcept { return false; }
+    bool await_suspend(std::coroutine_handle<> handle) {
+      awaiting = handle;
+      start([this](T v) {
+        value.emplace(std::move(v));
+        if (second.exchange(true, std::memory_order_acq_rel))
+          resume(awaiting);
+      });
+      return !second.exchange(true, std::memory_order_acq_rel);
+    }
+    T await_resume() { return std::move(*value); }
+  };
+  return Awaiter(std::move(start), std::move(resume));
+}
+
+/**
+ * @brief Counts a lookup, times it, and counts it as failed unless its
+ * result was passed through succeeded().
+ *
+ * An explicit flag rather than std::uncaught_exceptions(): in a coroutine
+ * the scope may be created and destroyed on different threads.
+ */
+class LookupScope {
+public:
+  explicit LookupScope(ApiMetrics &metrics)
+      : metrics_(metrics), start_(std::chrono::steady_clock::now()) {
+    metrics_.add(Counter::Lookups);
+  }
+  ~LookupScope() {
+    metrics_.record(Stage::Lookup, since(start_));
+    if (!succeeded_)
+      metrics_.add(Counter::Failures);
+  }
+  LookupScope(const LookupScope &) = delete;
+  LookupScope &operator=(const LookupScope &) = delete;
+
+  /// Marks the lookup as answered; returns @p result.
+  AddressResult succeeded(AddressResult result) {
+    succeeded_ = true;
+    return result;
+  }
+
+private:
+  ApiMetrics &metrics_;
+  std::chrono::steady_clock::time_point start_;
+  bool succeeded_ = false;
+};
 } // namespace
 
 // -------------------------
@@ -80,6 +264,7 @@ Configuration ConfigLoader::load() const {
   ini.load(ini_path_);
 
   Configuration result_config; // The result object
+  bool shared_cache = true;
 
   for (auto &sectionPair : ini) {
     const std::string &sectionName = sectionPair.first;
@@ -102,6 +287,20 @@ Configuration ConfigLoader::load() const {
         }
         result_config.quota_file_path = qf;
       }
+      if (section.count("multiplex")) {
+        result_config.http.multiplex = section["multiplex"].as<bool>();
+      }
+      if (section.count("max-host-connections")) {
+        result_config.http.max_host_connections =
+            section["max-host-connections"].as<long>();
+      }
+      if (section.count("max-concurrent-streams")) {
+        result_config.http.max_concurrent_streams =
+            section["max-concurrent-streams"].as<long>();
+      }
+      if (section.count("shared-cache")) {
+        shared_cache = section["shared-cache"].as<bool>();
+      }
       continue; // Do not process as API
     }
 
@@ -147,9 +346,90 @@ Configuration ConfigLoader::load() const {
       cfg.timeout = 10;
     }
 
+    if (section.count("raw-json") != 0) {
+      cfg.keep_raw_json = section["raw-json"].as<bool>();
+    }
+
+    if (section.count("accept-encoding") != 0) {
+      cfg.accept_encoding = section["accept-encoding"].as<std::string>();
+    }
+
+    if (section.count("http-version") != 0) {
+      try {
+        cfg.http_version =
+            parse_http_version(section["http-version"].as<std::string>());
+      } catch (const std::invalid_argument &e) {
+        throw std::runtime_error(std::string(e.what()) +
+                                 " in API section: " + sectionName);
+      }
+    }
+
+    // Info lookups (country data, Wikipedia) rarely change
+    cfg.http_cache = type == "info" || type == "information";
+    if (section.count("http-cache") != 0) {
+      cfg.http_cache = section["http-cache"].as<bool>();
+    }
+
+    if (section.count("retry-attempts") != 0) {
+      cfg.retry.max_attempts = section["retry-attempts"].as<int>();
+    }
+    if (section.count("retry-base-delay-ms") != 0) {
+      cfg.retry.base_delay = std::chrono::milliseconds(
+          section["retry-base-delay-ms"].as<long>());
+    }
+    if (section.count("retry-max-delay-ms") != 0) {
+      cfg.retry.max_delay = std::chrono::milliseconds(
+          section["retry-max-delay-ms"].as<long>());
+    }
+    if (section.count("retry-after-max-ms") != 0) {
+      cfg.retry.max_retry_after = std::chrono::milliseconds(
+          section["retry-after-max-ms"].as<long>());
+    }
+    if (section.count("retry-jitter") != 0) {
+      cfg.retry.jitter = section["retry-jitter"].as<double>();
+      if (cfg.retry.jitter < 0.0 || cfg.retry.jitter > 1.0)
+        throw std::runtime_error(
+            "retry-jitter must be between 0 and 1 in API section: " +
+            sectionName);
+    }
+    if (section.count("honour-retry-after") != 0) {
+      cfg.retry.honour_retry_after =
+          section["honour-retry-after"].as<bool>();
+    }
+    if (section.count("retry-budget") != 0) {
+      cfg.retry.budget_ratio = section["retry-budget"].as<double>();
+    }
+    if (section.count("retry-budget-min") != 0) {
+      cfg.retry.budget_min_retries =
+          section["retry-budget-min"].as<unsigned>();
+    }
+    if (section.count("retry-on") != 0) {
+      // Comma-separated status codes, e.g. "429, 503"
+      cfg.retry.retry_on.clear();
+      std::stringstream codes(section["retry-on"].as<std::string>());
+      std::string code;
+      while (std::getline(codes, code, ',')) {
+        const auto status = parse_status_code(code);
+        if (!status)
+          throw std::runtime_error("Invalid retry-on status '" + code +
+                                   "' in API section: " + sectionName);
+        cfg.retry.retry_on.push_back(*status);
+      }
+    }
+
     result_config.apis.emplace(sectionName, std::move(cfg));
   }
 
+  // Every handle loaded from an INI resolves, handshakes and (with
+  // multiplex) connects through the same process-wide caches; the engine
+  // of the share keeps the configured limits
+  if (shared_cache) {
+    HttpShareOptions share;
+    share.max_host_connections = result_config.http.max_host_connections;
+    share.max_concurrent_streams = result_config.http.max_concurrent_streams;
+    result_config.http.share = HttpShare::process(share);
+  }
+
   return result_config;
 }
 
@@ -163,51 +443,355 @@ ReverseGeocoder::ReverseGeocoder(
     std::unique_ptr<HttpClient> http_client,
     const std::string &quota_file_path) // NEW: Path argument
     : configs_(std::move(configs)), http_client_(std::move(http_client)),
+      metrics_([this] {
+        std::vector<std::string> names;
+        for (const auto &entry : configs_)
+          names.push_back(entry.first);
+        return names;
+      }()),
       quota_manager_(quota_file_path) // NEW: Init with path
 {
 
   for (auto &a : adapters) {
     adapters_.emplace(a->name(), std::move(a));
   }
+  // Compile each URI template once instead of on every request
+  for (const auto &[name, cfg] : configs_) {
+    uri_templates_.emplace(name, UriTemplate(cfg.uri_template));
+    retry_budgets_.try_emplace(name, cfg.retry);
+  }
 }
 
-// ... (Rest of file remains exactly same as before, reverse_geocode etc.) ...
-AddressResult
-ReverseGeocoder::reverse_geocode(const Coordinates &coords,
-                                 const std::string &api_name,
-                                 const std::string &language_code) const {
-  // ... Code from before ...
+const ApiConfig &ReverseGeocoder::config(const std::string &api_name) const {
   auto it = configs_.find(api_name);
   if (it == configs_.end())
     throw std::runtime_error("Unknown API: " + api_name);
-  const auto &cfg = it->second;
+  return it->second;
+}
+
+const ApiAdapter &ReverseGeocoder::adapter(const ApiConfig &cfg) const {
+  auto adapter_it = adapters_.find(cfg.adapter);
+  if (adapter_it == adapters_.end())
+    throw std::runtime_error("No adapter registered for: " + cfg.adapter);
+  return *adapter_it->second;
+}
 
+void ReverseGeocoder::consume_quota(const ApiConfig &cfg,
+                                    ApiMetrics &metrics) const {
+  const TraceSpan span(tracer_, "quota", cfg.name);
   if (!quota_manager_.try_consume(cfg.name, cfg.daily_limit)) {
+    metrics.add(Counter::QuotaRejected);
     throw std::runtime_error("Daily limit exceeded for API: " + cfg.name);
   }
+  if (cfg.daily_limit > 0)
+    metrics.add(Counter::QuotaConsumed);
+}
 
-  auto adapter_it = adapters_.find(cfg.adapter);
-  if (adapter_it == adapters_.end())
-    throw std::runtime_error("No adapter registered for: " + cfg.adapter);
-  const auto &adapter = adapter_it->second;
+void ReverseGeocoder::release_quota(const ApiConfig &cfg,
+                                    ApiMetrics &metrics) const {
+  if (cfg.daily_limit <= 0)
+    return;
+  quota_manager_.release(cfg.name, cfg.daily_limit);
+  metrics.add(Counter::QuotaReleased);
+}
 
-  nlohmann::json params;
-  params["latitude"] = coords.latitude;
-  params["longitude"] = coords.longitude;
-  params["apikey"] = cfg.api_key;
-  params["lang"] = language_code;
-  params["country_code"] = coords.country_code.empty() ? cfg.api_key : coords.country_code;
+void ReverseGeocoder::cancelled(const ApiConfig &cfg, ApiMetrics &metrics,
+                                bool reserved) const {
+  metrics.add(Counter::Cancelled);
+  if (reserved)
+    release_quota(cfg, metrics);
+  throw LookupCancelled(cfg.name);
+}
 
-  inja::Environment env;
-  std::string url = env.render(cfg.uri_template, params);
+AddressResult ReverseGeocoder::parse(const ApiConfig &cfg,
+                                     const ApiAdapter &adapter,
+                                     ApiMetrics &metrics,
+                                     std::string_view body) const {
+  const TraceSpan span(tracer_, "parse", cfg.name);
+  const auto started = std::chrono::steady_clock::now();
+  // Adapters parse a view of the (possibly arena-backed) body; it is only
+  // copied out when the API asks for the raw response
+  AddressResult result = adapter.parse_response(body);
+  metrics.record(Stage::Parse, since(started));
+  if (cfg.keep_raw_json)
+    result.raw_json.assign(body);
+  return result;
+}
 
-  auto resp = http_client_->get(url, cfg.timeout);
+std::optional<std::chrono::milliseconds>
+ReverseGeocoder::settle_attempt(const ApiConfig &cfg, ApiMetrics &metrics,
+                                int attempt, const HttpResponse &resp,
+                                const CacheOutcome &outcome,
+                                std::chrono::microseconds elapsed) const {
+  auto count_saving = [&metrics](const CacheOutcome &outcome) {
+    metrics.add(Counter::SavedBytes, outcome.saved_bytes);
+    metrics.add(Counter::SavedMicros,
+                static_cast<std::uint64_t>(outcome.saved_time.count()));
+  };
+  if (outcome.kind == CacheOutcome::Kind::Fresh) {
+    // Stored by another lookup since the check before consume_quota(); no
+    // request went out, so its slot goes back
+    metrics.add(Counter::CacheHits);
+    count_saving(outcome);
+    release_quota(cfg, metrics);
+    return std::nullopt;
+  }
+  metrics.add(Counter::Requests);
+  if (outcome.kind == CacheOutcome::Kind::Revalidated) {
+    // Only headers went over the wire
+    metrics.add(Counter::Revalidations);
+    count_saving(outcome);
+  } else {
+    metrics.add(Counter::WireBytes,
+                resp.wire_bytes != 0 ? resp.wire_bytes : resp.body.size());
+    metrics.add(Counter::DecodedBytes, resp.body.size());
+  }
+  metrics.add(Counter::TransferMicros,
+              static_cast<std::uint64_t>(elapsed.count()));
+  record_timings(metrics, resp.timings);
+
+  if (resp.status_code >= 200 && resp.status_code < 300)
+    return std::nullopt;
+
+  // Transient failures are repeated here before a fallback chain moves
+  // on to the next (often more expensive) provider
+  const auto delay = retry_delay(cfg.retry, attempt, resp.status_code,
+                                 resp.retry_after,
+                                 retry_budgets_.at(cfg.name));
+  if (!delay) {
+    throw std::runtime_error("HTTP error: " +
+                             std::to_string(resp.status_code));
+  }
+  consume_quota(cfg, metrics);
+  metrics.add(Counter::Retries);
+  return delay;
+}
 
-  if (resp.status_code < 200 || resp.status_code >= 300) {
-    throw std::runtime_error("HTTP error: " + std::to_string(resp.status_code));
+AddressResult
+ReverseGeocoder::reverse_geocode(const Coordinates &coords,
+                                 const std::string &api_name,
+                                 const std::string &language_code,
+                                 std::stop_token stop) const {
+  const ApiConfig &cfg = config(api_name);
+  const ApiAdapter &adapter = this->adapter(cfg);
+
+  const std::string &country_code =
+      coords.country_code.empty() ? cfg.api_key : coords.country_code;
+
+  ApiMetrics &metrics = *metrics_.api(api_name);
+  LookupScope scope(metrics);
+  TraceSpan lookup_span(tracer_, "lookup", api_name);
+  if (lookup_span.active())
+    lookup_span.detail("lang=" + language_code);
+
+  if (stop.stop_requested())
+    cancelled(cfg, metrics, false);
+
+  // Adapters with local data answer without HTTP and without quota
+  if (auto local = adapter.resolve_local(
+          {coords.latitude, coords.longitude, country_code, language_code})) {
+    metrics.add(Counter::LocalAnswers);
+    return scope.succeeded(std::move(*local));
+  }
+
+  // Scanner state and other request temporaries share one arena
+  RequestArena arena;
+
+  TraceSpan render_span(tracer_, "render_uri", api_name);
+  const std::string url = uri_templates_.at(api_name).render(
+      {coords.latitude, coords.longitude, cfg.api_key, language_code,
+       country_code});
+  render_span.end();
+
+  // Fresh cached responses answer without HTTP and without quota
+  if (cfg.http_cache) {
+    if (const auto hit = http_cache_.fresh(url)) {
+      metrics.add(Counter::CacheHits);
+      metrics.add(Counter::SavedBytes, hit->body.size());
+      metrics.add(Counter::SavedMicros,
+                  static_cast<std::uint64_t>(hit->fetch_time.count()));
+      return scope.succeeded(parse(cfg, adapter, metrics, hit->body));
+    }
+  }
+
+  consume_quota(cfg, metrics);
+
+  HttpRequestOptions options;
+  options.accept_encoding = cfg.accept_encoding;
+  options.http_version = cfg.http_version;
+  options.stop = stop;
+
+  retry_budgets_.at(api_name).record_request();
+
+  HttpResponse resp;
+  for (int attempt = 1;; ++attempt) {
+    CacheOutcome outcome;
+    TraceSpan http_span(tracer_, "http", api_name);
+    const auto started = std::chrono::steady_clock::now();
+    resp = cfg.http_cache
+               ? http_cache_.fetch(*http_client_, url, cfg.timeout, options,
+                                   &outcome)
+               : http_client_->get(url, cfg.timeout, options);
+    const auto elapsed = since(started);
+    if (resp.cancelled)
+      cancelled(cfg, metrics, true);
+    if (http_span.active()) {
+      http_span.detail("attempt=" + std::to_string(attempt) +
+                       " status=" + std::to_string(resp.status_code));
+      http_span.end();
+      trace_timings(tracer_, api_name, started, resp.timings);
+    }
+
+    const auto delay =
+        settle_attempt(cfg, metrics, attempt, resp, outcome, elapsed);
+    if (!delay)
+      break;
+    // Only the calling thread waits; transfers of other threads on a
+    // shared engine continue. The slot of the next attempt is reserved.
+    const TraceSpan backoff_span(tracer_, "retry_backoff", api_name);
+    if (backoff(*delay, stop))
+      cancelled(cfg, metrics, true);
   }
 
-  return adapter->parse_response(resp.body);
+  return scope.succeeded(parse(cfg, adapter, metrics, resp.body));
+}
+
+Task<AddressResult>
+ReverseGeocoder::reverse_geocode_async(Coordinates coords,
+                                       std::string api_name,
+                                       std::string language_code,
+                                       std::stop_token stop) const {
+  const ApiConfig &cfg = config(api_name);
+  const ApiAdapter &adapter = this->adapter(cfg);
+
+  const std::string &country_code =
+      coords.country_code.empty() ? cfg.api_key : coords.country_code;
+
+  ApiMetrics &metrics = *metrics_.api(api_name);
+  LookupScope scope(metrics);
+  TraceSpan lookup_span(tracer_, "lookup", api_name);
+  if (lookup_span.active())
+    lookup_span.detail("lang=" + language_code);
+
+  if (stop.stop_requested())
+    cancelled(cfg, metrics, false);
+
+  if (auto local = adapter.resolve_local(
+          {coords.latitude, coords.longitude, country_code, language_code})) {
+    metrics.add(Counter::LocalAnswers);
+    co_return scope.succeeded(std::move(*local));
+  }
+
+  // No RequestArena here: the arena belongs to a thread, and the coroutine
+  // resumes on a worker thread
+  TraceSpan render_span(tracer_, "render_uri", api_name);
+  const std::string url = uri_templates_.at(api_name).render(
+      {coords.latitude, coords.longitude, cfg.api_key, language_code,
+       country_code});
+  render_span.end();
+
+  if (cfg.http_cache) {
+    if (const auto hit = http_cache_.fresh(url)) {
+      metrics.add(Counter::CacheHits);
+      metrics.add(Counter::SavedBytes, hit->body.size());
+      metrics.add(Counter::SavedMicros,
+                  static_cast<std::uint64_t>(hit->fetch_time.count()));
+      co_return scope.succeeded(parse(cfg, adapter, metrics, hit->body));
+    }
+  }
+
+  consume_quota(cfg, metrics);
+
+  retry_budgets_.at(api_name).record_request();
+
+  // Quota file writes, parsing and logging stay off the engine's thread
+  auto off_engine = [this](std::coroutine_handle<> handle) {
+    continuations().submit([handle] { handle.resume(); });
+  };
+
+  for (int attempt = 1;; ++attempt) {
+    HttpRequestOptions options;
+    options.accept_encoding = cfg.accept_encoding;
+    options.http_version = cfg.http_version;
+
+    CacheOutcome outcome;
+    std::shared_ptr<const CachedResponse> stale;
+    std::optional<HttpResponse> fresh;
+    if (cfg.http_cache)
+      fresh = http_cache_.begin_fetch(url, options, stale, outcome);
+
+    TraceSpan http_span(tracer_, "http", api_name);
+    const auto started = std::chrono::steady_clock::now();
+    HttpResponse resp;
+    if (fresh)
+      resp = std::move(*fresh);
+    else
+      resp = co_await on_callback<HttpResponse>(
+          [&](auto done) {
+            http_client_->get_async(url, cfg.timeout, options, stop,
+                                    std::move(done));
+          },
+          off_engine);
+    const auto elapsed = since(started);
+    if (resp.cancelled)
+      cancelled(cfg, metrics, true);
+    if (cfg.http_cache && !fresh)
+      http_cache_.end_fetch(url, stale, resp, elapsed, outcome);
+    if (http_span.active()) {
+      http_span.detail("attempt=" + std::to_string(attempt) +
+                       " status=" + std::to_string(resp.status_code));
+      http_span.end();
+      trace_timings(tracer_, api_name, started, resp.timings);
+    }
+
+    const auto delay =
+        settle_attempt(cfg, metrics, attempt, resp, outcome, elapsed);
+    if (!delay)
+      co_return scope.succeeded(parse(cfg, adapter, metrics, resp.body));
+
+    // A timer on the engine instead of a sleeping thread
+    TraceSpan backoff_span(tracer_, "retry_backoff", api_name);
+    const bool stopped = co_await on_callback<bool>(
+        [&](auto done) {
+          http_client_->wait_async(*delay, stop, std::move(done));
+        },
+        off_engine);
+    if (stopped)
+      cancelled(cfg, metrics, true);
+  }
+}
+
+WorkerPool &ReverseGeocoder::continuations() const {
+  std::call_once(continuations_started_,
+                 [this] { continuations_ = std::make_unique<WorkerPool>(); });
+  return *continuations_;
+}
+
+TransferStats
+ReverseGeocoder::transfer_stats(const std::string &api_name) const {
+  TransferStats stats;
+  ApiMetrics *metrics = metrics_.api(api_name);
+  if (!metrics)
+    return stats;
+  const ApiSnapshot c = metrics->snapshot();
+  stats.requests = c[Counter::Requests];
+  stats.wire_bytes = c[Counter::WireBytes];
+  stats.decoded_bytes = c[Counter::DecodedBytes];
+  stats.transfer_micros = c[Counter::TransferMicros];
+  stats.retries = c[Counter::Retries];
+  stats.cache_hits = c[Counter::CacheHits];
+  stats.revalidations = c[Counter::Revalidations];
+  stats.saved_bytes = c[Counter::SavedBytes];
+  stats.saved_micros = c[Counter::SavedMicros];
+  return stats;
+}
+
+MetricsSnapshot ReverseGeocoder::metrics() const {
+  return metrics_.snapshot();
+}
+
+void ReverseGeocoder::set_trace_sink(std::shared_ptr<TraceSink> sink) {
+  tracer_.set_sink(std::move(sink));
 }
 
 // ... (reverse_geocode_dual_language, reverse_geocode_json,
@@ -216,121 +800,222 @@ ReverseGeocoder::reverse_geocode(const Coordinates &coords,
 
 AddressResult ReverseGeocoder::reverse_geocode_dual_language(
     const Coordinates &coords, const std::string &api_name,
-    const std::string &user_lang) const {
-  auto it = configs_.find(api_name);
-  if (it == configs_.end())
-    throw std::runtime_error("Unknown API: " + api_name);
-  const auto &cfg = it->second;
+    const std::string &user_lang, std::stop_token stop) const {
+  const ApiConfig &cfg = config(api_name);
 
-  if (cfg.type == "info" || cfg.type == "information") {
+  if (is_info(cfg)) {
     std::string lang = user_lang.empty() ? "en" : user_lang;
-    return reverse_geocode(coords, api_name, lang);
+    return reverse_geocode(coords, api_name, lang, stop);
   }
+  const TraceSpan span(tracer_, "dual_language", api_name);
   AddressResult result;
-  auto en = reverse_geocode(coords, api_name, "en");
+  auto en = reverse_geocode(coords, api_name, "en", stop);
   result.address_english = en.address_english;
   result.country_code = en.country_code;
 
   // TODO: check
   result.attributes = en.attributes;
 
-  if (!user_lang.empty()) {
-    if (is_valid_language(user_lang)) {
-      auto local = reverse_geocode(coords, api_name, user_lang);
-      result.address_local = local.address_english;
-    } else {
-      result.address_local.clear();
-    }
-    return result;
-  }
-  if (!en.country_code.empty()) {
-    std::string local_lang = language_from_country(en.country_code);
-    auto local = reverse_geocode(coords, api_name, local_lang);
+  if (const std::string lang = local_language(user_lang, en.country_code);
+      !lang.empty()) {
+    auto local = reverse_geocode(coords, api_name, lang, stop);
     result.address_local = local.address_english;
-
-  } else {
-    result.address_local.clear();
   }
   return result;
 }
 
-nlohmann::json
-ReverseGeocoder::reverse_geocode_json(const Coordinates &coords,
-                                      const std::string &api_name,
-                                      const std::string &lang_override) const {
-  auto it = configs_.find(api_name);
-  if (it == configs_.end())
-    throw std::runtime_error("Unknown API: " + api_name);
-  std::string type = it->second.type;
-  AddressResult res =
-      reverse_geocode_dual_language(coords, api_name, lang_override);
+LookupResult
+ReverseGeocoder::lookup(const Coordinates &coords, const std::string &api_name,
+                        const std::string &lang_override,
+                        std::stop_token stop) const {
+  const ApiConfig &cfg = config(api_name);
+  LookupResult result;
+  result.address = reverse_geocode_dual_language(coords, api_name,
+                                                 lang_override, std::move(stop));
+  result.api = api_name;
+  result.type = cfg.type;
+  result.latitude = coords.latitude;
+  result.longitude = coords.longitude;
+  return result;
+}
+
+Task<LookupResult>
+ReverseGeocoder::lookup_async(Coordinates coords, std::string api_name,
+                              std::string lang_override,
+                              std::stop_token stop) const {
+  const ApiConfig &cfg = config(api_name);
+  LookupResult result;
+  result.api = api_name;
+  result.type = cfg.type;
+  result.latitude = coords.latitude;
+  result.longitude = coords.longitude;
+
+  if (is_info(cfg)) {
+    result.address = co_await reverse_geocode_async(
+        coords, api_name, lang_override.empty() ? "en" : lang_override, stop);
+    co_return result;
+  }
+  TraceSpan span(tracer_, "dual_language", api_name);
+  AddressResult en = co_await reverse_geocode_async(coords, api_name, "en", stop);
+  result.address.address_english = std::move(en.address_english);
+  result.address.country_code = en.country_code;
+  result.address.attributes = std::move(en.attributes);
+
+  if (const std::string lang = local_language(lang_override, en.country_code);
+      !lang.empty()) {
+    AddressResult local =
+        co_await reverse_geocode_async(coords, api_name, lang, stop);
+    result.address.address_local = std::move(local.address_english);
+  }
+  co_return result;
+}
+
+nlohmann::json LookupResult::to_json() const {
   nlohmann::json root;
-  root["meta"] = {{"api", api_name},
+  root["meta"] = {{"api", api},
                   {"type", type},
-                  {"latitude", coords.latitude},
-                  {"longitude", coords.longitude}};
-  if (type == "geocoding") {
-    root["result"] = {{"address_english", res.address_english},
-                      {"address_local", res.address_local},
-                      {"country_code", res.country_code}};
+                  {"latitude", latitude},
+                  {"longitude", longitude}};
+  if (is_geocoding()) {
+    root["result"] = {{"address_english", address.address_english},
+                      {"address_local", address.address_local},
+                      {"country_code", address.country_code}};
 
-    root["result"]["details"] = res.attributes;
+    root["result"]["details"] = address.attributes;
 
   } else {
-    root["result"] = {{"title", res.address_english},
-                      {"summary", res.address_local},
-                      {"country_code", res.country_code},
-                      {"data", res.attributes}};
+    root["result"] = {{"title", address.address_english},
+                      {"summary", address.address_local},
+                      {"country_code", address.country_code},
+                      {"data", address.attributes}};
   }
   return root;
 }
 
+nlohmann::json
+ReverseGeocoder::reverse_geocode_json(const Coordinates &coords,
+                                      const std::string &api_name,
+                                      const std::string &lang_override,
+                                      std::stop_token stop) const {
+  return lookup(coords, api_name, lang_override, std::move(stop)).to_json();
+}
+
 nlohmann::json ReverseGeocoder::reverse_geocode_fallback(
     const Coordinates &coords, const std::vector<std::string> &priority_list,
-    const std::string &lang_override) const {
+    const std::string &lang_override, std::stop_token stop) const {
   nlohmann::json last_error;
+  std::size_t depth = 0;
   for (const auto &api_name : priority_list) {
-    std::string clean_name = api_name;
-    clean_name.erase(0, clean_name.find_first_not_of(' '));
-    clean_name.erase(clean_name.find_last_not_of(' ') + 1);
+    const std::string clean_name = trim_api_name(api_name);
     if (clean_name.empty())
       continue;
+    ++depth;
+    TraceSpan span(tracer_, "fallback", clean_name);
+    if (span.active())
+      span.detail("depth=" + std::to_string(depth));
     try {
-      return reverse_geocode_json(coords, clean_name, lang_override);
+      auto json =
+          reverse_geocode_json(coords, clean_name, lang_override, stop);
+      metrics_.record_fallback(depth);
+      return json;
+    } catch (const LookupCancelled &) {
+      throw; // a cancelled lookup does not move on to the next provider
     } catch (const std::exception &e) {
-      std::cerr << "[Warning] API '" << clean_name << "' failed: " << e.what()
-                << ". Trying next provider...\n";
-      last_error = {{"error", "Provider failed"},
-                    {"provider", clean_name},
-                    {"details", e.what()}};
+      last_error = provider_failed(clean_name, e);
       continue;
     }
   }
-  nlohmann::json error_json;
-  error_json["error"] = "All providers failed";
-  error_json["last_attempt"] = last_error;
-  return error_json;
+  metrics_.record_fallback(0);
+  return all_failed(std::move(last_error));
+}
+
+Task<nlohmann::json> ReverseGeocoder::reverse_geocode_fallback_async(
+    Coordinates coords, std::vector<std::string> priority_list,
+    std::string lang_override, std::stop_token stop) const {
+  nlohmann::json last_error;
+  std::size_t depth = 0;
+  for (const auto &api_name : priority_list) {
+    const std::string clean_name = trim_api_name(api_name);
+    if (clean_name.empty())
+      continue;
+    ++depth;
+    TraceSpan span(tracer_, "fallback", clean_name);
+    if (span.active())
+      span.detail("depth=" + std::to_string(depth));
+    // A cancelled lookup does not move on to the next provider
+    std::optional<LookupResult> result;
+    try {
+      result = co_await lookup_async(coords, clean_name, lang_override, stop);
+    } catch (const LookupCancelled &) {
+      throw;
+    } catch (const std::exception &e) {
+      last_error = provider_failed(clean_name, e);
+      continue;
+    }
+    metrics_.record_fallback(depth);
+    co_return result->to_json();
+  }
+  metrics_.record_fallback(0);
+  co_return all_failed(std::move(last_error));
 }
 
 std::vector<nlohmann::json> ReverseGeocoder::batch_reverse_geocode(
     const std::vector<Coordinates> &coords_list,
     const std::vector<std::string> &priority_list,
-    const std::string &lang_override) const {
-  std::vector<std::future<nlohmann::json>> futures;
-  futures.reserve(coords_list.size());
-  for (const auto &coord : coords_list) {
-    futures.push_back(std::async(std::launch::async,
-                                 [this, coord, priority_list, lang_override]() {
-                                   return this->reverse_geocode_fallback(
-                                       coord, priority_list, lang_override);
-                                 }));
+    const std::string &lang_override, std::stop_token stop,
+    const BatchOptions &options, BatchReport *report) const {
+  // On an engine every point waits as a coroutine, through its transfers
+  // and its retry back-offs alike; threads would sleep through the latter
+  if (http_client_->asynchronous())
+    return sync_wait(batch_reverse_geocode_async(
+        coords_list, priority_list, lang_override, stop, options, report));
+
+  const BatchPlan plan(coords_list, options);
+  if (report)
+    *report = plan.report();
+
+  const std::vector<Coordinates> &unique = plan.unique();
+  std::vector<nlohmann::json> results(unique.size());
+  // One thread per unique point, or per cell when grouped
+  auto run = [&](std::size_t begin, std::size_t end) {
+    for (std::size_t i = begin; i < end; ++i)
+      results[i] =
+          reverse_geocode_fallback(unique[i], priority_list, lang_override, stop);
+  };
+  const std::vector<std::size_t> &starts = plan.group_starts();
+  std::vector<std::future<void>> futures;
+  if (options.cell_m > 0.0) {
+    futures.reserve(starts.size() - 1);
+    for (std::size_t g = 0; g + 1 < starts.size(); ++g)
+      futures.push_back(
+          std::async(std::launch::async, run, starts[g], starts[g + 1]));
+  } else {
+    futures.reserve(unique.size());
+    for (std::size_t i = 0; i < unique.size(); ++i)
+      futures.push_back(std::async(std::launch::async, run, i, i + 1));
   }
-  std::vector<nlohmann::json> results;
-  results.reserve(coords_list.size());
   for (auto &f : futures) {
-    results.push_back(f.get());
+    f.get();
   }
-  return results;
+  return fan_out_batch(plan, std::move(results), coords_list);
+}
+
+Task<std::vector<nlohmann::json>> ReverseGeocoder::batch_reverse_geocode_async(
+    std::vector<Coordinates> coords_list,
+    std::vector<std::string> priority_list, std::string lang_override,
+    std::stop_token stop, BatchOptions options, BatchReport *report) const {
+  const BatchPlan plan(coords_list, options);
+  if (report)
+    *report = plan.report();
+
+  // One coroutine frame per unique point; all of them wait on the engine
+  std::vector<Task<nlohmann::json>> lookups;
+  lookups.reserve(plan.unique().size());
+  for (const Coordinates &coords : plan.unique())
+    lookups.push_back(reverse_geocode_fallback_async(coords, priority_list,
+                                                     lang_override, stop));
+  std::vector<nlohmann::json> results = co_await when_all(std::move(lookups));
+  co_return fan_out_batch(plan, std::move(results), coords_list);
 }
 
 } // namespace regeocode
\ No newline at end of file
@@ -0,0 +1,354 @@
+/**
+ * SPDX-FileComment: Implementation of the record/replay HTTP clients.
+ * SPDX-FileType: SOURCE
+ * SPDX-FileContributor: ZHENG Robert
+ * SPDX-FileCopyrightText: 2026 ZHENG Robert
+ * SPDX-License-Identifier: MIT
+ *
+ * @file replay_http_client.cpp
+ * @brief Replay file format, ReplayHttpClient and RecordingHttpClient.
+ * @version 0.1.0
+ * @date 2026-10-19
+ *
+ * @author ZHENG Robert
+ * @license MIT License
+ */
+
+#include "regeocode/replay_http_client.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+
+namespace regeocode {
+
+namespace {
+constexpr std::string_view kMagic = "RGREPLY1";
+
+/// Headers written after the key and body, in file order.
+constexpr std::string Recording::*kHeaders[] = {
+    &Recording::retry_after,   &Recording::etag,    &Recording::last_modified,
+    &Recording::cache_control, &Recording::expires, &Recording::age};
+constexpr std::string HttpResponse::*kResponseHeaders[] = {
+    &HttpResponse::retry_after,   &HttpResponse::etag,
+    &HttpResponse::last_modified, &HttpResponse::cache_control,
+    &HttpResponse::expires,       &HttpResponse::age};
+
+std::uint64_t fnv1a(std::string_view s) {
+  std::uint64_t h = 14695981039346656037ull;
+  for (const char c : s) {
+    h ^= static_cast<unsigned char>(c);
+    h *= 1099511628211ull;
+  }
+  return h;
+}
+
+std::uint64_t splitmix64(std::uint64_t x) {
+  x += 0x9e3779b97f4a7c15ull;
+  x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ull;
+  x = (x ^ (x >> 27)) * 0x94d049bb133111ebull;
+  return x ^ (x >> 31);
+}
+
+void put_u32(std::string &out, std::uint32_t v) {
+  for (int i = 0; i < 4; ++i)
+    out.push_back(static_cast<char>((v >> (8 * i)) & 0xff));
+}
+
+void put_u64(std::string &out, std::uint64_t v) {
+  for (int i = 0; i < 8; ++i)
+    out.push_back(static_cast<char>((v >> (8 * i)) & 0xff));
+}
+
+void put_string(std::string &out, std::string_view s) {
+  put_u32(out, static_cast<std::uint32_t>(s.size()));
+  out.append(s);
+}
+
+/**
+ * @brief Bounds-checked little-endian reader over the file contents.
+ */
+class Reader {
+public:
+  Reader(std::string_view data, std::uint64_t pos) : data_(data), pos_(pos) {}
+
+  std::uint64_t u64() { return number(8); }
+  std::uint32_t u32() { return static_cast<std::uint32_t>(number(4)); }
+  std::string_view string() {
+    const std::uint32_t n = u32();
+    need(n);
+    const std::string_view s = data_.substr(pos_, n);
+    pos_ += n;
+    return s;
+  }
+
+private:
+  void need(std::uint64_t n) const {
+    if (pos_ > data_.size() || data_.size() - pos_ < n)
+      throw std::runtime_error("Truncated replay file");
+  }
+  std::uint64_t number(int bytes) {
+    need(static_cast<std::uint64_t>(bytes));
+    std::uint64_t v = 0;
+    for (int i = 0; i < bytes; ++i)
+      v |= static_cast<std::uint64_t>(
+               static_cast<unsigned char>(data_[pos_ + i]))
+           << (8 * i);
+    pos_ += static_cast<std::uint64_t>(bytes);
+    return v;
+  }
+
+  std::string_view data_;
+  std::uint64_t pos_;
+};
+
+/// "{{ apikey }}", with any blanks inside the braces.
+bool is_apikey_placeholder(std::string_view value) {
+  if (!value.starts_with("{{") || !value.ends_with("}}") || value.size() < 4)
+    return false;
+  value = value.substr(2, value.size() - 4);
+  value.remove_prefix(std::min(value.find_first_not_of(' '), value.size()));
+  value = value.substr(0, value.find_last_not_of(' ') + 1);
+  return value == "apikey";
+}
+} // namespace
+
+std::vector<std::string>
+credential_params(const std::vector<std::string> &uri_templates,
+                  std::vector<std::string> ignored) {
+  for (const std::string_view uri : uri_templates) {
+    const auto question = uri.find('?');
+    if (question == std::string_view::npos)
+      continue;
+    std::string_view rest = uri.substr(question + 1);
+    while (!rest.empty()) {
+      const auto amp = rest.find('&');
+      const std::string_view param = rest.substr(0, amp);
+      rest = amp == std::string_view::npos ? std::string_view{}
+                                           : rest.substr(amp + 1);
+      const auto eq = param.find('=');
+      if (eq == std::string_view::npos ||
+          !is_apikey_placeholder(param.substr(eq + 1)))
+        continue;
+      const std::string_view name = param.substr(0, eq);
+      if (std::find(ignored.begin(), ignored.end(), name) == ignored.end())
+        ignored.emplace_back(name);
+    }
+  }
+  return ignored;
+}
+
+std::string replay_key(std::string_view url,
+                       const std::vector<std::string> &ignored) {
+  const auto question = url.find('?');
+  if (question == std::string_view::npos || ignored.empty())
+    return std::string(url);
+
+  std::string key(url.substr(0, question + 1));
+  std::string_view rest = url.substr(question + 1);
+  bool first = true;
+  while (!rest.empty()) {
+    const auto amp = rest.find('&');
+    const std::string_view param = rest.substr(0, amp);
+    rest = amp == std::string_view::npos ? std::string_view{}
+                                         : rest.substr(amp + 1);
+    const std::string_view name = param.substr(0, param.find('='));
+    if (std::find(ignored.begin(), ignored.end(), name) != ignored.end())
+      continue;
+    if (!first)
+      key += '&';
+    key += param;
+    first = false;
+  }
+  if (first)
+    key.pop_back(); // nothing left after '?'
+  return key;
+}
+
+void write_replay_file(const std::string &path,
+                       const std::vector<Recording> &recordings) {
+  std::string out(kMagic);
+  std::vector<std::pair<std::uint64_t, std::uint64_t>> index;
+  index.reserve(recordings.size());
+  for (const Recording &r : recordings) {
+    index.emplace_back(fnv1a(r.key), out.size());
+    put_u32(out, static_cast<std::uint32_t>(r.status_code));
+    put_u64(out, r.wire_bytes);
+    put_string(out, r.key);
+    put_string(out, r.body);
+    for (const auto header : kHeaders)
+      put_string(out, r.*header);
+  }
+  // Sorted by hash, recording order within a key
+  std::stable_sort(index.begin(), index.end(),
+                   [](const auto &a, const auto &b) { return a.first < b.first; });
+  const std::uint64_t index_offset = out.size();
+  put_u64(out, index.size());
+  for (const auto &[hash, offset] : index) {
+    put_u64(out, hash);
+    put_u64(out, offset);
+  }
+  put_u64(out, index_offset);
+
+  std::ofstream f(path, std::ios::binary | std::ios::trunc);
+  if (!f.write(out.data(), static_cast<std::streamsize>(out.size())))
+    throw std::runtime_error("Cannot write replay file: " + path);
+}
+
+// -------------------------
+// ReplayHttpClient
+// -------------------------
+
+ReplayHttpClient::ReplayHttpClient(const std::string &path,
+                                   ReplayOptions options)
+    : options_(std::move(options)) {
+  std::ifstream f(path, std::ios::binary);
+  if (!f.is_open())
+    throw std::runtime_error("Replay file not found: " + path);
+  data_.assign(std::istreambuf_iterator<char>(f),
+               std::istreambuf_iterator<char>());
+  if (data_.size() < kMagic.size() + 16 || !data_.starts_with(kMagic))
+    throw std::runtime_error("Not a replay file: " + path);
+
+  const std::uint64_t index_offset = Reader(data_, data_.size() - 8).u64();
+  Reader index(data_, index_offset);
+  const std::uint64_t count = index.u64();
+  if (count > data_.size() / 16)
+    throw std::runtime_error("Corrupt replay index: " + path);
+  index_.reserve(count);
+  for (std::uint64_t i = 0; i < count; ++i) {
+    const std::uint64_t hash = index.u64();
+    const std::uint64_t offset = index.u64();
+    if (offset >= index_offset)
+      throw std::runtime_error("Corrupt replay index: " + path);
+    index_.push_back({hash, offset});
+  }
+}
+
+HttpResponse ReplayHttpClient::decode(std::uint64_t offset) const {
+  Reader in(data_, offset);
+  HttpResponse response;
+  response.status_code = static_cast<std::int32_t>(in.u32());
+  response.wire_bytes = in.u64();
+  (void)in.string(); // key
+  response.body.assign(in.string());
+  for (const auto header : kResponseHeaders)
+    response.*header = in.string();
+  return response;
+}
+
+double ReplayHttpClient::unit(std::uint64_t request,
+                              std::uint64_t draw) const {
+  return static_cast<double>(
+             splitmix64(options_.seed ^ (request * 2 + draw)) >> 11) *
+         0x1.0p-53;
+}
+
+HttpResponse ReplayHttpClient::get(const std::string &url, long /*timeout*/,
+                                   const HttpRequestOptions &options) const {
+  const std::uint64_t request =
+      served_.fetch_add(1, std::memory_order_relaxed);
+  const double fault = unit(request, 0);
+  const double jitter = unit(request, 1);
+  const auto latency =
+      options_.latency +
+      std::chrono::microseconds(static_cast<long long>(
+          static_cast<double>(options_.latency_jitter.count()) * jitter));
+  if (latency.count() > 0)
+    std::this_thread::sleep_for(latency);
+
+  if (fault < options_.error_rate) {
+    HttpResponse response;
+    response.status_code = options_.error_status;
+    response.retry_after = options_.error_retry_after;
+    return response;
+  }
+
+  const std::string key = replay_key(url, options_.ignored_params);
+  const std::uint64_t hash = fnv1a(key);
+  auto range = std::equal_range(
+      index_.begin(), index_.end(), IndexEntry{hash, 0},
+      [](const IndexEntry &a, const IndexEntry &b) { return a.hash < b.hash; });
+
+  // Recordings of this key, in order (other keys may share the hash)
+  std::vector<std::uint64_t> offsets;
+  for (auto it = range.first; it != range.second; ++it) {
+    Reader in(data_, it->offset + 12);
+    if (in.string() == key)
+      offsets.push_back(it->offset);
+  }
+  if (offsets.empty()) {
+    HttpResponse response;
+    response.status_code = options_.missing_status;
+    response.body.assign("No recording for " + key);
+    return response;
+  }
+
+  std::size_t turn = 0;
+  if (offsets.size() > 1) {
+    std::lock_guard lock(cursor_mutex_);
+    std::size_t &cursor = cursors_[key];
+    turn = std::min(cursor, offsets.size() - 1);
+    ++cursor;
+  }
+  HttpResponse response = decode(offsets[turn]);
+  if (!options.if_none_match.empty() && response.status_code == 200 &&
+      options.if_none_match == response.etag) {
+    response.status_code = 304;
+    response.body.clear();
+    response.wire_bytes = 0;
+  }
+  return response;
+}
+
+// -------------------------
+// RecordingHttpClient
+// -------------------------
+
+RecordingHttpClient::RecordingHttpClient(
+    std::unique_ptr<HttpClient> inner, std::vector<std::string> ignored_params)
+    : inner_(std::move(inner)), ignored_params_(std::move(ignored_params)) {}
+
+HttpResponse RecordingHttpClient::get(const std::string &url, long timeout,
+                                      const HttpRequestOptions &options) const {
+  HttpResponse response = inner_->get(url, timeout, options);
+  if (response.status_code == 304)
+    return response; // a revalidation, the body was recorded before
+
+  Recording r;
+  r.key = replay_key(url, ignored_params_);
+  r.status_code = response.status_code;
+  r.wire_bytes = response.wire_bytes;
+  r.body.assign(response.body);
+  r.retry_after = response.retry_after;
+  r.etag = response.etag;
+  r.last_modified = response.last_modified;
+  r.cache_control = response.cache_control;
+  r.expires = response.expires;
+  r.age = response.age;
+
+  std::lock_guard lock(mutex_);
+  if (const auto it = last_.find(r.key); it != last_.end()) {
+    const Recording &previous = recordings_[it->second];
+    if (previous.status_code == r.status_code && previous.body == r.body)
+      return response;
+  }
+  last_[r.key] = recordings_.size();
+  recordings_.push_back(std::move(r));
+  return response;
+}
+
+void RecordingHttpClient::save(const std::string &path) const {
+  std::lock_guard lock(mutex_);
+  write_replay_file(path, recordings_);
+}
+
+std::size_t RecordingHttpClient::size() const {
+  std::lock_guard lock(mutex_);
+  return recordings_.size();
+}
+
+} // namespace regeocode
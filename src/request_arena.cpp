@@ -0,0 +1,100 @@
+/**
+ * SPDX-FileComment: Implementation of the request-scoped memory arena.
+ * SPDX-FileType: SOURCE
+ * SPDX-FileContributor: ZHENG Robert
+ * SPDX-FileCopyrightText: 2026 ZHENG Robert
+ * SPDX-License-Identifier: MIT
+ *
+ * @file request_arena.cpp
+ * @brief Per-thread pooled std::pmr arena for the duration of one request.
+ * @version 0.1.0
+ * @date 2026-10-19
+ *
+ * @author ZHENG Robert
+ * @license MIT License
+ */
+
+#include "regeocode/request_arena.hpp"
+
+#include <algorithm>
+#include <memory>
+#include <optional>
+
+namespace regeocode {
+
+namespace {
+/**
+ * @brief Heap upstream that records how much the arena had to borrow.
+ */
+class CountingResource : public std::pmr::memory_resource {
+public:
+  std::size_t allocated = 0;
+
+private:
+  void *do_allocate(std::size_t bytes, std::size_t alignment) override {
+    allocated += bytes;
+    return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+  }
+  void do_deallocate(void *p, std::size_t bytes,
+                     std::size_t alignment) override {
+    std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+  }
+  bool do_is_equal(const std::pmr::memory_resource &other)
+      const noexcept override {
+    return this == &other;
+  }
+};
+
+struct ThreadPool {
+  std::unique_ptr<std::byte[]> buffer;
+  std::size_t size = 0;
+  std::size_t wanted = RequestArena::kInitialPoolBytes;
+  CountingResource upstream;
+  std::optional<std::pmr::monotonic_buffer_resource> arena;
+  std::size_t depth = 0;
+};
+
+ThreadPool &thread_pool() noexcept {
+  thread_local ThreadPool pool;
+  return pool;
+}
+} // namespace
+
+std::pmr::memory_resource *request_resource() noexcept {
+  ThreadPool &pool = thread_pool();
+  if (pool.depth == 0)
+    return std::pmr::get_default_resource();
+  return &*pool.arena;
+}
+
+RequestArena::RequestArena() : outermost_(thread_pool().depth == 0) {
+  ThreadPool &pool = thread_pool();
+  if (outermost_) {
+    if (pool.size < pool.wanted) {
+      pool.buffer = std::make_unique_for_overwrite<std::byte[]>(pool.wanted);
+      pool.size = pool.wanted;
+    }
+    pool.upstream.allocated = 0;
+    pool.arena.emplace(pool.buffer.get(), pool.size, &pool.upstream);
+  }
+  ++pool.depth;
+}
+
+RequestArena::~RequestArena() {
+  ThreadPool &pool = thread_pool();
+  --pool.depth;
+  if (!outermost_)
+    return;
+  pool.arena.reset(); // releases the overflow blocks
+  if (pool.upstream.allocated != 0)
+    pool.wanted =
+        std::min(pool.size + pool.upstream.allocated, kMaxPoolBytes);
+}
+
+std::pmr::memory_resource *RequestArena::resource() const noexcept {
+  return &*thread_pool().arena;
+}
+
+std::size_t RequestArena::pool_size() noexcept { return thread_pool().size; }
+
+} // namespace regeocode
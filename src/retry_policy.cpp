@@ -0,0 +1,135 @@
+/**
+ * SPDX-FileComment: Implementation of the per-API retry policy.
+ * SPDX-FileType: SOURCE
+ * SPDX-FileContributor: ZHENG Robert
+ * SPDX-FileCopyrightText: 2026 ZHENG Robert
+ * SPDX-License-Identifier: MIT
+ *
+ * @file retry_policy.cpp
+ * @brief Backoff computation, Retry-After parsing and the retry budget.
+ * @version 0.1.0
+ * @date 2026-10-19
+ *
+ * @author ZHENG Robert
+ * @license MIT License
+ */
+
+#include "regeocode/retry_policy.hpp"
+#include "regeocode/http_client.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <random>
+
+namespace regeocode {
+
+namespace {
+/// Uniform value in [0, 1) from a per-thread generator.
+double unit_random() {
+  thread_local std::minstd_rand engine{std::random_device{}()};
+  return std::uniform_real_distribution<double>(0.0, 1.0)(engine);
+}
+} // namespace
+
+bool RetryPolicy::retryable(long status_code) const {
+  return std::find(retry_on.begin(), retry_on.end(), status_code) !=
+         retry_on.end();
+}
+
+// -------------------------
+// RetryBudget
+// -------------------------
+
+RetryBudget::RetryBudget(double ratio, unsigned min_retries)
+    : deposit_(static_cast<std::int64_t>(std::max(0.0, ratio) * kUnit)),
+      cap_(std::max<std::int64_t>(min_retries, 1) * kUnit),
+      balance_(static_cast<std::int64_t>(min_retries) * kUnit) {}
+
+void RetryBudget::record_request() {
+  std::int64_t current = balance_.load(std::memory_order_relaxed);
+  while (current < cap_ &&
+         !balance_.compare_exchange_weak(current,
+                                         std::min(cap_, current + deposit_),
+                                         std::memory_order_relaxed)) {
+  }
+}
+
+bool RetryBudget::try_spend() {
+  std::int64_t current = balance_.load(std::memory_order_relaxed);
+  while (current >= kUnit) {
+    if (balance_.compare_exchange_weak(current, current - kUnit,
+                                       std::memory_order_relaxed))
+      return true;
+  }
+  return false;
+}
+
+std::int64_t RetryBudget::available() const {
+  return balance_.load(std::memory_order_relaxed) / kUnit;
+}
+
+// -------------------------
+// Backoff
+// -------------------------
+
+std::chrono::milliseconds backoff_delay(const RetryPolicy &policy, int retry,
+                                        double unit_random) {
+  const double base = static_cast<double>(policy.base_delay.count());
+  const double ceiling = static_cast<double>(policy.max_delay.count());
+  // 2^(retry-1) without overflowing for large retry counts
+  const double backoff =
+      std::min(ceiling, std::ldexp(base, std::clamp(retry - 1, 0, 62)));
+  const double jitter = std::clamp(policy.jitter, 0.0, 1.0);
+  return std::chrono::milliseconds(
+      static_cast<long long>(backoff * (1.0 - jitter * unit_random)));
+}
+
+std::optional<std::chrono::milliseconds>
+parse_retry_after(std::string_view value,
+                  std::chrono::system_clock::time_point now) {
+  constexpr std::string_view kWs = " \t\r\n";
+  const auto first = value.find_first_not_of(kWs);
+  if (first == std::string_view::npos)
+    return std::nullopt;
+  value = value.substr(first, value.find_last_not_of(kWs) - first + 1);
+
+  long long seconds = 0;
+  const auto [ptr, ec] =
+      std::from_chars(value.data(), value.data() + value.size(), seconds);
+  if (ec == std::errc() && ptr == value.data() + value.size())
+    return seconds < 0 ? std::nullopt
+                       : std::optional(std::chrono::milliseconds(
+                             std::min<long long>(seconds, 1LL << 31) * 1000));
+
+  const auto date = parse_http_date(value);
+  if (!date)
+    return std::nullopt;
+  if (*date <= now)
+    return std::chrono::milliseconds(0);
+  return std::chrono::ceil<std::chrono::milliseconds>(*date - now);
+}
+
+std::optional<std::chrono::milliseconds>
+retry_delay(const RetryPolicy &policy, int attempt, long status_code,
+            std::string_view retry_after, RetryBudget &budget) {
+  if (attempt >= policy.max_attempts || !policy.retryable(status_code))
+    return std::nullopt;
+
+  std::chrono::milliseconds delay = backoff_delay(policy, attempt,
+                                                  unit_random());
+  if (policy.honour_retry_after && !retry_after.empty()) {
+    if (const auto asked = parse_retry_after(retry_after)) {
+      // The provider knows when it recovers; waiting less only burns quota
+      if (*asked > policy.max_retry_after)
+        return std::nullopt;
+      delay = std::max(delay, *asked);
+    }
+  }
+
+  if (!budget.try_spend())
+    return std::nullopt;
+  return delay;
+}
+
+} // namespace regeocode
@@ -0,0 +1,172 @@
+/**
+ * SPDX-FileComment: Implementation of lookup tracing.
+ * SPDX-FileType: SOURCE
+ * SPDX-FileContributor: ZHENG Robert
+ * SPDX-FileCopyrightText: 2026 ZHENG Robert
+ * SPDX-License-Identifier: MIT
+ *
+ * @file tracing.cpp
+ * @brief Tracer, spans and the Chrome trace-event sink.
+ * @version 0.1.0
+ * @date 2026-10-19
+ *
+ * @author ZHENG Robert
+ * @license MIT License
+ */
+
+#include "regeocode/tracing.hpp"
+
+#include <cstdio>
+#include <fstream>
+#include <stdexcept>
+
+namespace regeocode {
+
+namespace {
+void append_json_string(std::string &out, std::string_view s) {
+  out += '"';
+  for (const char c : s) {
+    switch (c) {
+    case '"':
+      out += "\\\"";
+      break;
+    case '\\':
+      out += "\\\\";
+      break;
+    case '\n':
+      out += "\\n";
+      break;
+    default:
+      if (static_cast<unsigned char>(c) < 0x20) {
+        char buf[8];
+        std::snprintf(buf, sizeof(buf), "\\u%04x", c);
+        out += buf;
+      } else {
+        out += c;
+      }
+    }
+  }
+  out += '"';
+}
+
+std::chrono::microseconds
+since_origin(std::chrono::steady_clock::time_point t) {
+  return std::chrono::duration_cast<std::chrono::microseconds>(
+      t - trace_clock_origin());
+}
+} // namespace
+
+std::chrono::steady_clock::time_point trace_clock_origin() noexcept {
+  static const auto origin = std::chrono::steady_clock::now();
+  return origin;
+}
+
+std::uint32_t trace_thread_id() noexcept {
+  static std::atomic<std::uint32_t> next{1};
+  thread_local const std::uint32_t id =
+      next.fetch_add(1, std::memory_order_relaxed);
+  return id;
+}
+
+// -------------------------
+// Tracer
+// -------------------------
+
+void Tracer::set_sink(std::shared_ptr<TraceSink> sink) {
+  std::lock_guard lock(mutex_);
+  enabled_.store(sink != nullptr, std::memory_order_relaxed);
+  sink_ = std::move(sink);
+}
+
+std::shared_ptr<TraceSink> Tracer::sink() const {
+  std::lock_guard lock(mutex_);
+  return sink_;
+}
+
+#if REGEOCODE_TRACING
+void TraceSpan::end() {
+  if (!sink_)
+    return;
+  const auto now = std::chrono::steady_clock::now();
+  SpanRecord span;
+  span.name = name_;
+  span.api = api_;
+  span.detail = detail_;
+  span.start = since_origin(start_);
+  span.duration =
+      std::chrono::duration_cast<std::chrono::microseconds>(now - start_);
+  span.thread = trace_thread_id();
+  sink_->record(span);
+  sink_.reset();
+}
+#endif
+
+void trace_span(const Tracer &tracer, std::string_view name,
+                std::string_view api,
+                std::chrono::steady_clock::time_point start,
+                std::chrono::microseconds duration, std::string_view detail) {
+  if (!tracer.enabled())
+    return;
+  const auto sink = tracer.sink();
+  if (!sink)
+    return;
+  SpanRecord span;
+  span.name = name;
+  span.api = api;
+  span.detail = detail;
+  span.start = since_origin(start);
+  span.duration = duration;
+  span.thread = trace_thread_id();
+  sink->record(span);
+}
+
+// -------------------------
+// ChromeTraceSink
+// -------------------------
+
+ChromeTraceSink::ChromeTraceSink(std::string path) : path_(std::move(path)) {}
+
+ChromeTraceSink::~ChromeTraceSink() {
+  try {
+    flush();
+  } catch (const std::exception &) {
+    // Nothing sensible to do with a failed write during destruction
+  }
+}
+
+void ChromeTraceSink::record(const SpanRecord &span) {
+  std::string event = "{\"name\":";
+  append_json_string(event, span.name);
+  event += ",\"cat\":\"regeocode\",\"ph\":\"X\",\"ts\":" +
+           std::to_string(span.start.count()) +
+           ",\"dur\":" + std::to_string(span.duration.count()) +
+           ",\"pid\":1,\"tid\":" + std::to_string(span.thread) +
+           ",\"args\":{\"api\":";
+  append_json_string(event, span.api);
+  if (!span.detail.empty()) {
+    event += ",\"detail\":";
+    append_json_string(event, span.detail);
+  }
+  event += "}}";
+
+  std::lock_guard lock(mutex_);
+  events_.push_back(std::move(event));
+}
+
+void ChromeTraceSink::flush() {
+  std::lock_guard lock(mutex_);
+  std::ofstream f(path_, std::ios::trunc);
+  f << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+  for (std::size_t i = 0; i < events_.size(); ++i)
+    f << (i == 0 ? "\n" : ",\n") << events_[i];
+  f << "\n]}\n";
+  if (!f)
+    throw std::runtime_error("Cannot write trace file: " + path_);
+}
+
+std::size_t ChromeTraceSink::size() const {
+  std::lock_guard lock(mutex_);
+  return events_.size();
+}
+
+} // namespace regeocode
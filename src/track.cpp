@@ -0,0 +1,341 @@
+/**
+ * SPDX-FileComment: Implementation of track geocoding.
+ * SPDX-FileType: SOURCE
+ * SPDX-FileContributor: ZHENG Robert
+ * SPDX-FileCopyrightText: 2026 ZHENG Robert
+ * SPDX-License-Identifier: MIT
+ *
+ * @file track.cpp
+ * @brief GPX and NMEA readers and adaptive track geocoding.
+ * @version 0.1.0
+ * @date 2026-10-19
+ *
+ * @author ZHENG Robert
+ * @license MIT License
+ */
+
+#include "regeocode/track.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <fstream>
+#include <iterator>
+#include <optional>
+#include <stdexcept>
+#include <utility>
+
+namespace regeocode {
+
+namespace {
+constexpr double kEarthRadiusM = 6371008.8;
+constexpr double kPi = 3.14159265358979323846;
+
+/// Great-circle distance in metres.
+double distance_m(const Coordinates &a, const Coordinates &b) {
+  constexpr double rad = kPi / 180.0;
+  const double dlat = (b.latitude - a.latitude) * rad;
+  const double dlon = (b.longitude - a.longitude) * rad;
+  const double h = std::sin(dlat / 2) * std::sin(dlat / 2) +
+                   std::cos(a.latitude * rad) * std::cos(b.latitude * rad) *
+                       std::sin(dlon / 2) * std::sin(dlon / 2);
+  return 2 * kEarthRadiusM * std::asin(std::min(1.0, std::sqrt(h)));
+}
+
+std::optional<double> to_double(std::string_view s) {
+  double v = 0.0;
+  const auto [ptr, ec] = std::from_chars(s.data(), s.data() + s.size(), v);
+  if (ec != std::errc() || ptr != s.data() + s.size())
+    return std::nullopt;
+  return v;
+}
+
+bool is_space(char c) {
+  return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+}
+
+/// Value of attribute @p name in the start tag @p tag.
+std::optional<double> attribute(std::string_view tag, std::string_view name) {
+  for (std::size_t pos = tag.find(name); pos != std::string_view::npos;
+       pos = tag.find(name, pos + 1)) {
+    if (pos == 0 || !is_space(tag[pos - 1]))
+      continue;
+    std::size_t i = pos + name.size();
+    while (i < tag.size() && is_space(tag[i]))
+      ++i;
+    if (i >= tag.size() || tag[i] != '=')
+      continue;
+    ++i;
+    while (i < tag.size() && is_space(tag[i]))
+      ++i;
+    if (i >= tag.size() || (tag[i] != '"' && tag[i] != '\''))
+      return std::nullopt;
+    const std::size_t end = tag.find(tag[i], i + 1);
+    if (end == std::string_view::npos)
+      return std::nullopt;
+    return to_double(tag.substr(i + 1, end - i - 1));
+  }
+  return std::nullopt;
+}
+
+/// ddmm.mmmm / dddmm.mmmm with hemisphere to signed degrees.
+std::optional<double> nmea_angle(std::string_view value,
+                                 std::string_view hemisphere) {
+  const auto raw = to_double(value);
+  if (!raw || hemisphere.size() != 1)
+    return std::nullopt;
+  const double degrees = std::trunc(*raw / 100.0);
+  const double angle = degrees + (*raw - degrees * 100.0) / 60.0;
+  switch (hemisphere[0]) {
+  case 'N':
+  case 'E':
+    return angle;
+  case 'S':
+  case 'W':
+    return -angle;
+  default:
+    return std::nullopt;
+  }
+}
+
+bool checksum_ok(std::string_view body, std::string_view sum) {
+  unsigned expected = 0;
+  const auto [ptr, ec] =
+      std::from_chars(sum.data(), sum.data() + sum.size(), expected, 16);
+  if (sum.size() != 2 || ec != std::errc() || ptr != sum.data() + sum.size())
+    return false;
+  unsigned actual = 0;
+  for (const char c : body)
+    actual ^= static_cast<unsigned char>(c);
+  return actual == expected;
+}
+
+/// Fix of one RMC or GGA sentence (without '$' and checksum).
+std::optional<Coordinates> nmea_fix(std::string_view body) {
+  std::vector<std::string_view> fields;
+  for (std::size_t start = 0;;) {
+    const std::size_t comma = body.find(',', start);
+    fields.push_back(body.substr(start, comma - start));
+    if (comma == std::string_view::npos)
+      break;
+    start = comma + 1;
+  }
+  if (fields[0].size() < 5)
+    return std::nullopt;
+  const std::string_view type = fields[0].substr(fields[0].size() - 3);
+  std::size_t at = 0; // index of the latitude field
+  if (type == "RMC" && fields.size() > 6 && fields[2] == "A")
+    at = 3;
+  else if (type == "GGA" && fields.size() > 6 && !fields[6].empty() &&
+           fields[6] != "0")
+    at = 2;
+  else
+    return std::nullopt;
+  const auto lat = nmea_angle(fields[at], fields[at + 1]);
+  const auto lon = nmea_angle(fields[at + 2], fields[at + 3]);
+  if (!lat || !lon)
+    return std::nullopt;
+  return Coordinates{*lat, *lon, ""};
+}
+
+/// What has to differ for two points to lie in different segments.
+std::string label_of(const nlohmann::json &r,
+                     const std::vector<std::string> &keys) {
+  if (r.contains("error"))
+    return "\x01error";
+  const auto result = r.find("result");
+  if (result == r.end())
+    return {};
+  std::string label = result->value("country_code", "");
+  auto details = result->find("details");
+  if (details == result->end())
+    details = result->find("data");
+  for (const std::string &key : keys) {
+    label += '\x1f';
+    if (details == result->end() || !details->is_object())
+      continue;
+    const auto value = details->find(key);
+    if (value != details->end() && value->is_string())
+      label += value->get_ref<const std::string &>();
+  }
+  return label;
+}
+} // namespace
+
+const TrackSegment &TrackResult::segment_of(std::size_t i) const {
+  if (i >= points)
+    throw std::out_of_range("Track point out of range");
+  const auto next = std::upper_bound(
+      segments.begin(), segments.end(), i,
+      [](std::size_t v, const TrackSegment &s) { return v < s.first; });
+  return *std::prev(next);
+}
+
+nlohmann::json TrackResult::to_json() const {
+  nlohmann::json out = {{"points", points},
+                        {"lookups", lookups},
+                        {"segments", nlohmann::json::array()}};
+  for (const TrackSegment &s : segments)
+    out["segments"].push_back(
+        {{"first", s.first}, {"last", s.last}, {"result", s.result}});
+  return out;
+}
+
+std::vector<Coordinates> parse_gpx(std::string_view xml) {
+  std::vector<Coordinates> points;
+  for (std::size_t pos = xml.find('<'); pos != std::string_view::npos;
+       pos = xml.find('<', pos + 1)) {
+    if (xml.substr(pos, 4) == "<!--") {
+      pos = xml.find("-->", pos);
+      if (pos == std::string_view::npos)
+        break;
+      continue;
+    }
+    const std::string_view name = xml.substr(pos + 1, 5);
+    if (name != "trkpt" && name != "rtept")
+      continue;
+    const std::size_t end = xml.find('>', pos);
+    if (end == std::string_view::npos || pos + 6 >= end ||
+        !(is_space(xml[pos + 6]) || xml[pos + 6] == '/'))
+      continue;
+    const std::string_view tag = xml.substr(pos, end - pos);
+    const auto lat = attribute(tag, "lat");
+    const auto lon = attribute(tag, "lon");
+    if (!lat || !lon || std::abs(*lat) > 90.0 || std::abs(*lon) > 180.0)
+      throw std::runtime_error("Invalid GPX point at offset " +
+                               std::to_string(pos));
+    points.push_back({*lat, *lon, ""});
+  }
+  return points;
+}
+
+std::vector<Coordinates> parse_nmea(std::string_view log) {
+  std::vector<Coordinates> points;
+  while (!log.empty()) {
+    const std::size_t eol = log.find('\n');
+    std::string_view line = log.substr(0, eol);
+    log.remove_prefix(eol == std::string_view::npos ? log.size() : eol + 1);
+    while (!line.empty() && is_space(line.back()))
+      line.remove_suffix(1);
+    const std::size_t dollar = line.find('$');
+    if (dollar == std::string_view::npos)
+      continue;
+    std::string_view body = line.substr(dollar + 1);
+    if (const std::size_t star = body.find('*');
+        star != std::string_view::npos) {
+      if (!checksum_ok(body.substr(0, star), body.substr(star + 1)))
+        continue;
+      body = body.substr(0, star);
+    }
+    const auto fix = nmea_fix(body);
+    // RMC and GGA usually report the same fix
+    if (fix && (points.empty() || points.back().latitude != fix->latitude ||
+                points.back().longitude != fix->longitude))
+      points.push_back(*fix);
+  }
+  return points;
+}
+
+std::vector<Coordinates> read_track(const std::string &path) {
+  std::ifstream f(path, std::ios::binary);
+  if (!f.is_open())
+    throw std::runtime_error("Could not open track file: " + path);
+  const std::string text((std::istreambuf_iterator<char>(f)),
+                         std::istreambuf_iterator<char>());
+  std::string_view view(text);
+  if (view.starts_with("\xEF\xBB\xBF"))
+    view.remove_prefix(3);
+  while (!view.empty() && is_space(view.front()))
+    view.remove_prefix(1);
+  return view.starts_with('<') ? parse_gpx(view) : parse_nmea(view);
+}
+
+TrackResult geocode_track(const ReverseGeocoder &geocoder,
+                          const std::vector<Coordinates> &track,
+                          const std::vector<std::string> &priority_list,
+                          const std::string &lang_override,
+                          std::stop_token stop, const TrackOptions &options) {
+  TrackResult out;
+  out.points = track.size();
+  if (track.empty())
+    return out;
+  const std::size_t n = track.size();
+
+  std::vector<nlohmann::json> results(n);
+  std::vector<std::string> labels(n);
+  std::vector<bool> known(n, false);
+  auto look_up = [&](const std::vector<std::size_t> &indices) {
+    std::vector<Coordinates> coords;
+    coords.reserve(indices.size());
+    for (const std::size_t i : indices)
+      coords.push_back(track[i]);
+    BatchReport report;
+    auto answers = geocoder.batch_reverse_geocode(
+        coords, priority_list, lang_override, stop, {}, &report);
+    out.lookups += report.requests;
+    for (std::size_t k = 0; k < indices.size(); ++k) {
+      const std::size_t i = indices[k];
+      labels[i] = label_of(answers[k], options.label_keys);
+      results[i] = std::move(answers[k]);
+      known[i] = true;
+    }
+  };
+
+  // Probes: the ends, every n-th point, and after every probe_m metres
+  std::vector<std::size_t> probes{0};
+  const std::size_t every = std::max<std::size_t>(options.probe_every, 1);
+  double run_m = 0.0;
+  for (std::size_t i = 1; i < n; ++i) {
+    if (options.probe_m > 0.0)
+      run_m += distance_m(track[i - 1], track[i]);
+    if (i == n - 1 || i - probes.back() >= every ||
+        (options.probe_m > 0.0 && run_m >= options.probe_m)) {
+      probes.push_back(i);
+      run_m = 0.0;
+    }
+  }
+  look_up(probes);
+
+  // Halve every gap whose ends differ until the change is between
+  // neighbours; each round is one batch
+  std::vector<std::pair<std::size_t, std::size_t>> open;
+  for (std::size_t k = 0; k + 1 < probes.size(); ++k) {
+    if (probes[k + 1] > probes[k] + 1 &&
+        labels[probes[k]] != labels[probes[k + 1]])
+      open.emplace_back(probes[k], probes[k + 1]);
+  }
+  while (!open.empty()) {
+    std::vector<std::size_t> mids;
+    mids.reserve(open.size());
+    for (const auto &[a, b] : open)
+      mids.push_back(a + (b - a) / 2);
+    look_up(mids);
+    std::vector<std::pair<std::size_t, std::size_t>> next;
+    for (std::size_t k = 0; k < open.size(); ++k) {
+      const auto [a, b] = open[k];
+      const std::size_t m = mids[k];
+      if (m > a + 1 && labels[a] != labels[m])
+        next.emplace_back(a, m);
+      if (b > m + 1 && labels[m] != labels[b])
+        next.emplace_back(m, b);
+    }
+    open = std::move(next);
+  }
+
+  // Points between two looked-up points with the same label share it
+  out.segments.push_back({0, 0, std::move(results[0])});
+  std::size_t prev = 0;
+  for (std::size_t i = 1; i < n; ++i) {
+    if (!known[i])
+      continue;
+    if (labels[i] != labels[prev]) {
+      out.segments.back().last = i - 1;
+      out.segments.push_back({i, i, std::move(results[i])});
+    }
+    prev = i;
+  }
+  out.segments.back().last = n - 1;
+  return out;
+}
+
+} // namespace regeocode
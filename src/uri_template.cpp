@@ -0,0 +1,224 @@
+/**
+ * SPDX-FileComment: Implementation of precompiled request URI templates.
+ * SPDX-FileType: SOURCE
+ * SPDX-FileContributor: ZHENG Robert
+ * SPDX-FileCopyrightText: 2026 ZHENG Robert
+ * SPDX-License-Identifier: MIT
+ *
+ * @file uri_template.cpp
+ * @brief URI template compiled once per API instead of once per request.
+ * @version 0.1.0
+ * @date 2026-10-19
+ *
+ * @author ZHENG Robert
+ * @license MIT License
+ */
+
+#include "regeocode/uri_template.hpp"
+
+#include <array>
+#include <charconv>
+#include <cmath>
+#include <exception>
+#include <limits>
+#include <mutex>
+#include <optional>
+#include <string_view>
+#include <utility>
+
+#include "regeocode/inja.hpp"
+#include <nlohmann/json.hpp>
+
+namespace regeocode {
+
+namespace {
+std::string_view trim(std::string_view s) {
+  constexpr std::string_view kWs = " \t\r\n";
+  const auto first = s.find_first_not_of(kWs);
+  if (first == std::string_view::npos)
+    return {};
+  return s.substr(first, s.find_last_not_of(kWs) - first + 1);
+}
+
+/**
+ * @brief Appends @p value formatted like inja prints a JSON float.
+ *
+ * The shortest round-trip digits come from std::to_chars; they are laid out
+ * as nlohmann::json dumps a double: plain notation (integral values end in
+ * ".0") from 0.0001 up to 15 integer digits, else d.ddde+XX with at least
+ * two exponent digits.
+ */
+void append_number(std::string &out, double value) {
+  if (!std::isfinite(value)) {
+    out += "null";
+    return;
+  }
+  std::array<char, 32> buf;
+  const auto [end, ec] = std::to_chars(buf.data(), buf.data() + buf.size(),
+                                       value, std::chars_format::scientific);
+  std::string_view text(buf.data(), static_cast<std::size_t>(end - buf.data()));
+  if (text.front() == '-') {
+    out += '-';
+    text.remove_prefix(1);
+  }
+
+  // "d.ddde+XX": digits and the position n of the decimal point after them
+  const std::size_t e = text.find('e');
+  std::array<char, 20> digits;
+  std::size_t k = 0;
+  for (const char c : text.substr(0, e))
+    if (c != '.')
+      digits[k++] = c;
+  std::string_view exponent = text.substr(e + 1);
+  if (exponent.front() == '+')
+    exponent.remove_prefix(1);
+  int n = 0;
+  std::from_chars(exponent.data(), exponent.data() + exponent.size(), n);
+  ++n;
+  const std::string_view all(digits.data(), k);
+  const auto count = static_cast<int>(k);
+  constexpr int kMinExp = -4;
+  constexpr int kMaxExp = std::numeric_limits<double>::digits10;
+
+  if (count <= n && n <= kMaxExp) {
+    out += all;
+    out.append(static_cast<std::size_t>(n - count), '0');
+    out += ".0";
+  } else if (0 < n && n <= kMaxExp) {
+    out += all.substr(0, static_cast<std::size_t>(n));
+    out += '.';
+    out += all.substr(static_cast<std::size_t>(n));
+  } else if (kMinExp < n && n <= 0) {
+    out += "0.";
+    out.append(static_cast<std::size_t>(-n), '0');
+    out += all;
+  } else {
+    out += all.front();
+    if (k > 1) {
+      out += '.';
+      out += all.substr(1);
+    }
+    const int power = n - 1;
+    out += power < 0 ? "e-" : "e+";
+    const std::string magnitude = std::to_string(power < 0 ? -power : power);
+    if (magnitude.size() < 2)
+      out += '0';
+    out += magnitude;
+  }
+}
+} // namespace
+
+/**
+ * @brief inja state for templates the fast path does not cover.
+ */
+struct UriTemplate::Fallback {
+  explicit Fallback(const std::string &source) : tpl(parse(env, source)) {}
+
+  static std::optional<inja::Template> parse(inja::Environment &env,
+                                             const std::string &source) {
+    try {
+      return env.parse(source);
+    } catch (...) {
+      return std::nullopt;
+    }
+  }
+
+  inja::Environment env;
+  std::optional<inja::Template> tpl;
+  std::mutex mutex; // inja::Environment is not documented as thread-safe
+};
+
+UriTemplate::UriTemplate(std::string source) : source_(std::move(source)) {
+  const std::string_view src = source_;
+  bool simple = src.find("{%") == std::string_view::npos &&
+                src.find("{#") == std::string_view::npos &&
+                src.find("##") == std::string_view::npos;
+
+  std::size_t pos = 0;
+  while (simple && pos < src.size()) {
+    const std::size_t open = src.find("{{", pos);
+    const std::size_t literal_end =
+        open == std::string_view::npos ? src.size() : open;
+    if (literal_end > pos) {
+      pieces_.push_back({Slot::Literal, pos, literal_end - pos});
+      literal_bytes_ += literal_end - pos;
+    }
+    if (open == std::string_view::npos)
+      break;
+
+    const std::size_t close = src.find("}}", open + 2);
+    if (close == std::string_view::npos) {
+      simple = false;
+      break;
+    }
+    const std::string_view name = trim(src.substr(open + 2, close - open - 2));
+    if (name == "latitude")
+      pieces_.push_back({Slot::Latitude});
+    else if (name == "longitude")
+      pieces_.push_back({Slot::Longitude});
+    else if (name == "apikey")
+      pieces_.push_back({Slot::ApiKey});
+    else if (name == "lang")
+      pieces_.push_back({Slot::Lang});
+    else if (name == "country_code")
+      pieces_.push_back({Slot::CountryCode});
+    else
+      simple = false; // filters, whitespace control, unknown names
+    pos = close + 2;
+  }
+
+  if (!simple) {
+    pieces_.clear();
+    literal_bytes_ = 0;
+    fallback_ = std::make_unique<Fallback>(source_);
+  }
+}
+
+UriTemplate::~UriTemplate() = default;
+UriTemplate::UriTemplate(UriTemplate &&) noexcept = default;
+UriTemplate &UriTemplate::operator=(UriTemplate &&) noexcept = default;
+
+std::string UriTemplate::render(const UriValues &values) const {
+  if (fallback_) {
+    nlohmann::json params;
+    params["latitude"] = values.latitude;
+    params["longitude"] = values.longitude;
+    params["apikey"] = values.apikey;
+    params["lang"] = values.lang;
+    params["country_code"] = values.country_code;
+
+    std::lock_guard lock(fallback_->mutex);
+    if (!fallback_->tpl) // rethrow the original parse error
+      return fallback_->env.render(source_, params);
+    return fallback_->env.render(*fallback_->tpl, params);
+  }
+
+  std::string out;
+  out.reserve(literal_bytes_ + values.apikey.size() + values.lang.size() +
+              values.country_code.size() + 48);
+  for (const Piece &piece : pieces_) {
+    switch (piece.slot) {
+    case Slot::Literal:
+      out.append(source_, piece.offset, piece.length);
+      break;
+    case Slot::Latitude:
+      append_number(out, values.latitude);
+      break;
+    case Slot::Longitude:
+      append_number(out, values.longitude);
+      break;
+    case Slot::ApiKey:
+      out += values.apikey;
+      break;
+    case Slot::Lang:
+      out += values.lang;
+      break;
+    case Slot::CountryCode:
+      out += values.country_code;
+      break;
+    }
+  }
+  return out;
+}
+
+} // namespace regeocode
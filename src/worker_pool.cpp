@@ -0,0 +1,114 @@
+/**
+ * SPDX-FileComment: Implementation of the worker pool.
+ * SPDX-FileType: SOURCE
+ * SPDX-FileContributor: ZHENG Robert
+ * SPDX-FileCopyrightText: 2026 ZHENG Robert
+ * SPDX-License-Identifier: MIT
+ *
+ * @file worker_pool.cpp
+ * @brief Job queue, workers and parallel_for.
+ * @version 0.1.0
+ * @date 2026-10-19
+ *
+ * @author ZHENG Robert
+ * @license MIT License
+ */
+
+#include "regeocode/worker_pool.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <memory>
+
+namespace regeocode {
+
+WorkerPool::WorkerPool(std::size_t threads) {
+  if (threads == 0)
+    threads = default_size();
+  threads_.reserve(threads);
+  for (std::size_t i = 0; i < threads; ++i)
+    threads_.emplace_back([this] { run(); });
+}
+
+WorkerPool::~WorkerPool() {
+  {
+    std::lock_guard lock(mutex_);
+    stop_ = true;
+  }
+  wake_.notify_all();
+  for (auto &t : threads_)
+    t.join();
+}
+
+std::size_t WorkerPool::default_size() noexcept {
+  return std::max<std::size_t>(4, 2 * std::thread::hardware_concurrency());
+}
+
+void WorkerPool::submit(std::function<void()> job) {
+  {
+    std::lock_guard lock(mutex_);
+    jobs_.push_back(std::move(job));
+  }
+  wake_.notify_one();
+}
+
+void WorkerPool::run() {
+  for (;;) {
+    std::function<void()> job;
+    {
+      std::unique_lock lock(mutex_);
+      wake_.wait(lock, [this] { return stop_ || !jobs_.empty(); });
+      if (jobs_.empty())
+        return; // stopping and drained
+      job = std::move(jobs_.front());
+      jobs_.pop_front();
+    }
+    job();
+  }
+}
+
+void WorkerPool::parallel_for(std::size_t count,
+                              const std::function<void(std::size_t)> &fn) {
+  if (count == 0)
+    return;
+
+  // Helpers may only get to run after the caller finished everything, so
+  // the shared state outlives this call; fn is only touched for indices
+  // handed out, which the caller waits for
+  struct State {
+    std::atomic<std::size_t> next{0};
+    std::size_t done = 0;
+    std::exception_ptr error;
+    std::mutex mutex;
+    std::condition_variable finished;
+  };
+  const auto state = std::make_shared<State>();
+  auto work = [state, count, &fn] {
+    for (std::size_t i; (i = state->next.fetch_add(1)) < count;) {
+      std::exception_ptr error;
+      try {
+        fn(i);
+      } catch (...) {
+        error = std::current_exception();
+      }
+      std::lock_guard lock(state->mutex);
+      if (error && !state->error)
+        state->error = error;
+      if (++state->done == count)
+        state->finished.notify_all();
+    }
+  };
+
+  const std::size_t helpers = std::min(size(), count - 1);
+  for (std::size_t h = 0; h < helpers; ++h)
+    submit(work);
+  work();
+
+  std::unique_lock lock(state->mutex);
+  state->finished.wait(lock, [&] { return state->done == count; });
+  if (state->error)
+    std::rethrow_exception(state->error);
+}
+
+} // namespace regeocode
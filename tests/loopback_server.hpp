@@ -0,0 +1,236 @@
+/**
+ * SPDX-FileComment: Loopback HTTP server for the unit tests.
+ * SPDX-FileType: SOURCE
+ * SPDX-FileContributor: ZHENG Robert
+ * SPDX-FileCopyrightText: 2026 ZHENG Robert
+ * SPDX-License-Identifier: MIT
+ *
+ * @file loopback_server.hpp
+ * @brief Minimal HTTP/1.1 server on 127.0.0.1, so tests can drive the real
+ *        HttpClient and its engine without network access.
+ * @version 0.1.0
+ * @date 2026-10-19
+ *
+ * @author ZHENG Robert
+ * @license MIT License
+ */
+
+#pragma once
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdio>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace regeocode::test {
+
+/**
+ * @brief One request as the loopback server received it.
+ */
+struct LoopbackRequest {
+  std::string target;  ///< "/path?query"
+  std::string headers; ///< Header lines, each ending in "\r\n".
+
+  /// Value of header @p name (case-insensitive), or "" if absent.
+  std::string header(std::string_view name) const {
+    std::string_view rest = headers;
+    while (!rest.empty()) {
+      const auto eol = rest.find("\r\n");
+      const std::string_view line = rest.substr(0, eol);
+      rest = eol == std::string_view::npos ? std::string_view{}
+                                           : rest.substr(eol + 2);
+      const auto colon = line.find(':');
+      if (colon != name.size() ||
+          !std::equal(name.begin(), name.end(), line.begin(),
+                      [](char a, char b) {
+                        return std::tolower(static_cast<unsigned char>(a)) ==
+                               std::tolower(static_cast<unsigned char>(b));
+                      }))
+        continue;
+      std::string_view value = line.substr(colon + 1);
+      value.remove_prefix(std::min(value.find_first_not_of(' '), value.size()));
+      return std::string(value);
+    }
+    return "";
+  }
+};
+
+/**
+ * @brief The answer to one request.
+ */
+struct LoopbackReply {
+  int status = 200;
+  std::string body;
+  std::string headers;                ///< Extra lines, each ending in "\r\n".
+  std::chrono::milliseconds delay{0}; ///< Before the answer is sent.
+  bool chunked = false;               ///< Chunked instead of Content-Length.
+};
+
+/**
+ * @brief HTTP/1.1 server with keep-alive on an ephemeral loopback port.
+ *
+ * Every connection is served on a thread of its own, so slow replies do
+ * not hold up other requests; the handler may therefore run concurrently.
+ * Counts connections and requests, so tests can tell whether a client
+ * reused its connections. Destroying the server cuts delayed replies short
+ * and closes every connection.
+ */
+class LoopbackServer {
+public:
+  using Handler = std::function<LoopbackReply(const LoopbackRequest &)>;
+
+  explicit LoopbackServer(Handler handler) : handler_(std::move(handler)) {
+    fd_ = ::socket(AF_INET, SOCK_STREAM, 0);
+    int one = 1;
+    ::setsockopt(fd_, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    ::bind(fd_, reinterpret_cast<sockaddr *>(&addr), sizeof(addr));
+    ::listen(fd_, 64);
+    socklen_t len = sizeof(addr);
+    ::getsockname(fd_, reinterpret_cast<sockaddr *>(&addr), &len);
+    port_ = ntohs(addr.sin_port);
+    acceptor_ = std::thread([this] { serve(); });
+  }
+
+  ~LoopbackServer() {
+    {
+      std::lock_guard lock(mutex_);
+      stopping_ = true;
+      for (const int client : clients_)
+        ::shutdown(client, SHUT_RDWR);
+    }
+    wake_.notify_all();
+    ::shutdown(fd_, SHUT_RDWR); // unblocks accept()
+    acceptor_.join();
+    for (auto &session : sessions_)
+      session.join();
+    ::close(fd_);
+  }
+
+  LoopbackServer(const LoopbackServer &) = delete;
+  LoopbackServer &operator=(const LoopbackServer &) = delete;
+
+  /// URL of @p target on this server.
+  std::string url(std::string_view target = "/") const {
+    return "http://127.0.0.1:" + std::to_string(port_) + std::string(target);
+  }
+
+  /// Connections accepted so far.
+  std::size_t connections() const { return connections_; }
+  /// Requests answered or being answered so far.
+  std::size_t requests() const { return requests_; }
+
+private:
+  void serve() {
+    for (;;) {
+      const int client = ::accept(fd_, nullptr, nullptr);
+      std::lock_guard lock(mutex_);
+      if (stopping_) {
+        if (client >= 0)
+          ::close(client);
+        return;
+      }
+      if (client < 0)
+        continue;
+      ++connections_;
+      clients_.push_back(client);
+      sessions_.emplace_back([this, client] { session(client); });
+    }
+  }
+
+  void session(int client) {
+    std::string buffer;
+    char chunk[4096];
+    for (;;) {
+      std::size_t end;
+      while ((end = buffer.find("\r\n\r\n")) == std::string::npos) {
+        const ssize_t n = ::read(client, chunk, sizeof(chunk));
+        if (n <= 0)
+          return finish(client);
+        buffer.append(chunk, static_cast<std::size_t>(n));
+      }
+      LoopbackRequest request;
+      const auto line_end = buffer.find("\r\n");
+      const auto target = buffer.find(' ') + 1;
+      request.target = buffer.substr(target, buffer.find(' ', target) - target);
+      request.headers = buffer.substr(line_end + 2, end - line_end);
+      buffer.erase(0, end + 4);
+
+      ++requests_;
+      const LoopbackReply reply = handler_(request);
+      bool stopping;
+      {
+        std::unique_lock lock(mutex_);
+        stopping =
+            wake_.wait_for(lock, reply.delay, [this] { return stopping_; });
+      }
+      if (stopping || !write_all(client, render(reply)))
+        return finish(client);
+    }
+  }
+
+  static std::string render(const LoopbackReply &reply) {
+    std::string out = "HTTP/1.1 " + std::to_string(reply.status) +
+                      " Status\r\nContent-Type: application/json\r\n" +
+                      reply.headers;
+    if (!reply.chunked)
+      return out + "Content-Length: " + std::to_string(reply.body.size()) +
+             "\r\n\r\n" + reply.body;
+    out += "Transfer-Encoding: chunked\r\n\r\n";
+    constexpr std::size_t kChunk = 1024;
+    for (std::size_t pos = 0; pos < reply.body.size(); pos += kChunk) {
+      const std::string_view part =
+          std::string_view(reply.body).substr(pos, kChunk);
+      char size_line[32];
+      std::snprintf(size_line, sizeof(size_line), "%zx\r\n", part.size());
+      out.append(size_line).append(part).append("\r\n");
+    }
+    return out + "0\r\n\r\n";
+  }
+
+  static bool write_all(int fd, std::string_view data) {
+    while (!data.empty()) {
+      const ssize_t n = ::send(fd, data.data(), data.size(), MSG_NOSIGNAL);
+      if (n <= 0)
+        return false;
+      data.remove_prefix(static_cast<std::size_t>(n));
+    }
+    return true;
+  }
+
+  void finish(int client) {
+    std::lock_guard lock(mutex_);
+    std::erase(clients_, client);
+    ::close(client);
+  }
+
+  Handler handler_;
+  int fd_ = -1;
+  unsigned short port_ = 0;
+  std::atomic<std::size_t> connections_{0};
+  std::atomic<std::size_t> requests_{0};
+  std::mutex mutex_;
+  std::condition_variable wake_;
+  bool stopping_ = false;
+  std::vector<int> clients_;
+  std::vector<std::thread> sessions_;
+  std::thread acceptor_;
+};
+
+} // namespace regeocode::test
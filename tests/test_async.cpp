@@ -0,0 +1,276 @@
+/**
+ * SPDX-FileComment: Unit test for the awaitable lookups.
+ * SPDX-FileType: SOURCE
+ * SPDX-FileContributor: ZHENG Robert
+ * SPDX-FileCopyrightText: 2026 ZHENG Robert
+ * SPDX-License-Identifier: MIT
+ *
+ * @file test_async.cpp
+ * @brief Test cases for Task, when_all, the coroutine lookups and
+ *        cancellation; the engine itself is covered by test_transfer_engine.
+ * @version 0.1.0
+ * @date 2026-10-19
+ *
+ * @author ZHENG Robert
+ * @license MIT License
+ */
+
+#include "regeocode/adapter_nominatim.hpp"
+#include "regeocode/re_geocode_core.hpp"
+#include "regeocode/task.hpp"
+#include "test_support.hpp"
+
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <condition_variable>
+#include <future>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <print>
+#include <stdexcept>
+#include <stop_token>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+namespace {
+using namespace std::chrono_literals;
+
+/**
+ * @brief Answers every request with a fixture after a delay, from a thread
+ * of its own, like the engine does; "broken" URLs answer 500.
+ */
+class DeferredHttpClient : public regeocode::test::FixtureHttpClient {
+public:
+  explicit DeferredHttpClient(std::chrono::milliseconds delay)
+      : FixtureHttpClient(regeocode::test::read_fixture("nominatim")),
+        delay_(delay) {}
+  ~DeferredHttpClient() override {
+    for (auto &t : threads_)
+      t.join();
+  }
+
+  void get_async(const std::string &url, long /*timeout*/,
+                 const regeocode::HttpRequestOptions & /*options*/,
+                 std::stop_token stop,
+                 regeocode::ResponseCallback done) const override {
+    const int now = ++in_flight_;
+    for (int seen = max_in_flight_;
+         now > seen && !max_in_flight_.compare_exchange_weak(seen, now);)
+      ;
+    std::lock_guard lock(mutex_);
+    threads_.emplace_back([this, url, stop, done = std::move(done)] {
+      std::mutex m;
+      std::condition_variable_any wake;
+      std::unique_lock l(m);
+      wake.wait_for(l, stop, delay_, [] { return false; });
+      regeocode::HttpResponse response = respond(url);
+      if (stop.stop_requested()) {
+        response.status_code = 599;
+        response.cancelled = true;
+      }
+      --in_flight_;
+      done(std::move(response));
+    });
+  }
+
+  int max_in_flight() const { return max_in_flight_; }
+
+  /// Whether @p id is one of the threads answering requests.
+  bool answers_on(std::thread::id id) const {
+    std::lock_guard lock(mutex_);
+    for (const auto &t : threads_)
+      if (t.get_id() == id)
+        return true;
+    return false;
+  }
+
+private:
+  regeocode::HttpResponse respond(const std::string &url) const override {
+    regeocode::HttpResponse response = FixtureHttpClient::respond(url);
+    if (url.find("/broken") != std::string::npos)
+      response.status_code = 500;
+    return response;
+  }
+
+  std::chrono::milliseconds delay_;
+  mutable std::atomic<int> in_flight_{0};
+  mutable std::atomic<int> max_in_flight_{0};
+  mutable std::mutex mutex_;
+  mutable std::vector<std::thread> threads_;
+};
+
+std::unique_ptr<regeocode::ReverseGeocoder>
+make_geocoder(std::unique_ptr<regeocode::HttpClient> client) {
+  using namespace regeocode;
+  std::unordered_map<std::string, ApiConfig> configs{
+      {"nominatim", test::fixture_config("nominatim")},
+      {"broken", test::fixture_config("broken")}};
+  std::vector<ApiAdapterPtr> adapters;
+  adapters.push_back(std::make_unique<NominatimAdapter>());
+  return std::make_unique<ReverseGeocoder>(std::move(configs),
+                                           std::move(adapters),
+                                           std::move(client),
+                                           regeocode::test::quota_file());
+}
+
+regeocode::Task<int> add(regeocode::Task<int> a, regeocode::Task<int> b) {
+  co_return co_await std::move(a) + co_await std::move(b);
+}
+regeocode::Task<int> value(int v) { co_return v; }
+regeocode::Task<void> mark(bool &ran) {
+  ran = true;
+  co_return;
+}
+/// Thread @p lookup continues on after awaiting it.
+regeocode::Task<std::thread::id>
+resumed_on(regeocode::Task<regeocode::AddressResult> lookup) {
+  co_await std::move(lookup);
+  co_return std::this_thread::get_id();
+}
+regeocode::Task<int> fail() {
+  throw std::runtime_error("task failed");
+  co_return 0;
+}
+} // namespace
+
+/**
+ * @brief Main function for the async test.
+ *
+ * @return int Exit code (0 for success).
+ */
+int main() {
+  using namespace regeocode;
+
+  try {
+    // Test tasks are lazy, chain and propagate exceptions
+    {
+      bool ran = false;
+      auto lazy = mark(ran);
+      assert(!ran);
+      sync_wait(std::move(lazy));
+      assert(ran);
+      assert(sync_wait(add(value(2), value(40))) == 42);
+      bool caught = false;
+      try {
+        sync_wait(add(value(1), fail()));
+      } catch (const std::runtime_error &) {
+        caught = true;
+      }
+      assert(caught);
+
+      // Long chains completing inline do not grow the stack
+      std::vector<Task<int>> many;
+      for (int i = 0; i < 100000; ++i)
+        many.push_back(value(i));
+      const auto all = sync_wait(when_all(std::move(many)));
+      assert(all.size() == 100000 && all[99999] == 99999);
+    }
+    std::println("Test Task and when_all: OK");
+
+    // Test the awaitable lookups give what the blocking ones give
+    {
+      auto geocoder = make_geocoder(std::make_unique<DeferredHttpClient>(1ms));
+      const Coordinates munich{48.137, 11.576, ""};
+      const AddressResult blocking =
+          geocoder->reverse_geocode(munich, "nominatim", "de");
+      const AddressResult awaited =
+          sync_wait(geocoder->reverse_geocode_async(munich, "nominatim", "de"));
+      assert(awaited.address_english == blocking.address_english);
+      assert(awaited.attributes == blocking.attributes);
+
+      const LookupResult typed =
+          sync_wait(geocoder->lookup_async(munich, "nominatim", "de"));
+      assert(typed.to_json() == geocoder->lookup(munich, "nominatim", "de").to_json());
+
+      // The failing provider is skipped like in the blocking chain
+      const nlohmann::json fallback = sync_wait(
+          geocoder->reverse_geocode_fallback_async(munich, {"broken", " nominatim "}));
+      assert(fallback["meta"]["api"] == "nominatim");
+      const nlohmann::json none =
+          sync_wait(geocoder->reverse_geocode_fallback_async(munich, {"broken"}));
+      assert(none["error"] == "All providers failed");
+      assert(none["last_attempt"]["provider"] == "broken");
+    }
+    std::println("Test awaitable lookups: OK");
+
+    // Test a batch keeps every lookup in flight at once on one thread
+    {
+      auto client = std::make_unique<DeferredHttpClient>(1s);
+      const DeferredHttpClient &deferred = *client;
+      auto geocoder = make_geocoder(std::move(client));
+      std::vector<Coordinates> coords;
+      for (int i = 0; i < 200; ++i)
+        coords.push_back({48.0 + 0.001 * i, 11.576, ""});
+      const auto started = std::chrono::steady_clock::now();
+      const auto results = sync_wait(
+          geocoder->batch_reverse_geocode_async(coords, {"nominatim"}, "en"));
+      const auto elapsed = std::chrono::steady_clock::now() - started;
+      assert(results.size() == coords.size());
+      for (const auto &r : results)
+        assert(r["meta"]["api"] == "nominatim");
+      assert(deferred.max_in_flight() == 200);
+      // Sequentially this would take 200 s
+      assert(elapsed < 10s);
+    }
+    std::println("Test concurrent batch: OK");
+
+    // Test lookups continue off the thread that answered the transfer
+    {
+      auto client = std::make_unique<DeferredHttpClient>(1ms);
+      const DeferredHttpClient &deferred = *client;
+      auto geocoder = make_geocoder(std::move(client));
+      for (int i = 0; i < 4; ++i) {
+        const std::thread::id id = sync_wait(resumed_on(
+            geocoder->reverse_geocode_async({48.1, 11.5, ""}, "nominatim")));
+        assert(id != std::this_thread::get_id() && !deferred.answers_on(id));
+      }
+    }
+    std::println("Test continuations leave the engine: OK");
+
+    // Test stop tokens cancel lookups without trying further providers
+    {
+      auto geocoder = make_geocoder(std::make_unique<DeferredHttpClient>(5s));
+      std::stop_source stop;
+      auto pending = std::async(std::launch::async, [&] {
+        return sync_wait(geocoder->reverse_geocode_fallback_async(
+            {48.137, 11.576, ""}, {"nominatim", "nominatim"}, "en",
+            stop.get_token()));
+      });
+      std::this_thread::sleep_for(50ms);
+      const auto started = std::chrono::steady_clock::now();
+      stop.request_stop();
+      bool cancelled = false;
+      try {
+        pending.get();
+      } catch (const LookupCancelled &) {
+        cancelled = true;
+      }
+      assert(cancelled);
+      assert(std::chrono::steady_clock::now() - started < 2s);
+
+      // Already requested: nothing is sent
+      cancelled = false;
+      try {
+        sync_wait(geocoder->reverse_geocode_async(
+            {48.137, 11.576, ""}, "nominatim", "en", stop.get_token()));
+      } catch (const LookupCancelled &) {
+        cancelled = true;
+      }
+      assert(cancelled);
+    }
+    std::println("Test cancellation: OK");
+
+    std::println("All async tests passed!");
+  } catch (const std::exception &e) {
+    std::cerr << "Test failed with exception: " << e.what() << std::endl;
+    return 1;
+  }
+
+  return 0;
+}
@@ -0,0 +1,171 @@
+/**
+ * SPDX-FileComment: Unit test for the flat attribute container.
+ * SPDX-FileType: SOURCE
+ * SPDX-FileContributor: ZHENG Robert
+ * SPDX-FileCopyrightText: 2026 ZHENG Robert
+ * SPDX-License-Identifier: MIT
+ *
+ * @file test_attribute_map.cpp
+ * @brief Test cases for AttributeMap.
+ * @version 0.1.0
+ * @date 2026-10-19
+ *
+ * @author ZHENG Robert
+ * @license MIT License
+ */
+
+#include "regeocode/attribute_map.hpp"
+
+#include <cassert>
+#include <iostream>
+#include <nlohmann/json.hpp>
+#include <print>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+
+/**
+ * @brief Main function for the AttributeMap test.
+ *
+ * @return int Exit code (0 for success).
+ */
+int main() {
+  using namespace regeocode;
+
+  try {
+    // Test insert, overwrite and sorted iteration
+    AttributeMap attrs;
+    attrs["state"] = "Bayern";
+    attrs["city"] = std::string("München");
+    attrs["country"] = "Deutschland";
+    attrs["city"] = "Munich"; // shorter: in place
+    attrs["state"] = "Free State of Bavaria"; // longer: appended
+    assert(attrs.size() == 3);
+    assert(attrs["city"] == "Munich");
+    assert(attrs.at("state") == "Free State of Bavaria");
+
+    std::string keys;
+    for (const auto &[key, value] : attrs)
+      keys += std::string(key) + ",";
+    assert(keys == "city,country,state,");
+    std::println("Test insert: OK");
+
+    // Test lookup API
+    assert(attrs.contains("country") && attrs.count("country") == 1);
+    assert(!attrs.contains("postcode") && attrs.count("postcode") == 0);
+    assert(attrs.find("postcode") == attrs.end());
+    assert(attrs.find("city")->second == "Munich");
+    bool thrown = false;
+    try {
+      (void)attrs.at("postcode");
+    } catch (const std::out_of_range &) {
+      thrown = true;
+    }
+    assert(thrown);
+    assert(attrs.erase("country") == 1 && attrs.erase("country") == 0);
+    assert(attrs.size() == 2);
+    std::println("Test lookup: OK");
+
+    // Test self-assignment from the same arena and copies
+    attrs["town"] = attrs["state"];
+    assert(attrs["town"] == "Free State of Bavaria");
+    attrs["area"] = attrs["city"]; // inserted in front of the source
+    assert(attrs["area"] == "Munich");
+    assert(attrs.erase("area") == 1);
+    AttributeMap copy = attrs;
+    copy["town"] = "Dachau";
+    assert(copy != attrs);
+    assert(attrs["town"] == "Free State of Bavaria");
+    const std::string town = attrs["town"];
+    assert(town == "Free State of Bavaria");
+    std::println("Test copy: OK");
+
+    // Test regrown and erased values do not accumulate
+    {
+      AttributeMap grow;
+      grow["name"] = "x";
+      grow["other"] = "kept";
+      for (std::size_t i = 2; i < 2000; ++i) {
+        grow["name"] = std::string(i % 200 + 1, 'n');
+        grow["temp"] = std::string(64, 't');
+        grow.erase("temp");
+      }
+      assert(grow.size() == 2 && grow.at("other") == "kept");
+      assert(grow.at("name") == std::string(1999 % 200 + 1, 'n'));
+      // Dead bytes never outweigh the live ones (plus the last append)
+      assert(grow.buffer_size() <= 2 * (200 + 4) + 200);
+
+      grow["name"] = std::string(150, 'n');
+      grow["name"] = "short"; // shrunk in place, leaves dead bytes
+      const AttributeMap copy = grow;
+      assert(copy == grow);
+      assert(copy.buffer_size() == std::string_view("shortkept").size());
+      AttributeMap assigned;
+      assigned = grow;
+      assert(assigned.buffer_size() == copy.buffer_size());
+      AttributeMap moved = std::move(assigned);
+      assert(moved == grow && assigned.empty() && assigned.buffer_size() == 0);
+    }
+    std::println("Test compaction: OK");
+
+    // Test interning and JSON conversion
+    assert(intern_attribute_key(std::string("city"))->data() ==
+           intern_attribute_key("city")->data());
+    nlohmann::json j = attrs;
+    assert(j.is_object() && j.size() == 3);
+    assert(j["town"] == "Free State of Bavaria");
+    assert(attrs.to_map().at("city") == "Munich");
+    std::println("Test json: OK");
+
+    // Test names past the intern pool bound are kept by the map itself
+    {
+      AttributeMap many;
+      const std::size_t n = kMaxInternedAttributeKeys + 100;
+      for (std::size_t i = 0; i < n; ++i)
+        many["key_" + std::to_string(i)] = std::to_string(i);
+      assert(!intern_attribute_key("key_" + std::to_string(n - 1)));
+      assert(intern_attribute_key("city")); // pooled names still resolve
+      assert(many.size() == n);
+      for (std::size_t i = 0; i < n; ++i)
+        assert(many.at("key_" + std::to_string(i)) == std::to_string(i));
+
+      // Local keys survive growing values, copies and self-assignment
+      auto last = many["key_" + std::to_string(n - 1)];
+      last = std::string(1000, 'x');
+      assert(last.view().size() == 1000);
+      many["key_" + std::to_string(n - 2)] = many["key_" + std::to_string(n - 1)];
+      const AttributeMap copy = many;
+      assert(copy == many);
+      assert(copy.at("key_" + std::to_string(n - 2)) == std::string(1000, 'x'));
+
+      std::string previous;
+      for (const auto &[key, value] : copy) {
+        assert(previous < key);
+        previous = key;
+      }
+
+      // A held reference to a map-kept key survives compaction
+      AttributeMap local;
+      local["spilled_a"] = "a"; // the pool is full: both keys are local
+      auto held = local["spilled_b"];
+      held = "b";
+      const std::size_t before = local.buffer_size();
+      local["spilled_a"] = std::string(100, 'a');
+      local["spilled_a"] = "a"; // dead bytes outweigh live ones...
+      local["spilled_a"] = "aa"; // ...so this compacts, moving both keys
+      assert(local.buffer_size() <= before + 1);
+      held = "bb";
+      assert(held == "bb" && local.at("spilled_b") == "bb");
+      assert(local.at("spilled_a") == "aa");
+    }
+    std::println("Test intern bound: OK");
+
+    std::println("All AttributeMap tests passed!");
+  } catch (const std::exception &e) {
+    std::cerr << "Test failed with exception: " << e.what() << std::endl;
+    return 1;
+  }
+
+  return 0;
+}
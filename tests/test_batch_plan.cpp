@@ -0,0 +1,192 @@
+/**
+ * SPDX-FileComment: Unit test for batch planning.
+ * SPDX-FileType: SOURCE
+ * SPDX-FileContributor: ZHENG Robert
+ * SPDX-FileCopyrightText: 2026 ZHENG Robert
+ * SPDX-License-Identifier: MIT
+ *
+ * @file test_batch_plan.cpp
+ * @brief Test cases for deduplication, grid snapping, spatial grouping and
+ *        fan-out of batches, and for the batches built on them.
+ * @version 0.1.0
+ * @date 2026-10-19
+ *
+ * @author ZHENG Robert
+ * @license MIT License
+ */
+
+#include "regeocode/adapter_nominatim.hpp"
+#include "regeocode/batch_plan.hpp"
+#include "regeocode/re_geocode_core.hpp"
+#include "regeocode/task.hpp"
+#include "test_support.hpp"
+
+#include <cassert>
+#include <iostream>
+#include <memory>
+#include <print>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+/**
+ * @brief Main function for the batch plan test.
+ *
+ * @return int Exit code (0 for success).
+ */
+int main() {
+  using namespace regeocode;
+  const Coordinates munich{48.137, 11.576, ""};
+  const Coordinates berlin{52.520, 13.405, ""};
+  const Coordinates paris{48.857, 2.352, ""};
+
+  try {
+    // Test exact duplicates are merged and mapped back
+    {
+      const std::vector<Coordinates> coords{munich, berlin, munich, munich,
+                                            paris};
+      const BatchPlan plan(coords, {});
+      assert(plan.unique().size() == 3);
+      assert(plan.unique()[1].latitude == berlin.latitude);
+      for (const std::size_t i : {0, 2, 3})
+        assert(plan.source(i) == 0);
+      assert(plan.source(4) == 2);
+      const BatchReport report = plan.report();
+      assert(report.points == 5 && report.requests == 3 && report.groups == 1);
+      assert(report.unique_ratio() == 0.6);
+
+      // Copies for merged points, in input order
+      const auto out = plan.fan_out(std::vector<std::string>{"m", "b", "p"});
+      assert((out == std::vector<std::string>{"m", "b", "m", "m", "p"}));
+
+      // Country codes are part of the key; -0.0 is 0.0
+      const std::vector<Coordinates> tagged{
+          munich, {48.137, 11.576, "de"}, {0.0, -0.0, ""}, {-0.0, 0.0, ""}};
+      assert(BatchPlan(tagged, {}).unique().size() == 3);
+
+      const BatchPlan empty(std::vector<Coordinates>{}, {});
+      assert(empty.unique().empty() && empty.report().groups == 0);
+      assert(empty.report().unique_ratio() == 1.0);
+    }
+    std::println("Test deduplication: OK");
+
+    // Test points a metre apart share a 1 km cell, points 5 km apart do not
+    {
+      const std::vector<Coordinates> coords{
+          munich,
+          {munich.latitude + 0.00001, munich.longitude - 0.00001, ""},
+          {munich.latitude + 0.045, munich.longitude, ""}};
+      assert(BatchPlan(coords, {}).unique().size() == 3);
+      const BatchPlan plan(coords, {.quantum_m = 1000.0, .cell_m = 0.0});
+      assert(plan.unique().size() == 2);
+      assert(plan.source(1) == 0 && plan.source(2) == 1);
+      // The first point of a cell is looked up, not the cell's corner
+      assert(plan.unique()[0].latitude == munich.latitude);
+
+      // Near the poles columns do not shrink to nothing
+      const std::vector<Coordinates> polar{{89.9999, 10.0, ""},
+                                           {89.9999, -170.0, ""}};
+      assert(BatchPlan(polar, {.quantum_m = 1000.0, .cell_m = 0.0})
+                 .unique()
+                 .size() == 1);
+    }
+    std::println("Test grid snapping: OK");
+
+    // Test grouping keeps each cell's points together
+    {
+      const std::vector<Coordinates> coords{
+          munich, berlin, {munich.latitude + 0.001, munich.longitude, ""},
+          paris, {berlin.latitude, berlin.longitude + 0.001, ""}};
+      const BatchPlan plan(coords, {.quantum_m = 0.0, .cell_m = 50000.0});
+      assert(plan.unique().size() == 5);
+      const auto &starts = plan.group_starts();
+      assert(starts.size() == 4 && starts.back() == 5);
+      assert(plan.report().groups == 3);
+      for (std::size_t g = 0; g + 1 < starts.size(); ++g) {
+        const std::size_t size = starts[g + 1] - starts[g];
+        const double lat = plan.unique()[starts[g]].latitude;
+        assert(size == (lat == paris.latitude ? 1u : 2u));
+      }
+      // Every input point still gets the answer for its own position
+      for (std::size_t i = 0; i < coords.size(); ++i)
+        assert(plan.unique()[plan.source(i)].latitude == coords[i].latitude &&
+               plan.unique()[plan.source(i)].longitude == coords[i].longitude);
+    }
+    std::println("Test spatial grouping: OK");
+
+    // Test batches send one lookup per unique point
+    {
+      auto client = std::make_unique<test::FixtureHttpClient>();
+      const test::FixtureHttpClient &counting = *client;
+      const ApiConfig cfg = test::fixture_config("nominatim");
+      std::vector<ApiAdapterPtr> adapters;
+      adapters.push_back(std::make_unique<NominatimAdapter>());
+      const ReverseGeocoder geocoder({{cfg.name, cfg}}, std::move(adapters),
+                                     std::move(client),
+                                     regeocode::test::quota_file());
+
+      std::vector<Coordinates> coords;
+      for (int i = 0; i < 100; ++i)
+        coords.push_back({48.0 + 0.1 * (i % 10), 11.0, ""});
+
+      BatchReport report;
+      const auto results = geocoder.batch_reverse_geocode(
+          coords, {"nominatim"}, "de", {}, {}, &report);
+      assert(results.size() == coords.size());
+      assert(report.points == 100 && report.requests == 10);
+      assert(report.unique_ratio() == 0.1);
+      // Dual-language lookups: two requests per unique point
+      assert(counting.calls() == 20);
+      for (std::size_t i = 0; i < coords.size(); ++i)
+        assert(results[i]["meta"]["latitude"] == coords[i].latitude);
+
+      // Grouped by cell, the answers are the same
+      const auto grouped = geocoder.batch_reverse_geocode(
+          coords, {"nominatim"}, "de", {},
+          {.quantum_m = 0.0, .cell_m = 5000.0}, &report);
+      assert(grouped == results);
+      assert(report.groups == 10);
+
+      // The awaitable batch merges the same points
+      const std::size_t before = counting.calls();
+      BatchReport async_report;
+      const auto awaited = sync_wait(geocoder.batch_reverse_geocode_async(
+          coords, {"nominatim"}, "de", {}, {}, &async_report));
+      assert(awaited == results);
+      assert(async_report.requests == 10);
+      assert(counting.calls() - before == 20);
+
+      // Merged by the grid, each point still reports where it is
+      std::vector<Coordinates> near;
+      for (int i = 0; i < 4; ++i)
+        near.push_back({48.1 + 0.00001 * i, 11.5 + 0.00001 * i, ""});
+      const BatchOptions grid{.quantum_m = 1000.0, .cell_m = 0.0};
+      const auto merged = geocoder.batch_reverse_geocode(
+          near, {"nominatim"}, "de", {}, grid, &report);
+      const auto merged_async = sync_wait(geocoder.batch_reverse_geocode_async(
+          near, {"nominatim"}, "de", {}, grid, &async_report));
+      assert(report.requests == 1 && async_report.requests == 1);
+      assert(merged_async == merged);
+      for (std::size_t i = 0; i < near.size(); ++i) {
+        const auto &meta = merged[i]["meta"];
+        assert(meta["latitude"] == near[i].latitude);
+        assert(meta["longitude"] == near[i].longitude);
+        assert(meta.contains("looked_up_at") == (i > 0));
+        if (i > 0)
+          assert(meta["looked_up_at"]["latitude"] == near[0].latitude &&
+                 meta["looked_up_at"]["longitude"] == near[0].longitude);
+        assert(merged[i]["result"] == merged[0]["result"]);
+      }
+    }
+    std::println("Test deduplicated batches: OK");
+
+    std::println("All batch plan tests passed!");
+  } catch (const std::exception &e) {
+    std::cerr << "Test failed with exception: " << e.what() << std::endl;
+    return 1;
+  }
+
+  return 0;
+}
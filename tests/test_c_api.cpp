@@ -0,0 +1,398 @@
+/**
+ * SPDX-FileComment: Unit test for the C API.
+ * SPDX-FileType: SOURCE
+ * SPDX-FileContributor: ZHENG Robert
+ * SPDX-FileCopyrightText: 2026 ZHENG Robert
+ * SPDX-License-Identifier: MIT
+ *
+ * @file test_c_api.cpp
+ * @brief Test cases for the typed C records, result sets, the JSON-based
+ *        lookup and the batch and asynchronous entry points.
+ * @version 0.1.0
+ * @date 2026-10-19
+ *
+ * @author ZHENG Robert
+ * @license MIT License
+ */
+
+#include "regeocode/adapter_nominatim.hpp"
+#include "regeocode/adapter_openweather.hpp"
+#include "regeocode/re_geocode_c_api.h"
+#include "regeocode/re_geocode_core.hpp"
+#include "test_support.hpp"
+
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <print>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+namespace {
+/// Fails every request with something that is not a std::exception.
+class ThrowingHttpClient : public regeocode::test::FixtureHttpClient {
+protected:
+  regeocode::HttpResponse respond(const std::string &) const override {
+    throw 42;
+  }
+};
+
+geocoder_t *
+make_geocoder(std::unique_ptr<regeocode::HttpClient> client =
+                  std::make_unique<regeocode::test::FixtureHttpClient>()) {
+  using namespace regeocode;
+  std::unordered_map<std::string, ApiConfig> configs;
+  for (const auto &[name, type] :
+       {std::pair{"nominatim", "geocoding"}, {"openweather", "info"}})
+    configs.emplace(name, test::fixture_config(name, name, type));
+  std::vector<ApiAdapterPtr> adapters;
+  adapters.push_back(std::make_unique<NominatimAdapter>());
+  adapters.push_back(std::make_unique<OpenWeatherAdapter>());
+  return geocoder_wrap(std::make_unique<ReverseGeocoder>(
+      std::move(configs), std::move(adapters),
+      std::move(client), test::quota_file()));
+}
+} // namespace
+
+/**
+ * @brief Main function for the C API test.
+ *
+ * @return int Exit code (0 for success).
+ */
+int main() {
+  try {
+    geocoder_t *geocoder = make_geocoder();
+    assert(geocoder);
+
+    // Test the typed record carries what the JSON document carries
+    {
+      geocode_record_t record =
+          geocoder_lookup_record(geocoder, 48.137, 11.576, "nominatim", "de");
+      assert(record.success == 1 && record.error == nullptr);
+      assert(std::string_view(record.api) == "nominatim");
+      assert(std::string_view(record.type) == "geocoding");
+      assert(record.latitude == 48.137 && record.longitude == 11.576);
+      assert(std::string_view(record.country_code) == "de");
+      assert(std::strlen(record.address_english) > 0);
+      assert(record.attribute_count > 0);
+      for (std::size_t i = 1; i < record.attribute_count; ++i)
+        assert(std::string_view(record.attributes[i - 1].key) <
+               std::string_view(record.attributes[i].key));
+
+      const char *json = geocoder_record_json(&record);
+      assert(json && json == geocoder_record_json(&record)); // built once
+      const auto doc = nlohmann::json::parse(json);
+      assert(doc["meta"]["api"] == "nominatim");
+      assert(doc["result"]["address_english"] == record.address_english);
+      const auto &details = doc["result"]["details"];
+      assert(details.size() == record.attribute_count);
+      for (std::size_t i = 0; i < record.attribute_count; ++i)
+        assert(details[record.attributes[i].key] == record.attributes[i].value);
+
+      geocoder_record_free(&record);
+      assert(record.internal == nullptr && record.api == nullptr);
+      geocoder_record_free(&record); // freeing twice is harmless
+    }
+    std::println("Test geocoding record: OK");
+
+    // Test info APIs map title and summary, and the legacy struct agrees
+    {
+      geocode_record_t record =
+          geocoder_lookup_record(geocoder, 48.137, 11.576, "openweather", "");
+      assert(record.success == 1);
+      assert(std::string_view(record.type) == "info");
+      geocode_result_t legacy =
+          geocoder_lookup(geocoder, 48.137, 11.576, "openweather", nullptr);
+      assert(legacy.success == 1);
+      assert(std::string_view(legacy.address_english) ==
+             record.address_english);
+      assert(std::string_view(legacy.json_full) ==
+             geocoder_record_json(&record));
+      const auto doc = nlohmann::json::parse(legacy.json_full);
+      assert(doc["result"]["title"] == record.address_english);
+      geocoder_result_free(&legacy);
+      assert(legacy.json_full == nullptr && legacy.address_english == nullptr);
+      geocoder_result_free(&legacy);
+
+      // Callers may NULL a field they took over; json_full frees the block
+      legacy = geocoder_lookup(geocoder, 48.137, 11.576, "nominatim", "de");
+      assert(legacy.success == 1 && legacy.address_english != nullptr);
+      assert(legacy.json_full < legacy.address_english);
+      const std::string taken = legacy.address_english;
+      legacy.address_english = nullptr;
+      legacy.country_code = nullptr;
+      geocoder_result_free(&legacy);
+      assert(legacy.json_full == nullptr && !taken.empty());
+      geocoder_record_free(&record);
+    }
+    std::println("Test info record and legacy lookup: OK");
+
+    // Test failures report a message and no JSON
+    {
+      geocode_record_t record =
+          geocoder_lookup_record(geocoder, 0, 0, "missing", nullptr);
+      assert(record.success == 0);
+      assert(std::string_view(record.error) == "Unknown API: missing");
+      assert(record.api == nullptr && record.attribute_count == 0);
+      assert(geocoder_record_json(&record) == nullptr);
+      geocoder_record_free(&record);
+
+      record = geocoder_lookup_record(nullptr, 0, 0, "nominatim", nullptr);
+      assert(record.success == 0 && record.error != nullptr);
+      geocoder_record_free(&record);
+    }
+    std::println("Test failed record: OK");
+
+    // Test batches fill every slot in input order, failures included
+    {
+      constexpr std::size_t n = 40;
+      double lats[n], lons[n];
+      for (std::size_t i = 0; i < n; ++i) {
+        lats[i] = 48.0 + static_cast<double>(i) / 100;
+        lons[i] = 11.0;
+      }
+      geocode_record_t records[n];
+      assert(geocoder_lookup_batch(geocoder, lats, lons, n, "nominatim", "de",
+                                   records) == n);
+      for (std::size_t i = 0; i < n; ++i)
+        assert(records[i].success == 1 && records[i].latitude == lats[i]);
+      // One block for the batch, alive until its last record is freed
+      const char *first = records[0].api;
+      const char *last = records[n - 1].api;
+      assert(last > first && last - first < 64 * 1024);
+      for (std::size_t i = 0; i + 1 < n; ++i)
+        geocoder_record_free(&records[i]);
+      assert(records[0].internal == nullptr);
+      assert(std::string_view(records[n - 1].country_code) == "de");
+      assert(geocoder_record_json(&records[n - 1]) != nullptr);
+      geocoder_record_free(&records[n - 1]);
+      assert(geocoder_lookup_batch(geocoder, lats, lons, 3, "missing", nullptr,
+                                   records) == 0);
+      assert(records[2].success == 0 && records[2].error != nullptr);
+      for (std::size_t i = 0; i < 3; ++i)
+        geocoder_record_free(&records[i]);
+      assert(geocoder_lookup_batch(geocoder, lats, lons, 0, "nominatim",
+                                   nullptr, records) == 0);
+    }
+    std::println("Test batch lookup: OK");
+
+    // Test result sets hold every record in one block, freed at once
+    {
+      const double lats[] = {48.1, 48.2, 48.3, 48.4};
+      const double lons[] = {11.1, 11.2, 11.3, 11.4};
+      geocode_result_set_t *set =
+          geocoder_lookup_set(geocoder, lats, lons, 4, "nominatim", "de");
+      assert(set && geocoder_result_set_size(set) == 4);
+      const geocode_record_t *records = geocoder_result_set_records(set);
+      const auto *first = reinterpret_cast<const char *>(set);
+      for (std::size_t i = 0; i < 4; ++i) {
+        const geocode_record_t &r = records[i];
+        assert(r.success == 1 && r.longitude == lons[i]);
+        assert(std::string_view(r.country_code) == "de");
+        // Strings and attributes point into the set's block
+        assert(r.api > first && r.attributes[0].value > first);
+        assert(r.api - first < 64 * 1024);
+        assert(nlohmann::json::parse(geocoder_record_json(&r))["meta"]
+                   ["longitude"] == lons[i]);
+      }
+      // Threads sharing a record get the one JSON document
+      {
+        std::atomic<const char *> seen[8];
+        std::vector<std::thread> threads;
+        for (auto &json : seen)
+          threads.emplace_back(
+              [&json, &records] { json = geocoder_record_json(&records[3]); });
+        for (auto &t : threads)
+          t.join();
+        for (const auto &json : seen)
+          assert(json.load() == seen[0].load() && json.load() != nullptr);
+      }
+      geocode_record_t copy = records[1];
+      geocoder_record_free(&copy); // owned by the set: no effect
+      assert(copy.internal != nullptr);
+      geocoder_result_set_free(set);
+
+      set = geocoder_lookup_set(geocoder, lats, lons, 0, "nominatim", nullptr);
+      assert(set && geocoder_result_set_size(set) == 0);
+      geocoder_result_set_free(set);
+      assert(!geocoder_lookup_set(nullptr, lats, lons, 4, "nominatim", ""));
+      geocoder_result_set_free(nullptr);
+    }
+    std::println("Test result sets: OK");
+
+    // Test async lookups call back once each, off the calling thread
+    {
+      struct Pending {
+        std::mutex mutex;
+        std::condition_variable done;
+        int results = 0, failures = 0;
+        std::thread::id caller = std::this_thread::get_id();
+      } pending;
+      auto callback = [](geocode_record_t *record, void *user_data) {
+        auto &p = *static_cast<Pending *>(user_data);
+        assert(std::this_thread::get_id() != p.caller);
+        std::lock_guard lock(p.mutex);
+        ++(record->success ? p.results : p.failures);
+        geocoder_record_free(record);
+        p.done.notify_one();
+      };
+      for (int i = 0; i < 20; ++i) {
+        std::string api = i % 10 == 9 ? "missing" : "nominatim";
+        assert(geocoder_lookup_async(geocoder, 48.1, 11.5, api.c_str(), "de",
+                                     callback, &pending) == 1);
+      }
+      assert(geocoder_lookup_async(geocoder, 0, 0, "nominatim", nullptr,
+                                   nullptr, &pending) == 0);
+      std::unique_lock lock(pending.mutex);
+      pending.done.wait(lock, [&] {
+        return pending.results + pending.failures == 20;
+      });
+      assert(pending.results == 18 && pending.failures == 2);
+    }
+    std::println("Test async lookup: OK");
+
+    // Test async records outlive the callback and are freed elsewhere
+    {
+      struct Kept {
+        std::mutex mutex;
+        std::condition_variable done;
+        std::vector<geocode_record_t *> records;
+      } kept;
+      for (int i = 0; i < 8; ++i)
+        assert(geocoder_lookup_async(
+                   geocoder, 48.1, 11.5 + i, "nominatim", "de",
+                   [](geocode_record_t *record, void *user_data) {
+                     auto &k = *static_cast<Kept *>(user_data);
+                     std::lock_guard lock(k.mutex);
+                     k.records.push_back(record);
+                     k.done.notify_one();
+                   },
+                   &kept) == 1);
+      std::unique_lock lock(kept.mutex);
+      kept.done.wait(lock, [&] { return kept.records.size() == 8; });
+      for (geocode_record_t *record : kept.records) {
+        assert(record->success == 1 && record->longitude >= 11.5);
+        assert(std::string_view(record->country_code) == "de");
+        assert(geocoder_record_json(record) != nullptr);
+        geocoder_record_free(record); // releases the record itself
+      }
+    }
+    std::println("Test async records outlive the callback: OK");
+
+    // Test geocoder_free waits for queued lookups
+    {
+      geocoder_t *other = make_geocoder();
+      std::atomic<int> calls{0};
+      for (int i = 0; i < 50; ++i)
+        geocoder_lookup_async(
+            other, 48.1, 11.5, "openweather", nullptr,
+            [](geocode_record_t *record, void *user_data) {
+              ++*static_cast<std::atomic<int> *>(user_data);
+              geocoder_record_free(record);
+            },
+            &calls);
+      geocoder_free(other);
+      assert(calls == 50);
+    }
+    std::println("Test free drains async lookups: OK");
+
+    // Test callbacks may call back into a handle that is being freed
+    {
+      geocoder_t *other = make_geocoder();
+      struct Reentry {
+        geocoder_t *handle;
+        std::atomic<int> calls{0};
+        std::atomic<int> nested{0};
+      } reentry{other};
+      for (int i = 0; i < 20; ++i)
+        geocoder_lookup_async(
+            other, 48.1, 11.5, "openweather", nullptr,
+            [](geocode_record_t *record, void *user_data) {
+              auto &r = *static_cast<Reentry *>(user_data);
+              geocoder_record_free(record);
+              // Still running while geocoder_free() drains the queue
+              std::this_thread::sleep_for(std::chrono::milliseconds(5));
+              geocode_record_t again = geocoder_lookup_record(
+                  r.handle, 48.2, 11.6, "nominatim", nullptr);
+              assert(again.success == 1);
+              geocoder_record_free(&again);
+              const double lats[] = {48.3, 48.4}, lons[] = {11.3, 11.4};
+              geocode_record_t batch[2];
+              assert(geocoder_lookup_batch(r.handle, lats, lons, 2,
+                                           "nominatim", nullptr, batch) == 2);
+              geocoder_record_free(&batch[0]);
+              geocoder_record_free(&batch[1]);
+              ++r.calls;
+            },
+            &reentry);
+      // Queued by a callback below: the drain runs it as well
+      geocoder_lookup_async(
+          other, 48.1, 11.5, "openweather", nullptr,
+          [](geocode_record_t *record, void *user_data) {
+            auto &r = *static_cast<Reentry *>(user_data);
+            geocoder_record_free(record);
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+            assert(geocoder_lookup_async(
+                       r.handle, 48.5, 11.5, "nominatim", nullptr,
+                       [](geocode_record_t *record, void *user_data) {
+                         ++static_cast<Reentry *>(user_data)->nested;
+                         geocoder_record_free(record);
+                       },
+                       user_data) == 1);
+          },
+          &reentry);
+      geocoder_free(other);
+      assert(reentry.calls == 20 && reentry.nested == 1);
+    }
+    std::println("Test free with re-entering callbacks: OK");
+
+    // Test no exception crosses the C boundary
+    {
+      geocoder_t *other = make_geocoder(std::make_unique<ThrowingHttpClient>());
+      geocode_record_t record =
+          geocoder_lookup_record(other, 48.1, 11.5, "nominatim", nullptr);
+      assert(record.success == 0 && record.error != nullptr);
+      geocoder_record_free(&record);
+
+      const double lats[] = {48.1, 48.2}, lons[] = {11.1, 11.2};
+      geocode_record_t records[2];
+      assert(geocoder_lookup_batch(other, lats, lons, 2, "nominatim", nullptr,
+                                   records) == 0);
+      assert(records[1].success == 0 && records[1].error != nullptr);
+      geocoder_record_free(&records[0]);
+      geocoder_record_free(&records[1]);
+      assert(!geocoder_lookup_set(other, lats, lons, 2, "nominatim", nullptr));
+
+      std::atomic<int> failures{0};
+      assert(geocoder_lookup_async(
+                 other, 48.1, 11.5, "nominatim", nullptr,
+                 [](geocode_record_t *record, void *user_data) {
+                   if (!record->success && record->error)
+                     ++*static_cast<std::atomic<int> *>(user_data);
+                   geocoder_record_free(record);
+                 },
+                 &failures) == 1);
+      geocoder_free(other);
+      assert(failures == 1);
+    }
+    std::println("Test failures stay inside the C API: OK");
+
+    geocoder_free(geocoder);
+    std::println("All C API tests passed!");
+  } catch (const std::exception &e) {
+    std::cerr << "Test failed with exception: " << e.what() << std::endl;
+    return 1;
+  }
+
+  return 0;
+}
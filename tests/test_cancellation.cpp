@@ -0,0 +1,302 @@
+/**
+ * SPDX-FileComment: Unit test for cancelling lookups in flight.
+ * SPDX-FileType: SOURCE
+ * SPDX-FileContributor: ZHENG Robert
+ * SPDX-FileCopyrightText: 2026 ZHENG Robert
+ * SPDX-License-Identifier: MIT
+ *
+ * @file test_cancellation.cpp
+ * @brief Test cases for stop tokens on the blocking transfers and lookups,
+ *        quota slots given back, and geocoder_cancel().
+ * @version 0.1.0
+ * @date 2026-10-19
+ *
+ * @author ZHENG Robert
+ * @license MIT License
+ */
+
+#include "regeocode/adapter_nominatim.hpp"
+#include "regeocode/quota_manager.hpp"
+#include "regeocode/re_geocode_c_api.h"
+#include "regeocode/re_geocode_core.hpp"
+
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <cassert>
+#include <chrono>
+#include <filesystem>
+#include <future>
+#include <iostream>
+#include <memory>
+#include <print>
+#include <stop_token>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace {
+using namespace std::chrono_literals;
+
+/**
+ * @brief Loopback listener that accepts connections but never answers, so
+ * every request to it blocks until its timeout or its stop token.
+ */
+class SilentServer {
+public:
+  SilentServer() : fd_(::socket(AF_INET, SOCK_STREAM, 0)) {
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    socklen_t len = sizeof(addr);
+    ::bind(fd_, reinterpret_cast<sockaddr *>(&addr), sizeof(addr));
+    ::listen(fd_, 64);
+    ::getsockname(fd_, reinterpret_cast<sockaddr *>(&addr), &len);
+    url_ = "http://127.0.0.1:" + std::to_string(ntohs(addr.sin_port)) + "/";
+  }
+  ~SilentServer() { ::close(fd_); }
+  SilentServer(const SilentServer &) = delete;
+  SilentServer &operator=(const SilentServer &) = delete;
+
+  const std::string &url() const { return url_; }
+
+private:
+  int fd_;
+  std::string url_;
+};
+
+/// Always busy: 503 with a Retry-After of 20 seconds.
+class BusyHttpClient : public regeocode::HttpClient {
+public:
+  regeocode::HttpResponse
+  get(const std::string & /*url*/, long /*timeout*/,
+      const regeocode::HttpRequestOptions & /*options*/) const override {
+    regeocode::HttpResponse response;
+    response.status_code = 503;
+    response.retry_after = "20";
+    return response;
+  }
+};
+
+regeocode::ApiConfig make_config(const std::string &url, long daily_limit) {
+  regeocode::ApiConfig cfg;
+  cfg.name = "nominatim";
+  cfg.adapter = "nominatim";
+  cfg.type = "geocoding";
+  cfg.uri_template = url + "?lat={{ latitude }}";
+  cfg.timeout = 60;
+  cfg.daily_limit = daily_limit;
+  return cfg;
+}
+
+std::unique_ptr<regeocode::ReverseGeocoder>
+make_geocoder(const regeocode::ApiConfig &cfg,
+              std::unique_ptr<regeocode::HttpClient> client,
+              const std::string &quota_file) {
+  std::vector<regeocode::ApiAdapterPtr> adapters;
+  adapters.push_back(std::make_unique<regeocode::NominatimAdapter>());
+  return std::make_unique<regeocode::ReverseGeocoder>(
+      std::unordered_map<std::string, regeocode::ApiConfig>{{cfg.name, cfg}},
+      std::move(adapters), std::move(client), quota_file);
+}
+
+/// Slots of @p api used today according to @p quota_file.
+long used_slots(const std::string &quota_file, const std::string &api,
+                long limit) {
+  regeocode::QuotaManager quota(quota_file);
+  long used = limit;
+  while (used > 0 && quota.try_consume(api, limit))
+    --used;
+  return used;
+}
+
+/// Runs @p lookup, requests @p stop after 50 ms, and returns how long the
+/// lookup took to end with LookupCancelled after that.
+template <typename Lookup>
+std::chrono::steady_clock::duration cancel_after_start(std::stop_source &stop,
+                                                       Lookup lookup) {
+  auto pending = std::async(std::launch::async, lookup);
+  std::this_thread::sleep_for(50ms);
+  const auto requested = std::chrono::steady_clock::now();
+  stop.request_stop();
+  bool cancelled = false;
+  try {
+    pending.get();
+  } catch (const regeocode::LookupCancelled &) {
+    cancelled = true;
+  }
+  assert(cancelled);
+  return std::chrono::steady_clock::now() - requested;
+}
+} // namespace
+
+/**
+ * @brief Main function for the cancellation test.
+ *
+ * @return int Exit code (0 for success).
+ */
+int main() {
+  using namespace regeocode;
+  const SilentServer server;
+  const std::string quota_file =
+      (std::filesystem::temp_directory_path() / "quota_cancellation_test.json")
+          .string();
+  std::filesystem::remove(quota_file);
+
+  try {
+    // Test released slots can be consumed again, on the same day only
+    {
+      QuotaManager quota(quota_file);
+      assert(quota.try_consume("api", 2));
+      assert(quota.try_consume("api", 2));
+      assert(!quota.try_consume("api", 2));
+      quota.release("api", 2);
+      assert(quota.try_consume("api", 2));
+      quota.release("api", 2);
+      quota.release("api", 2);
+      quota.release("api", 2); // never below zero
+      assert(quota.try_consume("api", 2));
+      assert(quota.try_consume("api", 2));
+      assert(!quota.try_consume("api", 2));
+      quota.release("unknown", 2);
+      quota.release("api", 0); // unlimited APIs count nothing
+      assert(!quota.try_consume("api", 2));
+      std::filesystem::remove(quota_file);
+    }
+    std::println("Test quota release: OK");
+
+    // Test blocking transfers end when their token is requested
+    for (const bool multiplex : {false, true}) {
+      HttpClientOptions client_options;
+      client_options.multiplex = multiplex;
+      const HttpClient client(client_options);
+      std::stop_source stop;
+      HttpRequestOptions options;
+      options.stop = stop.get_token();
+      HttpResponse response;
+      const auto waited = cancel_after_start(stop, [&] {
+        response = client.get(server.url(), 60, options);
+        if (response.cancelled)
+          throw LookupCancelled("http");
+      });
+      assert(response.status_code == 599);
+      // The progress callback polls about once a second; the engine cancels
+      // at once
+      assert(waited < (multiplex ? 500ms : 3s));
+
+      // Already requested: nothing is sent
+      assert(client.get(server.url(), 60, options).cancelled);
+    }
+    std::println("Test cancelled transfers: OK");
+
+    // Test a cancelled lookup gives its quota slot back and does not try
+    // further providers
+    {
+      HttpClientOptions client_options;
+      client_options.multiplex = true;
+      const auto cfg = make_config(server.url(), 10);
+      auto geocoder = make_geocoder(
+          cfg, std::make_unique<HttpClient>(client_options), quota_file);
+      std::stop_source stop;
+      const auto waited = cancel_after_start(stop, [&] {
+        return geocoder->reverse_geocode_fallback(
+            {48.137, 11.576, ""}, {"nominatim", "nominatim"}, "en",
+            stop.get_token());
+      });
+      assert(waited < 1s);
+      const ApiSnapshot counters = geocoder->metrics().apis.at("nominatim");
+      assert(counters[Counter::Lookups] == 1);
+      assert(counters[Counter::Cancelled] == 1);
+      assert(counters[Counter::QuotaConsumed] == 1);
+      assert(counters[Counter::QuotaReleased] == 1);
+      assert(used_slots(quota_file, "nominatim", 10) == 0);
+      std::filesystem::remove(quota_file);
+    }
+    std::println("Test cancelled lookup: OK");
+
+    // Test a batch stops all of its threads
+    {
+      const auto cfg = make_config(server.url(), 0);
+      auto geocoder =
+          make_geocoder(cfg, std::make_unique<HttpClient>(), quota_file);
+      std::stop_source stop;
+      std::vector<Coordinates> coords;
+      for (int i = 0; i < 8; ++i)
+        coords.push_back({48.0 + 0.01 * i, 11.576, ""});
+      const auto waited = cancel_after_start(stop, [&] {
+        return geocoder->batch_reverse_geocode(coords, {"nominatim"}, "en",
+                                               stop.get_token());
+      });
+      assert(waited < 3s);
+      const ApiSnapshot counters = geocoder->metrics().apis.at("nominatim");
+      assert(counters[Counter::Cancelled] == coords.size());
+    }
+    std::println("Test cancelled batch: OK");
+
+    // Test a retry back-off is cut short; the slot reserved for the retry
+    // is given back, the one of the answered request is not
+    {
+      auto cfg = make_config("http://busy/", 10);
+      cfg.retry.max_attempts = 3;
+      auto geocoder =
+          make_geocoder(cfg, std::make_unique<BusyHttpClient>(), quota_file);
+      std::stop_source stop;
+      const auto waited = cancel_after_start(stop, [&] {
+        return geocoder->reverse_geocode({48.137, 11.576, ""}, "nominatim",
+                                         "en", stop.get_token());
+      });
+      assert(waited < 1s);
+      assert(used_slots(quota_file, "nominatim", 10) == 1);
+      std::filesystem::remove(quota_file);
+    }
+    std::println("Test cancelled back-off: OK");
+
+    // Test geocoder_cancel() reaches running and queued lookups only
+    {
+      const auto cfg = make_config(server.url(), 0);
+      geocoder_t *handle = geocoder_wrap(
+          make_geocoder(cfg, std::make_unique<HttpClient>(), quota_file));
+      struct Received {
+        std::promise<std::string> error;
+      };
+      std::vector<Received> received(4);
+      for (auto &r : received) {
+        assert(geocoder_lookup_async(
+            handle, 48.137, 11.576, "nominatim", "en",
+            [](geocode_record_t *record, void *user) {
+              static_cast<Received *>(user)->error.set_value(
+                  record->success ? "" : record->error);
+              geocoder_record_free(record);
+            },
+            &r));
+      }
+      std::this_thread::sleep_for(50ms);
+      const auto requested = std::chrono::steady_clock::now();
+      geocoder_cancel(handle);
+      for (auto &r : received) {
+        const std::string error = r.error.get_future().get();
+        assert(error.find("Lookup cancelled") != std::string::npos);
+      }
+      assert(std::chrono::steady_clock::now() - requested < 3s);
+
+      // Lookups after the cancel are not affected by it
+      geocode_record_t later =
+          geocoder_lookup_record(handle, 48.137, 11.576, "unknown", "en");
+      assert(!later.success &&
+             std::string_view(later.error).find("cancelled") ==
+                 std::string_view::npos);
+      geocoder_record_free(&later);
+      geocoder_free(handle);
+    }
+    std::println("Test geocoder_cancel: OK");
+
+    std::println("All cancellation tests passed!");
+  } catch (const std::exception &e) {
+    std::cerr << "Test failed with exception: " << e.what() << std::endl;
+    return 1;
+  }
+  std::filesystem::remove(quota_file);
+  return 0;
+}
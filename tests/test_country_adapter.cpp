@@ -18,6 +18,8 @@
 
 #include "regeocode/adapter_country.hpp"
 #include <cassert>
+#include <filesystem>
+#include <fstream>
 #include <iostream>
 #include <print>
 
@@ -56,6 +58,39 @@ int main() {
     assert(xx.empty());
     std::println("Test XX: OK (Empty)");
 
+    // Test direct record lookup by alpha-2, alpha-3 and numeric code
+    const auto *rec = adapter.find("de");
+    assert(rec != nullptr);
+    assert(rec->cca2 == "DE");
+    assert(rec->name_common == "Germany");
+    assert(adapter.find("DEU") == rec);
+    assert(adapter.find("276") == rec);
+    assert(adapter.find("xx") == nullptr);
+    assert(adapter.find("") == nullptr);
+    std::println("Test find(): OK");
+
+    // Test codes outside the static index are kept, not dropped
+    {
+      const auto path = (std::filesystem::temp_directory_path() /
+                         "regeocode_unindexed_countries.json")
+                            .string();
+      std::ofstream(path) << R"([
+        {"cca2": "ZZ", "name": {"common": "Zedland", "official": "Zedland"},
+         "capital": ["Zed"], "region": "Nowhere", "flag": ""},
+        {"cca2": "de", "name": {"common": "Germany", "official": ""}}
+      ])";
+      CountryAdapter custom(path);
+      std::filesystem::remove(path);
+      const auto zz = custom.get_country("zz");
+      assert(zz["name.common"] == "Zedland" && zz["capital"] == "Zed");
+      assert(zz["flag_url"] ==
+             "https://github.com/lipis/flag-icons/blob/main/flags/4x3/zz.svg");
+      assert(custom.find("ZZ") != nullptr && custom.find("ZZ")->cca2 == "ZZ");
+      assert(custom.find("de")->cca2 == "DE");
+      assert(custom.find("zy") == nullptr);
+    }
+    std::println("Test unindexed codes: OK");
+
     std::println("All CountryAdapter tests passed!");
   } catch (const std::exception &e) {
     std::cerr << "Test failed with exception: " << e.what() << std::endl;
@@ -0,0 +1,101 @@
+/**
+ * SPDX-FileComment: Unit test for the local Country Info adapter.
+ * SPDX-FileType: SOURCE
+ * SPDX-FileContributor: ZHENG Robert
+ * SPDX-FileCopyrightText: 2026 ZHENG Robert
+ * SPDX-License-Identifier: MIT
+ *
+ * @file test_country_info_local.cpp
+ * @brief Test case for country_info lookups answered from countries.json.
+ * @version 0.1.0
+ * @date 2026-10-19
+ *
+ * @author ZHENG Robert
+ * @license MIT License
+ */
+
+#include "regeocode/adapter_country_info_local.hpp"
+#include "regeocode/http_client.hpp"
+#include "regeocode/re_geocode_core.hpp"
+#include "test_support.hpp"
+
+#include <cassert>
+#include <iostream>
+#include <memory>
+#include <print>
+#include <stdexcept>
+
+namespace {
+/**
+ * @brief HttpClient that fails the test if a request is sent.
+ */
+class NoNetworkHttpClient : public regeocode::HttpClient {
+public:
+  regeocode::HttpResponse
+  get(const std::string &url, long /*timeout*/,
+      const regeocode::HttpRequestOptions & /*options*/) const override {
+    throw std::runtime_error("Unexpected HTTP request: " + url);
+  }
+};
+} // namespace
+
+/**
+ * @brief Main function for the local country info test.
+ *
+ * @return int Exit code (0 for success).
+ */
+int main() {
+  using namespace regeocode;
+
+  try {
+    ApiConfig cfg;
+    cfg.name = "country_info";
+    cfg.uri_template = "https://restcountries.com/v3.1/alpha/{{ country_code }}";
+    cfg.api_key = "DE";
+    cfg.adapter = "country_info";
+    cfg.type = "info";
+
+    std::unordered_map<std::string, ApiConfig> configs;
+    configs["country_info"] = cfg;
+
+    std::vector<ApiAdapterPtr> adapters;
+    adapters.push_back(
+        std::make_unique<LocalCountryInfoAdapter>("data/countries.json"));
+
+    ReverseGeocoder geocoder(std::move(configs), std::move(adapters),
+                             std::make_unique<NoNetworkHttpClient>(),
+                             regeocode::test::quota_file());
+
+    // Test China (country code from coordinates)
+    auto cn = geocoder.reverse_geocode({0.0, 0.0, "cn"}, "country_info");
+    assert(cn.country_code == "CN");
+    assert(cn.address_english == "People's Republic of China");
+    assert(cn.address_local == "China");
+    assert(cn.attributes["cca3"] == "CHN");
+    assert(cn.attributes["capital"] == "[\"Beijing\"]");
+    assert(cn.attributes["region"] == "Asia");
+    assert(cn.attributes["subregion"] == "Eastern Asia");
+    assert(cn.attributes["continents"] == "[\"Asia\"]");
+    assert(cn.attributes["flag_svg"] == "https://flagcdn.com/cn.svg");
+    assert(cn.attributes.contains("currencies"));
+    std::println("Test CN: OK");
+
+    // Test Germany (country code from API-Key)
+    auto de = geocoder.reverse_geocode({0.0, 0.0, ""}, "country_info");
+    assert(de.attributes["cca3"] == "DEU");
+    assert(de.attributes["continents"] == "[\"Europe\"]");
+    std::println("Test DE: OK");
+
+    // Test Brazil (continent derived from subregion)
+    auto br = geocoder.reverse_geocode({0.0, 0.0, "BR"}, "country_info");
+    assert(br.attributes["continents"] == "[\"South America\"]");
+    std::println("Test BR: OK");
+
+    std::println("All LocalCountryInfoAdapter tests passed!");
+  } catch (const std::exception &e) {
+    std::cerr << "Test failed with exception: " << e.what() << std::endl;
+    return 1;
+  }
+
+  return 0;
+}
@@ -0,0 +1,293 @@
+/**
+ * SPDX-FileComment: Unit test for the HTTP response cache.
+ * SPDX-FileType: SOURCE
+ * SPDX-FileContributor: ZHENG Robert
+ * SPDX-FileCopyrightText: 2026 ZHENG Robert
+ * SPDX-License-Identifier: MIT
+ *
+ * @file test_http_cache.cpp
+ * @brief Test cases for HttpCache freshness, revalidation, eviction and the
+ *        cache statistics of ReverseGeocoder.
+ * @version 0.1.0
+ * @date 2026-10-19
+ *
+ * @author ZHENG Robert
+ * @license MIT License
+ */
+
+#include "regeocode/adapter_country_info.hpp"
+#include "regeocode/http_cache.hpp"
+#include "regeocode/re_geocode_core.hpp"
+#include "regeocode/tracing.hpp"
+#include "test_support.hpp"
+
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <print>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+namespace {
+/**
+ * @brief HttpClient acting as an origin server with one versioned resource.
+ *
+ * Answers 304 when If-None-Match carries the current ETag.
+ */
+class OriginHttpClient : public regeocode::HttpClient {
+public:
+  explicit OriginHttpClient(std::string body) : body(std::move(body)) {}
+
+  regeocode::HttpResponse
+  get(const std::string & /*url*/, long /*timeout*/,
+      const regeocode::HttpRequestOptions &options) const override {
+    ++calls;
+    last_if_none_match = options.if_none_match;
+    regeocode::HttpResponse response;
+    response.etag = etag;
+    response.cache_control = cache_control;
+    response.expires = expires;
+    if (!etag.empty() && options.if_none_match == etag) {
+      response.status_code = 304;
+      ++not_modified;
+      return response;
+    }
+    response.status_code = 200;
+    response.body = body;
+    return response;
+  }
+
+  std::string body;
+  std::string etag = "\"v1\"";
+  std::string cache_control = "max-age=3600";
+  std::string expires;
+  mutable std::size_t calls = 0;
+  mutable std::size_t not_modified = 0;
+  mutable std::string last_if_none_match;
+};
+
+/// Runs a hook when the first quota span ends.
+class QuotaHook : public regeocode::TraceSink {
+public:
+  explicit QuotaHook(std::function<void()> hook) : hook_(std::move(hook)) {}
+  void record(const regeocode::SpanRecord &span) override {
+    if (span.name == "quota" && !fired_.exchange(true))
+      hook_();
+  }
+
+private:
+  std::function<void()> hook_;
+  std::atomic<bool> fired_{false};
+};
+} // namespace
+
+/**
+ * @brief Main function for the HTTP cache test.
+ *
+ * @return int Exit code (0 for success).
+ */
+int main() {
+  using namespace regeocode;
+  using Kind = CacheOutcome::Kind;
+
+  try {
+    const std::string url = "http://origin/resource";
+
+    // Test fresh responses are served without a request
+    {
+      HttpCache cache;
+      OriginHttpClient origin("hello");
+      CacheOutcome outcome;
+      auto r = cache.fetch(origin, url, 5, {}, &outcome);
+      assert(outcome.kind == Kind::Miss && r.body == "hello");
+      r = cache.fetch(origin, url, 5, {}, &outcome);
+      assert(outcome.kind == Kind::Fresh && r.status_code == 200);
+      assert(r.body == "hello" && outcome.saved_bytes == 5);
+      assert(origin.calls == 1 && cache.fresh(url));
+    }
+    std::println("Test fresh: OK");
+
+    // Test stale responses are revalidated; a 304 keeps the body
+    {
+      HttpCache cache;
+      OriginHttpClient origin("hello");
+      origin.cache_control = "max-age=0";
+      CacheOutcome outcome;
+      cache.fetch(origin, url, 5, {}, &outcome);
+      assert(!cache.fresh(url) && cache.entries() == 1);
+      auto r = cache.fetch(origin, url, 5, {}, &outcome);
+      assert(origin.last_if_none_match == "\"v1\"");
+      assert(outcome.kind == Kind::Revalidated && r.status_code == 200);
+      assert(r.body == "hello" && outcome.saved_bytes == 5);
+
+      // A new version replaces the entry
+      origin.etag = "\"v2\"";
+      origin.body = "world";
+      r = cache.fetch(origin, url, 5, {}, &outcome);
+      assert(outcome.kind == Kind::Miss && r.body == "world");
+      r = cache.fetch(origin, url, 5, {}, &outcome);
+      assert(outcome.kind == Kind::Revalidated && r.body == "world");
+      assert(origin.not_modified == 2);
+    }
+    std::println("Test revalidation: OK");
+
+    // Test caching headers: no-store, no-cache, Age, Expires
+    {
+      HttpResponse response;
+      response.status_code = 200;
+      response.body = "x";
+      const std::chrono::microseconds fetch_time{100};
+
+      HttpCache cache;
+      response.cache_control = "private, no-store";
+      cache.store(url, response, fetch_time);
+      assert(cache.entries() == 0);
+
+      response.cache_control = "no-cache";
+      response.etag = "\"a\"";
+      cache.store(url, response, fetch_time);
+      assert(cache.entries() == 1 && !cache.fresh(url));
+
+      response.cache_control = "max-age=60";
+      response.age = "60";
+      cache.store(url, response, fetch_time);
+      assert(!cache.fresh(url));
+      response.age = "59";
+      cache.store(url, response, fetch_time);
+      assert(cache.fresh(url));
+
+      response.cache_control.clear();
+      response.age.clear();
+      response.expires = "Thu, 01 Jan 2099 00:00:00 GMT";
+      cache.store(url, response, fetch_time);
+      assert(cache.fresh(url));
+      response.expires = "0"; // invalid: already expired
+      cache.store(url, response, fetch_time);
+      assert(!cache.fresh(url) && cache.entries() == 1);
+
+      // Neither freshness nor validators: not kept
+      response.expires.clear();
+      response.etag.clear();
+      cache.store(url, response, fetch_time);
+      assert(cache.entries() == 0);
+
+      // Errors are not kept
+      response.cache_control = "max-age=60";
+      response.status_code = 404;
+      cache.store(url, response, fetch_time);
+      assert(cache.entries() == 0);
+
+      // Nor answers for one user, or chosen by request headers the key
+      // does not hold
+      response.status_code = 200;
+      response.cache_control = "private, max-age=60";
+      cache.store(url, response, fetch_time);
+      assert(cache.entries() == 0);
+      response.cache_control = "max-age=60";
+      for (const char *vary :
+           {"*", "Accept-Language", "accept-encoding, Cookie"}) {
+        response.vary = vary;
+        cache.store(url, response, fetch_time);
+        assert(cache.entries() == 0);
+      }
+      response.vary = "Accept-Encoding";
+      cache.store(url, response, fetch_time);
+      assert(cache.fresh(url));
+    }
+    std::println("Test directives: OK");
+
+    // Test least recently used entries are evicted first
+    {
+      HttpCache cache(8 * 100);
+      HttpResponse response;
+      response.status_code = 200;
+      response.cache_control = "max-age=60";
+      response.body = std::string(100, 'x');
+      for (const char *u : {"a", "b", "c", "d", "e", "f", "g", "h"})
+        cache.store(u, response, {});
+      assert(cache.entries() == 8 && cache.size_bytes() == 800);
+      assert(cache.fresh("a")); // now most recently used
+      cache.store("i", response, {});
+      assert(cache.entries() == 8 && cache.fresh("a") && !cache.fresh("b"));
+      response.body = std::string(101, 'x'); // above capacity / 8
+      cache.store("j", response, {});
+      assert(!cache.fresh("j"));
+    }
+    std::println("Test eviction: OK");
+
+    // Test the geocoder serves info APIs from the cache and counts savings
+    {
+      ApiConfig cfg;
+      cfg.name = "country_info";
+      cfg.adapter = "country_info";
+      cfg.type = "info";
+      cfg.uri_template = "http://origin/alpha/{{ country_code }}";
+      cfg.http_cache = true;
+
+      std::vector<ApiAdapterPtr> adapters;
+      adapters.push_back(std::make_unique<CountryInfoAdapter>());
+      auto client =
+          std::make_unique<OriginHttpClient>(test::read_fixture("country_info"));
+      const auto *origin = client.get();
+      ReverseGeocoder geocoder({{"country_info", cfg}}, std::move(adapters),
+                               std::move(client), regeocode::test::quota_file());
+
+      const Coordinates where{48.137, 11.576, "de"};
+      const auto first = geocoder.reverse_geocode(where, "country_info");
+      const auto second = geocoder.reverse_geocode(where, "country_info");
+      assert(first.address_english == second.address_english);
+      assert(origin->calls == 1);
+      auto stats = geocoder.transfer_stats("country_info");
+      assert(stats.requests == 1 && stats.cache_hits == 1);
+      assert(stats.saved_bytes == origin->body.size());
+    }
+    std::println("Test geocoder cache: OK");
+
+#if REGEOCODE_TRACING
+    // Test a lookup finding the entry another one filled after its quota
+    // check gives its slot back
+    {
+      ApiConfig cfg;
+      cfg.name = "country_info";
+      cfg.adapter = "country_info";
+      cfg.type = "info";
+      cfg.uri_template = "http://origin/alpha/{{ country_code }}";
+      cfg.http_cache = true;
+      cfg.daily_limit = 10;
+
+      std::vector<ApiAdapterPtr> adapters;
+      adapters.push_back(std::make_unique<CountryInfoAdapter>());
+      auto client =
+          std::make_unique<OriginHttpClient>(test::read_fixture("country_info"));
+      const auto *origin = client.get();
+      const test::TempFile quota("race_quota.json");
+      ReverseGeocoder geocoder({{"country_info", cfg}}, std::move(adapters),
+                               std::move(client), quota.path());
+
+      // Between the quota span and the fetch, another lookup fills the entry
+      const Coordinates where{48.137, 11.576, "fr"};
+      geocoder.set_trace_sink(std::make_shared<QuotaHook>([&] {
+        std::thread([&] { geocoder.reverse_geocode(where, "country_info"); })
+            .join();
+      }));
+      geocoder.reverse_geocode(where, "country_info");
+      assert(origin->calls == 1);
+      const ApiSnapshot m = geocoder.metrics().apis.at("country_info");
+      assert(m[Counter::CacheHits] == 1 && m[Counter::Requests] == 1);
+      assert(m[Counter::QuotaConsumed] == 2 && m[Counter::QuotaReleased] == 1);
+    }
+    std::println("Test cache race refund: OK");
+#endif
+
+    std::println("All HTTP cache tests passed!");
+  } catch (const std::exception &e) {
+    std::cerr << "Test failed with exception: " << e.what() << std::endl;
+    return 1;
+  }
+
+  return 0;
+}
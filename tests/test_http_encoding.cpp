@@ -0,0 +1,207 @@
+/**
+ * SPDX-FileComment: Unit test for compressed transfers.
+ * SPDX-FileType: SOURCE
+ * SPDX-FileContributor: ZHENG Robert
+ * SPDX-FileCopyrightText: 2026 ZHENG Robert
+ * SPDX-License-Identifier: MIT
+ *
+ * @file test_http_encoding.cpp
+ * @brief Test cases for Accept-Encoding negotiation and gzip decoding by the
+ *        real HttpClient against a loopback provider.
+ * @version 0.1.0
+ * @date 2026-10-19
+ *
+ * @author ZHENG Robert
+ * @license MIT License
+ */
+
+#include "regeocode/adapter_nominatim.hpp"
+#include "regeocode/http_client.hpp"
+#include "regeocode/re_geocode_core.hpp"
+#include "loopback_server.hpp"
+#include "test_support.hpp"
+
+#include <zlib.h>
+
+#include <cassert>
+#include <future>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <print>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace {
+/// gzip-compresses @p data in one shot.
+std::string gzip(const std::string &data) {
+  z_stream zs{};
+  deflateInit2(&zs, Z_DEFAULT_COMPRESSION, Z_DEFLATED, 15 + 16, 8,
+               Z_DEFAULT_STRATEGY);
+  std::string out(deflateBound(&zs, data.size()) + 32, '\0');
+  zs.next_in = reinterpret_cast<Bytef *>(const_cast<char *>(data.data()));
+  zs.avail_in = static_cast<uInt>(data.size());
+  zs.next_out = reinterpret_cast<Bytef *>(out.data());
+  zs.avail_out = static_cast<uInt>(out.size());
+  deflate(&zs, Z_FINISH);
+  out.resize(zs.total_out);
+  deflateEnd(&zs);
+  return out;
+}
+
+/**
+ * @brief Nominatim stand-in that gzips its answer when the request offers
+ * gzip, and remembers the Accept-Encoding it was sent.
+ */
+class GzipProvider {
+public:
+  GzipProvider()
+      : body_(regeocode::test::read_fixture("nominatim")),
+        gzipped_(gzip(body_)),
+        server_([this](const regeocode::test::LoopbackRequest &request) {
+          const std::string offered = request.header("Accept-Encoding");
+          {
+            std::lock_guard lock(mutex_);
+            offered_.push_back(offered);
+          }
+          regeocode::test::LoopbackReply reply;
+          reply.chunked = request.target.find("chunked") != std::string::npos;
+          if (offered.find("gzip") == std::string::npos) {
+            reply.body = body_;
+            return reply;
+          }
+          reply.body = gzipped_;
+          reply.headers = "Content-Encoding: gzip\r\n";
+          return reply;
+        }) {}
+
+  std::string url(std::string_view target = "/reverse") const {
+    return server_.url(target);
+  }
+  const std::string &body() const { return body_; }
+  const std::string &gzipped() const { return gzipped_; }
+  /// Accept-Encoding of the last request ("" if none was sent).
+  std::string last_offered() const {
+    std::lock_guard lock(mutex_);
+    return offered_.empty() ? "" : offered_.back();
+  }
+
+private:
+  std::string body_;
+  std::string gzipped_;
+  mutable std::mutex mutex_;
+  std::vector<std::string> offered_;
+  regeocode::test::LoopbackServer server_;
+};
+} // namespace
+
+/**
+ * @brief Main function for the HTTP encoding test.
+ *
+ * @return int Exit code (0 for success).
+ */
+int main() {
+  using namespace regeocode;
+
+  try {
+    GzipProvider provider;
+    assert(provider.gzipped().size() < provider.body().size());
+
+    // Test a gzip answer is decoded; wire bytes are the compressed size
+    {
+      const HttpClient client;
+      for (const std::string_view target : {"/reverse", "/reverse?chunked"}) {
+        HttpRequestOptions gzip_only;
+        gzip_only.accept_encoding = "gzip";
+        const HttpResponse r = client.get(provider.url(target), 5, gzip_only);
+        assert(r.status_code == 200);
+        assert(provider.last_offered() == "gzip");
+        assert(std::string_view(r.body) == provider.body());
+        assert(r.wire_bytes == provider.gzipped().size());
+      }
+
+      // auto offers every coding libcurl has, which includes gzip
+      const HttpResponse automatic = client.get(provider.url(), 5);
+      assert(provider.last_offered().find("gzip") != std::string::npos);
+      assert(std::string_view(automatic.body) == provider.body());
+      assert(automatic.wire_bytes == provider.gzipped().size());
+    }
+    std::println("Test gzip decoding: OK");
+
+    // Test identity sends no Accept-Encoding and gets the plain body
+    {
+      const HttpClient client;
+      HttpRequestOptions identity;
+      identity.accept_encoding = "identity";
+      const HttpResponse r = client.get(provider.url(), 5, identity);
+      assert(provider.last_offered().empty());
+      assert(std::string_view(r.body) == provider.body());
+      assert(r.wire_bytes == provider.body().size());
+    }
+    std::println("Test identity: OK");
+
+    // Test the engine decodes the same way; bodies of unknown length are
+    // handed over from the transfer's own buffer
+    {
+      HttpClientOptions options;
+      options.multiplex = true;
+      const HttpClient client(options);
+      for (const std::string_view encoding : {"gzip", "identity"}) {
+        for (const std::string_view target : {"/reverse", "/reverse?chunked"}) {
+          HttpRequestOptions request;
+          request.accept_encoding = encoding;
+          std::promise<HttpResponse> received;
+          client.get_async(provider.url(target), 5, request, {},
+                           [&](HttpResponse r) {
+                             received.set_value(std::move(r));
+                           });
+          const HttpResponse r = received.get_future().get();
+          assert(std::string_view(r.body) == provider.body());
+          assert(r.wire_bytes == (encoding == "gzip"
+                                      ? provider.gzipped().size()
+                                      : provider.body().size()));
+        }
+      }
+    }
+    std::println("Test engine gzip decoding: OK");
+
+    // Test the geocoder passes accept-encoding on, parses the decoded
+    // answers and counts wire against decoded bytes
+    for (const std::string encoding : {"gzip", "identity"}) {
+      ApiConfig cfg;
+      cfg.name = "nominatim";
+      cfg.adapter = "nominatim";
+      cfg.uri_template = provider.url("/reverse?lat={{ latitude }}");
+      cfg.accept_encoding = encoding;
+      std::vector<ApiAdapterPtr> adapters;
+      adapters.push_back(std::make_unique<NominatimAdapter>());
+      ReverseGeocoder geocoder({{cfg.name, cfg}}, std::move(adapters),
+                               std::make_unique<HttpClient>(),
+                               regeocode::test::quota_file());
+
+      for (int i = 0; i < 2; ++i) {
+        const AddressResult res =
+            geocoder.reverse_geocode({48.137 + i, 11.576, ""}, "nominatim");
+        assert(res.country_code == "de");
+        assert(res.attributes.at("city") == "München");
+      }
+      assert(provider.last_offered() == (encoding == "gzip" ? "gzip" : ""));
+      const TransferStats stats = geocoder.transfer_stats("nominatim");
+      const std::uint64_t wire = encoding == "gzip"
+                                     ? provider.gzipped().size()
+                                     : provider.body().size();
+      assert(stats.requests == 2);
+      assert(stats.decoded_bytes == 2 * provider.body().size());
+      assert(stats.wire_bytes == 2 * wire);
+    }
+    std::println("Test geocoder transfer stats: OK");
+
+    std::println("All HTTP encoding tests passed!");
+  } catch (const std::exception &e) {
+    std::cerr << "Test failed with exception: " << e.what() << std::endl;
+    return 1;
+  }
+
+  return 0;
+}
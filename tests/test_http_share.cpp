@@ -0,0 +1,153 @@
+/**
+ * SPDX-FileComment: Unit test for the shared HTTP caches.
+ * SPDX-FileType: SOURCE
+ * SPDX-FileContributor: ZHENG Robert
+ * SPDX-FileCopyrightText: 2026 ZHENG Robert
+ * SPDX-License-Identifier: MIT
+ *
+ * @file test_http_share.cpp
+ * @brief Test cases for HttpShare: lifetime, connections shared between
+ *        clients, the process-wide shares and the engine limits the
+ *        ConfigLoader gives them.
+ * @version 0.1.0
+ * @date 2026-10-19
+ *
+ * @author ZHENG Robert
+ * @license MIT License
+ */
+
+#include "regeocode/http_client.hpp"
+#include "regeocode/re_geocode_core.hpp"
+#include "loopback_server.hpp"
+#include "test_support.hpp"
+
+#include <cassert>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <latch>
+#include <memory>
+#include <print>
+#include <string>
+#include <string_view>
+
+namespace {
+using namespace std::chrono_literals;
+
+/// Echoes the request target after 100 ms.
+regeocode::test::LoopbackReply
+slow_echo(const regeocode::test::LoopbackRequest &request) {
+  regeocode::test::LoopbackReply reply;
+  reply.body = request.target;
+  reply.delay = 100ms;
+  return reply;
+}
+
+/// Runs @p n concurrent transfers to @p url on @p client.
+void get_concurrently(const regeocode::HttpClient &client,
+                      const std::string &url, int n) {
+  std::latch done(n);
+  for (int i = 0; i < n; ++i)
+    client.get_async(url, 5, {}, {}, [&](regeocode::HttpResponse r) {
+      assert(r.status_code == 200);
+      done.count_down();
+    });
+  done.wait();
+}
+
+/// Loads an INI with the given [config] lines.
+regeocode::Configuration load(const regeocode::test::TempFile &ini,
+                              const std::string &config) {
+  std::ofstream(ini.path()) << "[config]\n" << config << "type = config\n\n"
+                            << "[nominatim]\nURI = http://127.0.0.1/\n"
+                               "API-Key =\nAdapter = nominatim\n";
+  return regeocode::ConfigLoader(ini.path()).load();
+}
+} // namespace
+
+/**
+ * @brief Main function for the HTTP share test.
+ *
+ * @return int Exit code (0 for success).
+ */
+int main() {
+  using namespace regeocode;
+
+  try {
+    // Test a share outlives the clients attached to it
+    {
+      HttpClientOptions shared;
+      shared.multiplex = true;
+      shared.share = std::make_shared<HttpShare>();
+      const std::weak_ptr<HttpShare> watch = shared.share;
+      const HttpClient first(shared), second(shared);
+      shared.share.reset();
+      assert(!watch.expired());
+    }
+    std::println("Test share lifetime: OK");
+
+    // Test clients on one share use one connection; separate ones do not
+    for (const bool share : {true, false}) {
+      test::LoopbackServer server(slow_echo);
+      HttpClientOptions options;
+      options.multiplex = true;
+      if (share)
+        options.share = std::make_shared<HttpShare>();
+      const HttpClient first(options), second(options);
+      for (int i = 0; i < 3; ++i) {
+        assert(std::string_view(first.get(server.url("/a"), 5).body) == "/a");
+        assert(std::string_view(second.get(server.url("/b"), 5).body) == "/b");
+      }
+      assert(server.requests() == 6);
+      assert(server.connections() == (share ? 1u : 2u));
+    }
+    std::println("Test shared connections: OK");
+
+    // Test one process-wide share per set of options
+    {
+      assert(HttpShare::process() == HttpShare::process());
+      HttpShareOptions limited;
+      limited.max_host_connections = 1;
+      assert(HttpShare::process(limited) == HttpShare::process(limited));
+      assert(HttpShare::process(limited) != HttpShare::process());
+    }
+    std::println("Test process shares: OK");
+
+    // Test the INI's engine limits hold with the default shared-cache
+    {
+      const test::TempFile ini("share.ini");
+      const Configuration config =
+          load(ini, "multiplex = true\nmax-host-connections = 1\n"
+                    "max-concurrent-streams = 7\n");
+      assert(config.http.max_host_connections == 1);
+      assert(config.http.max_concurrent_streams == 7);
+      HttpShareOptions expected;
+      expected.max_host_connections = 1;
+      expected.max_concurrent_streams = 7;
+      assert(config.http.share == HttpShare::process(expected));
+
+      test::LoopbackServer server(slow_echo);
+      const HttpClient client(config.http);
+      const auto started = std::chrono::steady_clock::now();
+      get_concurrently(client, server.url("/limited"), 4);
+      assert(std::chrono::steady_clock::now() - started >= 400ms);
+      assert(server.connections() == 1);
+
+      // Without a limit the same transfers overlap
+      test::LoopbackServer open(slow_echo);
+      const HttpClient unlimited(load(ini, "multiplex = true\n").http);
+      get_concurrently(unlimited, open.url("/open"), 4);
+      assert(open.connections() > 1);
+
+      assert(!load(ini, "shared-cache = false\n").http.share);
+    }
+    std::println("Test configured limits: OK");
+
+    std::println("All HTTP share tests passed!");
+  } catch (const std::exception &e) {
+    std::cerr << "Test failed with exception: " << e.what() << std::endl;
+    return 1;
+  }
+
+  return 0;
+}
@@ -0,0 +1,649 @@
+/**
+ * SPDX-FileComment: Unit test for the on-demand JSON scanner.
+ * SPDX-FileType: SOURCE
+ * SPDX-FileContributor: ZHENG Robert
+ * SPDX-FileCopyrightText: 2026 ZHENG Robert
+ * SPDX-License-Identifier: MIT
+ *
+ * @file test_json_scan.cpp
+ * @brief Test cases for json_scan and the adapters built on it, checked
+ *        against the nlohmann::json parses they replaced.
+ * @version 0.1.0
+ * @date 2026-10-19
+ *
+ * @author ZHENG Robert
+ * @license MIT License
+ */
+
+#include "regeocode/adapter_bing.hpp"
+#include "regeocode/adapter_country_info.hpp"
+#include "regeocode/adapter_geonames_timezone.hpp"
+#include "regeocode/adapter_geonames_wikipedia.hpp"
+#include "regeocode/adapter_google.hpp"
+#include "regeocode/adapter_marea_tides.hpp"
+#include "regeocode/adapter_nominatim.hpp"
+#include "regeocode/adapter_opencage.hpp"
+#include "regeocode/adapter_openweather.hpp"
+#include "regeocode/adapter_pollution.hpp"
+#include "regeocode/adapter_seaweather.hpp"
+#include "regeocode/adapter_tides.hpp"
+#include "regeocode/json_scan.hpp"
+#include "regeocode/re_geocode_core.hpp"
+#include "test_support.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <print>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+namespace {
+/**
+ * @brief The nlohmann::json parses the adapters used before json_scan,
+ * kept as the reference the scanning adapters must reproduce.
+ */
+namespace dom {
+using nlohmann::json;
+
+struct Parsed {
+  std::string address_english;
+  std::string address_local;
+  std::string country_code;
+  std::map<std::string, std::string> attributes;
+};
+
+std::string get_string_safe(const json &j, const std::string &key) {
+  if (j.contains(key) && j[key].is_string())
+    return j[key].get<std::string>();
+  return "";
+}
+
+std::string get_stringified_safe(const json &j, const std::string &key) {
+  if (!j.contains(key))
+    return "";
+  return j[key].is_string() ? j[key].get<std::string>() : j[key].dump();
+}
+
+/// Nominatim and OpenCage pick the first of city, town and village.
+std::string city_of(const json &j) {
+  for (const char *key : {"city", "town", "village"})
+    if (j.contains(key))
+      return get_string_safe(j, key);
+  return "";
+}
+
+Parsed nominatim(const std::string &body) {
+  const json j = json::parse(body);
+  Parsed res;
+  res.address_english = get_string_safe(j, "display_name");
+  res.address_local = res.address_english;
+  if (j.contains("address") && j["address"].is_object()) {
+    const auto &addr = j["address"];
+    res.country_code = get_string_safe(addr, "country_code");
+    res.attributes["country"] = get_string_safe(addr, "country");
+    res.attributes["state"] = get_string_safe(addr, "state");
+    res.attributes["city"] = city_of(addr);
+  }
+  return res;
+}
+
+Parsed google(const std::string &body) {
+  const json j = json::parse(body);
+  Parsed res;
+  if (!j.contains("results") || !j["results"].is_array() ||
+      j["results"].empty())
+    return res;
+  const auto &first = j["results"][0];
+  res.address_english = get_string_safe(first, "formatted_address");
+  res.address_local = res.address_english;
+  if (!first.contains("address_components") ||
+      !first["address_components"].is_array())
+    return res;
+  for (const auto &comp : first["address_components"]) {
+    if (!comp.is_object() || !comp.contains("types") ||
+        !comp["types"].is_array())
+      continue;
+    const auto &types = comp["types"];
+    const auto has = [&](const char *type) {
+      return std::find(types.begin(), types.end(), type) != types.end();
+    };
+    if (has("country")) {
+      res.country_code = get_string_safe(comp, "short_name");
+      res.attributes["country"] = get_string_safe(comp, "long_name");
+    }
+    if (has("administrative_area_level_1"))
+      res.attributes["state"] = get_string_safe(comp, "long_name");
+    if (has("locality"))
+      res.attributes["city"] = get_string_safe(comp, "long_name");
+  }
+  return res;
+}
+
+Parsed opencage(const std::string &body) {
+  const json j = json::parse(body);
+  Parsed res;
+  if (!j.contains("results") || !j["results"].is_array() ||
+      j["results"].empty())
+    return res;
+  const auto &first = j["results"][0];
+  res.address_english = get_string_safe(first, "formatted");
+  res.address_local = res.address_english;
+  if (first.contains("components") && first["components"].is_object()) {
+    const auto &comp = first["components"];
+    res.country_code = get_string_safe(comp, "country_code");
+    res.attributes["continent"] = get_string_safe(comp, "continent");
+    res.attributes["country"] = get_string_safe(comp, "country");
+    res.attributes["state"] = get_string_safe(comp, "state");
+    res.attributes["city"] = city_of(comp);
+  }
+  return res;
+}
+
+Parsed bing(const std::string &body) {
+  Parsed res;
+  try {
+    const json root = json::parse(body);
+    if (!root.contains("addresses") || !root["addresses"].is_array() ||
+        root["addresses"].empty())
+      return res;
+    const auto &first_hit = root["addresses"][0];
+    if (first_hit.contains("address")) {
+      const auto &addr = first_hit["address"];
+      if (addr.contains("freeformAddress")) {
+        res.address_english = addr["freeformAddress"].get<std::string>();
+        res.address_local = res.address_english;
+      }
+      if (addr.contains("countryCode"))
+        res.country_code = addr["countryCode"].get<std::string>();
+      for (const auto &[key, val] : addr.items()) {
+        if (val.is_string()) {
+          res.attributes[key] = val.get<std::string>();
+          if (key == "countrySubdivision")
+            res.attributes["state"] = val.get<std::string>();
+          if (key == "municipality")
+            res.attributes["city"] = val.get<std::string>();
+        } else if (val.is_number_integer()) {
+          res.attributes[key] = std::to_string(val.get<long>());
+        } else if (val.is_number()) {
+          res.attributes[key] = std::to_string(val.get<double>());
+        } else if (val.is_boolean()) {
+          res.attributes[key] = val.get<bool>() ? "true" : "false";
+        }
+      }
+    }
+    if (first_hit.contains("position"))
+      res.attributes["position_raw"] = first_hit["position"].get<std::string>();
+  } catch (const std::exception &) {
+  }
+  return res;
+}
+
+Parsed country_info(const std::string &body) {
+  const json full = json::parse(body);
+  Parsed res;
+  if (!full.is_array() || full.empty())
+    return res;
+  const auto &j = full[0];
+  res.country_code = get_string_safe(j, "cca2");
+  res.address_english = get_stringified_safe(j.at("name"), "official");
+  res.address_local = get_stringified_safe(j.at("name"), "common");
+  res.attributes["cca2"] = res.country_code;
+  res.attributes["cca3"] = get_string_safe(j, "cca3");
+  res.attributes["capital"] = get_stringified_safe(j, "capital");
+  res.attributes["region"] = get_string_safe(j, "region");
+  res.attributes["subregion"] = get_string_safe(j, "subregion");
+  if (j.contains("maps") && j["maps"].is_object())
+    res.attributes["maps_osm"] = get_string_safe(j["maps"], "openStreetMaps");
+  res.attributes["continents"] = get_stringified_safe(j, "continents");
+  if (j.contains("name") && j["name"].is_object()) {
+    res.attributes["name_official"] = get_string_safe(j["name"], "official");
+    res.attributes["name_common"] = get_string_safe(j["name"], "common");
+  }
+  res.attributes["currencies"] = get_stringified_safe(j, "currencies");
+  if (j.contains("flags") && j["flags"].is_object()) {
+    res.attributes["flag_png"] = get_string_safe(j["flags"], "png");
+    res.attributes["flag_svg"] = get_string_safe(j["flags"], "svg");
+    res.attributes["flag_alt"] = get_string_safe(j["flags"], "alt");
+  }
+  return res;
+}
+
+Parsed timezone(const std::string &body) {
+  Parsed res;
+  try {
+    const json j = json::parse(body);
+    if (j.contains("status"))
+      return res;
+    if (j.contains("countryCode"))
+      res.country_code = j["countryCode"].get<std::string>();
+    if (j.contains("timezoneId")) {
+      res.address_english = j["timezoneId"].get<std::string>();
+      res.attributes["timezone_id"] = res.address_english;
+    }
+    if (j.contains("time")) {
+      res.address_local = j["time"].get<std::string>();
+      res.attributes["local_time"] = res.address_local;
+    }
+    if (j.contains("gmtOffset")) {
+      std::ostringstream oss;
+      oss << j["gmtOffset"].get<double>();
+      res.attributes["gmt_offset"] = oss.str();
+    }
+    if (j.contains("countryName")) {
+      const std::string name = j["countryName"].get<std::string>();
+      res.address_english = res.address_english.empty()
+                                ? name
+                                : res.address_english + " (" + name + ")";
+    }
+  } catch (const json::exception &) {
+  }
+  return res;
+}
+
+Parsed wikipedia(const std::string &body) {
+  Parsed res;
+  try {
+    const json j = json::parse(body);
+    if (!j.contains("geonames") || !j["geonames"].is_array() ||
+        j["geonames"].empty())
+      return res;
+    const auto &first = j["geonames"][0];
+    if (first.contains("title"))
+      res.address_english = first["title"].get<std::string>();
+    if (first.contains("summary"))
+      res.address_local = first["summary"].get<std::string>();
+    if (first.contains("wikipediaUrl")) {
+      const std::string url = first["wikipediaUrl"].get<std::string>();
+      res.address_local = res.address_local.empty()
+                              ? url
+                              : res.address_local + " (" + url + ")";
+    }
+    if (first.contains("countryCode"))
+      res.country_code = first["countryCode"].get<std::string>();
+  } catch (const json::exception &) {
+  }
+  return res;
+}
+
+Parsed openweather(const std::string &body) {
+  Parsed res;
+  try {
+    const json j = json::parse(body);
+    if (j.contains("name"))
+      res.address_english = j["name"].get<std::string>();
+    if (j.contains("sys") && j["sys"].contains("country"))
+      res.country_code = j["sys"]["country"].get<std::string>();
+    if (j.contains("weather") && !j["weather"].empty()) {
+      res.address_local = j["weather"][0]["description"].get<std::string>();
+      res.attributes["condition"] = res.address_local;
+    }
+    if (j.contains("main")) {
+      const auto &m = j["main"];
+      res.attributes["temp"] = std::to_string(m.value("temp", 0.0));
+      res.attributes["feels_like"] = std::to_string(m.value("feels_like", 0.0));
+      res.attributes["pressure"] = std::to_string(m.value("pressure", 0));
+      res.attributes["humidity"] = std::to_string(m.value("humidity", 0));
+    }
+    if (j.contains("wind")) {
+      res.attributes["wind_speed"] =
+          std::to_string(j["wind"].value("speed", 0.0));
+      res.attributes["wind_deg"] = std::to_string(j["wind"].value("deg", 0));
+    }
+  } catch (...) {
+  }
+  return res;
+}
+
+Parsed pollution(const std::string &body) {
+  Parsed res;
+  try {
+    const json j = json::parse(body);
+    if (!j.contains("list") || j["list"].empty())
+      return res;
+    const auto &first = j["list"][0];
+    if (first.contains("main") && first["main"].contains("aqi")) {
+      const int aqi = first["main"]["aqi"].get<int>();
+      static const char *ratings[] = {"",         "Good", "Fair",
+                                      "Moderate", "Poor", "Very Poor"};
+      res.attributes["aqi"] = std::to_string(aqi);
+      res.address_english = std::string("Air Quality: ") +
+                            (aqi >= 1 && aqi <= 5 ? ratings[aqi] : "Unknown");
+    }
+    if (first.contains("components"))
+      for (const auto &el : first["components"].items())
+        res.attributes[el.key()] = std::to_string(el.value().get<double>());
+  } catch (...) {
+  }
+  return res;
+}
+
+/// Extremes and current height shared by both tide providers.
+void tide_events(const json &root, const std::string &unit, Parsed &res) {
+  if (root.contains("extremes") && root["extremes"].is_array() &&
+      !root["extremes"].empty()) {
+    int i = 0;
+    for (const auto &item : root["extremes"]) {
+      const std::string prefix = "event_" + std::to_string(i);
+      const std::string state = item["state"];
+      const std::string time = item["datetime"];
+      const double height = item["height"].get<double>();
+      res.attributes[prefix + "_state"] = state;
+      res.attributes[prefix + "_time"] = time;
+      res.attributes[prefix + "_height"] = std::to_string(height);
+      if (i == 0) {
+        std::stringstream ss;
+        ss << state << " (" << std::fixed << std::setprecision(2) << height
+           << unit << ") at " << time;
+        res.address_local = ss.str();
+      }
+      if (++i >= 5)
+        break;
+    }
+  }
+  if (root.contains("heights") && root["heights"].is_array() &&
+      !root["heights"].empty()) {
+    const auto &current = root["heights"][0];
+    if (current.contains("height"))
+      res.attributes["current_height"] =
+          std::to_string(current["height"].get<double>());
+    if (current.contains("state"))
+      res.attributes["current_state"] = current["state"].get<std::string>();
+  }
+}
+
+Parsed marea_tides(const std::string &body) {
+  Parsed res{"Tide Information", "No data available", "", {}};
+  try {
+    const json root = json::parse(body);
+    const std::string unit =
+        root.contains("unit") ? root["unit"].get<std::string>() : "m";
+    res.attributes["unit"] = unit;
+    if (root.contains("copyright"))
+      res.attributes["copyright"] = root["copyright"].get<std::string>();
+    if (root.contains("source"))
+      res.attributes["source"] = root["source"].get<std::string>();
+    if (root.contains("origin")) {
+      const auto &origin = root["origin"];
+      if (origin.contains("distance") && origin.contains("unit")) {
+        std::stringstream ss;
+        ss << std::fixed << std::setprecision(2)
+           << origin["distance"].get<double>() << " "
+           << origin["unit"].get<std::string>();
+        res.attributes["station_distance"] = ss.str();
+      }
+    }
+    if (root.contains("datums"))
+      for (const auto &[key, val] : root["datums"].items())
+        if (val.is_number())
+          res.attributes["datum_" + key] = std::to_string(val.get<double>());
+    tide_events(root, unit, res);
+  } catch (const std::exception &e) {
+    res.attributes["error"] = e.what();
+  }
+  return res;
+}
+
+Parsed tides(const std::string &body) {
+  Parsed res{"Tide Information", "No data available", "", {}};
+  try {
+    const json root = json::parse(body);
+    const std::string unit =
+        root.contains("unit") ? root["unit"].get<std::string>() : "m";
+    res.attributes["unit"] = unit;
+    if (root.contains("disclaimer"))
+      res.attributes["disclaimer"] = root["disclaimer"].get<std::string>();
+    if (root.contains("origin")) {
+      const auto &origin = root["origin"];
+      if (origin.contains("distance") && origin.contains("unit"))
+        res.attributes["station_distance"] =
+            std::to_string(origin["distance"].get<double>()) + " " +
+            origin["unit"].get<std::string>();
+    }
+    tide_events(root, unit, res);
+  } catch (const std::exception &e) {
+    res.attributes["error"] = e.what();
+  }
+  return res;
+}
+
+Parsed seaweather(const std::string &body) {
+  Parsed res{"Sea Weather Conditions", "No data available", "", {}};
+  try {
+    const json root = json::parse(body);
+    if (root.contains("meta")) {
+      const auto &meta = root["meta"];
+      if (meta.contains("lat"))
+        res.attributes["meta_lat"] = std::to_string(meta["lat"].get<double>());
+      if (meta.contains("lng"))
+        res.attributes["meta_lng"] = std::to_string(meta["lng"].get<double>());
+      if (meta.contains("dailyQuota"))
+        res.attributes["meta_dailyQuota"] =
+            std::to_string(meta["dailyQuota"].get<long>());
+      if (meta.contains("requestCount"))
+        res.attributes["meta_requestCount"] =
+            std::to_string(meta["requestCount"].get<long>());
+    }
+    if (!root.contains("hours") || !root["hours"].is_array() ||
+        root["hours"].empty())
+      return res;
+    const auto &current = root["hours"][0];
+    std::stringstream summary;
+    bool first_item = true;
+    if (current.contains("time")) {
+      const std::string t = current["time"].get<std::string>();
+      res.attributes["time"] = t;
+      summary << "Time: " << t << " | ";
+    }
+    for (const auto &[key, val_obj] : current.items()) {
+      if (key == "time" || !val_obj.is_object())
+        continue;
+      for (const auto &[source, value] : val_obj.items()) {
+        std::string val;
+        if (value.is_number())
+          val = std::to_string(value.get<double>());
+        else if (value.is_string())
+          val = value.get<std::string>();
+        res.attributes[key + "_" + source] = val;
+        if (first_item) {
+          summary << key << ": " << val;
+          first_item = false;
+        }
+      }
+    }
+    const auto any_value = [&](const std::string &key) -> std::string {
+      if (current.contains(key) && current[key].is_object() &&
+          !current[key].empty()) {
+        const auto it = current[key].begin();
+        if (it.value().is_number())
+          return std::to_string(it.value().get<double>());
+        if (it.value().is_string())
+          return it.value().get<std::string>();
+      }
+      return "";
+    };
+    const std::string temp = any_value("airTemperature");
+    const std::string wave = any_value("waveHeight");
+    std::stringstream loc;
+    if (!temp.empty())
+      loc << "Air Temp: " << temp << "°C ";
+    if (!wave.empty())
+      loc << "Wave: " << wave << "m";
+    res.address_local = loc.str().empty() ? summary.str() : loc.str();
+  } catch (const std::exception &e) {
+    res.attributes["error"] = e.what();
+  }
+  return res;
+}
+} // namespace dom
+
+/// Asserts @p adapter gives what the DOM reference gives for a fixture.
+void check_against_dom(const regeocode::ApiAdapter &adapter,
+                       dom::Parsed (*reference)(const std::string &),
+                       const std::string &fixture) {
+  const std::string body = regeocode::test::read_fixture(fixture);
+  const regeocode::AddressResult scanned = adapter.parse_response(body);
+  const dom::Parsed expected = reference(body);
+  if (scanned.address_english != expected.address_english ||
+      scanned.address_local != expected.address_local ||
+      scanned.country_code != expected.country_code ||
+      scanned.attributes.to_map() != expected.attributes)
+    throw std::runtime_error("Adapter differs from the DOM parse: " + fixture);
+}
+} // namespace
+
+/**
+ * @brief Main function for the JSON scanner test.
+ *
+ * @return int Exit code (0 for success).
+ */
+int main() {
+  using namespace regeocode;
+
+  try {
+    // Test paths, wildcards and kinds
+    const std::string doc =
+        R"({"a": {"b": "x\"yä", "n": -1.5e2, "i": 42, "t": true},
+            "skip": [1, {"deep": ["]", "}"]}],
+            "list": [{"k": "v0"}, {"k": "v1"}, {"k": null}]})";
+    const scan::PathSet paths{"a.b", "a.n", "a.i", "a.t", "list.*.k", "a",
+                              "missing"};
+    auto r = scan::scan(doc, paths);
+    assert(r.string(0) == "x\"y\xc3\xa4");
+    assert(r.get(1)->as_double() == -150.0);
+    assert(!r.get(1)->is_integer());
+    assert(r.get(2)->as_long() == 42 && r.get(2)->is_integer());
+    assert(r.get(3)->kind == scan::Kind::Boolean);
+    assert(r.is_object(5));
+    assert(!r.has(6));
+
+    std::size_t list_hits = 0;
+    for (const auto &f : r.fields()) {
+      if (f.path != 4)
+        continue;
+      assert(f.capture(0).index == list_hits);
+      ++list_hits;
+    }
+    assert(list_hits == 3);
+    std::println("Test paths: OK");
+
+    // Test malformed input
+    bool thrown = false;
+    try {
+      scan::scan(R"({"a": "unterminated)", paths);
+    } catch (const scan::parse_error &) {
+      thrown = true;
+    }
+    assert(thrown);
+    std::println("Test malformed: OK");
+
+    // Test streaming with early stop: nothing after the stop point is read,
+    // not even the malformed tail
+    std::vector<std::string> keys;
+    bool complete = scan::scan_each(
+        R"({"list": [{"k": "v0"}, {"k": "v1"}, {"k": "v2"}], "x": ]})", paths,
+        [&](const scan::Field &f) {
+          if (f.path == 4)
+            keys.push_back(f.str());
+          return keys.size() < 2;
+        });
+    assert(!complete);
+    assert(keys.size() == 2 && keys[1] == "v1");
+
+    complete = scan::scan_each(doc, paths, [](const scan::Field &) {
+      return true;
+    });
+    assert(complete);
+    std::println("Test streaming: OK");
+
+    // Test adapters against recorded responses
+    NominatimAdapter nominatim;
+    auto n = nominatim.parse_response(test::read_fixture("nominatim"));
+    assert(n.country_code == "de");
+    assert(n.attributes["city"] == "München");
+    assert(n.attributes["state"] == "Bayern");
+    assert(n.raw_json.empty()); // adapters only borrow the body
+
+    GoogleAdapter google;
+    auto g = google.parse_response(test::read_fixture("google"));
+    assert(g.address_english == "Marienplatz 8, 80331 München, Deutschland");
+    assert(g.country_code == "DE");
+    assert(g.attributes["country"] == "Deutschland");
+    assert(g.attributes["city"] == "München");
+
+    MareaTidesAdapter marea;
+    auto m = marea.parse_response(test::read_fixture("marea_tides"));
+    assert(m.attributes["source"] == "FES2014"); // after the heights array
+    assert(m.attributes["station_distance"] == "0.74 km");
+    assert(m.attributes["event_0_state"] == "HIGH TIDE");
+    assert(m.attributes.count("current_height") == 1);
+    assert(m.address_local.starts_with("HIGH TIDE (1.21m) at "));
+
+    // Unit after the extremes still ends up in the summary; only five
+    // events are kept
+    TidesAdapter tides;
+    auto t = tides.parse_response(
+        R"({"extremes": [{"state": "LOW TIDE", "datetime": "t0", "height": -1},
+                         {"state": "HIGH TIDE", "datetime": "t1", "height": 1},
+                         {}, {}, {}, {"state": "LOW TIDE"}],
+            "heights": [{"height": 0.5, "state": "RISING"}, {"height": 0.6}],
+            "unit": "ft"})");
+    assert(t.address_local == "LOW TIDE (-1.00ft) at t0");
+    assert(t.attributes["current_state"] == "RISING");
+    assert(t.attributes.count("event_5_state") == 0);
+    assert(t.attributes.count("error") == 0);
+
+    SeaWeatherAdapter sea;
+    auto s = sea.parse_response(test::read_fixture("seaweather"));
+    assert(s.attributes["meta_requestCount"] == "3");
+    assert(s.attributes["time"] == "2025-10-19T00:00:00+00:00");
+    assert(s.address_local == "Air Temp: 11.300000°C Wave: 0.910000m");
+    std::println("Test adapters: OK");
+
+    // Test every adapter gives what the DOM parse gave for its fixture
+    check_against_dom(NominatimAdapter{}, dom::nominatim, "nominatim");
+    check_against_dom(GoogleAdapter{}, dom::google, "google");
+    check_against_dom(OpenCageAdapter{}, dom::opencage, "opencage");
+    check_against_dom(BingAdapter{}, dom::bing, "bing");
+    check_against_dom(CountryInfoAdapter{}, dom::country_info, "country_info");
+    check_against_dom(GeoNamesTimezoneAdapter{}, dom::timezone, "timezone");
+    check_against_dom(GeoNamesWikipediaAdapter{}, dom::wikipedia, "wikipedia");
+    check_against_dom(OpenWeatherAdapter{}, dom::openweather, "openweather");
+    check_against_dom(PollutionAdapter{}, dom::pollution, "pollution");
+    check_against_dom(MareaTidesAdapter{}, dom::marea_tides, "marea_tides");
+    check_against_dom(TidesAdapter{}, dom::tides, "tides");
+    check_against_dom(SeaWeatherAdapter{}, dom::seaweather, "seaweather");
+    std::println("Test adapters against the DOM parse: OK");
+
+    // Test raw-json: the geocoder hands the body out only when configured
+    for (bool keep : {false, true}) {
+      ApiConfig cfg = test::fixture_config("nominatim");
+      cfg.keep_raw_json = keep;
+
+      std::vector<ApiAdapterPtr> adapters;
+      adapters.push_back(std::make_unique<NominatimAdapter>());
+      ReverseGeocoder geocoder(
+          {{"nominatim", cfg}}, std::move(adapters),
+          std::make_unique<test::FixtureHttpClient>(),
+          regeocode::test::quota_file());
+
+      auto res = geocoder.reverse_geocode({48.137, 11.576, ""}, "nominatim");
+      assert(res.country_code == "de");
+      assert(res.raw_json == (keep ? test::read_fixture("nominatim") : ""));
+    }
+    std::println("Test raw-json: OK");
+
+    std::println("All json_scan tests passed!");
+  } catch (const std::exception &e) {
+    std::cerr << "Test failed with exception: " << e.what() << std::endl;
+    return 1;
+  }
+
+  return 0;
+}
@@ -0,0 +1,265 @@
+/**
+ * SPDX-FileComment: Unit test for the per-API metrics.
+ * SPDX-FileType: SOURCE
+ * SPDX-FileContributor: ZHENG Robert
+ * SPDX-FileCopyrightText: 2026 ZHENG Robert
+ * SPDX-License-Identifier: MIT
+ *
+ * @file test_metrics.cpp
+ * @brief Test cases for histogram buckets, sharded counters, the
+ *        geocoder's instrumentation and the Prometheus export.
+ * @version 0.1.0
+ * @date 2026-10-19
+ *
+ * @author ZHENG Robert
+ * @license MIT License
+ */
+
+#include "regeocode/adapter_nominatim.hpp"
+#include "regeocode/metrics.hpp"
+#include "regeocode/re_geocode_core.hpp"
+#include "test_support.hpp"
+
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <print>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+/**
+ * @brief Answers with the Nominatim fixture and curl-like timings; URLs
+ * containing "/down" fail with a 503, "/flaky" fails on its first call.
+ */
+class TimedHttpClient : public regeocode::test::FixtureHttpClient {
+public:
+  TimedHttpClient()
+      : FixtureHttpClient(regeocode::test::read_fixture("nominatim")) {}
+
+protected:
+  regeocode::HttpResponse respond(const std::string &url) const override {
+    using us = std::chrono::microseconds;
+    regeocode::HttpResponse response;
+    if (url.find("/down") != std::string::npos ||
+        (url.find("/flaky") != std::string::npos && flaky_calls_++ == 0))
+      response.status_code = 503;
+    else
+      response = FixtureHttpClient::respond(url);
+    response.timings = {us(100), us(200), us(0), us(3000), us(50)};
+    return response;
+  }
+
+private:
+  mutable std::atomic<int> flaky_calls_{0};
+};
+} // namespace
+
+/**
+ * @brief Main function for the metrics test.
+ *
+ * @return int Exit code (0 for success).
+ */
+int main() {
+  using namespace regeocode;
+  using H = HistogramSnapshot;
+
+  try {
+    // Test buckets cover every value within 12.5 % and keep their order
+    {
+      std::size_t previous = 0;
+      for (std::uint64_t v = 0; v < (1u << 20); v += 1 + v / 64) {
+        const std::size_t b = H::bucket_of(v);
+        assert(b >= previous && b < H::kBuckets);
+        assert(H::bucket_limit(b) >= v);
+        assert(static_cast<double>(H::bucket_limit(b) - v) <=
+               0.125 * static_cast<double>(v) + 1.0);
+        assert(b == 0 || H::bucket_limit(b - 1) < v);
+        previous = b;
+      }
+      assert(H::bucket_of(~0ull) == H::kBuckets - 1);
+    }
+    std::println("Test histogram buckets: OK");
+
+    // Test percentiles and concurrent recording
+    {
+      ApiMetrics metrics;
+      std::vector<std::thread> threads;
+      for (int t = 0; t < 8; ++t)
+        threads.emplace_back([&] {
+          for (int i = 1; i <= 1000; ++i) {
+            metrics.add(Counter::Requests);
+            metrics.record(Stage::Wait, std::chrono::microseconds(i));
+          }
+        });
+      for (auto &t : threads)
+        t.join();
+      const ApiSnapshot s = metrics.snapshot();
+      assert(s[Counter::Requests] == 8000);
+      const H &wait = s[Stage::Wait];
+      assert(wait.count == 8000 && wait.sum_micros == 8 * 500500);
+      assert(wait.mean().count() == 500);
+      const auto p50 = wait.percentile(0.5).count();
+      const auto p99 = wait.percentile(0.99).count();
+      assert(p50 >= 500 && p50 <= 563);
+      assert(p99 >= 990 && p99 <= 1114);
+      assert(s[Stage::Dns].count == 0 && s[Stage::Dns].percentile(0.5) ==
+                                             std::chrono::microseconds(0));
+    }
+    std::println("Test per-thread recording: OK");
+
+    // Test slots of ended threads are reused and survive their ApiMetrics
+    {
+      ApiMetrics metrics;
+      for (int t = 0; t < 64; ++t)
+        std::thread([&] {
+          auto scratch = std::make_unique<ApiMetrics>();
+          scratch->add(Counter::Lookups);
+          metrics.add(Counter::Lookups);
+          scratch.reset();
+          ApiMetrics other;
+          other.add(Counter::Lookups);
+          assert(other.snapshot()[Counter::Lookups] == 1);
+        }).join();
+      assert(metrics.snapshot()[Counter::Lookups] == 64);
+    }
+    std::println("Test slot reuse: OK");
+
+    // Test label values are escaped and time sums given in seconds
+    {
+      MetricsSnapshot m;
+      m.apis["a\"b\\c\nd"].counters[static_cast<std::size_t>(
+          Counter::TransferMicros)] = 1500000;
+      const std::string text = to_prometheus(m);
+      assert(text.find("regeocode_transfer_seconds_total{api=\"a\\\"b\\\\c"
+                       "\\nd\"} 1.5\n") != std::string::npos);
+      assert(text.find("_micros") == std::string::npos);
+    }
+    std::println("Test Prometheus escaping: OK");
+
+    // Test the geocoder records lookups, retries, stages and fallbacks
+    {
+      std::unordered_map<std::string, ApiConfig> configs;
+      for (const std::string name : {"ok", "down", "flaky"}) {
+        ApiConfig cfg = test::fixture_config(name);
+        cfg.retry.max_attempts = 2;
+        cfg.retry.base_delay = std::chrono::milliseconds(1);
+        configs.emplace(name, cfg);
+      }
+      configs.at("down").retry.max_attempts = 1;
+      std::vector<ApiAdapterPtr> adapters;
+      adapters.push_back(std::make_unique<NominatimAdapter>());
+      const ReverseGeocoder geocoder(std::move(configs), std::move(adapters),
+                                     std::make_unique<TimedHttpClient>(),
+                                     regeocode::test::quota_file());
+      const Coordinates where{48.137, 11.576, "de"};
+
+      geocoder.reverse_geocode(where, "flaky");
+      auto json = geocoder.reverse_geocode_fallback(where, {"down", "ok"});
+      assert(!json.contains("error"));
+      json = geocoder.reverse_geocode_fallback(where, {"down", " "});
+      assert(json.contains("error"));
+
+      const MetricsSnapshot m = geocoder.metrics();
+      const ApiSnapshot &flaky = m.apis.at("flaky");
+      assert(flaky[Counter::Lookups] == 1 && flaky[Counter::Failures] == 0);
+      assert(flaky[Counter::Requests] == 2 && flaky[Counter::Retries] == 1);
+      assert(flaky[Stage::Lookup].count == 1 && flaky[Stage::Parse].count == 1);
+      assert(flaky[Stage::Wait].count == 2);
+      assert(flaky[Stage::Wait].percentile(0.5).count() >= 3000);
+      const ApiSnapshot &down = m.apis.at("down");
+      assert(down[Counter::Lookups] == 2 && down[Counter::Failures] == 2);
+      assert(down[Stage::Parse].count == 0);
+      // "ok" ran a dual-language lookup: English and German
+      assert(m.apis.at("ok")[Counter::Lookups] == 2);
+      assert(m.fallback_depth[2] == 1 && m.fallback_depth[0] == 1);
+      assert(m.fallback_depth[1] == 0);
+      assert(geocoder.transfer_stats("flaky").retries == 1);
+
+      // Prometheus text
+      const std::string text = to_prometheus(m);
+      assert(text.find("# TYPE regeocode_requests_total counter\n") !=
+             std::string::npos);
+      assert(text.find("regeocode_retries_total{api=\"flaky\"} 1\n") !=
+             std::string::npos);
+      assert(text.find("regeocode_stage_seconds_count{api=\"flaky\","
+                       "stage=\"wait\"} 2\n") != std::string::npos);
+      assert(text.find("regeocode_fallback_depth_total{depth=\"none\"} 1\n") !=
+             std::string::npos);
+
+      const std::string path =
+          (std::filesystem::temp_directory_path() / "regeocode_metrics.prom")
+              .string();
+      write_prometheus_file(m, path);
+      std::ifstream f(path);
+      std::stringstream ss;
+      ss << f.rdbuf();
+      assert(ss.str() == text);
+      std::remove(path.c_str());
+
+      // Periodic snapshots, and a last one when the reporter stops
+      std::atomic<int> reports{0};
+      {
+        MetricsReporter reporter(
+            [&] { return geocoder.metrics(); },
+            [&](const MetricsSnapshot &s) {
+              assert(s.apis.size() == 3);
+              ++reports;
+            },
+            std::chrono::milliseconds(5));
+        std::this_thread::sleep_for(std::chrono::milliseconds(30));
+      }
+      assert(reports >= 2);
+    }
+    std::println("Test geocoder metrics: OK");
+
+    // Test awaited lookups count failures only when they do fail
+    {
+      std::unordered_map<std::string, ApiConfig> configs;
+      for (const std::string name : {"ok", "down"}) {
+        ApiConfig cfg = test::fixture_config(name);
+        cfg.retry.max_attempts = 1;
+        configs.emplace(name, cfg);
+      }
+      std::vector<ApiAdapterPtr> adapters;
+      adapters.push_back(std::make_unique<NominatimAdapter>());
+      const ReverseGeocoder geocoder(std::move(configs), std::move(adapters),
+                                     std::make_unique<TimedHttpClient>(),
+                                     regeocode::test::quota_file());
+      const Coordinates where{48.137, 11.576, "de"};
+
+      sync_wait(geocoder.reverse_geocode_async(where, "ok"));
+      sync_wait(geocoder.reverse_geocode_async(where, "ok"));
+      bool threw = false;
+      try {
+        sync_wait(geocoder.reverse_geocode_async(where, "down"));
+      } catch (const std::exception &) {
+        threw = true;
+      }
+      assert(threw);
+
+      const MetricsSnapshot m = geocoder.metrics();
+      const ApiSnapshot &ok = m.apis.at("ok");
+      assert(ok[Counter::Lookups] == 2 && ok[Counter::Failures] == 0);
+      assert(ok[Stage::Lookup].count == 2);
+      const ApiSnapshot &down = m.apis.at("down");
+      assert(down[Counter::Lookups] == 1 && down[Counter::Failures] == 1);
+    }
+    std::println("Test awaited lookup metrics: OK");
+
+    std::println("All metrics tests passed!");
+  } catch (const std::exception &e) {
+    std::cerr << "Test failed with exception: " << e.what() << std::endl;
+    return 1;
+  }
+
+  return 0;
+}
@@ -0,0 +1,261 @@
+/**
+ * SPDX-FileComment: Unit test for the record/replay HTTP clients.
+ * SPDX-FileType: SOURCE
+ * SPDX-FileContributor: ZHENG Robert
+ * SPDX-FileCopyrightText: 2026 ZHENG Robert
+ * SPDX-License-Identifier: MIT
+ *
+ * @file test_replay_http_client.cpp
+ * @brief Test cases for replay keys, the replay file, fault injection and
+ *        offline geocoding through ReplayHttpClient.
+ * @version 0.1.0
+ * @date 2026-10-19
+ *
+ * @author ZHENG Robert
+ * @license MIT License
+ */
+
+#include "regeocode/adapter_google.hpp"
+#include "regeocode/adapter_nominatim.hpp"
+#include "regeocode/re_geocode_core.hpp"
+#include "regeocode/replay_http_client.hpp"
+#include "test_support.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <print>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace {
+/**
+ * @brief Stand-in for the live client: answers by host, plus a scripted
+ * outage for one path.
+ */
+class LiveHttpClient : public regeocode::HttpClient {
+public:
+  regeocode::HttpResponse
+  get(const std::string &url, long /*timeout*/,
+      const regeocode::HttpRequestOptions & /*options*/) const override {
+    regeocode::HttpResponse response;
+    if (url.find("/flaky") != std::string::npos && flaky_calls++ == 0) {
+      response.status_code = 503;
+      response.retry_after = "1";
+      return response;
+    }
+    response.status_code = 200;
+    response.etag = "\"e1\"";
+    response.body = regeocode::test::read_fixture(
+        url.find("google") != std::string::npos ? "google" : "nominatim");
+    response.wire_bytes = response.body.size() / 3;
+    return response;
+  }
+
+  mutable int flaky_calls = 0;
+};
+
+template <typename F> bool throws(F &&f) {
+  try {
+    f();
+  } catch (const std::runtime_error &) {
+    return true;
+  }
+  return false;
+}
+} // namespace
+
+/**
+ * @brief Main function for the replay client test.
+ *
+ * @return int Exit code (0 for success).
+ */
+int main() {
+  using namespace regeocode;
+  const std::string path =
+      (std::filesystem::temp_directory_path() / "regeocode_test.replay")
+          .string();
+
+  try {
+    // Test credentials are not part of the key
+    assert(replay_key("http://x/r?lat=1&key=SECRET&lon=2") ==
+           "http://x/r?lat=1&lon=2");
+    assert(replay_key("http://x/r?appid=S") == "http://x/r");
+    assert(replay_key("http://x/r?token=S&subscription-key=S&lat=1") ==
+           "http://x/r?lat=1");
+    assert(replay_key("http://x/r") == "http://x/r");
+    assert(replay_key("http://x/r?key=S", {}) == "http://x/r?key=S");
+    std::println("Test replay key: OK");
+
+    // Test recording and replaying
+    {
+      RecordingHttpClient recorder(std::make_unique<LiveHttpClient>());
+      recorder.get("http://nominatim/reverse?lat=1&lon=2", 5);
+      recorder.get("http://nominatim/reverse?lat=1&lon=2", 5); // same again
+      recorder.get("http://google/json?latlng=1,2&key=SECRET", 5);
+      recorder.get("http://nominatim/flaky", 5);
+      recorder.get("http://nominatim/flaky", 5);
+      assert(recorder.size() == 4);
+      recorder.save(path);
+    }
+    {
+      std::ifstream f(path, std::ios::binary);
+      std::stringstream ss;
+      ss << f.rdbuf();
+      assert(ss.str().find("SECRET") == std::string::npos);
+    }
+    {
+      const ReplayHttpClient replay(path);
+      assert(replay.size() == 4);
+      auto r = replay.get("http://nominatim/reverse?lat=1&lon=2", 5);
+      assert(r.status_code == 200 &&
+             std::string_view(r.body) == test::read_fixture("nominatim"));
+      assert(r.etag == "\"e1\"" && r.wire_bytes == r.body.size() / 3);
+      r = replay.get("http://google/json?latlng=1,2&key=OTHER", 5);
+      assert(r.status_code == 200 &&
+             std::string_view(r.body) == test::read_fixture("google"));
+      assert(replay.get("http://nominatim/unknown", 5).status_code == 404);
+
+      // Recordings of one key in turn, then the last one repeats
+      r = replay.get("http://nominatim/flaky", 5);
+      assert(r.status_code == 503 && r.retry_after == "1");
+      assert(replay.get("http://nominatim/flaky", 5).status_code == 200);
+      assert(replay.get("http://nominatim/flaky", 5).status_code == 200);
+
+      // Conditional requests
+      HttpRequestOptions conditional;
+      conditional.if_none_match = "\"e1\"";
+      r = replay.get("http://nominatim/reverse?lat=1&lon=2", 5, conditional);
+      assert(r.status_code == 304 && r.body.empty());
+    }
+    std::println("Test record/replay: OK");
+
+    // Test every parameter an API template fills with the key is redacted
+    {
+      const std::vector<std::string> ignored = credential_params(
+          {"https://atlas.microsoft.com/search/address/reverse/json"
+           "?api-version=1.0&query={{ latitude }},{{ longitude }}"
+           "&subscription-key={{ apikey }}",
+           "http://custom/r?lat={{ latitude }}&auth={{apikey}}"
+           "&lang={{ lang }}"});
+      assert(std::ranges::count(ignored, "auth") == 1);
+      assert(std::ranges::count(ignored, "subscription-key") == 1);
+      assert(std::ranges::count(ignored, "lang") == 0);
+
+      const test::TempFile file("credentials.replay");
+      const std::string azure = "https://atlas.microsoft.com/search/address/"
+                                "reverse/json?api-version=1.0&query=1,2";
+      {
+        RecordingHttpClient recorder(std::make_unique<LiveHttpClient>(),
+                                     ignored);
+        recorder.get(azure + "&subscription-key=AZURESECRET", 5);
+        recorder.get("http://custom/r?lat=1&auth=CUSTOMSECRET&lang=en", 5);
+        recorder.save(file.path());
+      }
+      std::ifstream f(file.path(), std::ios::binary);
+      std::stringstream ss;
+      ss << f.rdbuf();
+      assert(ss.str().find("AZURESECRET") == std::string::npos);
+      assert(ss.str().find("CUSTOMSECRET") == std::string::npos);
+      assert(ss.str().find("subscription-key") == std::string::npos);
+
+      ReplayOptions options;
+      options.ignored_params = ignored;
+      const ReplayHttpClient replay(file.path(), options);
+      assert(replay.get(azure + "&subscription-key=OTHER", 5).status_code ==
+             200);
+      assert(replay.get("http://custom/r?lat=1&auth=X&lang=en", 5)
+                 .status_code == 200);
+    }
+    std::println("Test credential parameters: OK");
+
+    // Test fault injection is reproducible
+    {
+      ReplayOptions faults;
+      faults.error_rate = 0.25;
+      faults.error_status = 429;
+      faults.error_retry_after = "2";
+      faults.seed = 42;
+      auto failures = [&] {
+        const ReplayHttpClient replay(path, faults);
+        std::vector<bool> failed;
+        for (int i = 0; i < 1000; ++i) {
+          const auto r = replay.get("http://nominatim/reverse?lat=1&lon=2", 5);
+          assert(r.status_code == 200 ||
+                 (r.status_code == 429 && r.retry_after == "2"));
+          failed.push_back(r.status_code == 429);
+        }
+        return failed;
+      };
+      const auto first = failures();
+      assert(first == failures());
+      const auto count = std::count(first.begin(), first.end(), true);
+      assert(count > 200 && count < 300);
+    }
+    std::println("Test fault injection: OK");
+
+    // Test malformed files are rejected
+    {
+      assert(throws([] { ReplayHttpClient("/nonexistent/replay"); }));
+      std::ofstream(path, std::ios::binary) << "not a replay file at all";
+      assert(throws([&] { ReplayHttpClient{path}; }));
+      write_replay_file(path, {});
+      assert(ReplayHttpClient(path).size() == 0);
+    }
+    std::println("Test malformed files: OK");
+
+    // Test the whole geocoder runs offline
+    {
+      std::vector<Recording> recordings(2);
+      recordings[0].key = "http://replay/nominatim?lat=48.137&lon=11.576";
+      recordings[0].status_code = 200;
+      recordings[0].body = test::read_fixture("nominatim");
+      recordings[1].key = "http://replay/google?latlng=48.137,11.576";
+      recordings[1].status_code = 200;
+      recordings[1].body = test::read_fixture("google");
+      write_replay_file(path, recordings);
+
+      std::unordered_map<std::string, ApiConfig> configs;
+      for (const std::string name : {"nominatim", "google"}) {
+        ApiConfig cfg;
+        cfg.name = name;
+        cfg.adapter = name;
+        cfg.api_key = "SECRET";
+        cfg.uri_template =
+            name == "google"
+                ? "http://replay/google?latlng={{ latitude }},{{ longitude "
+                  "}}&key={{ apikey }}"
+                : "http://replay/nominatim?lat={{ latitude }}&lon={{ "
+                  "longitude }}";
+        configs.emplace(name, cfg);
+      }
+      std::vector<ApiAdapterPtr> adapters;
+      adapters.push_back(std::make_unique<NominatimAdapter>());
+      adapters.push_back(std::make_unique<GoogleAdapter>());
+      ReverseGeocoder geocoder(std::move(configs), std::move(adapters),
+                               std::make_unique<ReplayHttpClient>(path),
+                               regeocode::test::quota_file());
+      const Coordinates where{48.137, 11.576, "de"};
+      assert(geocoder.reverse_geocode(where, "nominatim").country_code ==
+             "de");
+      assert(!geocoder.reverse_geocode(where, "google").address_english
+                  .empty());
+    }
+    std::println("Test offline geocoding: OK");
+
+    std::remove(path.c_str());
+    std::println("All replay client tests passed!");
+  } catch (const std::exception &e) {
+    std::cerr << "Test failed with exception: " << e.what() << std::endl;
+    return 1;
+  }
+
+  return 0;
+}
@@ -0,0 +1,174 @@
+/**
+ * SPDX-FileComment: Unit test for the request arena and URI templates.
+ * SPDX-FileType: SOURCE
+ * SPDX-FileContributor: ZHENG Robert
+ * SPDX-FileCopyrightText: 2026 ZHENG Robert
+ * SPDX-License-Identifier: MIT
+ *
+ * @file test_request_arena.cpp
+ * @brief Test cases for RequestArena and UriTemplate.
+ * @version 0.1.0
+ * @date 2026-10-19
+ *
+ * @author ZHENG Robert
+ * @license MIT License
+ */
+
+#include "regeocode/http_client.hpp"
+#include "regeocode/inja.hpp"
+#include "regeocode/json_scan.hpp"
+#include "regeocode/request_arena.hpp"
+#include "regeocode/uri_template.hpp"
+
+#include <cassert>
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <nlohmann/json.hpp>
+#include <print>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+
+namespace {
+/// What the geocoder rendered before templates were compiled.
+std::string render_with_inja(const std::string &tpl,
+                             const regeocode::UriValues &v) {
+  nlohmann::json params;
+  params["latitude"] = v.latitude;
+  params["longitude"] = v.longitude;
+  params["apikey"] = v.apikey;
+  params["lang"] = v.lang;
+  params["country_code"] = v.country_code;
+  inja::Environment env;
+  return env.render(tpl, params);
+}
+} // namespace
+
+/**
+ * @brief Main function for the request arena test.
+ *
+ * @return int Exit code (0 for success).
+ */
+int main() {
+  using namespace regeocode;
+
+  try {
+    // Test scoping: nested arenas join, the default resource outside
+    assert(request_resource() == std::pmr::get_default_resource());
+    {
+      RequestArena outer;
+      assert(request_resource() == outer.resource());
+      {
+        RequestArena inner;
+        assert(inner.resource() == outer.resource());
+      }
+      assert(request_resource() == outer.resource());
+    }
+    assert(request_resource() == std::pmr::get_default_resource());
+    std::println("Test scope: OK");
+
+    // Test pooling: an overflowing request grows the thread's buffer
+    const std::size_t initial = [] {
+      RequestArena arena;
+      return RequestArena::pool_size();
+    }();
+    assert(initial >= RequestArena::kInitialPoolBytes);
+    {
+      RequestArena arena;
+      std::pmr::string big(request_resource());
+      big.assign(initial * 2, 'x');
+    }
+    {
+      RequestArena arena;
+      assert(RequestArena::pool_size() > initial);
+      assert(RequestArena::pool_size() <= RequestArena::kMaxPoolBytes);
+    }
+    std::thread([] {
+      assert(RequestArena::pool_size() == 0); // pools are per thread
+      RequestArena arena;
+      assert(RequestArena::pool_size() == RequestArena::kInitialPoolBytes);
+    }).join();
+    std::println("Test pool: OK");
+
+    // Test responses built inside an arena outlive it
+    {
+      HttpResponse kept;
+      {
+        RequestArena arena;
+        HttpResponse response;
+        response.body.assign(64 * 1024, 'r');
+        kept = std::move(response);
+      }
+      {
+        RequestArena reused; // same pooled buffer, overwritten
+        std::pmr::string filler(128 * 1024, 'x', request_resource());
+      }
+      assert(kept.body.size() == 64 * 1024 &&
+             kept.body.find_first_not_of('r') == std::string::npos);
+    }
+    std::println("Test responses outlive the arena: OK");
+
+    // Test arena-backed scanning
+    {
+      RequestArena arena;
+      const scan::PathSet paths{"a", "b.*"};
+      const auto r = scan::scan(R"({"a":"x","b":[1,2,3]})", paths);
+      assert(r.string(0) == "x" && r.fields().size() == 4);
+    }
+    std::println("Test scan: OK");
+
+    // Test compiled templates render exactly like inja
+    const UriValues values{48.137154, 11.576124, "KEY", "de", "de"};
+    for (const std::string tpl :
+         {"https://x/reverse?lat={{ latitude }}&lon={{longitude}}&k={{ apikey }}",
+          "https://x/{{ lang }}/{{ country_code }}?n=1",
+          "{{ latitude }}{{ longitude }}", "no variables",
+          "https://x/?q={{ latitude }},{{ longitude }}{% if lang %}&l={{ lang "
+          "}}{% endif %}",
+          "https://x/?l={{ upper(lang) }}"}) {
+      const UriTemplate compiled(tpl);
+      assert(compiled.render(values) == render_with_inja(tpl, values));
+    }
+    assert(UriTemplate("https://x/{{ latitude }}").is_simple());
+    assert(!UriTemplate("https://x/{{ upper(lang) }}").is_simple());
+    for (const double d :
+         {0.0, -0.0, 1.0, -12.5, 1e-7, 123456789.125, 48.0, 11.576, 0.1 + 0.2,
+          1e-4, 1e-5, 123456789012345.0, 1e15, 1e16, 1.5e300, 5e-324,
+          std::numeric_limits<double>::max(),
+          std::numeric_limits<double>::infinity()}) {
+      const UriValues v{d, -d, "", "", ""};
+      const std::string tpl = "{{ latitude }}/{{ longitude }}";
+      assert(UriTemplate(tpl).render(v) == render_with_inja(tpl, v));
+    }
+    // Pinned, so a change of either formatter shows
+    for (const auto &[d, text] :
+         {std::pair{48.0, "48.0"}, {11.576, "11.576"}, {1e-7, "1e-07"},
+          {-0.0, "-0.0"}, {1e-4, "0.0001"}, {1e16, "1e+16"},
+          {123456789012345.0, "123456789012345.0"}, {1.5e300, "1.5e+300"}}) {
+      const UriValues v{d, 0.0, "", "", ""};
+      assert(UriTemplate("{{ latitude }}").render(v) == text);
+      assert(render_with_inja("{{ latitude }}", v) == text);
+    }
+    std::println("Test uri template: OK");
+
+    // Test a broken template only fails when rendered
+    const UriTemplate broken("https://x/{% if lang %}");
+    bool thrown = false;
+    try {
+      (void)broken.render(values);
+    } catch (const std::exception &) {
+      thrown = true;
+    }
+    assert(thrown);
+    std::println("Test broken template: OK");
+
+    std::println("All request arena tests passed!");
+  } catch (const std::exception &e) {
+    std::cerr << "Test failed with exception: " << e.what() << std::endl;
+    return 1;
+  }
+
+  return 0;
+}
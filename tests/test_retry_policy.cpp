@@ -0,0 +1,299 @@
+/**
+ * SPDX-FileComment: Unit test for the per-API retry policy.
+ * SPDX-FileType: SOURCE
+ * SPDX-FileContributor: ZHENG Robert
+ * SPDX-FileCopyrightText: 2026 ZHENG Robert
+ * SPDX-License-Identifier: MIT
+ *
+ * @file test_retry_policy.cpp
+ * @brief Test cases for backoff, Retry-After, the retry budget, retries in
+ *        ReverseGeocoder and batches, and the retry keys of the INI.
+ * @version 0.1.0
+ * @date 2026-10-19
+ *
+ * @author ZHENG Robert
+ * @license MIT License
+ */
+
+#include "regeocode/adapter_nominatim.hpp"
+#include "regeocode/re_geocode_core.hpp"
+#include "regeocode/retry_policy.hpp"
+#include "loopback_server.hpp"
+#include "test_support.hpp"
+
+#include <cassert>
+#include <chrono>
+#include <fstream>
+#include <future>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <print>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+/**
+ * @brief HttpClient that plays back a list of responses, then succeeds.
+ */
+class ScriptedHttpClient : public regeocode::test::FixtureHttpClient {
+public:
+  struct Step {
+    long status;
+    std::string retry_after;
+  };
+
+  explicit ScriptedHttpClient(std::vector<Step> steps)
+      : steps_(std::move(steps)) {}
+
+protected:
+  regeocode::HttpResponse respond(const std::string &url) const override {
+    const std::size_t call = calls() - 1;
+    if (call >= steps_.size())
+      return FixtureHttpClient::respond(url);
+    regeocode::HttpResponse response;
+    response.status_code = steps_[call].status;
+    response.retry_after = steps_[call].retry_after;
+    return response;
+  }
+
+private:
+  std::vector<Step> steps_;
+};
+
+/// Threads of this process, from /proc/self/status.
+int thread_count() {
+  std::ifstream status("/proc/self/status");
+  std::string line;
+  while (std::getline(status, line))
+    if (line.starts_with("Threads:"))
+      return std::stoi(line.substr(8));
+  return 0;
+}
+
+/// Retry policy of the nominatim section of an INI with @p keys.
+regeocode::RetryPolicy load_retry(const std::string &keys) {
+  const regeocode::test::TempFile ini("retry.ini");
+  std::ofstream(ini.path()) << "[nominatim]\nURI = http://127.0.0.1/\n"
+                               "API-Key =\nAdapter = nominatim\n"
+                            << keys;
+  return regeocode::ConfigLoader(ini.path())
+      .load()
+      .apis.at("nominatim")
+      .retry;
+}
+} // namespace
+
+/**
+ * @brief Main function for the retry policy test.
+ *
+ * @return int Exit code (0 for success).
+ */
+int main() {
+  using namespace regeocode;
+  using namespace std::chrono_literals;
+
+  try {
+    // Test backoff: doubling, ceiling and jitter range
+    RetryPolicy policy;
+    policy.base_delay = 100ms;
+    policy.max_delay = 1000ms;
+    policy.jitter = 0.0;
+    assert(backoff_delay(policy, 1, 0.9) == 100ms);
+    assert(backoff_delay(policy, 2, 0.9) == 200ms);
+    assert(backoff_delay(policy, 4, 0.9) == 800ms);
+    assert(backoff_delay(policy, 5, 0.9) == 1000ms);
+    assert(backoff_delay(policy, 500, 0.9) == 1000ms);
+    policy.jitter = 1.0;
+    assert(backoff_delay(policy, 2, 0.0) == 200ms);
+    assert(backoff_delay(policy, 2, 0.5) == 100ms);
+    assert(backoff_delay(policy, 2, 0.999) < 1ms);
+    std::println("Test backoff: OK");
+
+    // Test Retry-After: delay-seconds and HTTP-dates
+    const auto now = std::chrono::sys_days{std::chrono::year{2026} /
+                                           std::chrono::October /
+                                           std::chrono::day{19}} +
+                     12h;
+    assert(parse_retry_after("120", now) == 120s);
+    assert(parse_retry_after(" 0 ", now) == 0ms);
+    assert(parse_retry_after("Mon, 19 Oct 2026 12:00:30 GMT", now) == 30s);
+    assert(parse_retry_after("Sun, 18 Oct 2026 12:00:00 GMT", now) == 0ms);
+    assert(!parse_retry_after("-5", now));
+    assert(!parse_retry_after("soon", now));
+    assert(!parse_retry_after("Mon, 19 Foo 2026 12:00:30 GMT", now));
+    assert(!parse_retry_after("", now));
+    std::println("Test retry-after: OK");
+
+    // Test budget: min_retries up front, then ratio of the traffic
+    RetryBudget budget(0.25, 2);
+    assert(budget.available() == 2);
+    assert(budget.try_spend() && budget.try_spend() && !budget.try_spend());
+    for (int i = 0; i < 3; ++i)
+      budget.record_request();
+    assert(!budget.try_spend());
+    budget.record_request();
+    assert(budget.try_spend() && !budget.try_spend());
+    for (int i = 0; i < 100; ++i)
+      budget.record_request();
+    assert(budget.available() == 2); // capped, no burst after idle time
+    std::println("Test budget: OK");
+
+    // Test retry decisions
+    policy.max_attempts = 3;
+    policy.jitter = 0.0;
+    policy.max_retry_after = 10s;
+    RetryBudget ample(1.0, 100);
+    assert(retry_delay(policy, 1, 503, "", ample) == 100ms);
+    assert(retry_delay(policy, 2, 503, "", ample) == 200ms);
+    assert(!retry_delay(policy, 3, 503, "", ample)); // attempts used up
+    assert(!retry_delay(policy, 1, 404, "", ample)); // not transient
+    assert(retry_delay(policy, 1, 429, "3", ample) == 3s);
+    assert(retry_delay(policy, 1, 429, "junk", ample) == 100ms);
+    assert(!retry_delay(policy, 1, 429, "60", ample)); // too long
+    policy.honour_retry_after = false;
+    assert(retry_delay(policy, 1, 429, "60", ample) == 100ms);
+    RetryBudget spent(0.0, 0);
+    assert(!retry_delay(policy, 1, 503, "", spent));
+    std::println("Test retry decision: OK");
+
+    // Test the geocoder repeats transient failures and counts them
+    auto make_geocoder = [&](const RetryPolicy &retry,
+                             std::vector<ScriptedHttpClient::Step> steps,
+                             const ScriptedHttpClient *&client_out) {
+      ApiConfig cfg = test::fixture_config("nominatim");
+      cfg.retry = retry;
+      std::vector<ApiAdapterPtr> adapters;
+      adapters.push_back(std::make_unique<NominatimAdapter>());
+      auto client = std::make_unique<ScriptedHttpClient>(std::move(steps));
+      client_out = client.get();
+      return std::make_unique<ReverseGeocoder>(
+          std::unordered_map<std::string, ApiConfig>{{"nominatim", cfg}},
+          std::move(adapters), std::move(client), regeocode::test::quota_file());
+    };
+
+    RetryPolicy fast;
+    fast.max_attempts = 3;
+    fast.base_delay = 1ms;
+    fast.max_delay = 2ms;
+    const ScriptedHttpClient *client = nullptr;
+    {
+      auto geocoder = make_geocoder(fast, {{503, ""}, {429, "0"}}, client);
+      const auto res = geocoder->reverse_geocode({48.137, 11.576, ""},
+                                                 "nominatim");
+      assert(res.country_code == "de");
+      assert(client->calls() == 3);
+      const auto stats = geocoder->transfer_stats("nominatim");
+      assert(stats.requests == 3 && stats.retries == 2);
+    }
+    {
+      // Attempts used up: the last error surfaces
+      auto geocoder =
+          make_geocoder(fast, {{503, ""}, {503, ""}, {503, ""}}, client);
+      bool thrown = false;
+      try {
+        geocoder->reverse_geocode({48.137, 11.576, ""}, "nominatim");
+      } catch (const std::runtime_error &e) {
+        thrown = std::string(e.what()) == "HTTP error: 503";
+      }
+      assert(thrown && client->calls() == 3);
+    }
+    {
+      // A long Retry-After hands over to the fallback chain at once
+      auto geocoder = make_geocoder(fast, {{503, "3600"}}, client);
+      const auto json = geocoder->reverse_geocode_fallback(
+          {48.137, 11.576, ""}, {"nominatim"});
+      assert(json.contains("error") && client->calls() == 1);
+    }
+    {
+      // Without a policy nothing is repeated
+      auto geocoder = make_geocoder(RetryPolicy{}, {{503, ""}}, client);
+      bool thrown = false;
+      try {
+        geocoder->reverse_geocode({48.137, 11.576, ""}, "nominatim");
+      } catch (const std::runtime_error &) {
+        thrown = true;
+      }
+      assert(thrown && client->calls() == 1);
+    }
+    std::println("Test geocoder retries: OK");
+
+    // Test batches on an engine wait out back-offs without a thread each
+    {
+      std::mutex mutex;
+      std::map<std::string, int> seen;
+      const std::string body = test::read_fixture("nominatim");
+      test::LoopbackServer server([&](const test::LoopbackRequest &request) {
+        test::LoopbackReply reply;
+        std::lock_guard lock(mutex);
+        if (seen[request.target]++ == 0)
+          reply.status = 503;
+        else
+          reply.body = body;
+        return reply;
+      });
+      ApiConfig cfg = test::fixture_config("nominatim");
+      cfg.uri_template = server.url("/reverse?lat={{ latitude }}");
+      cfg.retry.max_attempts = 2;
+      cfg.retry.base_delay = 500ms;
+      cfg.retry.jitter = 0.0;
+      cfg.retry.budget_min_retries = 32;
+      HttpClientOptions engine;
+      engine.multiplex = true;
+      engine.max_host_connections = 2;
+      std::vector<ApiAdapterPtr> adapters;
+      adapters.push_back(std::make_unique<NominatimAdapter>());
+      const ReverseGeocoder geocoder({{cfg.name, cfg}}, std::move(adapters),
+                                     std::make_unique<HttpClient>(engine),
+                                     test::quota_file());
+
+      std::vector<Coordinates> coords;
+      for (int i = 0; i < 32; ++i)
+        coords.push_back({48.0 + 0.01 * i, 11.0, ""});
+      const int before = thread_count();
+      auto batch = std::async(std::launch::async, [&] {
+        return geocoder.batch_reverse_geocode(coords, {"nominatim"});
+      });
+      std::this_thread::sleep_for(250ms); // every point is backing off
+      assert(thread_count() - before < 8);
+      for (const auto &json : batch.get())
+        assert(json["result"]["country_code"] == "de");
+      assert(geocoder.transfer_stats("nominatim").retries == 32);
+    }
+    std::println("Test batch back-offs: OK");
+
+    // Test the retry keys of the INI
+    {
+      const RetryPolicy policy = load_retry(
+          "retry-attempts = 4\nretry-jitter = 0.25\nretry-budget-min = 3\n"
+          "honour-retry-after = false\nretry-on = 429 , 503\n");
+      assert(policy.max_attempts == 4 && policy.jitter == 0.25);
+      assert(policy.budget_min_retries == 3 && !policy.honour_retry_after);
+      assert((policy.retry_on == std::vector<long>{429, 503}));
+      assert(load_retry("").budget_min_retries == 10);
+
+      for (const std::string bad :
+           {"retry-on = 503abc\n", "retry-on = 429,,503\n",
+            "retry-on = 42\n", "retry-jitter = 1.5\n"}) {
+        bool thrown = false;
+        try {
+          load_retry(bad);
+        } catch (const std::runtime_error &) {
+          thrown = true;
+        }
+        assert(thrown);
+      }
+    }
+    std::println("Test retry keys: OK");
+
+    std::println("All retry policy tests passed!");
+  } catch (const std::exception &e) {
+    std::cerr << "Test failed with exception: " << e.what() << std::endl;
+    return 1;
+  }
+
+  return 0;
+}
@@ -0,0 +1,143 @@
+/**
+ * SPDX-FileComment: Helpers shared by the unit tests.
+ * SPDX-FileType: SOURCE
+ * SPDX-FileContributor: ZHENG Robert
+ * SPDX-FileCopyrightText: 2026 ZHENG Robert
+ * SPDX-License-Identifier: MIT
+ *
+ * @file test_support.hpp
+ * @brief Fixtures, a fixture-serving HttpClient, API configs and temporary
+ *        files for the unit tests, so that test runs need no network and
+ *        leave nothing behind in the source tree.
+ * @version 0.1.0
+ * @date 2026-10-19
+ *
+ * @author ZHENG Robert
+ * @license MIT License
+ */
+
+#pragma once
+
+#include "regeocode/http_client.hpp"
+#include "regeocode/re_geocode_core.hpp"
+
+#include <unistd.h>
+
+#include <atomic>
+#include <cstddef>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <utility>
+
+namespace regeocode::test {
+
+/**
+ * @brief File in the temp directory, unique to this process and removed
+ * when the object goes away.
+ */
+class TempFile {
+public:
+  explicit TempFile(std::string_view name)
+      : path_((std::filesystem::temp_directory_path() /
+               ("regeocode_" + std::to_string(::getpid()) + "_" +
+                std::string(name)))
+                  .string()) {
+    std::error_code ec;
+    std::filesystem::remove(path_, ec);
+  }
+  ~TempFile() {
+    std::error_code ec;
+    std::filesystem::remove(path_, ec);
+  }
+  TempFile(const TempFile &) = delete;
+  TempFile &operator=(const TempFile &) = delete;
+
+  const std::string &path() const noexcept { return path_; }
+
+private:
+  std::string path_;
+};
+
+/// Quota file for the geocoders of this test process; removed at exit.
+inline const std::string &quota_file() {
+  static const TempFile file("quota.json");
+  return file.path();
+}
+
+/// Body of tests/fixtures/<name>.json; tests run from the source root.
+inline std::string read_fixture(const std::string &name) {
+  std::ifstream f("tests/fixtures/" + name + ".json");
+  if (!f.is_open())
+    throw std::runtime_error("Missing fixture: " + name);
+  std::stringstream ss;
+  ss << f.rdbuf();
+  return ss.str();
+}
+
+/**
+ * @brief Config for API @p name on the fixture host:
+ * "http://fixture/<name>?lat={{ latitude }}&lon={{ longitude }}".
+ */
+inline ApiConfig fixture_config(const std::string &name,
+                                const std::string &adapter = "nominatim",
+                                const std::string &type = "geocoding") {
+  ApiConfig cfg;
+  cfg.name = name;
+  cfg.adapter = adapter;
+  cfg.type = type;
+  cfg.uri_template =
+      "http://fixture/" + name + "?lat={{ latitude }}&lon={{ longitude }}";
+  return cfg;
+}
+
+/**
+ * @brief HttpClient answering from tests/fixtures instead of the network.
+ *
+ * Answers "http://<host>/<name>?..." with fixture <name>, or every request
+ * with one fixed body, and counts the requests. Stubs that script failures
+ * or timings derive from it and override respond().
+ */
+class FixtureHttpClient : public HttpClient {
+public:
+  FixtureHttpClient() = default;
+  explicit FixtureHttpClient(std::string body)
+      : body_(std::move(body)), fixed_(true) {}
+
+  HttpResponse get(const std::string &url, long /*timeout*/,
+                   const HttpRequestOptions & /*options*/) const override {
+    ++calls_;
+    return respond(url);
+  }
+
+  /// Requests made so far.
+  std::size_t calls() const { return calls_; }
+
+protected:
+  /// The answer to @p url: a 200 with the fixture or the fixed body.
+  virtual HttpResponse respond(const std::string &url) const {
+    HttpResponse response;
+    response.status_code = 200;
+    response.body = fixed_ ? body_ : read_fixture(fixture_of(url));
+    return response;
+  }
+
+  /// First path segment of @p url, which names the fixture.
+  static std::string fixture_of(const std::string &url) {
+    const auto host = url.find("://");
+    const auto path =
+        url.find('/', host == std::string::npos ? 0 : host + 3) + 1;
+    return url.substr(path, url.find_first_of("/?", path) - path);
+  }
+
+private:
+  std::string body_;
+  bool fixed_ = false;
+  mutable std::atomic<std::size_t> calls_{0};
+};
+
+} // namespace regeocode::test
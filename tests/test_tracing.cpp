@@ -0,0 +1,205 @@
+/**
+ * SPDX-FileComment: Unit test for lookup tracing.
+ * SPDX-FileType: SOURCE
+ * SPDX-FileContributor: ZHENG Robert
+ * SPDX-FileCopyrightText: 2026 ZHENG Robert
+ * SPDX-License-Identifier: MIT
+ *
+ * @file test_tracing.cpp
+ * @brief Test cases for spans of the geocoder's lookup stages and the
+ *        Chrome trace-event sink.
+ * @version 0.1.0
+ * @date 2026-10-19
+ *
+ * @author ZHENG Robert
+ * @license MIT License
+ */
+
+#include "regeocode/adapter_nominatim.hpp"
+#include "regeocode/re_geocode_core.hpp"
+#include "regeocode/tracing.hpp"
+#include "test_support.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <print>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+namespace {
+/**
+ * @brief Answers with the Nominatim fixture and curl-like timings; the
+ * first request fails with a 503.
+ */
+class FlakyHttpClient : public regeocode::test::FixtureHttpClient {
+public:
+  FlakyHttpClient()
+      : FixtureHttpClient(regeocode::test::read_fixture("nominatim")) {}
+
+protected:
+  regeocode::HttpResponse respond(const std::string &url) const override {
+    using us = std::chrono::microseconds;
+    regeocode::HttpResponse response;
+    if (calls() == 1)
+      response.status_code = 503;
+    else
+      response = FixtureHttpClient::respond(url);
+    response.timings = {us(100), us(200), us(300), us(400), us(50)};
+    return response;
+  }
+};
+
+struct Span {
+  std::string name, api, detail;
+  std::chrono::microseconds start, duration;
+};
+
+class CollectingSink : public regeocode::TraceSink {
+public:
+  void record(const regeocode::SpanRecord &span) override {
+    std::lock_guard lock(mutex);
+    spans.push_back({std::string(span.name), std::string(span.api),
+                     std::string(span.detail), span.start, span.duration});
+  }
+  std::size_t count(std::string_view name) const {
+    return static_cast<std::size_t>(std::ranges::count_if(
+        spans, [&](const Span &s) { return s.name == name; }));
+  }
+  const Span &first(std::string_view name) const {
+    return *std::ranges::find_if(spans,
+                                 [&](const Span &s) { return s.name == name; });
+  }
+
+  std::mutex mutex;
+  std::vector<Span> spans;
+};
+
+bool inside(const Span &inner, const Span &outer) {
+  return inner.start >= outer.start &&
+         inner.start + inner.duration <= outer.start + outer.duration;
+}
+} // namespace
+
+/**
+ * @brief Main function for the tracing test.
+ *
+ * @return int Exit code (0 for success).
+ */
+int main() {
+  using namespace regeocode;
+
+  try {
+    // Test spans without a tracer sink cost nothing and record nothing
+    {
+      Tracer tracer;
+      assert(!tracer.enabled());
+      TraceSpan span(tracer, "idle");
+      assert(!span.active());
+    }
+    std::println("Test disabled tracer: OK");
+
+#if REGEOCODE_TRACING
+    // Test every stage of a dual-language lookup with a retry is traced
+    {
+      ApiConfig cfg = test::fixture_config("osm");
+      cfg.daily_limit = 100;
+      cfg.retry.max_attempts = 2;
+      cfg.retry.base_delay = std::chrono::milliseconds(1);
+      std::unordered_map<std::string, ApiConfig> configs{{"osm", cfg}};
+      std::vector<ApiAdapterPtr> adapters;
+      adapters.push_back(std::make_unique<NominatimAdapter>());
+      ReverseGeocoder geocoder(std::move(configs), std::move(adapters),
+                               std::make_unique<FlakyHttpClient>(),
+                               regeocode::test::quota_file());
+      const auto sink = std::make_shared<CollectingSink>();
+      geocoder.set_trace_sink(sink);
+
+      const auto json = geocoder.reverse_geocode_fallback(
+          {48.137, 11.576, "de"}, {"osm"}, "de");
+      assert(!json.contains("error"));
+
+      // One lookup per language inside the dual-language span
+      assert(sink->count("fallback") == 1 && sink->count("dual_language") == 1);
+      assert(sink->count("lookup") == 2);
+      assert(sink->first("lookup").detail == "lang=en");
+      assert(sink->spans.back().name == "fallback");
+      assert(sink->first("fallback").detail == "depth=1");
+      for (const Span &s : sink->spans)
+        if (s.name == "lookup")
+          assert(inside(s, sink->first("dual_language")));
+
+      // First language: render, quota, failed request, backoff, quota,
+      // request, parse; second: render, quota, request, parse
+      assert(sink->count("render_uri") == 2 && sink->count("parse") == 2);
+      assert(sink->count("quota") == 3 && sink->count("retry_backoff") == 1);
+      assert(sink->count("http") == 3);
+      assert(sink->first("http").detail == "attempt=1 status=503");
+      assert(sink->first("http").api == "osm");
+      assert(inside(sink->first("http"), sink->first("lookup")));
+
+      // Transfer phases laid end to end from the request start
+      assert(sink->count("dns") == 3 && sink->count("transfer") == 3);
+      const Span &dns = sink->first("dns");
+      const Span &tls = sink->first("tls");
+      assert(dns.duration.count() == 100 && tls.duration.count() == 300);
+      assert(tls.start == dns.start + std::chrono::microseconds(300));
+
+      // Removing the sink stops tracing
+      const std::size_t before = sink->spans.size();
+      geocoder.set_trace_sink(nullptr);
+      geocoder.reverse_geocode({48.137, 11.576, "de"}, "osm", "en");
+      assert(sink->spans.size() == before);
+    }
+    std::println("Test geocoder spans: OK");
+
+    // Test the Chrome trace-event file
+    {
+      const std::string path =
+          (std::filesystem::temp_directory_path() / "regeocode_trace.json")
+              .string();
+      {
+        Tracer tracer;
+        const auto sink = std::make_shared<ChromeTraceSink>(path);
+        tracer.set_sink(sink);
+        {
+          TraceSpan outer(tracer, "lookup", "osm");
+          outer.detail("lang=\"de\"");
+          trace_span(tracer, "dns", "osm", std::chrono::steady_clock::now(),
+                     std::chrono::microseconds(42));
+        }
+        assert(sink->size() == 2);
+      } // written when the last owner lets go
+
+      std::ifstream f(path);
+      const auto trace = nlohmann::json::parse(f);
+      const auto &events = trace.at("traceEvents");
+      assert(events.size() == 2);
+      assert(events[0].at("name") == "dns" && events[0].at("dur") == 42);
+      assert(events[0].at("ph") == "X");
+      assert(events[1].at("name") == "lookup");
+      assert(events[1].at("args").at("api") == "osm");
+      assert(events[1].at("args").at("detail") == "lang=\"de\"");
+      assert(events[1].at("tid") == events[0].at("tid"));
+      std::remove(path.c_str());
+    }
+    std::println("Test Chrome trace file: OK");
+#endif
+
+    std::println("All tracing tests passed!");
+  } catch (const std::exception &e) {
+    std::cerr << "Test failed with exception: " << e.what() << std::endl;
+    return 1;
+  }
+
+  return 0;
+}
@@ -0,0 +1,306 @@
+/**
+ * SPDX-FileComment: Unit test for track geocoding.
+ * SPDX-FileType: SOURCE
+ * SPDX-FileContributor: ZHENG Robert
+ * SPDX-FileCopyrightText: 2026 ZHENG Robert
+ * SPDX-License-Identifier: MIT
+ *
+ * @file test_track.cpp
+ * @brief Test cases for the GPX and NMEA readers and for adaptive track
+ *        geocoding against a provider with known boundaries.
+ * @version 0.1.0
+ * @date 2026-10-19
+ *
+ * @author ZHENG Robert
+ * @license MIT License
+ */
+
+#include "regeocode/adapter_nominatim.hpp"
+#include "regeocode/re_geocode_core.hpp"
+#include "regeocode/track.hpp"
+#include "test_support.hpp"
+
+#include <cassert>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <print>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+namespace {
+/// Region of a latitude: "Alpha" < 48.5 <= "Beta" < 49.0 <= "Gamma"; the
+/// band [49.25, 49.3) has no answer.
+std::string region(double lat) {
+  if (lat >= 49.25 && lat < 49.3)
+    return "";
+  return lat < 48.5 ? "Alpha" : lat < 49.0 ? "Beta" : "Gamma";
+}
+
+/// Nominatim stand-in whose city and state follow region().
+class RegionHttpClient : public regeocode::HttpClient {
+public:
+  regeocode::HttpResponse
+  get(const std::string &url, long /*timeout*/,
+      const regeocode::HttpRequestOptions & /*options*/) const override {
+    const double lat = std::strtod(url.c_str() + url.find("lat=") + 4, nullptr);
+    const std::string city = region(lat);
+    regeocode::HttpResponse response;
+    if (city.empty()) {
+      response.status_code = 500;
+      return response;
+    }
+    const nlohmann::json body = {
+        {"display_name", city},
+        {"address",
+         {{"city", city},
+          {"state", city == "Gamma" ? "North" : "South"},
+          {"country", "Deutschland"},
+          {"country_code", "de"}}}};
+    response.status_code = 200;
+    response.body = body.dump();
+    return response;
+  }
+};
+
+/// Runs of equal region() along @p track as (first, last) pairs.
+std::vector<std::pair<std::size_t, std::size_t>>
+expected_runs(const std::vector<regeocode::Coordinates> &track) {
+  std::vector<std::pair<std::size_t, std::size_t>> runs;
+  for (std::size_t i = 0; i < track.size(); ++i) {
+    if (i == 0 ||
+        region(track[i].latitude) != region(track[i - 1].latitude))
+      runs.emplace_back(i, i);
+    runs.back().second = i;
+  }
+  return runs;
+}
+
+/// A track from 48.0 to 49.5 degrees north.
+std::vector<regeocode::Coordinates> make_track(std::size_t n) {
+  std::vector<regeocode::Coordinates> track;
+  for (std::size_t i = 0; i < n; ++i)
+    track.push_back(
+        {48.0 + 1.5 * static_cast<double>(i) / static_cast<double>(n - 1),
+         11.0, ""});
+  return track;
+}
+
+void check_segments(const regeocode::TrackResult &result,
+                    const std::vector<regeocode::Coordinates> &track) {
+  const auto runs = expected_runs(track);
+  assert(result.points == track.size());
+  assert(result.segments.size() == runs.size());
+  for (std::size_t k = 0; k < runs.size(); ++k) {
+    const auto &segment = result.segments[k];
+    assert(segment.first == runs[k].first && segment.last == runs[k].second);
+    const std::string city = region(track[segment.first].latitude);
+    if (city.empty()) {
+      assert(segment.result.contains("error"));
+    } else {
+      assert(segment.result["result"]["details"]["city"] == city);
+      assert(segment.result["meta"]["latitude"] ==
+             track[segment.first].latitude);
+    }
+  }
+}
+
+/// NMEA sentence with its checksum.
+std::string sentence(const std::string &body) {
+  unsigned sum = 0;
+  for (const char c : body)
+    sum ^= static_cast<unsigned char>(c);
+  char hex[3];
+  std::snprintf(hex, sizeof(hex), "%02X", sum);
+  return "$" + body + "*" + hex + "\r\n";
+}
+} // namespace
+
+/**
+ * @brief Main function for the track test.
+ *
+ * @return int Exit code (0 for success).
+ */
+int main() {
+  using namespace regeocode;
+  const auto temp = std::filesystem::temp_directory_path();
+
+  try {
+    // Test GPX track and route points are read in order
+    {
+      const std::string gpx = R"(<?xml version="1.0"?>
+<gpx version="1.1" creator="test">
+  <wpt lat="1.0" lon="1.0"><name>not part of the track</name></wpt>
+  <!-- <trkpt lat="2.0" lon="2.0"> -->
+  <trk><trkseg>
+    <trkpt lat="48.1" lon="11.5"><ele>520</ele></trkpt>
+    <trkpt  lon = "-0.25"  lat = "-33.75" />
+  </trkseg></trk>
+  <rte><rtept lon='2.35' lat='48.85'></rtept></rte>
+</gpx>)";
+      const auto points = parse_gpx(gpx);
+      assert(points.size() == 3);
+      assert(points[0].latitude == 48.1 && points[0].longitude == 11.5);
+      assert(points[1].latitude == -33.75 && points[1].longitude == -0.25);
+      assert(points[2].latitude == 48.85 && points[2].longitude == 2.35);
+
+      bool thrown = false;
+      try {
+        parse_gpx(R"(<trkpt lat="91" lon="0"/>)");
+      } catch (const std::runtime_error &) {
+        thrown = true;
+      }
+      assert(thrown);
+    }
+    std::println("Test GPX reader: OK");
+
+    // Test NMEA fixes: RMC and GGA, hemispheres, no fix, bad checksums
+    {
+      std::string log;
+      log += sentence("GPRMC,123519,A,4807.038,N,01131.000,E,022.4,084.4,230394,003.1,W");
+      log += sentence("GPGGA,123519,4807.038,N,01131.000,E,1,08,0.9,545.4,M,46.9,M,,");
+      log += sentence("GPRMC,123520,V,4808.000,N,01131.000,E,,,230394,,");
+      log += sentence("GPGGA,123520,4808.000,N,01131.000,E,0,00,,,M,,M,,");
+      log += "$GPRMC,123521,A,4809.000,N,01131.000,E,,,230394,,*00\n";
+      log += "garbage line\n";
+      log += sentence("GNRMC,123522,A,3345.000,S,00015.000,W,,,230394,,");
+      const auto points = parse_nmea(log);
+      assert(points.size() == 2);
+      assert(std::abs(points[0].latitude - (48.0 + 7.038 / 60.0)) < 1e-9);
+      assert(std::abs(points[0].longitude - (11.0 + 31.0 / 60.0)) < 1e-9);
+      assert(points[1].latitude == -33.75 && points[1].longitude == -0.25);
+    }
+    std::println("Test NMEA reader: OK");
+
+    // Test read_track() tells the formats apart
+    {
+      const auto gpx_path = (temp / "regeocode_track_test.gpx").string();
+      const auto nmea_path = (temp / "regeocode_track_test.nmea").string();
+      std::ofstream(gpx_path) << "\xEF\xBB\xBF\n<gpx><trk><trkseg>"
+                                 "<trkpt lat=\"1.5\" lon=\"2.5\"/>"
+                                 "</trkseg></trk></gpx>";
+      std::ofstream(nmea_path)
+          << sentence("GPGGA,0,0130.000,N,00230.000,E,1,08,,,M,,M,,");
+      assert(read_track(gpx_path).size() == 1);
+      const auto fixes = read_track(nmea_path);
+      assert(fixes.size() == 1 && fixes[0].latitude == 1.5 &&
+             fixes[0].longitude == 2.5);
+      std::filesystem::remove(gpx_path);
+      std::filesystem::remove(nmea_path);
+
+      bool thrown = false;
+      try {
+        read_track((temp / "regeocode_no_such_track.gpx").string());
+      } catch (const std::runtime_error &) {
+        thrown = true;
+      }
+      assert(thrown);
+    }
+    std::println("Test read_track: OK");
+
+    const ApiConfig cfg = test::fixture_config("nominatim");
+    std::vector<ApiAdapterPtr> adapters;
+    adapters.push_back(std::make_unique<NominatimAdapter>());
+    const ReverseGeocoder geocoder({{cfg.name, cfg}}, std::move(adapters),
+                                   std::make_unique<RegionHttpClient>(),
+                                   regeocode::test::quota_file());
+
+    // Test segments match a lookup of every point
+    {
+      const auto track = make_track(300);
+      const TrackResult every =
+          geocode_track(geocoder, track, {"nominatim"}, "", {},
+                        {.probe_every = 1});
+      assert(every.lookups == track.size());
+      check_segments(every, track);
+
+      const TrackResult adaptive =
+          geocode_track(geocoder, track, {"nominatim"}, "", {},
+                        {.probe_every = 32});
+      check_segments(adaptive, track);
+      assert(adaptive.lookups < track.size() / 4);
+    }
+    std::println("Test adaptive segments: OK");
+
+    // Test a long track needs a fraction of the lookups
+    {
+      const auto track = make_track(10000);
+      const TrackResult result = geocode_track(geocoder, track, {"nominatim"});
+      check_segments(result, track);
+      // Every 64th point and the last, and four boundaries found in six
+      // halvings each
+      assert(result.lookups == 158 + 4 * 6);
+      std::println("  {} points, {} lookups, {} segments", result.points,
+                   result.lookups, result.segments.size());
+
+      for (const std::size_t i : {0, 3333, 3334, 6666, 6667, 9999}) {
+        const TrackSegment &s = result.segment_of(i);
+        assert(s.first <= i && i <= s.last);
+      }
+      bool thrown = false;
+      try {
+        result.segment_of(track.size());
+      } catch (const std::out_of_range &) {
+        thrown = true;
+      }
+      assert(thrown);
+
+      const nlohmann::json j = result.to_json();
+      assert(j["points"] == 10000 && j["lookups"] == result.lookups);
+      assert(j["segments"].size() == result.segments.size());
+      assert(j["segments"][1]["first"] == result.segments[1].first);
+    }
+    std::println("Test long track: OK");
+
+    // Test probing by distance on a constant region
+    {
+      std::vector<Coordinates> track;
+      for (int i = 0; i < 1000; ++i) // 10 m apart
+        track.push_back({48.0 + i * 10.0 / 111195.0, 11.0, ""});
+      const TrackResult result =
+          geocode_track(geocoder, track, {"nominatim"}, "", {},
+                        {.probe_every = 100000, .probe_m = 500.0});
+      assert(result.segments.size() == 1 && result.segments[0].last == 999);
+      assert(result.lookups >= 20 && result.lookups <= 22);
+
+      // Only the label keys count
+      const TrackResult coarse =
+          geocode_track(geocoder, make_track(300), {"nominatim"}, "", {},
+                        {.probe_every = 32, .label_keys = {"state"}});
+      assert(coarse.segments.size() == 4);
+
+      assert(geocode_track(geocoder, {}, {"nominatim"}).segments.empty());
+    }
+    std::println("Test probe options: OK");
+
+    // Test a requested stop token cancels the track
+    {
+      std::stop_source stop;
+      stop.request_stop();
+      bool cancelled = false;
+      try {
+        geocode_track(geocoder, make_track(100), {"nominatim"}, "",
+                      stop.get_token());
+      } catch (const LookupCancelled &) {
+        cancelled = true;
+      }
+      assert(cancelled);
+    }
+    std::println("Test cancelled track: OK");
+
+    std::println("All track tests passed!");
+  } catch (const std::exception &e) {
+    std::cerr << "Test failed with exception: " << e.what() << std::endl;
+    return 1;
+  }
+
+  return 0;
+}
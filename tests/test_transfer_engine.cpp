@@ -0,0 +1,266 @@
+/**
+ * SPDX-FileComment: Unit test for the transfer engine.
+ * SPDX-FileType: SOURCE
+ * SPDX-FileContributor: ZHENG Robert
+ * SPDX-FileCopyrightText: 2026 ZHENG Robert
+ * SPDX-License-Identifier: MIT
+ *
+ * @file test_transfer_engine.cpp
+ * @brief Test cases for the multiplexing HttpClient: concurrent and
+ *        blocking transfers, connection reuse and limits, stop tokens,
+ *        timers, shutdown and http-version values.
+ * @version 0.1.0
+ * @date 2026-10-19
+ *
+ * @author ZHENG Robert
+ * @license MIT License
+ */
+
+#include "regeocode/http_client.hpp"
+#include "loopback_server.hpp"
+#include "test_support.hpp"
+
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <filesystem>
+#include <future>
+#include <iostream>
+#include <latch>
+#include <memory>
+#include <mutex>
+#include <print>
+#include <stdexcept>
+#include <stop_token>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace {
+using namespace std::chrono_literals;
+using Clock = std::chrono::steady_clock;
+
+/// Echoes the request target; "/slow/<ms>..." answers after that delay.
+regeocode::test::LoopbackReply
+echo(const regeocode::test::LoopbackRequest &request) {
+  regeocode::test::LoopbackReply reply;
+  reply.body = request.target;
+  if (request.target.starts_with("/slow/"))
+    reply.delay =
+        std::chrono::milliseconds(std::stol(request.target.substr(6)));
+  return reply;
+}
+
+regeocode::HttpClientOptions engine_options(long max_host_connections = 0) {
+  regeocode::HttpClientOptions options;
+  options.multiplex = true;
+  options.max_host_connections = max_host_connections;
+  return options;
+}
+
+/// Starts @p urls on @p client at once and returns the responses in order.
+std::vector<regeocode::HttpResponse>
+get_all(const regeocode::HttpClient &client,
+        const std::vector<std::string> &urls) {
+  std::vector<regeocode::HttpResponse> responses(urls.size());
+  std::latch done(static_cast<std::ptrdiff_t>(urls.size()));
+  for (std::size_t i = 0; i < urls.size(); ++i)
+    client.get_async(urls[i], 10, {}, {},
+                     [&responses, &done, i](regeocode::HttpResponse r) {
+                       responses[i] = std::move(r);
+                       done.count_down();
+                     });
+  done.wait();
+  return responses;
+}
+} // namespace
+
+/**
+ * @brief Main function for the transfer engine test.
+ *
+ * @return int Exit code (0 for success).
+ */
+int main() {
+  using namespace regeocode;
+
+  try {
+    test::LoopbackServer server(echo);
+
+    // Test concurrent transfers run side by side on the one engine thread
+    {
+      const HttpClient client(engine_options());
+      std::vector<std::string> urls;
+      for (int i = 0; i < 16; ++i)
+        urls.push_back(server.url("/slow/300?i=" + std::to_string(i)));
+      const auto started = Clock::now();
+      const auto responses = get_all(client, urls);
+      // One after the other this would take 4.8 s
+      assert(Clock::now() - started < 2s);
+      for (std::size_t i = 0; i < urls.size(); ++i) {
+        assert(responses[i].status_code == 200);
+        assert(std::string_view(responses[i].body) ==
+               urls[i].substr(urls[i].find("/slow")));
+      }
+    }
+    std::println("Test concurrent transfers: OK");
+
+    // Test blocking gets from several threads share the engine, and
+    // sequential requests reuse one connection
+    {
+      test::LoopbackServer fresh(echo);
+      const HttpClient client(engine_options());
+      for (int i = 0; i < 10; ++i)
+        assert(std::string_view(client.get(fresh.url("/seq"), 5).body) ==
+               "/seq");
+      assert(fresh.connections() == 1 && fresh.requests() == 10);
+
+      std::vector<std::thread> threads;
+      std::atomic<int> ok{0};
+      for (int t = 0; t < 8; ++t)
+        threads.emplace_back([&, t] {
+          for (int i = 0; i < 4; ++i) {
+            const std::string target =
+                "/slow/20?t=" + std::to_string(t) + "&i=" + std::to_string(i);
+            const HttpResponse r = client.get(fresh.url(target), 5);
+            if (std::string_view(r.body) == target)
+              ++ok;
+          }
+        });
+      for (auto &t : threads)
+        t.join();
+      assert(ok == 32 && fresh.requests() == 42);
+    }
+    std::println("Test blocking transfers: OK");
+
+    // Test max-host-connections holds transfers back on one connection
+    {
+      test::LoopbackServer fresh(echo);
+      const HttpClient client(engine_options(1));
+      std::vector<std::string> urls(6, fresh.url("/slow/100"));
+      const auto started = Clock::now();
+      for (const auto &r : get_all(client, urls))
+        assert(r.status_code == 200);
+      assert(Clock::now() - started >= 600ms);
+      assert(fresh.connections() == 1);
+    }
+    std::println("Test connection limit: OK");
+
+    // Test stop tokens end transfers at once, however they were started
+    {
+      const HttpClient client(engine_options());
+      std::stop_source stop;
+      std::promise<HttpResponse> silent;
+      client.get_async(server.url("/slow/3600000"), 60, {}, stop.get_token(),
+                       [&](HttpResponse r) { silent.set_value(std::move(r)); });
+
+      HttpRequestOptions blocking;
+      blocking.stop = stop.get_token();
+      auto pending = std::async(std::launch::async, [&] {
+        return client.get(server.url("/slow/3600000"), 60, blocking);
+      });
+
+      std::this_thread::sleep_for(50ms);
+      const auto started = Clock::now();
+      stop.request_stop();
+      const HttpResponse aborted = silent.get_future().get();
+      assert(aborted.cancelled && aborted.status_code == 599);
+      const HttpResponse stopped = pending.get();
+      assert(stopped.cancelled && stopped.status_code == 599);
+      assert(Clock::now() - started < 2s);
+
+      // Already requested: completes cancelled without a request
+      const std::size_t before = server.requests();
+      std::promise<HttpResponse> never;
+      client.get_async(server.url("/never"), 5, {}, stop.get_token(),
+                       [&](HttpResponse r) { never.set_value(std::move(r)); });
+      assert(never.get_future().get().cancelled);
+      assert(server.requests() == before);
+    }
+    std::println("Test stop tokens: OK");
+
+    // Test timers fire in time order and can be cancelled
+    {
+      const HttpClient client(engine_options());
+      std::mutex mutex;
+      std::vector<int> fired;
+      std::latch done(3);
+      const auto started = Clock::now();
+      for (const int ms : {60, 20, 40})
+        client.wait_async(std::chrono::milliseconds(ms), {}, [&, ms](bool c) {
+          assert(!c);
+          std::lock_guard lock(mutex);
+          fired.push_back(ms);
+          done.count_down();
+        });
+      done.wait();
+      assert(Clock::now() - started >= 60ms);
+      assert((fired == std::vector<int>{20, 40, 60}));
+
+      std::stop_source stop;
+      std::promise<bool> timer;
+      client.wait_async(1h, stop.get_token(),
+                        [&](bool c) { timer.set_value(c); });
+      stop.request_stop();
+      assert(timer.get_future().get());
+    }
+    std::println("Test timers: OK");
+
+    // Test destroying the client lets transfers in flight finish and
+    // cancels pending timers
+    {
+      std::promise<HttpResponse> received;
+      std::promise<bool> timer;
+      {
+        const HttpClient client(engine_options());
+        client.get_async(
+            server.url("/slow/100"), 5, {}, {},
+            [&](HttpResponse r) { received.set_value(std::move(r)); });
+        client.wait_async(1h, {}, [&](bool c) { timer.set_value(c); });
+        std::this_thread::sleep_for(20ms);
+      }
+      auto response = received.get_future();
+      assert(response.wait_for(0s) == std::future_status::ready);
+      assert(std::string_view(response.get().body) == "/slow/100");
+      assert(timer.get_future().get());
+    }
+    std::println("Test shutdown: OK");
+
+    // Test other schemes run on the engine too
+    {
+      const HttpClient client(engine_options());
+      const std::string path =
+          std::filesystem::absolute("tests/fixtures/nominatim.json").string();
+      std::promise<HttpResponse> received;
+      client.get_async("file://" + path, 5, {}, {}, [&](HttpResponse r) {
+        received.set_value(std::move(r));
+      });
+      const HttpResponse file = received.get_future().get();
+      assert(!file.cancelled &&
+             std::string_view(file.body) == test::read_fixture("nominatim"));
+    }
+    std::println("Test file transfers: OK");
+
+    // Test http-version values
+    assert(parse_http_version("auto") == HttpVersion::Auto);
+    assert(parse_http_version(" 1.1 ") == HttpVersion::Http1_1);
+    assert(parse_http_version("2") == HttpVersion::Http2);
+    assert(parse_http_version("2-prior-knowledge") ==
+           HttpVersion::Http2PriorKnowledge);
+    bool thrown = false;
+    try {
+      (void)parse_http_version("3");
+    } catch (const std::invalid_argument &) {
+      thrown = true;
+    }
+    assert(thrown);
+    std::println("Test http-version: OK");
+
+    std::println("All transfer engine tests passed!");
+  } catch (const std::exception &e) {
+    std::cerr << "Test failed with exception: " << e.what() << std::endl;
+    return 1;
+  }
+
+  return 0;
+}
@@ -0,0 +1,102 @@
+/**
+ * SPDX-FileComment: Unit test for the worker pool.
+ * SPDX-FileType: SOURCE
+ * SPDX-FileContributor: ZHENG Robert
+ * SPDX-FileCopyrightText: 2026 ZHENG Robert
+ * SPDX-License-Identifier: MIT
+ *
+ * @file test_worker_pool.cpp
+ * @brief Test cases for queued jobs, parallel_for and draining on shutdown.
+ * @version 0.1.0
+ * @date 2026-10-19
+ *
+ * @author ZHENG Robert
+ * @license MIT License
+ */
+
+#include "regeocode/worker_pool.hpp"
+
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <future>
+#include <iostream>
+#include <print>
+#include <stdexcept>
+#include <vector>
+
+/**
+ * @brief Main function for the worker pool test.
+ *
+ * @return int Exit code (0 for success).
+ */
+int main() {
+  using namespace regeocode;
+
+  try {
+    // Test every index runs exactly once
+    {
+      WorkerPool pool(4);
+      assert(pool.size() == 4);
+      std::vector<std::atomic<int>> hits(1000);
+      pool.parallel_for(hits.size(), [&](std::size_t i) { ++hits[i]; });
+      for (const auto &h : hits)
+        assert(h == 1);
+      pool.parallel_for(0, [](std::size_t) { assert(false); });
+    }
+    std::println("Test parallel_for: OK");
+
+    // Test the first exception reaches the caller after all indices ran
+    {
+      WorkerPool pool(2);
+      std::atomic<int> ran{0};
+      bool caught = false;
+      try {
+        pool.parallel_for(50, [&](std::size_t i) {
+          ++ran;
+          if (i % 10 == 3)
+            throw std::runtime_error("bad index");
+        });
+      } catch (const std::runtime_error &) {
+        caught = true;
+      }
+      assert(caught && ran == 50);
+    }
+    std::println("Test parallel_for exceptions: OK");
+
+    // Test parallel_for inside a job completes although no worker is free
+    {
+      WorkerPool pool(1);
+      std::promise<int> sum;
+      pool.submit([&] {
+        std::atomic<int> total{0};
+        pool.parallel_for(10, [&](std::size_t i) {
+          total += static_cast<int>(i);
+        });
+        sum.set_value(total);
+      });
+      auto f = sum.get_future();
+      assert(f.wait_for(std::chrono::seconds(5)) == std::future_status::ready);
+      assert(f.get() == 45);
+    }
+    std::println("Test nested parallel_for: OK");
+
+    // Test destruction runs the jobs still queued
+    std::atomic<int> done{0};
+    {
+      WorkerPool pool(2);
+      for (int i = 0; i < 100; ++i)
+        pool.submit([&] { ++done; });
+    }
+    assert(done == 100);
+    assert(WorkerPool::default_size() >= 4);
+    std::println("Test shutdown drains the queue: OK");
+
+    std::println("All worker pool tests passed!");
+  } catch (const std::exception &e) {
+    std::cerr << "Test failed with exception: " << e.what() << std::endl;
+    return 1;
+  }
+
+  return 0;
+}